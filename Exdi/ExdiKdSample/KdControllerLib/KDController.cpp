@@ -27,6 +27,7 @@ KDController::KDController(_In_ HANDLE processHandle, _In_ HANDLE stdInput, _In_
     , m_kdPromptRegex("\n(|[0-9]+: )kd> ")  //The prompt can be either "kd> " or "#: kd>" where # is the core number.
 	, m_cachedProcessorCount(0)
     , m_lastKnownActiveCpu(0)
+    , m_bulkReadThreshold(DefaultBulkReadThreshold)
 {
     //If we run inside the WinDbg process and WinDbg gets closed without ending the session cleanly, we still want
     //to terminate the underlying kd.exe in order to make the machine connection available for subsequent debug
@@ -198,6 +199,15 @@ void KDController::SetRegisters(_In_ unsigned processorNumber, _In_ const std::m
 }
 
 SimpleCharBuffer KDController::ReadMemory(_In_ AddressType address, _In_ size_t size)
+{
+    if (m_bulkReadThreshold != 0 && size >= m_bulkReadThreshold)
+    {
+        return ReadMemoryInBulk(address, size);
+    }
+    return ReadMemoryAsText(address, size);
+}
+
+SimpleCharBuffer KDController::ReadMemoryAsText(_In_ AddressType address, _In_ size_t size)
 {
     char command[128];
     assert(address <= (address + size));
@@ -210,6 +220,82 @@ SimpleCharBuffer KDController::ReadMemory(_In_ AddressType address, _In_ size_t
     }
 
     std::string reply = ExecuteCommand(command);
+    ParseByteDump(reply, size, result);
+    return result;
+}
+
+SimpleCharBuffer KDController::ReadMemoryInBulk(_In_ AddressType address, _In_ size_t size)
+{
+    assert(address <= (address + size));
+
+    SimpleCharBuffer result;
+    if (!result.TryEnsureCapacity(size))
+    {
+        throw _com_error(E_OUTOFMEMORY);
+    }
+
+    //KD.EXE is our child process running under the same account, so it can write into our temporary directory.
+    char tempDirectory[MAX_PATH];
+    char tempFile[MAX_PATH];
+    DWORD tempDirectoryLength = GetTempPathA(_countof(tempDirectory), tempDirectory);
+    if (tempDirectoryLength == 0 || tempDirectoryLength >= _countof(tempDirectory))
+    {
+        throw _com_error(HRESULT_FROM_WIN32(GetLastError()));
+    }
+
+    if (GetTempFileNameA(tempDirectory, "kdm", 0, tempFile) == 0)
+    {
+        throw _com_error(HRESULT_FROM_WIN32(GetLastError()));
+    }
+
+    try
+    {
+        char command[MAX_PATH + 128];
+        _snprintf_s(command, _TRUNCATE, ".writemem \"%s\" %I64x L?%I64x", tempFile, address, static_cast<ULONGLONG>(size));
+
+        //The reply is either a short progress message or 'Unable to read memory at ..., file is partial'.
+        //In both cases the file size tells us how many bytes were actually read.
+        std::string reply = ExecuteCommand(command);
+        UNREFERENCED_PARAMETER(reply);
+
+        AppendFileContents(tempFile, size, result);
+    }
+    catch (...)
+    {
+        DeleteFileA(tempFile);
+        throw;
+    }
+    DeleteFileA(tempFile);
+
+    if (result.GetLength() < size)
+    {
+        //.writemem stops at the first unreadable page or may not be supported by the connected KD at all.
+        //Let the text path read the remainder so that partial reads behave exactly as before.
+        size_t bytesRead = result.GetLength();
+        SimpleCharBuffer remainder = ReadMemoryAsText(address + bytesRead, size - bytesRead);
+        if (remainder.GetLength() != 0)
+        {
+            result.SetLength(bytesRead + remainder.GetLength());
+            memcpy(result.GetInternalBuffer() + bytesRead, remainder.GetInternalBuffer(), remainder.GetLength());
+        }
+    }
+
+    return result;
+}
+
+void KDController::ParseByteDump(_In_ const std::string &reply, _In_ size_t size, _Inout_ SimpleCharBuffer &result)
+{
+    if (size == 0)
+    {
+        return;
+    }
+
+    size_t const finalLength = result.GetLength() + size;
+    if (result.GetCapacity() < finalLength && !result.TryEnsureCapacity(finalLength))
+    {
+        throw _com_error(E_OUTOFMEMORY);
+    }
+
     //Iterate over each line of the reply
     size_t lineStart = 0;
     for (;;)
@@ -223,7 +309,7 @@ SimpleCharBuffer KDController::ReadMemory(_In_ AddressType address, _In_ size_t
         }
 
         size_t byteDumpEnd = reply.find("  ", addressEnd + 1);
-        if (addressEnd >= lineEnd)
+        if (byteDumpEnd >= lineEnd)
         {
             break;
         }
@@ -244,7 +330,7 @@ SimpleCharBuffer KDController::ReadMemory(_In_ AddressType address, _In_ size_t
 				if (reply[i] == '?')
 				{
 					//We've reached the end of a mapped page. Partial read here should succeed.
-					break;
+					return;
 				}
                 throw _com_error(E_FAIL);
             }
@@ -252,9 +338,9 @@ SimpleCharBuffer KDController::ReadMemory(_In_ AddressType address, _In_ size_t
             result.SetLength(result.GetLength() + 1);
             result[result.GetLength() - 1] = static_cast<char>(value);
 
-            if (result.GetLength() >= size)
+            if (result.GetLength() >= finalLength)
             {
-                return result;
+                return;
             }
         }
 
@@ -265,7 +351,60 @@ SimpleCharBuffer KDController::ReadMemory(_In_ AddressType address, _In_ size_t
             break;
         }
     }
-    return result;
+}
+
+void KDController::AppendFileContents(_In_z_ LPCSTR pFilePath, _In_ size_t size, _Inout_ SimpleCharBuffer &result)
+{
+    HandleWrapper file;
+    file.Attach(CreateFileA(pFilePath, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, 
+                            OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr));
+    if (!file.IsValid())
+    {
+        throw _com_error(HRESULT_FROM_WIN32(GetLastError()));
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file.Get(), &fileSize))
+    {
+        throw _com_error(HRESULT_FROM_WIN32(GetLastError()));
+    }
+
+    size_t bytesToCopy = size;
+    if (static_cast<ULONGLONG>(fileSize.QuadPart) < bytesToCopy)
+    {
+        bytesToCopy = static_cast<size_t>(fileSize.QuadPart);
+    }
+
+    if (bytesToCopy == 0)
+    {
+        //An empty file cannot be mapped. Nothing was read.
+        return;
+    }
+
+    size_t const finalLength = result.GetLength() + bytesToCopy;
+    if (result.GetCapacity() < finalLength && !result.TryEnsureCapacity(finalLength))
+    {
+        throw _com_error(E_OUTOFMEMORY);
+    }
+
+    HandleWrapper mapping;
+    mapping.Attach(CreateFileMappingA(file.Get(), nullptr, PAGE_READONLY, 0, 0, nullptr));
+    if (mapping.Get() == nullptr)
+    {
+        mapping.Detach();
+        throw _com_error(HRESULT_FROM_WIN32(GetLastError()));
+    }
+
+    const void *pView = MapViewOfFile(mapping.Get(), FILE_MAP_READ, 0, 0, bytesToCopy);
+    if (pView == nullptr)
+    {
+        throw _com_error(HRESULT_FROM_WIN32(GetLastError()));
+    }
+
+    memcpy(result.GetEndOfData(), pView, bytesToCopy);
+    result.SetLength(finalLength);
+
+    UnmapViewOfFile(pView);
 }
 
 ULONGLONG KDController::ParseRegisterValue(_In_ const std::string &stringValue)
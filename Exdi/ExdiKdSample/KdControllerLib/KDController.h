@@ -46,7 +46,23 @@ namespace KDControllerLib
         std::map<std::string, std::string> QueryAllRegisters(_In_ unsigned processorNumber);
         void SetRegisters(_In_ unsigned processorNumber, _In_ const std::map<std::string, AddressType> &registerValues);
 
+        //Reads smaller than the bulk read threshold are served by parsing the 'db' output. Larger reads ask KD
+        //to write the range into a temporary file ('.writemem') and copy the raw bytes back without any conversion.
         SimpleCharBuffer ReadMemory(_In_ AddressType address, _In_ size_t size);
+        SimpleCharBuffer ReadMemoryAsText(_In_ AddressType address, _In_ size_t size);
+        SimpleCharBuffer ReadMemoryInBulk(_In_ AddressType address, _In_ size_t size);
+
+        static const size_t DefaultBulkReadThreshold = 4096;
+
+        //Specify 0 to always use the text path.
+        void SetBulkReadThreshold(_In_ size_t threshold) { m_bulkReadThreshold = threshold; }
+        size_t GetBulkReadThreshold() const { return m_bulkReadThreshold; }
+
+        //Appends up to 'size' bytes from the output of a 'db' command. Stops at the first unreadable ('??') byte.
+        static void ParseByteDump(_In_ const std::string &reply, _In_ size_t size, _Inout_ SimpleCharBuffer &result);
+
+        //Appends up to 'size' bytes from a file created by the '.writemem' command.
+        static void AppendFileContents(_In_z_ LPCSTR pFilePath, _In_ size_t size, _Inout_ SimpleCharBuffer &result);
 
 		unsigned GetProcessorCount();
 		AddressType GetKPCRAddress(_In_ unsigned processorNumber);
@@ -81,6 +97,7 @@ namespace KDControllerLib
 
 		unsigned m_cachedProcessorCount;
         unsigned m_lastKnownActiveCpu;
+        size_t m_bulkReadThreshold;
 
         std::string ReadStdoutUntilDelimiter();
     };
@@ -0,0 +1,222 @@
+//----------------------------------------------------------------------------
+//
+// KDControllerMemoryReadTest.cpp
+//
+// Unit tests and a benchmark for the text ('db') and bulk ('.writemem')
+// memory reading paths of the KDController class.
+//
+// Copyright (c) Microsoft. All rights reserved.
+//
+//----------------------------------------------------------------------------
+
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include <string>
+#include "../KDControllerLib/KDController.h"
+#include "../KDControllerLib/ExceptionHelpers.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace KDControllerLib;
+
+namespace KdControllerLibTests
+{
+	TEST_CLASS(KDControllerMemoryReadTest)
+	{
+	public:
+        TEST_METHOD(ParseFullLinesTest)
+        {
+            std::string reply = FormatByteDump(0xfffff80012340000, 48, 48);
+            SimpleCharBuffer buffer;
+            KDController::ParseByteDump(reply, 48, buffer);
+
+            Assert::IsTrue(buffer.GetLength() == 48);
+            for (size_t i = 0; i < buffer.GetLength(); ++i)
+            {
+                Assert::IsTrue(static_cast<unsigned char>(buffer[i]) == GetPatternByte(i));
+            }
+        }
+
+        TEST_METHOD(ParsePartialLineTest)
+        {
+            std::string reply = FormatByteDump(0x1000, 21, 21);
+            SimpleCharBuffer buffer;
+            KDController::ParseByteDump(reply, 21, buffer);
+
+            Assert::IsTrue(buffer.GetLength() == 21);
+            Assert::IsTrue(static_cast<unsigned char>(buffer[20]) == GetPatternByte(20));
+        }
+
+        TEST_METHOD(ParseUnreadableTailTest)
+        {
+            //Only the first 20 bytes are readable, the rest of the requested range is displayed as '??'.
+            std::string reply = FormatByteDump(0x1000, 64, 20);
+            SimpleCharBuffer buffer;
+            KDController::ParseByteDump(reply, 64, buffer);
+
+            Assert::IsTrue(buffer.GetLength() == 20);
+        }
+
+        TEST_METHOD(AppendFileContentsTest)
+        {
+            size_t const fileSize = 1000;
+            TemporaryDataFile file(fileSize);
+
+            SimpleCharBuffer buffer;
+            KDController::AppendFileContents(file.GetPath(), fileSize, buffer);
+            Assert::IsTrue(buffer.GetLength() == fileSize);
+            for (size_t i = 0; i < buffer.GetLength(); ++i)
+            {
+                Assert::IsTrue(static_cast<unsigned char>(buffer[i]) == GetPatternByte(i));
+            }
+
+            //A file shorter than the request is a partial read.
+            SimpleCharBuffer partialBuffer;
+            KDController::AppendFileContents(file.GetPath(), fileSize * 2, partialBuffer);
+            Assert::IsTrue(partialBuffer.GetLength() == fileSize);
+        }
+
+        TEST_METHOD(AppendEmptyFileTest)
+        {
+            TemporaryDataFile file(0);
+
+            SimpleCharBuffer buffer;
+            KDController::AppendFileContents(file.GetPath(), 4096, buffer);
+            Assert::IsTrue(buffer.GetLength() == 0);
+        }
+
+        //Compares the client side cost of both paths for a range of read sizes. The text path additionally
+        //has to transfer roughly 4.5 times more data through the KD.EXE output pipe, which is not measured here.
+        TEST_METHOD(TextVersusBulkBenchmark)
+        {
+            size_t const sizes[] = { 256, 4096, 65536, 1024 * 1024 };
+            for (size_t size : sizes)
+            {
+                std::string reply = FormatByteDump(0xfffff80012340000, size, size);
+                TemporaryDataFile file(size);
+
+                int const iterations = static_cast<int>((4 * 1024 * 1024) / size);
+
+                LARGE_INTEGER frequency, start, textEnd, bulkEnd;
+                QueryPerformanceFrequency(&frequency);
+
+                QueryPerformanceCounter(&start);
+                for (int i = 0; i < iterations; ++i)
+                {
+                    SimpleCharBuffer buffer;
+                    KDController::ParseByteDump(reply, size, buffer);
+                    Assert::IsTrue(buffer.GetLength() == size);
+                }
+                QueryPerformanceCounter(&textEnd);
+                for (int i = 0; i < iterations; ++i)
+                {
+                    SimpleCharBuffer buffer;
+                    KDController::AppendFileContents(file.GetPath(), size, buffer);
+                    Assert::IsTrue(buffer.GetLength() == size);
+                }
+                QueryPerformanceCounter(&bulkEnd);
+
+                double textMicroseconds = (textEnd.QuadPart - start.QuadPart) * 1000000.0 / frequency.QuadPart / iterations;
+                double bulkMicroseconds = (bulkEnd.QuadPart - textEnd.QuadPart) * 1000000.0 / frequency.QuadPart / iterations;
+
+                char message[256];
+                _snprintf_s(message, _TRUNCATE, "%8Iu bytes: text %10.1f us (%Iu bytes of output), bulk %10.1f us\n",
+                            size, textMicroseconds, reply.length(), bulkMicroseconds);
+                Logger::WriteMessage(message);
+            }
+        }
+
+    private:
+        static unsigned char GetPatternByte(_In_ size_t offset)
+        {
+            return static_cast<unsigned char>((offset * 7) ^ (offset >> 8));
+        }
+
+        //Produces the text KD.EXE prints for 'db', e.g.
+        //fffff800`12340000  4d 5a 90 00 03 00 00 00-04 00 00 00 ff ff 00 00  MZ..............
+        static std::string FormatByteDump(_In_ ULONGLONG address, _In_ size_t size, _In_ size_t readableSize)
+        {
+            std::string result;
+            result.reserve((size / 16 + 1) * 80);
+
+            for (size_t lineOffset = 0; lineOffset < size; lineOffset += 16)
+            {
+                char line[128];
+                ULONGLONG lineAddress = address + lineOffset;
+                int position = _snprintf_s(line, _TRUNCATE, "%08x`%08x ", static_cast<unsigned>(lineAddress >> 32), 
+                                           static_cast<unsigned>(lineAddress));
+                
+                std::string characters;
+                for (size_t i = 0; i < 16; ++i)
+                {
+                    size_t offset = lineOffset + i;
+                    char separator = (i == 8) ? '-' : ' ';
+                    if (offset >= size)
+                    {
+                        position += _snprintf_s(line + position, _countof(line) - position, _TRUNCATE, "   ");
+                        continue;
+                    }
+
+                    if (offset < readableSize)
+                    {
+                        unsigned char value = GetPatternByte(offset);
+                        position += _snprintf_s(line + position, _countof(line) - position, _TRUNCATE, "%c%02x", separator, value);
+                        characters += (value >= 0x20 && value < 0x7f) ? static_cast<char>(value) : '.';
+                    }
+                    else
+                    {
+                        position += _snprintf_s(line + position, _countof(line) - position, _TRUNCATE, "%c??", separator);
+                        characters += '?';
+                    }
+                }
+
+                result += line;
+                result += "  ";
+                result += characters;
+                result += "\n";
+            }
+            return result;
+        }
+
+        class TemporaryDataFile
+        {
+        public:
+            TemporaryDataFile(_In_ size_t size)
+            {
+                char tempDirectory[MAX_PATH];
+                Assert::IsTrue(GetTempPathA(_countof(tempDirectory), tempDirectory) != 0);
+                Assert::IsTrue(GetTempFileNameA(tempDirectory, "kdt", 0, m_path) != 0);
+
+                HANDLE file = CreateFileA(m_path, GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+                Assert::IsTrue(file != INVALID_HANDLE_VALUE);
+
+                std::string data(size, '\0');
+                for (size_t i = 0; i < size; ++i)
+                {
+                    data[i] = static_cast<char>(GetPatternByte(i));
+                }
+
+                DWORD written = 0;
+                if (size != 0)
+                {
+                    Assert::IsTrue(WriteFile(file, data.c_str(), static_cast<DWORD>(size), &written, nullptr) == TRUE);
+                }
+                CloseHandle(file);
+                Assert::IsTrue(written == size);
+            }
+
+            ~TemporaryDataFile()
+            {
+                DeleteFileA(m_path);
+            }
+
+            LPCSTR GetPath() const
+            {
+                return m_path;
+            }
+
+        private:
+            char m_path[MAX_PATH];
+        };
+	};
+}
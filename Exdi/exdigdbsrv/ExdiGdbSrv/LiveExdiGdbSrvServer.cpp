@@ -52,6 +52,9 @@ using namespace GdbSrvControllerLib;
 #define SEGDESC_INVALID                 0xffffffff
 #define X86_DESC_FLAGS                  (X86_DESC_DEFAULT_BIG | X86_DESC_PRESENT)
 
+//  Interval (msec) between GdbServer link probes done by the health monitor thread
+#define HEALTH_MONITOR_PROBE_INTERVAL_MS    500
+
 
 //=============================================================================
 // Global data definitions
@@ -149,6 +152,11 @@ HRESULT STDMETHODCALLTYPE CLiveExdiGdbSrvServer::Run(void)
         {
             return E_POINTER;
         }
+        HRESULT flushResult = FlushPendingMemoryWrites(pController);
+        if (FAILED(flushResult))
+        {
+            return flushResult;
+        }
         pController->ResetAsynchronousCmdStopReplyPacket();
         pController->StartRunCommand();
 
@@ -245,6 +253,11 @@ HRESULT STDMETHODCALLTYPE CLiveExdiGdbSrvServer::DoSingleStep(DWORD dwProcessorN
         {
             return E_POINTER;
         }
+        HRESULT flushResult = FlushPendingMemoryWrites(pController);
+        if (FAILED(flushResult))
+        {
+            return flushResult;
+        }
         pController->ResetAsynchronousCmdStopReplyPacket();
         pController->StartStepCommand(dwProcessorNumber);
 
@@ -272,6 +285,11 @@ HRESULT STDMETHODCALLTYPE CLiveExdiGdbSrvServer::Reboot(void)
         {
             return E_POINTER;
         }
+        HRESULT flushResult = FlushPendingMemoryWrites(pController);
+        if (FAILED(flushResult))
+        {
+            return flushResult;
+        }
         //  This should reboot only the target machine.
         if (pController->RestartGdbSrvTarget())
         {
@@ -973,6 +991,17 @@ HRESULT CLiveExdiGdbSrvServer::FinalConstruct()
         return HRESULT_FROM_WIN32(GetLastError());
     }
 
+    m_healthMonitorStopEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+    if (m_healthMonitorStopEvent == nullptr)
+    {
+        return HRESULT_FROM_WIN32(GetLastError());
+    }
+    m_healthMonitorThread = CreateThread(nullptr, 0, HealthMonitorThreadBody, this, 0, &threadId);
+    if (m_healthMonitorThread == nullptr)
+    {
+        return HRESULT_FROM_WIN32(GetLastError());
+    }
+
     m_timerId = SetTimer(nullptr, 0, 100, TimerCallback);
     assert(m_timerId != 0);
 
@@ -1014,6 +1043,21 @@ void CLiveExdiGdbSrvServer::FinalRelease()
     ReleaseSemaphore(m_notificationSemaphore, 1, nullptr);
     WaitForSingleObjectWhileDispatchingMessages(m_notificationThread, INFINITE);
 
+    if (m_healthMonitorThread != nullptr)
+    {
+        SetEvent(m_healthMonitorStopEvent);
+        WaitForSingleObject(m_healthMonitorThread, INFINITE);
+        CloseHandle(m_healthMonitorThread);
+        m_healthMonitorThread = nullptr;
+    }
+    if (m_healthMonitorStopEvent != nullptr)
+    {
+        CloseHandle(m_healthMonitorStopEvent);
+        m_healthMonitorStopEvent = nullptr;
+    }
+
+    //  Deleting the controller shuts down the GdbServer session, which first sends the memory writes
+    //  still buffered by the write-combining layer (the failed or lost writes are reported to the log).
     delete m_pGdbSrvController;
     m_pGdbSrvController = nullptr;
 }
@@ -1569,7 +1613,14 @@ ADDRESS_TYPE CLiveExdiGdbSrvServer::GetCurrentExecutionAddress(_Out_ DWORD *pPro
 
     *pProcessorNumberOfLastEvent = pController->GetLastKnownActiveCpu();
     ADDRESS_TYPE result;
-    std::map<std::string, std::string> registers = pController->QueryAllRegisters(*pProcessorNumberOfLastEvent);
+    //  The pc is usually expedited in the stop reply, so try it before requesting all registers.
+    const char * pcRegister[] = {(m_detectedProcessorFamily == PROCESSOR_FAMILY_X86) ?
+                                 ((m_targetProcessorArch == X86_ARCH) ? "Eip" : "rip") : "pc"};
+    std::map<std::string, std::string> registers;
+    if (!pController->FindCachedRegisters(*pProcessorNumberOfLastEvent, pcRegister, ARRAYSIZE(pcRegister), registers))
+    {
+        registers = pController->QueryAllRegisters(*pProcessorNumberOfLastEvent);
+    }
 
     if (m_detectedProcessorFamily == PROCESSOR_FAMILY_ARM || m_detectedProcessorFamily == PROCESSOR_FAMILY_ARMV8ARCH64)
     {
@@ -1594,6 +1645,32 @@ ADDRESS_TYPE CLiveExdiGdbSrvServer::GetCurrentExecutionAddress(_Out_ DWORD *pPro
     return result;
 }
 
+//
+//  FlushPendingMemoryWrites    Sends the memory writes buffered by the controller write-combining layer.
+//                              The controller reports each failed write to the log, and the failure
+//                              is returned to the engine. The failed writes are also displayed by using
+//                              the original (not coalesced) write requests issued by the debugger engine.
+//
+HRESULT CLiveExdiGdbSrvServer::FlushPendingMemoryWrites(_In_ AsynchronousGdbSrvController * const pController)
+{
+    assert(pController != nullptr);
+    std::vector<MemoryRangeType> failedWrites;
+    if (pController->FlushPendingMemoryWrites(&failedWrites))
+    {
+        return S_OK;
+    }
+
+    std::string message("Error: the GdbServer failed writing the following memory ranges:\n");
+    for (auto const & failedWrite : failedWrites)
+    {
+        char range[64];
+        sprintf_s(range, _countof(range), "%I64x L%Ix\n", failedWrite.first, failedWrite.second);
+        message += range;
+    }
+    MessageBoxA(0, message.c_str(), "EXDI-GdbServer", MB_ICONERROR);
+    return E_FAIL;
+}
+
 HRESULT STDMETHODCALLTYPE CLiveExdiGdbSrvServer::SetKeepaliveInterface(/* [in] */ IeXdiKeepaliveInterface3 *pKeepalive)
 {
     m_pKeepaliveInterface = pKeepalive;
@@ -1636,17 +1713,14 @@ HRESULT STDMETHODCALLTYPE CLiveExdiGdbSrvServer::PerformKeepaliveChecks(void)
         return E_POINTER;
     }
 
-    // Get the GdbServer connection status
-    bool isGdbServerDown = false;
-    HRESULT gdbServerError = S_OK;;
-    if (pController->CheckGdbSrvAlive(gdbServerError))
+    //  Get the GdbServer connection status published by the health monitor thread,
+    //  so this check never touches the link on the calling thread.
+    HRESULT gdbServerError = m_gdbServerLinkStatus.load();
+    bool isGdbServerDown = (gdbServerError == ERROR_OPERATION_ABORTED);
+    if (m_isGdbServerLinkLossPending.exchange(false))
     {
-        if (gdbServerError == ERROR_OPERATION_ABORTED)
-        {
-            //  Close the connection with the GdbServer
-            pController->ShutdownGdbSrv();
-            isGdbServerDown = true;
-        }
+        //  Close the connection with the GdbServer, only once per lost link.
+        pController->ShutdownGdbSrv();
     }
 
     HRESULT result = m_pKeepaliveInterface->IsDebugSessionAlive();
@@ -1785,6 +1859,68 @@ DWORD CALLBACK CLiveExdiGdbSrvServer::NotificationThreadBody(LPVOID p)
     return 0;
 }
 
+//
+//  HealthMonitorThreadBody     Background thread that tracks the GdbServer link liveness.
+//
+//  Note.
+//  Each core connection is probed only while its link is idle, so the monitor never waits
+//  behind (or interleaves with) a packet exchange. A lost connection is sticky per core
+//  until the controller reports a new connection, and the aggregated status is published
+//  to m_gdbServerLinkStatus for PerformKeepaliveChecks(). The transition to a lost link
+//  is signaled once through m_isGdbServerLinkLossPending, so the connection is shut down once.
+//  The TCP keep alive probes configured for the session surface a dead peer as a socket error.
+//
+DWORD CALLBACK CLiveExdiGdbSrvServer::HealthMonitorThreadBody(LPVOID p)
+{
+    CLiveExdiGdbSrvServer * pServer = reinterpret_cast<CLiveExdiGdbSrvServer *>(p);
+    AsynchronousGdbSrvController * pController = pServer->GetGdbSrvController();
+    assert(pController != nullptr);
+
+    std::vector<HRESULT> coreLinkStatus(pController->GetNumberOfRspConnections(), S_OK);
+    unsigned connectionGeneration = pController->GetGdbSrvConnectionGeneration();
+    HRESULT publishedStatus = S_OK;
+
+    while (WaitForSingleObject(pServer->m_healthMonitorStopEvent, HEALTH_MONITOR_PROBE_INTERVAL_MS) == WAIT_TIMEOUT)
+    {
+        //  A (re)connection starts a new session, so forget the lost state of the previous one.
+        unsigned currentGeneration = pController->GetGdbSrvConnectionGeneration();
+        if (currentGeneration != connectionGeneration)
+        {
+            connectionGeneration = currentGeneration;
+            coreLinkStatus.assign(pController->GetNumberOfRspConnections(), S_OK);
+            pServer->m_isGdbServerLinkLossPending.store(false);
+        }
+
+        HRESULT linkStatus = S_OK;
+        for (unsigned core = 0; core < coreLinkStatus.size(); ++core)
+        {
+            if (coreLinkStatus[core] != ERROR_OPERATION_ABORTED)
+            {
+                HRESULT error = S_OK;
+                if (pController->ProbeGdbSrvAlive(error, core))
+                {
+                    coreLinkStatus[core] = error;
+                }
+            }
+            if (coreLinkStatus[core] == ERROR_OPERATION_ABORTED)
+            {
+                linkStatus = ERROR_OPERATION_ABORTED;
+            }
+            else if (linkStatus == S_OK)
+            {
+                linkStatus = coreLinkStatus[core];
+            }
+        }
+        if (linkStatus == ERROR_OPERATION_ABORTED && publishedStatus != ERROR_OPERATION_ABORTED)
+        {
+            pServer->m_isGdbServerLinkLossPending.store(true);
+        }
+        publishedStatus = linkStatus;
+        pServer->m_gdbServerLinkStatus.store(linkStatus);
+    }
+    return 0;
+}
+
 VOID CALLBACK CLiveExdiGdbSrvServer::TimerCallback(_In_  HWND hwnd, _In_  UINT uMsg, _In_  UINT_PTR idEvent, _In_  DWORD dwTime)
 {
     UNREFERENCED_PARAMETER(hwnd);
@@ -18,6 +18,7 @@
 #include "GdbSrvControllerLib.h"
 #include <string>
 #include <memory>
+#include <atomic>
 
 
 
@@ -55,6 +56,10 @@ public:
           m_pSelfReferenceForNotificationThread(nullptr),
           m_notificationThread(nullptr),
           m_notificationSemaphore(nullptr),
+          m_healthMonitorThread(nullptr),
+          m_healthMonitorStopEvent(nullptr),
+          m_gdbServerLinkStatus(S_OK),
+          m_isGdbServerLinkLossPending(false),
           m_terminating(false),
           m_lastResumingCommandWasStep(false),
           m_targetIsRunning(false),
@@ -289,6 +294,13 @@ public:
         InterfaceMarshalHelper<IAsynchronousCommandNotificationReceiver> * m_pSelfReferenceForNotificationThread;
         HANDLE m_notificationThread;
         HANDLE m_notificationSemaphore;
+        //  Background GdbServer link health monitor
+        HANDLE m_healthMonitorThread;
+        HANDLE m_healthMonitorStopEvent;
+        //  Last link status published by the health monitor thread
+        std::atomic<HRESULT> m_gdbServerLinkStatus;
+        //  Set by the health monitor when the link becomes lost, cleared once the connection is shut down
+        std::atomic<bool> m_isGdbServerLinkLossPending;
         bool m_terminating;
         bool m_lastResumingCommandWasStep;
         bool m_targetIsRunning;
@@ -306,6 +318,7 @@ public:
         ADDRESS_TYPE GetCurrentExecutionAddress(_Out_ DWORD *pProcessorNumberOfLastEvent);
         HRESULT SetGdbServerParameters();
         HRESULT SetGdbServerConnection(void);
+        HRESULT FlushPendingMemoryWrites(_In_ GdbSrvControllerLib::AsynchronousGdbSrvController * const pController);
         ADDRESS_TYPE ParseAsynchronousCommandResult(_Out_ DWORD * pProcessorNumberOfLastEvent, _Out_ HALT_REASON_TYPE * pHaltReason);
         void GetX86CoreRegisters(_In_ std::map<std::string, std::string> &registers, _Out_ CONTEXT_X86_EX * pContext);
         void GetFPCoprocessorRegisters(_In_ std::map<std::string, std::string> &registers, _In_ DWORD processorNumber, 
@@ -322,6 +335,7 @@ public:
                               _In_ std::map<std::string, std::string> &registers, _Out_ PVOID pContext);
         void SetNeonRegisters(_In_ DWORD processorNumber, _In_ const VOID * pContext, _In_ GdbSrvControllerLib::AsynchronousGdbSrvController * const pController);
         static DWORD CALLBACK NotificationThreadBody(LPVOID p);
+        static DWORD CALLBACK HealthMonitorThreadBody(LPVOID p);
         static VOID CALLBACK TimerCallback(_In_ HWND hwnd, _In_  UINT uMsg, _In_  UINT_PTR idEvent, _In_  DWORD dwTime);
 
 };
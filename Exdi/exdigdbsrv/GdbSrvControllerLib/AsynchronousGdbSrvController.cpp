@@ -182,6 +182,12 @@ AsynchronousGdbSrvController::~AsynchronousGdbSrvController()
 //
 unsigned AsynchronousGdbSrvController::CreateCodeBreakpoint(_In_ AddressType address)
 {
+    //  The GdbServer saves the original instruction, so it has to see the buffered memory writes.
+    if (!GdbSrvController::FlushPendingMemoryWrites(nullptr))
+    {
+        throw std::exception("Flushing the pending memory writes failed");
+    }
+
     unsigned slot = static_cast<unsigned>(-1);
     for(unsigned i = 0; i < m_breakpointSlots.size(); ++i)
     {
@@ -264,6 +270,12 @@ void AsynchronousGdbSrvController::DeleteCodeBreakpoint(_In_ unsigned breakpoint
         throw std::exception("Trying to delete nonexisting breakpoint");
     }
 
+    //  The GdbServer restores the original instruction, so it must not be overwritten later by a buffered write.
+    if (!GdbSrvController::FlushPendingMemoryWrites(nullptr))
+    {
+        throw std::exception("Flushing the pending memory writes failed");
+    }
+
     ConfigExdiGdbServerHelper& cfgData = ConfigExdiGdbServerHelper::GetInstanceCfgExdiGdbServer(nullptr);
     PCSTR pBpCommand = (cfgData.GetTreatSwBpAsHwBp()) ? "z1" : "z0";
     TargetArchitecture targetArchitecture = GdbSrvController::GetTargetArchitecture();
@@ -492,6 +504,12 @@ void AsynchronousGdbSrvController::StartAsynchronousCommand(_In_ LPCSTR pCommand
         CloseHandle(m_asynchronousCommandThread);
     }
 
+    //  The target is about to resume, so the registers seen at the last stop are stale.
+    if (isReqNeeded)
+    {
+        GdbSrvController::InvalidateRegisterCache();
+    }
+
     //At this point no other thread is using these, so no lock is needed
     m_currentAsynchronousCommand = pCommand;
     m_currentAsynchronousCommandResult.clear();
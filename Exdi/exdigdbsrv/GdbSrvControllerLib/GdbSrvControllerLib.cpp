@@ -33,6 +33,13 @@ const DWORD C_MAX_MONITOR_CMD_BUFFER = 8192;
 //  Maximum size of register name string
 const DWORD C_MAX_REGISTER_NAME_ARRAY_ELEM = 32;
 
+//  Maximum number of requests sent in a row before reading their responses (no-ack mode pipelining).
+const size_t C_MAX_PIPELINED_REQUESTS = 32;
+
+//  Maximum number of memory bytes buffered by the write-combining layer before
+//  forcing a flush. Larger single writes are sent directly.
+const size_t C_MAX_PENDING_MEMORY_WRITE_BYTES = 0x10000;
+
 //  List of Exdi-Component functions that can be invoked from the debugger engine side.
 //  This can be expanded to include any function that can be executed from the engine.
 //  The engine just passes through this function to the Exdi-Component.
@@ -109,7 +116,9 @@ public:
         m_pRspClient(std::unique_ptr <GdbSrvRspClient<TcpConnectorStream>>
             (new (std::nothrow) GdbSrvRspClient<TcpConnectorStream>(coreNumberConnectionParameters))),
         m_IsForcedPAMemoryMode(false),
-        m_ConfigPAMemMode(false)
+        m_ConfigPAMemMode(false),
+        m_isWriteCombiningEnabled(false),
+        m_pendingMemoryWriteBytes(0)
     {
         m_cachedKPCRStartAddress.clear();
         m_targetProcessorIds.clear();
@@ -120,6 +129,7 @@ public:
             this, std::placeholders::_1, std::placeholders::_2));
         ConfigExdiGdbServerHelper& cfgData = ConfigExdiGdbServerHelper::GetInstanceCfgExdiGdbServer(nullptr);
         m_IsThrowExceptionEnabled = cfgData.IsExceptionThrowEnabled();
+        m_isWriteCombiningEnabled = cfgData.IsWriteCombiningMemoryEnabled();
         InitializeSystemRegistersFunctions();
         InitializeInternalGdbClientFunctionMap();
         cfgData.GetGdbServerRegisters(&m_spRegisterVector);
@@ -191,6 +201,14 @@ public:
             throw _com_error(E_INVALIDARG);
         }
 
+        //  A monitor command can change the target state behind our back,
+        //  so it has to observe all the previously buffered memory writes.
+        InvalidateRegisterCache();
+        if (!FlushPendingMemoryWrites(nullptr))
+        {
+            throw _com_error(E_FAIL);
+        }
+
         size_t cmdToExecMaxLength = (wcslen(pCmdToExecute) + 1) * sizeof(WCHAR);
         unique_ptr<char> pCommand(new (nothrow) char[cmdToExecMaxLength]);
         if (WideCharToMultiByte(CP_ACP, WC_NO_BEST_FIT_CHARS, pCmdToExecute, -1, pCommand.get(), static_cast<int>(cmdToExecMaxLength), nullptr, nullptr) == 0)
@@ -383,7 +401,10 @@ public:
     bool GdbSrvControllerImpl::CloseGdbSrvCore(_In_ const std::wstring &closeStr, _In_ unsigned core)
     {
         assert(m_pRspClient != nullptr);
-        return m_pRspClient->CloseRspCore(closeStr, core);
+        //  Detaching must not drop the memory writes buffered by the write-combining layer.
+        bool isFlushed = FlushPendingMemoryWrites(nullptr);
+        bool isClosed = m_pRspClient->CloseRspCore(closeStr, core);
+        return isFlushed && isClosed;
     }
 
     //  
@@ -407,9 +428,34 @@ public:
     //  ShutdownGdbSrv  Shutdown the connection by invoking the shutdown mechanism
     //                  implemented in the GdServer RSP layer.
     //
+    //  Note.
+    //  The memory writes buffered by the write-combining layer are sent before closing
+    //  the link if it is still connected, otherwise they are dropped. In both cases,
+    //  the failed (lost) writes are reported to the log.
+    //
     void GdbSrvControllerImpl::ShutdownGdbSrv()
     {
         assert(m_pRspClient != nullptr);
+        if (!m_pendingMemoryWrites.empty())
+        {
+            //  This is also called from the destructor, so it must not throw.
+            try
+            {
+                HRESULT gdbServerError = S_OK;
+                if (m_pRspClient->GetRspSessionStatus(gdbServerError, C_ALLCORES) && gdbServerError == ERROR_SUCCESS)
+                {
+                    FlushPendingMemoryWrites(nullptr);
+                }
+                else
+                {
+                    DiscardPendingMemoryWrites();
+                }
+            }
+            catch (...)
+            {
+                DiscardPendingMemoryWrites();
+            }
+        }
         m_pRspClient->ShutDownRsp();
     }
 
@@ -468,6 +514,8 @@ public:
     {
         bool isDone = false;
 
+        InvalidateRegisterCache();
+
         //  Send the restart packet. It's only supported in extended mode.
         const char cmdRestartTarget[] = "R";
         std::string reply = ExecuteCommandEx(cmdRestartTarget, false, 0);
@@ -487,6 +535,26 @@ public:
         return m_pRspClient->GetRspSessionStatus(error, C_ALLCORES);
     }
 
+    //
+    //  ProbeGdbSrvAlive    Checks if the GdbServer core connection is still alive.
+    //                      The probe is skipped (returns false) if the link is busy exchanging packets.
+    //
+    bool GdbSrvControllerImpl::ProbeGdbSrvAlive(_Out_ HRESULT & error, _In_ unsigned core)
+    {
+        assert(m_pRspClient != nullptr);
+        return m_pRspClient->ProbeRspSessionStatus(error, core);
+    }
+
+    //
+    //  GetGdbSrvConnectionGeneration   Returns a counter that changes every time a GdbServer link
+    //                                  connection (or core channel) has been (re)established.
+    //
+    unsigned GdbSrvControllerImpl::GetGdbSrvConnectionGeneration()
+    {
+        assert(m_pRspClient != nullptr);
+        return m_pRspClient->GetRspConnectionGeneration();
+    }
+
     //
     //  ReqGdbServerSupportedFeatures   Request the list of the enabled features from the GdbServer
     //
@@ -843,26 +911,31 @@ public:
         }
 
         std::string command(pCommand);
-        bool isDone = m_pRspClient->SendRspPacket(command, processor);
-        if (isDone)
         {
-            isDone = m_pRspClient->ReceiveRspPacket(result, processor, isRspWaitNeeded);
-            if (!isDone)
+            //  Keep the link for the whole request/response exchange, so the link health probe
+            //  cannot run between sending the packet and reading its response.
+            scoped_lock exchangeGuard(m_pRspClient->GetRspExchangeLock());
+            bool isDone = m_pRspClient->SendRspPacket(command, processor);
+            if (isDone)
             {
-                //  Did the user interrupt?
-                if (!m_pRspClient->GetInterruptFlag())
+                isDone = m_pRspClient->ReceiveRspPacket(result, processor, isRspWaitNeeded);
+                if (!isDone)
                 {
-                    //  No, then this is a fatal error or a communication error ocurred
-                    m_pRspClient->HandleRspErrors(GdbSrvTextType::CommandError);
-                    throw _com_error(HRESULT_FROM_WIN32(m_pRspClient->GetRspLastError()));
+                    //  Did the user interrupt?
+                    if (!m_pRspClient->GetInterruptFlag())
+                    {
+                        //  No, then this is a fatal error or a communication error ocurred
+                        m_pRspClient->HandleRspErrors(GdbSrvTextType::CommandError);
+                        throw _com_error(HRESULT_FROM_WIN32(m_pRspClient->GetRspLastError()));
+                    }
                 }
             }
-        }
-        else
-        {
-            //  A fatal error or a communication error ocurred
-            m_pRspClient->HandleRspErrors(GdbSrvTextType::CommandError);
-            throw _com_error(HRESULT_FROM_WIN32(m_pRspClient->GetRspLastError()));
+            else
+            {
+                //  A fatal error or a communication error ocurred
+                m_pRspClient->HandleRspErrors(GdbSrvTextType::CommandError);
+                throw _com_error(HRESULT_FROM_WIN32(m_pRspClient->GetRspLastError()));
+            }
         }
 
         if (m_pTextHandler != nullptr && m_displayCommands)
@@ -914,6 +987,79 @@ public:
         return result;
     }
 
+    //
+    //  ExecuteCommandsPipelined    Executes a sequence of GdbServer commands on a particular processor core
+    //                              by sending a window of requests before reading their responses.
+    //
+    //  Parameters:
+    //  commands                    Commands to execute.
+    //  processor                   Processor core to send the commands.
+    //
+    //  Return:
+    //  The command responses (in the same order as the commands).
+    //
+    //  Note.
+    //  Pipelining is only possible in no-ack mode, since in ack mode each request waits for the '+' packet,
+    //  so otherwise the commands are executed one by one.
+    //  The window is limited, so the GdbServer does not stall on sending responses we are not reading yet.
+    //
+    std::vector<std::string> GdbSrvControllerImpl::ExecuteCommandsPipelined(_In_ const std::vector<std::string> & commands,
+                                                                            _In_ unsigned processor)
+    {
+        std::vector<std::string> replies;
+        replies.reserve(commands.size());
+        if (!m_pRspClient->IsFeatureEnabled(PACKET_QSTART_NO_ACKMODE))
+        {
+            for (auto const & command : commands)
+            {
+                replies.push_back(ExecuteCommandOnProcessor(command.c_str(), true, 0, processor));
+            }
+            return replies;
+        }
+
+        for (size_t windowStart = 0; windowStart < commands.size(); windowStart += C_MAX_PIPELINED_REQUESTS)
+        {
+            //  The window requests and responses are exchanged as a whole under the link lock.
+            scoped_lock exchangeGuard(m_pRspClient->GetRspExchangeLock());
+            size_t windowEnd = std::min<size_t>(commands.size(), windowStart + C_MAX_PIPELINED_REQUESTS);
+            for (size_t index = windowStart; index < windowEnd; ++index)
+            {
+                if (m_pTextHandler != nullptr && m_displayCommands)
+                {
+                    m_pTextHandler->HandleText(GdbSrvTextType::Command, commands[index].c_str(), commands[index].length());
+                }
+                if (!m_pRspClient->SendRspPacket(commands[index], processor))
+                {
+                    //  A fatal error or a communication error ocurred
+                    m_pRspClient->HandleRspErrors(GdbSrvTextType::CommandError);
+                    throw _com_error(HRESULT_FROM_WIN32(m_pRspClient->GetRspLastError()));
+                }
+            }
+            for (size_t index = windowStart; index < windowEnd; ++index)
+            {
+                std::string reply;
+                bool isPollingMode = false;
+                //  Only the first response can reset the input buffer, the next ones can be already stored there.
+                if (!m_pRspClient->ReceiveRspPacketEx(reply, processor, true, isPollingMode, index == windowStart))
+                {
+                    if (m_pRspClient->GetInterruptFlag())
+                    {
+                        //  The pending responses are lost, so we cannot continue.
+                        throw _com_error(E_ABORT);
+                    }
+                    m_pRspClient->HandleRspErrors(GdbSrvTextType::CommandError);
+                    throw _com_error(HRESULT_FROM_WIN32(m_pRspClient->GetRspLastError()));
+                }
+                if (m_pTextHandler != nullptr && m_displayCommands)
+                {
+                    m_pTextHandler->HandleText(GdbSrvTextType::CommandOutput, reply.c_str(), reply.length());
+                }
+                replies.push_back(reply);
+            }
+        }
+        return replies;
+    }
+
     //
     //  ExecuteCommandOnProcessor   Executes/Posts a GdbServer command on a paricular processor core.
     //
@@ -1083,6 +1229,16 @@ public:
     std::map<std::string, std::string> GdbSrvControllerImpl::QueryAllRegistersEx(_In_ unsigned processorNumber,
         _In_ RegisterGroupType groupType = CORE_REGS)
     {
+        //  The stop reply may have expedited the whole register set.
+        if (groupType == CORE_REGS)
+        {
+            auto itCache = m_stopReplyRegisterCache.find(processorNumber);
+            if (itCache != m_stopReplyRegisterCache.end() && itCache->second.size() == RegistersGroupSize(CORE_REGS))
+            {
+                return itCache->second;
+            }
+        }
+
         //  Set the processor core from where we will get the registers.
         if (!SetThreadCommand(processorNumber, "g"))
         {
@@ -1176,6 +1332,7 @@ public:
                                               _In_ bool isRegisterValuePtr,
                                               _In_ RegisterGroupType groupType = CORE_REGS)
     {
+        InvalidateRegisterCache();
         if (processorNumber != -1)
         {
             //  Set the processor core before setting the register values.
@@ -1250,32 +1407,37 @@ public:
         _In_ const size_t numberOfElements,
         _In_ RegisterGroupType groupType = CORE_REGS) 
     {
-        if (processorNumber != -1)
+        std::map<std::string, std::string> result;
+        if (groupType == CORE_REGS && FindCachedRegisters(processorNumber, registerNames, numberOfElements, result))
         {
-            //  Set the processor core before setting the register values.
-            if (!SetThreadCommand(processorNumber, "g"))
-            {
-                throw _com_error(E_FAIL);
-            }
+            return result;
         }
 
-        std::map<std::string, std::string> result;
+        //  The system/fpu register values are kept until the target resumes.
+        unsigned cachedProcessor = (processorNumber != -1) ? processorNumber : GetLastKnownActiveCpu();
+        std::vector<const_regIterator> registersToQuery;
         for (size_t index = 0; index < numberOfElements; ++index)
         {
-            std::string registerName(registerNames[index]); 
-            const_regIterator it = FindRegisterVectorEntryEx(registerName, groupType);
-
-            char command[512];
-            _snprintf_s(command, _TRUNCATE, "p%s", it->nameOrder.c_str());
+            if (groupType == CORE_REGS || !FindGroupCachedRegister(cachedProcessor, registerNames[index], result))
+            {
+                registersToQuery.push_back(FindRegisterVectorEntryEx(registerNames[index], groupType));
+            }
+        }
+        if (registersToQuery.empty())
+        {
+            return result;
+        }
 
-            std::string reply = ExecuteCommand(command);
-            if (IsReplyError(reply) || reply.empty())
+        if (processorNumber != -1)
+        {
+            //  Set the processor core before setting the register values.
+            if (!SetThreadCommand(processorNumber, "g"))
             {
                 throw _com_error(E_FAIL);
             }
-            //  Process the register value returned by the GDBServer
-            result[registerName] = TargetArchitectureHelpers::ReverseRegValue(reply);
         }
+
+        QueryRegistersPipelined(registersToQuery, groupType, result);
         return result;
     }
 
@@ -1320,6 +1482,26 @@ public:
         _In_ unsigned processorNumber, _In_ RegisterGroupType groupType,
         _Out_ int & maxRegisterNameLength)
     {
+        maxRegisterNameLength = 0;
+        std::map<std::string, std::string> result;
+        unsigned cachedProcessor = (processorNumber != -1) ? processorNumber : GetLastKnownActiveCpu();
+        std::vector<const_regIterator> registersToQuery;
+        for (const_regIterator it = RegistersBegin(groupType);
+            it != RegistersEnd(groupType); ++it)
+        {
+            maxRegisterNameLength = (maxRegisterNameLength < it->name.length()) ? 
+                static_cast<int>(it->name.length()) :
+                maxRegisterNameLength;
+            if (groupType == CORE_REGS || !FindGroupCachedRegister(cachedProcessor, it->name, result))
+            {
+                registersToQuery.push_back(it);
+            }
+        }
+        if (registersToQuery.empty())
+        {
+            return result;
+        }
+
         if (processorNumber != -1)
         {
             //  Set the processor core before setting the register values.
@@ -1329,28 +1511,73 @@ public:
             }
         }
 
-        maxRegisterNameLength = 0;
-        std::map<std::string, std::string> result;
-        for (const_regIterator it = RegistersBegin(groupType);
-            it != RegistersEnd(groupType); ++it)
-        {
-            const_regIterator itReg = FindRegisterVectorEntryEx(it->name, groupType);
+        QueryRegistersPipelined(registersToQuery, groupType, result);
+        return result;
+    }
 
+    //
+    //  QueryRegistersPipelined  Reads a set of registers on the current active core by pipelining
+    //                           the 'p n' requests (see ExecuteCommandsPipelined()).
+    //
+    //  Parameters:
+    //  registers               Register vector entries to read.
+    //  groupType               Register group type
+    //  result                  Map receiving the register name and its hex-decimal ascii value.
+    //
+    //  Note.
+    //  The values of the non-core registers are cached until the target resumes
+    //  or a register is written (see InvalidateRegisterCache()).
+    //
+    void GdbSrvControllerImpl::QueryRegistersPipelined(_In_ const std::vector<const_regIterator> & registers,
+                                                       _In_ RegisterGroupType groupType,
+                                                       _Inout_ std::map<std::string, std::string> & result)
+    {
+        std::vector<std::string> commands;
+        commands.reserve(registers.size());
+        for (auto const & itReg : registers)
+        {
             char command[512];
             _snprintf_s(command, _TRUNCATE, "p%s", itReg->nameOrder.c_str());
+            commands.push_back(command);
+        }
 
-            std::string reply = ExecuteCommand(command);
-            if (IsReplyError(reply) || reply.empty())
+        unsigned processor = GetLastKnownActiveCpu();
+        std::vector<std::string> replies = ExecuteCommandsPipelined(commands, processor);
+        assert(replies.size() == registers.size());
+        for (size_t index = 0; index < replies.size(); ++index)
+        {
+            if (IsReplyError(replies[index]) || replies[index].empty())
             {
                 throw _com_error(E_FAIL);
             }
-            maxRegisterNameLength = (maxRegisterNameLength < itReg->name.length()) ? 
-                static_cast<int>(itReg->name.length()) :
-                maxRegisterNameLength;
             //  Process the register value returned by the GDBServer
-            result[itReg->name] = TargetArchitectureHelpers::ReverseRegValue(reply);
+            std::string registerValue = TargetArchitectureHelpers::ReverseRegValue(replies[index]);
+            if (groupType != CORE_REGS)
+            {
+                m_groupRegisterCache[processor][registers[index]->name] = registerValue;
+            }
+            result[registers[index]->name] = registerValue;
         }
-        return result;
+    }
+
+    //
+    //  FindGroupCachedRegister  Looks for a system/fpu register value read since the last resume.
+    //
+    bool GdbSrvControllerImpl::FindGroupCachedRegister(_In_ unsigned processorNumber, _In_ const std::string & registerName,
+                                                       _Inout_ std::map<std::string, std::string> & result)
+    {
+        auto itCache = m_groupRegisterCache.find(processorNumber);
+        if (itCache == m_groupRegisterCache.end())
+        {
+            return false;
+        }
+        auto itReg = itCache->second.find(registerName);
+        if (itReg == itCache->second.end())
+        {
+            return false;
+        }
+        result[itReg->first] = itReg->second;
+        return true;
     }
 
     //
@@ -1804,6 +2031,278 @@ public:
         return isDone;
     }
 
+    //
+    //  IsWriteCombiningMemoryType  Checks if the memory class can be buffered by the write-combining layer.
+    //
+    //  Note.
+    //  Physical memory (it can be a peripheral IO region) and memory pointed by special registers
+    //  are always written through, since their writes can have side effects on the target.
+    //
+    bool GdbSrvControllerImpl::IsWriteCombiningMemoryType(_In_ const memoryAccessType memType) const
+    {
+        return m_isWriteCombiningEnabled && !memType.isPhysical && !memType.isSpecialRegs;
+    }
+
+    static bool IsSameMemoryType(_In_ const memoryAccessType & memType1, _In_ const memoryAccessType & memType2)
+    {
+        return memcmp(&memType1, &memType2, sizeof(memoryAccessType)) == 0;
+    }
+
+    //
+    //  IsPendingMemoryType     Checks if an access of the memory class can be served along with the
+    //                          pending writes. The pending writes are always of a single memory class
+    //                          (an access of another class flushes them first), since the memory
+    //                          classes can alias the same memory on the target.
+    //
+    bool GdbSrvControllerImpl::IsPendingMemoryType(_In_ const memoryAccessType memType) const
+    {
+        return m_pendingMemoryWrites.empty() || IsSameMemoryType(m_pendingMemoryWrites.front().memType, memType);
+    }
+
+    //
+    //  WriteCombinedMemory     Writes memory through the write-combining layer.
+    //                          The write is merged with the adjacent/overlapping pending writes,
+    //                          and it will be sent to the GdbServer by FlushPendingMemoryWrites().
+    //
+    //  Parameters:
+    //  address         Address location where we should write the data
+    //  size            Size of the memory write.
+    //  pRawBuffer      Pointer to the buffer that contains the data to write
+    //  pdwBytesWritten Pointer to the variable containing how many bytes have been written.
+    //  memType         The memory class that will be accessed by the write operation.
+    //
+    //  Return:
+    //  true            if we succeeded (the data has been buffered or written).
+    //  false           otherwise.
+    //
+    //  Note.
+    //  The write is sent directly (after flushing the pending writes, so the write order is kept)
+    //  if write combining is disabled, the memory class is not buffered or the write is too large.
+    //  A write of another memory class than the pending writes flushes them before being buffered.
+    //
+    bool GdbSrvControllerImpl::WriteCombinedMemory(_In_ AddressType address, _In_ size_t size, _In_ const void * pRawBuffer,
+                                                   _Out_ DWORD * pdwBytesWritten, _In_ const memoryAccessType memType)
+    {
+        assert(pRawBuffer != nullptr && pdwBytesWritten != nullptr);
+
+        if (!IsWriteCombiningMemoryType(memType) || size == 0 || size >= C_MAX_PENDING_MEMORY_WRITE_BYTES)
+        {
+            if (!FlushPendingMemoryWrites(nullptr))
+            {
+                throw _com_error(E_FAIL);
+            }
+            return WriteMemory(address, size, pRawBuffer, pdwBytesWritten, memType, false);
+        }
+        if (!IsPendingMemoryType(memType))
+        {
+            if (!FlushPendingMemoryWrites(nullptr))
+            {
+                throw _com_error(E_FAIL);
+            }
+        }
+
+        //  Find the extent of the pending writes that overlap or touch the new one.
+        AddressType endAddress = address + size;
+        AddressType mergedStart = address;
+        AddressType mergedEnd = endAddress;
+        for (auto const & pending : m_pendingMemoryWrites)
+        {
+            AddressType pendingEnd = pending.address + pending.data.size();
+            if (pending.address <= endAddress && address <= pendingEnd)
+            {
+                mergedStart = (std::min)(mergedStart, pending.address);
+                mergedEnd = (std::max)(mergedEnd, pendingEnd);
+            }
+        }
+
+        PendingMemoryWrite merged;
+        merged.address = mergedStart;
+        merged.memType = memType;
+        merged.data.resize(static_cast<size_t>(mergedEnd - mergedStart));
+        for (auto it = m_pendingMemoryWrites.begin(); it != m_pendingMemoryWrites.end();)
+        {
+            AddressType pendingEnd = it->address + it->data.size();
+            if (it->address <= endAddress && address <= pendingEnd)
+            {
+                memcpy(&merged.data[static_cast<size_t>(it->address - mergedStart)], it->data.data(), it->data.size());
+                merged.originalWrites.insert(merged.originalWrites.end(), it->originalWrites.begin(), it->originalWrites.end());
+                m_pendingMemoryWriteBytes -= it->data.size();
+                it = m_pendingMemoryWrites.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+        //  The new data overrides the older pending data.
+        memcpy(&merged.data[static_cast<size_t>(address - mergedStart)], pRawBuffer, size);
+        merged.originalWrites.push_back(MemoryRangeType(address, size));
+        m_pendingMemoryWriteBytes += merged.data.size();
+        m_pendingMemoryWrites.push_back(std::move(merged));
+
+        *pdwBytesWritten = static_cast<DWORD>(size);
+
+        if (m_pendingMemoryWriteBytes >= C_MAX_PENDING_MEMORY_WRITE_BYTES)
+        {
+            return FlushPendingMemoryWrites(nullptr);
+        }
+        return true;
+    }
+
+    //
+    //  ReadCombinedMemory  Reads memory through the write-combining layer, so the pending
+    //                      (not yet flushed) writes are visible to the reader.
+    //
+    //  Parameters:
+    //  address         Memory address location to read.
+    //  maxSize         Size of the memory chunk to read.
+    //  memType         The memory class that will be accessed by the read operation.
+    //
+    //  Return:
+    //  A simple buffer object containing the memory content.
+    //
+    //  Note.
+    //  If a pending write covers the whole request then the read does not go to the GdbServer.
+    //  A read of a memory class that is not buffered, or of another memory class than
+    //  the pending writes, flushes the pending writes first, as it can alias the buffered memory.
+    //
+    SimpleCharBuffer GdbSrvControllerImpl::ReadCombinedMemory(_In_ AddressType address, _In_ size_t maxSize,
+                                                              _In_ const memoryAccessType memType)
+    {
+        if (m_pendingMemoryWrites.empty() || maxSize == 0)
+        {
+            return ReadMemory(address, maxSize, memType);
+        }
+        if (!IsWriteCombiningMemoryType(memType) || !IsPendingMemoryType(memType))
+        {
+            if (!FlushPendingMemoryWrites(nullptr))
+            {
+                throw _com_error(E_FAIL);
+            }
+            return ReadMemory(address, maxSize, memType);
+        }
+
+        AddressType endAddress = address + maxSize;
+        for (auto const & pending : m_pendingMemoryWrites)
+        {
+            if (pending.address <= address && endAddress <= pending.address + pending.data.size())
+            {
+                SimpleCharBuffer result;
+                if (!result.TryEnsureCapacity(maxSize))
+                {
+                    throw _com_error(E_OUTOFMEMORY);
+                }
+                result.SetLength(maxSize);
+                memcpy(&result[0], &pending.data[static_cast<size_t>(address - pending.address)], maxSize);
+                return result;
+            }
+        }
+
+        SimpleCharBuffer result = ReadMemory(address, maxSize, memType);
+        AddressType readEnd = address + result.GetLength();
+        for (auto const & pending : m_pendingMemoryWrites)
+        {
+            AddressType overlapStart = (std::max)(address, pending.address);
+            AddressType overlapEnd = (std::min)(readEnd, static_cast<AddressType>(pending.address + pending.data.size()));
+            if (overlapStart < overlapEnd)
+            {
+                memcpy(&result[static_cast<size_t>(overlapStart - address)],
+                       &pending.data[static_cast<size_t>(overlapStart - pending.address)],
+                       static_cast<size_t>(overlapEnd - overlapStart));
+            }
+        }
+        return result;
+    }
+
+    //
+    //  FlushPendingMemoryWrites    Sends the memory writes buffered by the write-combining layer.
+    //                              This is the memory fence, so it has to be called before
+    //                              resuming the target or doing any request that needs
+    //                              to see the written memory.
+    //
+    //  Parameters:
+    //  pFailedWrites   Optional pointer to the vector receiving the original writes (address, size)
+    //                  that were coalesced in a failed write packet.
+    //
+    //  Return:
+    //  true            if all the pending writes have been written.
+    //  false           otherwise.
+    //
+    bool GdbSrvControllerImpl::FlushPendingMemoryWrites(_Out_opt_ std::vector<MemoryRangeType> * pFailedWrites)
+    {
+        if (pFailedWrites != nullptr)
+        {
+            pFailedWrites->clear();
+        }
+
+        std::vector<PendingMemoryWrite> pendingWrites;
+        pendingWrites.swap(m_pendingMemoryWrites);
+        m_pendingMemoryWriteBytes = 0;
+
+        //  The writes are sent in program order (a merged write takes the place of its last write).
+        bool isDone = true;
+        for (auto const & pending : pendingWrites)
+        {
+            //  A failed write must not prevent sending the remaining ones.
+            bool isWriteDone = false;
+            try
+            {
+                DWORD bytesWritten = 0;
+                isWriteDone = WriteMemory(pending.address, pending.data.size(), pending.data.data(), &bytesWritten, pending.memType, true);
+            }
+            catch (...)
+            {
+                isWriteDone = false;
+            }
+
+            if (!isWriteDone)
+            {
+                isDone = false;
+                ReportFailedMemoryWrites(pending.originalWrites, "failed writing");
+                if (pFailedWrites != nullptr)
+                {
+                    pFailedWrites->insert(pFailedWrites->end(), pending.originalWrites.begin(), pending.originalWrites.end());
+                }
+            }
+        }
+        return isDone;
+    }
+
+    //
+    //  DiscardPendingMemoryWrites  Drops the memory writes buffered by the write-combining layer.
+    //                              This is used when the link is lost, so the writes cannot be sent.
+    //                              The dropped writes are reported to the log.
+    //
+    void GdbSrvControllerImpl::DiscardPendingMemoryWrites()
+    {
+        std::vector<PendingMemoryWrite> pendingWrites;
+        pendingWrites.swap(m_pendingMemoryWrites);
+        m_pendingMemoryWriteBytes = 0;
+        for (auto const & pending : pendingWrites)
+        {
+            ReportFailedMemoryWrites(pending.originalWrites, "lost the connection before writing");
+        }
+    }
+
+    //
+    //  ReportFailedMemoryWrites    Reports to the log the original memory writes (address, size) issued
+    //                              by the debugger engine that were coalesced in a buffered write that
+    //                              could not be sent.
+    //
+    void GdbSrvControllerImpl::ReportFailedMemoryWrites(_In_ const std::vector<MemoryRangeType> & originalWrites, _In_ PCSTR pReason)
+    {
+        for (auto const & originalWrite : originalWrites)
+        {
+            char message[128];
+            int length = sprintf_s(message, _countof(message), "Error: the GdbServer %s the memory range %I64x L%Ix\n",
+                                   pReason, originalWrite.first, originalWrite.second);
+            if (length > 0)
+            {
+                DisplayLogEntry(message, static_cast<size_t>(length));
+            }
+        }
+    }
+
     //
     //  GetProcessorCount   Get the number of processor cores in the Target.
     //                      This function relays on RSP query threads info packets
@@ -2076,6 +2575,13 @@ public:
                     }
                 }
 
+                //  Keep the expedited registers, so the next register query on this core can avoid a round trip.
+                if (pRspPacket->status.isTAAPacket)
+                {
+                    unsigned stoppedCore = (pRspPacket->status.isThreadFound) ? pRspPacket->processorNumber : m_lastKnownActiveCpu;
+                    SeedRegisterCacheFromStopReply(cmdResponse.substr(startPosition + 3), stoppedCore);
+                }
+
                 //  Extract the current instruction address
                 if (FindPcAddressFromStopReply(cmdResponse, &pRspPacket->currentAddress))
                 {
@@ -2103,6 +2609,116 @@ public:
         return isParsed;
     }
 
+    //
+    //  SeedRegisterCacheFromStopReply  Stores the expedited registers sent in a 'T AA' stop reply packet
+    //                                  as the current register values of the stopped core.
+    //
+    //  Parameters:
+    //  stopReplyFields     The 'n1:r1;n2:r2;...' part of the stop reply (after the 'T AA' header).
+    //  processorNumber     Core processor number that reported the stop.
+    //
+    //  Note.
+    //  The cache is discarded on every resume (see InvalidateRegisterCache()), so a stop reply
+    //  only replaces the stopped core entry.
+    //  Only the numeric register fields ('n' is a hex register number) are stored. The other fields
+    //  (thread, core, watch, swbreak,...) never consist only of hex digits, so they are ignored.
+    //  Register values containing 'xx' (unavailable bytes) are ignored as well.
+    //
+    void GdbSrvControllerImpl::SeedRegisterCacheFromStopReply(_In_ const std::string & stopReplyFields,
+                                                              _In_ unsigned processorNumber)
+    {
+        std::map<std::string, std::string> & coreRegisters = m_stopReplyRegisterCache[processorNumber];
+        coreRegisters.clear();
+
+        string::size_type fieldStart = 0;
+        while (fieldStart < stopReplyFields.length())
+        {
+            string::size_type fieldEnd = stopReplyFields.find(';', fieldStart);
+            if (fieldEnd == string::npos)
+            {
+                fieldEnd = stopReplyFields.length();
+            }
+            string::size_type separator = stopReplyFields.find(':', fieldStart);
+            if (separator != string::npos && separator > fieldStart && separator < fieldEnd)
+            {
+                std::string regNumber = stopReplyFields.substr(fieldStart, separator - fieldStart);
+                std::string regValue = stopReplyFields.substr(separator + 1, fieldEnd - separator - 1);
+                if (regNumber.find_first_not_of("0123456789abcdefABCDEF") == string::npos &&
+                    !regValue.empty() && regValue.find('x') == string::npos)
+                {
+                    unsigned long regOrder = strtoul(regNumber.c_str(), nullptr, 16);
+                    for (const_regIterator it = RegistersBegin(CORE_REGS); it != RegistersEnd(CORE_REGS); ++it)
+                    {
+                        if (strtoul(it->nameOrder.c_str(), nullptr, 16) == regOrder)
+                        {
+                            if (regValue.length() == (it->registerSize << 1))
+                            {
+                                //  Stored in memory order as QueryAllRegistersEx() does.
+                                coreRegisters[it->name] = TargetArchitectureHelpers::ReverseRegValue(regValue);
+                            }
+                            break;
+                        }
+                    }
+                }
+            }
+            fieldStart = fieldEnd + 1;
+        }
+
+        if (coreRegisters.empty())
+        {
+            m_stopReplyRegisterCache.erase(processorNumber);
+        }
+    }
+
+    //
+    //  FindCachedRegisters     Looks for the requested core registers in the values expedited by the last stop reply.
+    //
+    //  Parameters:
+    //  processorNumber     Core processor number.
+    //  registerNames       An array containing the list of register names to look for.
+    //  numberOfElements    Number of elements in the array.
+    //  result              Map receiving the register name and its hex-decimal ascii value.
+    //
+    //  Return:
+    //  true                If all requested registers were found (result contains them).
+    //  false               Otherwise (result is left untouched).
+    //
+    bool GdbSrvControllerImpl::FindCachedRegisters(_In_ unsigned processorNumber,
+                                                   _In_reads_(numberOfElements) const char * registerNames[],
+                                                   _In_ const size_t numberOfElements,
+                                                   _Out_ std::map<std::string, std::string> & result)
+    {
+        auto itCache = m_stopReplyRegisterCache.find(processorNumber);
+        if (itCache == m_stopReplyRegisterCache.end() || numberOfElements == 0)
+        {
+            return false;
+        }
+
+        std::map<std::string, std::string> cachedValues;
+        for (size_t index = 0; index < numberOfElements; ++index)
+        {
+            auto itReg = itCache->second.find(registerNames[index]);
+            if (itReg == itCache->second.end())
+            {
+                return false;
+            }
+            cachedValues[itReg->first] = itReg->second;
+        }
+        result.insert(cachedValues.begin(), cachedValues.end());
+        return true;
+    }
+
+    //
+    //  InvalidateRegisterCache     Discards the register values expedited by the last stop reply
+    //                              and the system/fpu register values read since the last resume.
+    //                              It must be called when the target resumes or the registers are changed.
+    //
+    void GdbSrvControllerImpl::InvalidateRegisterCache()
+    {
+        m_stopReplyRegisterCache.clear();
+        m_groupRegisterCache.clear();
+    }
+
     //
     //  GetKpcrOffset   Get the KPCR base address for the passed in processor.
     //
@@ -2709,6 +3325,21 @@ public:
     unique_ptr<SystemRegistersMapType> m_spSystemRegAccessCodeMap;
     bool m_IsForcedPAMemoryMode;
     bool m_ConfigPAMemMode;
+    //  Memory write buffered by the write-combining layer (all the pending writes have the same memory class)
+    typedef struct
+    {
+        AddressType address;                            //  Start address of the coalesced range
+        std::vector<unsigned char> data;                //  Data to write
+        memoryAccessType memType;                       //  Memory class of the write
+        std::vector<MemoryRangeType> originalWrites;    //  Writes coalesced into this range (for error reporting)
+    } PendingMemoryWrite;
+    bool m_isWriteCombiningEnabled;
+    std::vector<PendingMemoryWrite> m_pendingMemoryWrites;
+    size_t m_pendingMemoryWriteBytes;
+    //  Core registers expedited by the last 'T AA' stop reply (processor number -> register name/value)
+    std::map<unsigned, std::map<std::string, std::string>> m_stopReplyRegisterCache;
+    //  System/fpu registers read since the last resume (processor number -> register name/value)
+    std::map<unsigned, std::map<std::string, std::string>> m_groupRegisterCache;
 
     const_regIterator RegistersBegin(_In_ RegisterGroupType type = CORE_REGS) const {return (type == CORE_REGS) ? m_spRegisterVector->begin() : m_spSystemRegisterVector->begin();}
     const_regIterator RegistersEnd(_In_ RegisterGroupType type = CORE_REGS) const {return (type == CORE_REGS) ? m_spRegisterVector->end() : m_spSystemRegisterVector->end();}
@@ -3322,6 +3953,33 @@ bool GdbSrvController::CheckGdbSrvAlive(_Out_ HRESULT & error)
     return m_pGdbSrvControllerImpl->CheckGdbSrvAlive(error);    
 }
 
+bool GdbSrvController::FindCachedRegisters(_In_ unsigned processorNumber,
+                                           _In_reads_(numberOfElements) const char * registerNames[],
+                                           _In_ const size_t numberOfElements,
+                                           _Out_ std::map<std::string, std::string> & result)
+{
+    assert(m_pGdbSrvControllerImpl != nullptr);
+    return m_pGdbSrvControllerImpl->FindCachedRegisters(processorNumber, registerNames, numberOfElements, result);
+}
+
+void GdbSrvController::InvalidateRegisterCache()
+{
+    assert(m_pGdbSrvControllerImpl != nullptr);
+    m_pGdbSrvControllerImpl->InvalidateRegisterCache();
+}
+
+bool GdbSrvController::ProbeGdbSrvAlive(_Out_ HRESULT & error, _In_ unsigned core)
+{
+    assert(m_pGdbSrvControllerImpl != nullptr);
+    return m_pGdbSrvControllerImpl->ProbeGdbSrvAlive(error, core);
+}
+
+unsigned GdbSrvController::GetGdbSrvConnectionGeneration()
+{
+    assert(m_pGdbSrvControllerImpl != nullptr);
+    return m_pGdbSrvControllerImpl->GetGdbSrvConnectionGeneration();
+}
+
 bool GdbSrvController::ReqGdbServerSupportedFeatures()
 {
     assert(m_pGdbSrvControllerImpl != nullptr);
@@ -3452,7 +4110,7 @@ std::map<std::string, std::string> GdbSrvController::QueryRegistersByGroup(_In_
 SimpleCharBuffer GdbSrvController::ReadMemory(_In_ AddressType address, _In_ size_t size, _In_ const memoryAccessType memType)
 {
     assert(m_pGdbSrvControllerImpl != nullptr);
-    return m_pGdbSrvControllerImpl->ReadMemory(address, size, memType);
+    return m_pGdbSrvControllerImpl->ReadCombinedMemory(address, size, memType);
 }
 
 SimpleCharBuffer GdbSrvController::ReadSystemRegisters(_In_ AddressType address, _In_ size_t size, _In_ const memoryAccessType memType)
@@ -3465,7 +4123,13 @@ bool GdbSrvController::WriteMemory(_In_ AddressType address, _In_ size_t size, _
                                    _Out_ DWORD * pdwBytesWritten, _In_ const memoryAccessType memType)
 {
     assert(m_pGdbSrvControllerImpl != nullptr && pRawBuffer != nullptr && pdwBytesWritten != nullptr);
-    return m_pGdbSrvControllerImpl->WriteMemory(address, size, pRawBuffer, pdwBytesWritten, memType, false);
+    return m_pGdbSrvControllerImpl->WriteCombinedMemory(address, size, pRawBuffer, pdwBytesWritten, memType);
+}
+
+bool GdbSrvController::FlushPendingMemoryWrites(_Out_opt_ std::vector<MemoryRangeType> * pFailedWrites)
+{
+    assert(m_pGdbSrvControllerImpl != nullptr);
+    return m_pGdbSrvControllerImpl->FlushPendingMemoryWrites(pFailedWrites);
 }
 
 unsigned GdbSrvController::GetProcessorCount()
@@ -113,6 +113,11 @@ namespace GdbSrvControllerLib
         WORD fUnUsed: 11;
     } memoryAccessType;
 
+    //
+    //  Memory range (address, size) used for reporting the buffered memory writes.
+    //
+    typedef std::pair<AddressType, size_t> MemoryRangeType;
+
     //
     //  Register iterator types
     // 
@@ -159,6 +164,12 @@ namespace GdbSrvControllerLib
         //  Check if the GdbServer is still connected.
         bool CheckGdbSrvAlive(_Out_ HRESULT & error);
 
+        //  Check if the GdbServer core connection is still alive without blocking on the link.
+        bool ProbeGdbSrvAlive(_Out_ HRESULT & error, _In_ unsigned core);
+
+        //  Get the GdbServer link connection counter (it changes on every (re)connection).
+        unsigned GetGdbSrvConnectionGeneration();
+
         //  Configure the GdbServer communication session.
         bool ConfigureGdbSrvCommSession(_In_ bool fDisplayCommData, _In_ int core);
 
@@ -223,6 +234,15 @@ namespace GdbSrvControllerLib
                                                           _In_reads_(numberOfElements) const char * registerNames[],
                                                           _In_ const size_t numberOfElements);
 
+        //  Look for a sub-set of core registers in the values expedited by the last stop reply.
+        bool FindCachedRegisters(_In_ unsigned processorNumber,
+                                 _In_reads_(numberOfElements) const char * registerNames[],
+                                 _In_ const size_t numberOfElements,
+                                 _Out_ std::map<std::string, std::string> & result);
+
+        //  Discard the register values expedited by the last stop reply.
+        void InvalidateRegisterCache();
+
         //  Request reading the full set of specific register group
         std::map<std::string, std::string> QueryRegistersByGroup(_In_ unsigned processorNumber,
                                                                  _In_ RegisterGroupType groupType,
@@ -283,6 +303,9 @@ namespace GdbSrvControllerLib
         bool WriteMemory(_In_ AddressType address, _In_ size_t size, _In_ const void * pRawBuffer, 
                          _Out_ DWORD * pdwBytesWritten, _In_ const memoryAccessType memType);
 
+        //  Send the memory writes buffered by the write-combining layer (memory fence).
+        bool FlushPendingMemoryWrites(_Out_opt_ std::vector<MemoryRangeType> * pFailedWrites);
+
         //  Get the number of RSP GdbServer connections.
         unsigned GetNumberOfRspConnections();
 
@@ -47,6 +47,11 @@ using namespace GdbSrvControllerLib;
 //  Check if there is a NAK/Start data packet
 #define IS_NAK_OR_START_PACKET(ch)              ((ch == '-') || (ch == '$'))
 
+//  TCP keep alive timing (msec). The system default waits two hours before sending
+//  the first keep alive probe, which is far too long for detecting a dead GdbServer.
+#define RSP_KEEPALIVE_IDLE_TIME_MS              10000
+#define RSP_KEEPALIVE_PROBE_INTERVAL_MS         1000
+
 //  This type indicates the error structure used for displaying errors
 typedef struct 
 {
@@ -889,6 +894,14 @@ bool GdbSrvRspClient<TcpConnectorStream>::ConfigRspSession(_In_ const RSP_CONFIG
                 break;
             }
 
+            struct tcp_keepalive keepAliveValues = {1, RSP_KEEPALIVE_IDLE_TIME_MS, RSP_KEEPALIVE_PROBE_INTERVAL_MS};
+            if (pStream->SetWSAIoctl(SIO_KEEPALIVE_VALS, &keepAliveValues,
+                                     sizeof(keepAliveValues), nullptr, 0, &bytesReturned) == SOCKET_ERROR)
+            {
+                configDone = false;
+                break;
+            }
+
             int resultRecv = 0;
             if (pConfigData->recvTimeout != 0)
             {
@@ -1026,6 +1039,43 @@ bool GdbSrvRspClient<TcpConnectorStream>::GetRspSessionStatus(_Out_ HRESULT & er
     return isDone;
 }
 
+//
+//  ProbeRspSessionStatus   Get the connection status of the link layer session without
+//                          competing with an in-progress packet exchange.
+//                          This is intended for a background monitor, so it never blocks
+//                          waiting on the RSP lock. The callers executing commands hold the
+//                          lock from sending the request until the response has been received
+//                          (see GetRspExchangeLock), so the probe cannot run in between.
+//
+//  Parameters:
+//  error                   A reference to the error code returned by the link layer.
+//  core                    Processor core to check for RspConnection. If C_ALLCORES, then check all cores.
+//
+//  Return:
+//  true                    If the link was idle and the status has been retrieved.
+//
+//  false                   If there is a packet exchange in progress (the link is in use, so the
+//                          caller should keep its previous status) or there is no connection yet.
+//
+bool GdbSrvRspClient<TcpConnectorStream>::ProbeRspSessionStatus(_Out_ HRESULT & error, _In_ unsigned core)
+{
+    if (!TryEnterCriticalSection(&m_gdbSrvRspLock))
+    {
+        return false;
+    }
+    bool isDone = false;
+    try
+    {
+        isDone = GetRspSessionStatus(error, core);
+    }
+    catch (...)
+    {
+        isDone = false;
+    }
+    LeaveCriticalSection(&m_gdbSrvRspLock);
+    return isDone;
+}
+
 //
 //  UpdateRspPacketFeatures   Updates the local cache for the GdbServer supported features, so
 //                            this function will parse the response and 
@@ -1110,7 +1160,12 @@ bool GdbSrvRspClient<TcpConnectorStream>::ConnectRsp()
 
     unsigned int retries = (s_LinkLayerConfigOptions.connectAttempts == 0) ? 1 :
                             s_LinkLayerConfigOptions.connectAttempts;
-    return m_pConnector->Connect(retries);
+    bool isConnected = m_pConnector->Connect(retries);
+    if (isConnected)
+    {
+        ++m_connectionGeneration;
+    }
+    return isConnected;
 }
 
 //
@@ -1142,6 +1197,10 @@ bool GdbSrvRspClient<TcpConnectorStream>::AttachRspToCore(_In_ const wstring &co
         unsigned int retries = (s_LinkLayerConfigOptions.connectAttempts == 0) ? 1 :
                                 s_LinkLayerConfigOptions.connectAttempts;
         isAttached = m_pConnector->TcpConnectCore(retries, core);
+        if (isAttached)
+        {
+            ++m_connectionGeneration;
+        }
     }
     return isAttached;
 }
@@ -1169,7 +1228,12 @@ bool GdbSrvRspClient<TcpConnectorStream>::ConnectRspToCore(_In_ const wstring &c
     }
     unsigned int retries = (s_LinkLayerConfigOptions.connectAttempts == 0) ? 1 :
                             s_LinkLayerConfigOptions.connectAttempts;
-    return m_pConnector->TcpConnectCore(retries, core);
+    bool isConnected = m_pConnector->TcpConnectCore(retries, core);
+    if (isConnected)
+    {
+        ++m_connectionGeneration;
+    }
+    return isConnected;
 }
 
 //
@@ -1405,7 +1469,8 @@ size_t GdbSrvRspClient<TcpConnectorStream>::GetNumberOfStreamConnections()
 
 GdbSrvRspClient<TcpConnectorStream>::GdbSrvRspClient(_In_ const vector<wstring> &coreConnectionParameters) :
                                      m_interruptEvent(CreateEvent(nullptr, FALSE, FALSE, nullptr)),
-                                     m_pConnector(unique_ptr<TConnectStream>(new (nothrow) TConnectStream(coreConnectionParameters)))
+                                     m_pConnector(unique_ptr<TConnectStream>(new (nothrow) TConnectStream(coreConnectionParameters))),
+                                     m_connectionGeneration(0)
 {
     InitializeCriticalSection(&m_gdbSrvRspLock);
      m_fInterruptFlag = false;
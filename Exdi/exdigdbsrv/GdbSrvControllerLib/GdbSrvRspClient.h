@@ -17,6 +17,7 @@
 #include <string>
 #include <memory>
 #include <vector>
+#include <atomic>
 #include "TextHelpers.h"
 #include "HandleHelpers.h"
 #include "TcpConnectorStream.h"
@@ -149,6 +150,15 @@ namespace GdbSrvControllerLib
         //  Get the RSP connection status
         bool GetRspSessionStatus(_Out_ HRESULT & error, _In_ unsigned core);
 
+        //  Probe the RSP connection status only if there is no packet exchange in progress
+        bool ProbeRspSessionStatus(_Out_ HRESULT & error, _In_ unsigned core);
+
+        //  Get the lock that has to be held across a full request/response packet exchange
+        CRITICAL_SECTION & GetRspExchangeLock() { return m_gdbSrvRspLock; }
+
+        //  Get the number of link connections established so far (changes on every (re)connection)
+        unsigned GetRspConnectionGeneration() const { return m_connectionGeneration.load(); }
+
         //  Retrieves the last error from the link layer
         int GetRspLastError(); 
 
@@ -211,5 +221,6 @@ namespace GdbSrvControllerLib
         bool GetNoAckModeRequired(_In_ const string & command);
         bool SendRspInterruptEx(_In_ bool fResetAllCores, _In_ unsigned activeCore);
         bool m_fInterruptFlag;
+        atomic<unsigned> m_connectionGeneration;
     }; 
 }
\ No newline at end of file
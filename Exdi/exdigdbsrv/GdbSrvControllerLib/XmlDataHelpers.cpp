@@ -102,6 +102,7 @@ typedef struct
     WCHAR fForcedLegacyResumeStepCommands[C_MAX_ATTR_LENGTH]; //  Flag if set, then use the legacy step/resume command mode.
     WCHAR fServerRequirePAMemoryAccess[C_MAX_ATTR_LENGTH]; //  if set the server requires PAs for all memory access R/W.
     WCHAR fGdbMonitorCmdDoNotWaitOnOK[C_MAX_ATTR_LENGTH]; //  if set the server requires PAs for all memory access R/W.
+    WCHAR fWriteCombiningMemory[C_MAX_ATTR_LENGTH];     //  if set the memory writes are buffered and flushed before resuming the target.
 } ConfigExdiDataEntry;
 
 typedef struct
@@ -179,6 +180,7 @@ const WCHAR gdbQSupportedPacket[] = L"qSupportedPacket";
 const WCHAR gdbTreatSwBpAsHwBp[] = L"enableTreatingSwBpAsHwBp";
 const WCHAR gdbRequirePAMemoryAccess[] = L"requirePAMemoryAccess";
 const WCHAR gdbMonitorCmdDoNotWaitOnOK[] = L"gdbMonitorCmdDoNotWaitOnOK";
+const WCHAR gdbWriteCombiningMemory[] = L"enableWriteCombiningMemory";
 const WCHAR gdbServerUuid[] = L"uuid";
 const WCHAR displayCommPackets[] = L"displayCommPackets";
 const WCHAR debuggerSessionByCore[] = L"debuggerSessionByCore";
@@ -260,6 +262,7 @@ const XML_ATTRNAME_HANDLER_STRUCT attrExdiServerHandlerMap[] =
     {exdiGdbServerConfigData, forceLegacyResumeStepCmds,  XmlDataHelpers::XmlGetStringValue, FIELD_OFFSET(ConfigExdiDataEntry, fForcedLegacyResumeStepCommands), C_MAX_ATTR_LENGTH},
     {exdiGdbServerConfigData, gdbRequirePAMemoryAccess,   XmlDataHelpers::XmlGetStringValue, FIELD_OFFSET(ConfigExdiDataEntry, fServerRequirePAMemoryAccess), C_MAX_ATTR_LENGTH},
     {exdiGdbServerConfigData, gdbMonitorCmdDoNotWaitOnOK, XmlDataHelpers::XmlGetStringValue, FIELD_OFFSET(ConfigExdiDataEntry, fGdbMonitorCmdDoNotWaitOnOK), C_MAX_ATTR_LENGTH},
+    {exdiGdbServerConfigData, gdbWriteCombiningMemory,    XmlDataHelpers::XmlGetStringValue, FIELD_OFFSET(ConfigExdiDataEntry, fWriteCombiningMemory), C_MAX_ATTR_LENGTH},
 };
 
 //  Attribute name - handler map for the GdbServer server tag info
@@ -823,6 +826,7 @@ HRESULT XmlDataHelpers::HandleTagAttributeList(_In_ TAG_ATTR_LIST* const pTagAtt
                     pConfigTable->component.fForcedLegacyResumeStepCommands = (_wcsicmp(exdiData.fForcedLegacyResumeStepCommands, L"yes") == 0) ? true : false;
                     pConfigTable->component.fPAMemoryAccess = (_wcsicmp(exdiData.fServerRequirePAMemoryAccess, L"yes") == 0) ? true : false;
                     pConfigTable->component.fgdbMonitorCmdDoNotWaitOnOK = (_wcsicmp(exdiData.fGdbMonitorCmdDoNotWaitOnOK, L"yes") == 0) ? true : false;
+                    pConfigTable->component.fWriteCombiningMemory = (_wcsicmp(exdiData.fWriteCombiningMemory, L"yes") == 0) ? true : false;
                     isSet = true;
                 }
             }
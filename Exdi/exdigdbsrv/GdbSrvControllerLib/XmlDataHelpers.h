@@ -59,6 +59,7 @@ namespace GdbSrvControllerLib
         bool fForcedLegacyResumeStepCommands; //  Flag if set the GDB server will use the legacy resume/step command mode
         bool fPAMemoryAccess;           //  GDB server reuires memory access via PA
         bool fgdbMonitorCmdDoNotWaitOnOK; //  Flag if set then the GDB monitor response processing won't wait on the "OK" string
+        bool fWriteCombiningMemory;     //  Flag if set then the memory writes are combined and flushed before resuming the target
     } ConfigExdiData;
 
     //  This type indicates the Target data.
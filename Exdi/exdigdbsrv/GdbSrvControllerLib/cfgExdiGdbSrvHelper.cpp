@@ -349,6 +349,11 @@ class ConfigExdiGdbServerHelper::ConfigExdiGdbServerHelperImpl
         return m_ExdiGdbServerData.component.fgdbMonitorCmdDoNotWaitOnOK;
     }
 
+    inline bool ConfigExdiGdbServerHelperImpl::IsWriteCombiningMemoryEnabled()
+    {
+        return m_ExdiGdbServerData.component.fWriteCombiningMemory;
+    }
+
     private:
     CComPtr<IXmlReader> m_XmlLiteReader;
     CComPtr<IStream> m_IStream;
@@ -900,4 +905,10 @@ bool ConfigExdiGdbServerHelper::IsGdbMonitorCmdDoNotWaitOnOKEnable()
 {
     assert(m_pConfigExdiGdbServerHelperImpl != nullptr);
     return m_pConfigExdiGdbServerHelperImpl->IsGdbMonitorCmdDoNotWaitOnOKEnable();
+}
+
+bool ConfigExdiGdbServerHelper::IsWriteCombiningMemoryEnabled()
+{
+    assert(m_pConfigExdiGdbServerHelperImpl != nullptr);
+    return m_pConfigExdiGdbServerHelperImpl->IsWriteCombiningMemoryEnabled();
 }
\ No newline at end of file
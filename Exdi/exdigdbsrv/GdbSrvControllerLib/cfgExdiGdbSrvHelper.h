@@ -67,6 +67,7 @@ class ConfigExdiGdbServerHelper final
         void SetXmlBufferToParse(_In_ PCWSTR pXmlConfigFile);
         void SetTargetArchitecture(_In_ TargetArchitecture targetArch);
         bool IsGdbMonitorCmdDoNotWaitOnOKEnable();
+        bool IsWriteCombiningMemoryEnabled();
 
     private:
         ConfigExdiGdbServerHelper(_In_opt_ PCWSTR pXmlConfigFile);
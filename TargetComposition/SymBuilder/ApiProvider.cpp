@@ -359,13 +359,12 @@ ApiProvider::~ApiProvider()
 // Namespace APIs:
 //
 
-Object SymbolBuilderNamespace::CreateSymbols(_In_ const Object& /*contextObject*/,
-                                             _In_ Object moduleArg,
-                                             _In_ std::optional<Object> options)
+void SymbolBuilderNamespace::ResolveModule(_In_ Object moduleArg,
+                                           _Out_ ULONG64 *pModuleBase,
+                                           _Out_ HostContext *pModuleContext)
 {
     ModelObjectKind moduleArgKind = moduleArg.GetKind();
 
-    bool autoImportSymbols = false;
     ULONG64 moduleBase = 0;
     Object moduleObject;
     switch(moduleArgKind)
@@ -408,6 +407,21 @@ Object SymbolBuilderNamespace::CreateSymbols(_In_ const Object& /*contextObject*
         moduleContext = HostContext::Current();
     }
 
+    *pModuleBase = moduleBase;
+    *pModuleContext = moduleContext;
+}
+
+Object SymbolBuilderNamespace::CreateSymbols(_In_ const Object& /*contextObject*/,
+                                             _In_ Object moduleArg,
+                                             _In_ std::optional<Object> options)
+{
+    bool autoImportSymbols = false;
+    std::optional<std::wstring> snapshotPath;
+
+    ULONG64 moduleBase;
+    HostContext moduleContext;
+    ResolveModule(moduleArg, &moduleBase, &moduleContext);
+
     if (options.has_value())
     {
         Object optionsObj = options.value();
@@ -416,6 +430,20 @@ Object SymbolBuilderNamespace::CreateSymbols(_In_ const Object& /*contextObject*
         {
             autoImportSymbols = (bool)autoImportSymbolsKey.value();
         }
+
+        std::optional<Object> loadSnapshotKey = optionsObj.TryGetKeyValue(L"LoadSnapshot");
+        if (loadSnapshotKey.has_value())
+        {
+            snapshotPath = (std::wstring)loadSnapshotKey.value();
+        }
+
+        //
+        // A symbol set has only one import source.  It can come from a snapshot or from DbgHelp but not both.
+        //
+        if (autoImportSymbols && snapshotPath.has_value())
+        {
+            throw std::invalid_argument("options");
+        }
     }
 
     ComPtr<ISvcSymbolBuilderManager> spSymbolManager;
@@ -445,8 +473,8 @@ Object SymbolBuilderNamespace::CreateSymbols(_In_ const Object& /*contextObject*
     CheckHr(spSymbolProcess->CreateSymbolsForModule(spModule.Get(), moduleKey, &spSymbolSet));
 
     //
-    // If we have been asked to automatically import symbols, set up an appropriate "on demand" importer.
-    // It is *NOT* a failure to create the symbol builder set if we cannot set up the importer!
+    // If we have been asked to automatically import symbols or to load a snapshot, set up an appropriate "on demand"
+    // importer.  It is *NOT* a failure to create the symbol builder set if we cannot set up an auto import!
     //
     std::unique_ptr<SymbolImporter> spImporter;
     if (autoImportSymbols)
@@ -470,11 +498,66 @@ Object SymbolBuilderNamespace::CreateSymbols(_In_ const Object& /*contextObject*
             spSymbolSet->SetImporter(std::move(spImporter));
         }
     }
+    else if (snapshotPath.has_value())
+    {
+        //
+        // Nothing is read from the snapshot here beyond validating its header.  Symbols are brought in on
+        // demand as they are queried exactly as with an auto import.
+        //
+        // Unlike an auto import, a snapshot was explicitly asked for.  If it cannot be used (it is missing, corrupt,
+        // or was saved from some other module), fail rather than leave behind an empty symbol set that would
+        // hide the module's other symbols.
+        //
+        spImporter.reset(new SymbolImporter_Snapshot(spSymbolSet.Get(), snapshotPath.value().c_str()));
+        HRESULT hrConnect = spImporter->ConnectToSource();
+        if (FAILED(hrConnect))
+        {
+            spSymbolProcess->RemoveSymbolsForModule(moduleKey);
+            CheckHr(hrConnect);
+        }
+
+        spSymbolSet->SetImporter(std::move(spImporter));
+    }
 
     SymbolSetObject& symbolSetFactory = ApiProvider::Get().GetSymbolSetFactory();
     return symbolSetFactory.CreateInstance(spSymbolSet);
 }
 
+void SymbolBuilderNamespace::DeleteSymbols(_In_ const Object& /*contextObject*/,
+                                           _In_ Object moduleArg)
+{
+    ULONG64 moduleBase;
+    HostContext moduleContext;
+    ResolveModule(moduleArg, &moduleBase, &moduleContext);
+
+    ComPtr<ISvcSymbolBuilderManager> spSymbolManager;
+    ComPtr<ISvcProcess> spProcess;
+    bool isKernel;
+    GetSymbolBuilderManager(moduleContext, &spSymbolManager, &spProcess, &isKernel);
+
+    ComPtr<SymbolBuilderProcess> spSymbolProcess;
+    CheckHr(spSymbolManager->TrackProcess(isKernel, spProcess.Get(), &spSymbolProcess));
+
+    ComPtr<ISvcModule> spModule;
+    CheckHr(spSymbolManager->ModuleBaseToModule(spProcess.Get(), moduleBase, &spModule));
+
+    ULONG64 moduleKey;
+    CheckHr(spModule->GetKey(&moduleKey));
+
+    ComPtr<SymbolSet> spSymbolSet;
+    if (!spSymbolProcess->TryGetSymbolsForModule(moduleKey, &spSymbolSet))
+    {
+        throw std::invalid_argument("module");
+    }
+
+    spSymbolProcess->RemoveSymbolsForModule(moduleKey);
+
+    //
+    // Anything above us which cached symbols from the set must go back and find the module's symbols elsewhere.
+    //
+    CheckHr(spSymbolSet->InvalidateExternalCaches());
+}
+
 //*************************************************
 // Object Extensions (Module)
 //
@@ -546,6 +629,72 @@ Object SymbolSetObject::GetPublics(_In_ const Object& /*symbolSetObject*/,
     return publicsFactory.CreateInstance(spSymbolSet);
 }
 
+void SymbolSetObject::BeginBatch(_In_ const Object& /*symbolSetObject*/,
+                                 _In_ ComPtr<SymbolSet>& spSymbolSet)
+{
+    SymbolSet *pSymbolSet = spSymbolSet.Get();
+    CheckHr(pSymbolSet->BeginBatch());
+}
+
+void SymbolSetObject::CommitBatch(_In_ const Object& /*symbolSetObject*/,
+                                  _In_ ComPtr<SymbolSet>& spSymbolSet)
+{
+    SymbolSet *pSymbolSet = spSymbolSet.Get();
+    CheckHr(pSymbolSet->CommitBatch());
+}
+
+void SymbolSetObject::AbortBatch(_In_ const Object& /*symbolSetObject*/,
+                                 _In_ ComPtr<SymbolSet>& spSymbolSet)
+{
+    SymbolSet *pSymbolSet = spSymbolSet.Get();
+    CheckHr(pSymbolSet->AbortBatch());
+}
+
+ULONG64 SymbolSetObject::GetCacheInvalidationCount(_In_ const Object& /*symbolSetObject*/,
+                                                   _In_ ComPtr<SymbolSet>& spSymbolSet)
+{
+    return spSymbolSet->GetCacheInvalidationCount();
+}
+
+ULONG64 SymbolSetObject::GetDecodedFunctionCount(_In_ const Object& /*symbolSetObject*/,
+                                                 _In_ ComPtr<SymbolSet>& spSymbolSet)
+{
+    return spSymbolSet->InternalGetCodeCache().GetDecodedFunctionCount();
+}
+
+void SymbolSetObject::Save(_In_ const Object& /*symbolSetObject*/,
+                           _In_ ComPtr<SymbolSet>& spSymbolSet,
+                           _In_ std::wstring snapshotPath)
+{
+    SymbolSet *pSymbolSet = spSymbolSet.Get();
+    CheckHr(pSymbolSet->SaveSnapshot(snapshotPath.c_str()));
+}
+
+std::experimental::generator<Object> SymbolSetObject::FindSymbols(_In_ const Object& /*symbolSetObject*/,
+                                                                  _In_ ComPtr<SymbolSet>& spSymbolSet,
+                                                                  _In_ std::wstring pattern,
+                                                                  _In_ std::optional<bool> caseInsensitive)
+{
+    std::vector<ULONG64> symbols;
+    CheckHr(spSymbolSet->FindGlobalSymbols(pattern.c_str(), caseInsensitive.value_or(false), &symbols));
+
+    //
+    // The set may change after a co_yield.  Only rely on the ids found up front and skip anything which has
+    // since been deleted.
+    //
+    for (ULONG64 symbolId : symbols)
+    {
+        BaseSymbol *pSymbol = spSymbolSet->InternalGetSymbol(symbolId);
+        if (pSymbol == nullptr)
+        {
+            continue;
+        }
+
+        Object symbolObject = BoxSymbol(pSymbol);
+        co_yield symbolObject;
+    }
+}
+
 //*************************************************
 // General Symbol Helpers:
 //
@@ -942,27 +1091,22 @@ std::experimental::generator<Object> TypesObject::GetIterator(_In_ const Object
 {
     //
     // We must take **GREAT CARE** with what we touch and how we iterate.  After a co_yield, the state
-    // of things may have drastically changed.  We must refetch things and only rely upon positional
-    // counters!
+    // of things may have drastically changed.  We must refetch things and only rely upon the id we
+    // last returned!  A position within the list shifts if anything before it is deleted.
     //
-    size_t cur = 0;
+    ULONG64 nextId = 0;
     for(;;)
     {
-        auto&& globalSymbols = spSymbolSet->InternalGetGlobalSymbols();
-        if (cur >= globalSymbols.size())
+        auto&& globalSymbols = spSymbolSet->InternalGetGlobalSymbols(SvcSymbolType);
+        ULONG64 nextGlobal = GlobalKindIndex::NextSymbol(globalSymbols, nextId);
+        if (nextGlobal == 0)
         {
             break;
         }
 
-        ULONG64 nextGlobal = globalSymbols[cur];
-        ++cur;
+        nextId = nextGlobal + 1;
 
         BaseSymbol *pNextSymbol = spSymbolSet->InternalGetSymbol(nextGlobal);
-        if (pNextSymbol->InternalGetKind() != SvcSymbolType)
-        {
-            continue;
-        }
-
         BaseTypeSymbol *pNextType = static_cast<BaseTypeSymbol *>(pNextSymbol);
         Object typeObject = BoxType(pNextType);
         co_yield typeObject;
@@ -981,7 +1125,7 @@ Object BaseSymbolObject<TSym>::GetName(_In_ const Object& /*symbolObject*/, _In_
         return Object::CreateNoValue();
     }
 
-    return spSymbol->InternalGetName();
+    return std::wstring(spSymbol->InternalGetName().view());
 }
 
 template<typename TSym>
@@ -992,7 +1136,7 @@ Object BaseSymbolObject<TSym>::GetQualifiedName(_In_ const Object& /*symbolObjec
         return Object::CreateNoValue();
     }
 
-    return spSymbol->InternalGetQualifiedName();
+    return std::wstring(spSymbol->InternalGetQualifiedName().view());
 }
 
 template<typename TSym>
@@ -1028,7 +1172,7 @@ std::wstring BaseTypeObject<TType>::ToString(_In_ const Object& /*typeObject*/,
                                              _In_ ComPtr<TType>& spTypeSymbol,
                                              _In_ const Metadata& /*metadata*/)
 {
-    std::wstring const& name = spTypeSymbol->InternalGetQualifiedName();
+    InternedString name = spTypeSymbol->InternalGetQualifiedName();
 
     std::wstring displayString = m_pwszConvTag;
     displayString += L": ";
@@ -1325,7 +1469,7 @@ std::wstring FieldObject::ToString(_In_ const Object& /*fieldObject*/,
                                    _In_ ComPtr<FieldSymbol>& spFieldSymbol,
                                    _In_ const Metadata& /*metadata*/)
 {
-    std::wstring const& fieldName = spFieldSymbol->InternalGetName();
+    InternedString fieldName = spFieldSymbol->InternalGetName();
 
     std::wstring displayString;
     wchar_t buf[128];
@@ -1347,7 +1491,7 @@ std::wstring FieldObject::ToString(_In_ const Object& /*fieldObject*/,
     else if (spFieldSymbol->InternalIsConstantValue())
     {
         BaseSymbol *pFieldTypeSymbol = spFieldSymbol->InternalGetSymbolSet()->InternalGetSymbol(fieldTypeId);
-        std::wstring const& fieldTypeName = pFieldTypeSymbol->InternalGetQualifiedName();
+        InternedString fieldTypeName = pFieldTypeSymbol->InternalGetQualifiedName();
         std::wstring value = ValueToString(spFieldSymbol->InternalGetSymbolValue());
 
         displayString = L"Field: ";
@@ -1361,7 +1505,7 @@ std::wstring FieldObject::ToString(_In_ const Object& /*fieldObject*/,
     else
     {
         BaseSymbol *pFieldTypeSymbol = spFieldSymbol->InternalGetSymbolSet()->InternalGetSymbol(fieldTypeId);
-        std::wstring const& fieldTypeName = pFieldTypeSymbol->InternalGetQualifiedName();
+        InternedString fieldTypeName = pFieldTypeSymbol->InternalGetQualifiedName();
 
         displayString = L"Field: ";
         displayString += (fieldName.empty() ? L"<Unknown>" : fieldName.c_str());
@@ -1725,7 +1869,7 @@ std::wstring BaseClassObject::ToString(_In_ const Object& /*baseClassObject*/,
     ULONG64 baseClassTypeId = spBaseClassSymbol->InternalGetSymbolTypeId();
     BaseSymbol *pBaseClassTypeSymbol = spBaseClassSymbol->InternalGetSymbolSet()->InternalGetSymbol(baseClassTypeId);
 
-    std::wstring const& baseClassTypeName = pBaseClassTypeSymbol->InternalGetQualifiedName();
+    InternedString baseClassTypeName = pBaseClassTypeSymbol->InternalGetQualifiedName();
 
     std::wstring displayString;
     displayString = L"Base Class: ( type = '";
@@ -1861,27 +2005,22 @@ std::experimental::generator<Object> DataObject::GetIterator(_In_ const Object /
 {
     //
     // We must take **GREAT CARE** with what we touch and how we iterate.  After a co_yield, the state
-    // of things may have drastically changed.  We must refetch things and only rely upon positional
-    // counters!
+    // of things may have drastically changed.  We must refetch things and only rely upon the id we
+    // last returned!  A position within the list shifts if anything before it is deleted.
     //
-    size_t cur = 0;
+    ULONG64 nextId = 0;
     for(;;)
     {
-        auto&& globalSymbols = spSymbolSet->InternalGetGlobalSymbols();
-        if (cur >= globalSymbols.size())
+        auto&& globalSymbols = spSymbolSet->InternalGetGlobalSymbols(SvcSymbolData);
+        ULONG64 nextGlobal = GlobalKindIndex::NextSymbol(globalSymbols, nextId);
+        if (nextGlobal == 0)
         {
             break;
         }
 
-        ULONG64 nextGlobal = globalSymbols[cur];
-        ++cur;
+        nextId = nextGlobal + 1;
 
         BaseSymbol *pNextSymbol = spSymbolSet->InternalGetSymbol(nextGlobal);
-        if (pNextSymbol->InternalGetKind() != SvcSymbolData)
-        {
-            continue;
-        }
-
         GlobalDataSymbol *pNextGlobalData = static_cast<GlobalDataSymbol *>(pNextSymbol);
         ComPtr<GlobalDataSymbol> spGlobalData = pNextGlobalData;
         GlobalDataObject& globalDataFactory = ApiProvider::Get().GetGlobalDataFactory();
@@ -1941,14 +2080,14 @@ std::wstring GlobalDataObject::ToString(_In_ const Object& /*globalDataObject*/,
     std::wstring displayString;
     wchar_t buf[128];
 
-    std::wstring const& dataName = spGlobalDataSymbol->InternalGetQualifiedName();
+    InternedString dataName = spGlobalDataSymbol->InternalGetQualifiedName();
 
     ULONG64 dataTypeId = spGlobalDataSymbol->InternalGetSymbolTypeId();
 
     if (spGlobalDataSymbol->InternalIsConstantValue())
     {
         BaseSymbol *pDataTypeSymbol = spGlobalDataSymbol->InternalGetSymbolSet()->InternalGetSymbol(dataTypeId);
-        std::wstring const& dataTypeName = pDataTypeSymbol->InternalGetQualifiedName();
+        InternedString dataTypeName = pDataTypeSymbol->InternalGetQualifiedName();
         std::wstring value = ValueToString(spGlobalDataSymbol->InternalGetSymbolValue());
 
         displayString = L"Global Data: ";
@@ -1962,7 +2101,7 @@ std::wstring GlobalDataObject::ToString(_In_ const Object& /*globalDataObject*/,
     else
     {
         BaseSymbol *pDataTypeSymbol = spGlobalDataSymbol->InternalGetSymbolSet()->InternalGetSymbol(dataTypeId);
-        std::wstring const& dataTypeName = pDataTypeSymbol->InternalGetQualifiedName();
+        InternedString dataTypeName = pDataTypeSymbol->InternalGetQualifiedName();
 
         displayString = L"Global Data: ";
         displayString += (dataName.empty() ? L"<Unknown>" : dataName.c_str());
@@ -2063,30 +2202,127 @@ std::experimental::generator<Object> FunctionsObject::GetIterator(_In_ const Obj
 {
     //
     // We must take **GREAT CARE** with what we touch and how we iterate.  After a co_yield, the state
-    // of things may have drastically changed.  We must refetch things and only rely upon positional
-    // counters!
+    // of things may have drastically changed.  We must refetch things and only rely upon the id we
+    // last returned!  A position within the list shifts if anything before it is deleted.
     //
-    size_t cur = 0;
+    ULONG64 nextId = 0;
     for(;;)
     {
-        auto&& globalSymbols = spSymbolSet->InternalGetGlobalSymbols();
-        if (cur >= globalSymbols.size())
+        auto&& globalSymbols = spSymbolSet->InternalGetGlobalSymbols(SvcSymbolFunction);
+        ULONG64 nextGlobal = GlobalKindIndex::NextSymbol(globalSymbols, nextId);
+        if (nextGlobal == 0)
         {
             break;
         }
 
-        ULONG64 nextGlobal = globalSymbols[cur];
-        ++cur;
+        nextId = nextGlobal + 1;
 
         BaseSymbol *pNextSymbol = spSymbolSet->InternalGetSymbol(nextGlobal);
-        if (pNextSymbol->InternalGetKind() != SvcSymbolFunction)
+        FunctionSymbol *pNextFunction = static_cast<FunctionSymbol *>(pNextSymbol);
+        Object functionObject = BoxSymbol(pNextFunction);
+        co_yield functionObject;
+    }
+}
+
+std::experimental::generator<Object> FunctionsObject::PropagateLiveRangesFromCallingConvention(
+    _In_ const Object& /*functionsObject*/,
+    _In_ ComPtr<SymbolSet>& spSymbolSet)
+{
+    SymbolSet *pSymbolSet = spSymbolSet.Get();
+
+    CallingConvention *pConvention;
+    CheckHr(pSymbolSet->GetSymbolBuilderManager()->GetDefaultCallingConvention(&pConvention));
+
+    //
+    // Gather the functions which have parameters up front and order them by address.  The order (and hence
+    // the result) does not depend on the order in which functions were created and the disassembler walks
+    // the module's code in order.  As with any generator, the set may change after a co_yield.  Only rely
+    // on the ids gathered here and skip anything which has since been deleted.
+    //
+    std::vector<std::pair<ULONG64, ULONG64>> functions;
+    for (ULONG64 globalId : pSymbolSet->InternalGetGlobalSymbols(SvcSymbolFunction))
+    {
+        BaseSymbol *pSymbol = pSymbolSet->InternalGetSymbol(globalId);
+        if (pSymbol == nullptr)
         {
             continue;
         }
 
-        FunctionSymbol *pNextFunction = static_cast<FunctionSymbol *>(pNextSymbol);
-        Object functionObject = BoxSymbol(pNextFunction);
-        co_yield functionObject;
+        for (ULONG64 childId : pSymbol->InternalGetChildren())
+        {
+            BaseSymbol *pChild = pSymbolSet->InternalGetSymbol(childId);
+            if (pChild != nullptr && pChild->InternalGetKind() == SvcSymbolDataParameter)
+            {
+                ULONG64 functionOffset;
+                CheckHr(static_cast<FunctionSymbol *>(pSymbol)->GetOffset(&functionOffset));
+                functions.push_back( { functionOffset, globalId });
+                break;
+            }
+        }
+    }
+
+    std::sort(functions.begin(), functions.end());
+
+    ComPtr<IDebugHostStatus> spStatus;
+    (void)GetHost()->QueryInterface(IID_PPV_ARGS(&spStatus));
+
+    //
+    // A single builder (and hence a single instance of the disassembler) is used for the entire walk.  Its
+    // state is reset for each function.
+    //
+    RangeBuilder builder;
+
+    ULONG64 completed = 0;
+    ULONG64 total = static_cast<ULONG64>(functions.size());
+    for (auto&& function : functions)
+    {
+        if (spStatus != nullptr)
+        {
+            bool interruptRequested = false;
+            if (SUCCEEDED(spStatus->PollUserInterrupt(&interruptRequested)) && interruptRequested)
+            {
+                break;
+            }
+        }
+
+        BaseSymbol *pSymbol = pSymbolSet->InternalGetSymbol(function.second);
+        if (pSymbol == nullptr || pSymbol->InternalGetKind() != SvcSymbolFunction)
+        {
+            --total;
+            continue;
+        }
+
+        //
+        // A function whose code cannot be walked should not stop the walk of every other function.  It is
+        // reported as such in the progress.  Running out of memory is not a problem with the function and
+        // ends the walk.
+        //
+        FunctionSymbol *pFunction = static_cast<FunctionSymbol *>(pSymbol);
+        bool succeeded = true;
+        SymbolSetBatch batch(pSymbolSet);
+        CheckHr(batch.Begin());
+        try
+        {
+            builder.PropagateParameterRanges(pFunction, pConvention);
+        }
+        catch(std::bad_alloc const&)
+        {
+            throw;
+        }
+        catch(...)
+        {
+            succeeded = false;
+        }
+        CheckHr(batch.Commit());
+
+        ++completed;
+
+        Object progressObject = Object::Create(HostContext(),
+                                               L"Function", BoxSymbol(pFunction),
+                                               L"Succeeded", succeeded,
+                                               L"Completed", completed,
+                                               L"Total", total);
+        co_yield progressObject;
     }
 }
 
@@ -2098,7 +2334,7 @@ std::wstring FunctionObject::ToString(_In_ const Object& /*functionObject*/,
                                       _In_ ComPtr<FunctionSymbol>& spFunctionSymbol,
                                       _In_ const Metadata& /*metadata*/)
 {
-    std::wstring const& functionName = spFunctionSymbol->InternalGetQualifiedName();
+    InternedString functionName = spFunctionSymbol->InternalGetQualifiedName();
 
     std::wstring displayString = L"Function: ";
     displayString += (functionName.empty() ? L"<Unknown>" : functionName.c_str());
@@ -2249,9 +2485,9 @@ std::wstring ParametersObject::ToString(_In_ const Object& /*parametersObject*/,
             str += L", ";
         }
 
-        str += pType->InternalGetQualifiedName();
+        str += pType->InternalGetQualifiedName(.view();
         str += L" ";
-        str += pParam->InternalGetName();
+        str += pParam->InternalGetName(.view();
 
         first = false;
     }
@@ -2325,7 +2561,7 @@ Object BaseVariableObject::GetName(_In_ const Object& /*variableObject*/,
         return Object::CreateNoValue();
     }
 
-    return spVariableSymbol->InternalGetName();
+    return std::wstring(spVariableSymbol->InternalGetName().view());
 }
 
 void BaseVariableObject::SetName(_In_ const Object& /*variableObject*/, 
@@ -2375,9 +2611,9 @@ std::wstring BaseVariableObject::ToString(_In_ const Object& /*variableObject*/,
         throw std::runtime_error("Type not found");
     }
 
-    str = pVarType->InternalGetQualifiedName();
+    str = pVarType->InternalGetQualifiedName(.view();
     str += L" ";
-    str += spVariableSymbol->InternalGetName();
+    str += spVariableSymbol->InternalGetName(.view();
 
     return str;
 }
@@ -2486,7 +2722,7 @@ std::wstring LiveRangeObject::ToString(_In_ const Object& /*liveRangeObject*/,
                pLiveRange->Offset + pLiveRange->Size);
 
     std::wstring str = buf;
-    str += liveRangeInfo.Variable->InternalGetName();
+    str += liveRangeInfo.Variable->InternalGetName(.view();
     str += L" = ";
 
     std::wstring liveRangeDesc;
@@ -2681,27 +2917,22 @@ std::experimental::generator<Object> PublicsObject::GetIterator(_In_ const Objec
 {
     //
     // We must take **GREAT CARE** with what we touch and how we iterate.  After a co_yield, the state
-    // of things may have drastically changed.  We must refetch things and only rely upon positional
-    // counters!
+    // of things may have drastically changed.  We must refetch things and only rely upon the id we
+    // last returned!  A position within the list shifts if anything before it is deleted.
     //
-    size_t cur = 0;
+    ULONG64 nextId = 0;
     for(;;)
     {
-        auto&& globalSymbols = spSymbolSet->InternalGetGlobalSymbols();
-        if (cur >= globalSymbols.size())
+        auto&& globalSymbols = spSymbolSet->InternalGetGlobalSymbols(SvcSymbolPublic);
+        ULONG64 nextGlobal = GlobalKindIndex::NextSymbol(globalSymbols, nextId);
+        if (nextGlobal == 0)
         {
             break;
         }
 
-        ULONG64 nextGlobal = globalSymbols[cur];
-        ++cur;
+        nextId = nextGlobal + 1;
 
         BaseSymbol *pNextSymbol = spSymbolSet->InternalGetSymbol(nextGlobal);
-        if (pNextSymbol->InternalGetKind() != SvcSymbolPublic)
-        {
-            continue;
-        }
-
         PublicSymbol *pNextPublic = static_cast<PublicSymbol *>(pNextSymbol);
         Object publicObject = BoxSymbol(pNextPublic);
         co_yield publicObject;
@@ -2712,7 +2943,7 @@ std::wstring PublicObject::ToString(_In_ const Object& /*publicObject*/,
                                     _In_ ComPtr<PublicSymbol>& spPublicSymbol,
                                     _In_ const Metadata& /*metadata*/)
 {
-    std::wstring const& publicName = spPublicSymbol->InternalGetQualifiedName();
+    InternedString publicName = spPublicSymbol->InternalGetQualifiedName();
 
     std::wstring displayString = L"Public Symbol: ";
     displayString += (publicName.empty() ? L"<Unknown>" : publicName.c_str());
@@ -2768,50 +2999,27 @@ Object PublicObject::PromoteToFunction(_In_ const Object& publicObject,
         codeEntryVa += moduleBase;
 
         //
-        // Many of the debugger's "API" type of extensions are somewhere under Debugger.Utility.  The data model
-        // disassembler places itself under "Debugger.Utility.Code".
-        //
-        Object codeNamespace = Object::RootNamespace().KeyValue(L"Debugger")
-                                                      .KeyValue(L"Utility")
-                                                      .KeyValue(L"Code");
-
-        Object disassembler = codeNamespace.CallMethod(L"CreateDisassembler");
-
-        //
-        // Calling .DisassembleFunction will have the data model disassembler perform a disassembly across the
-        // entire function doing flow analysis to form a basic block graph.  The returned object will have
-        //
-        //     .BasicBlocks - a list of basic blocks
-        //
-        // Where each basic block will have:
+        // The range builder has the data model disassembler perform a disassembly across the entire function
+        // doing flow analysis to form a basic block graph.  The decoded graph lands in the symbol set's code
+        // cache where a later propagation of parameter live ranges for the function will find it.  The returned
+        // basic blocks are sorted by their start address.
         //
-        //     .StartAddress         - the start address of the block
-        //     .EndAddress           - one byte past the end of the block
-        //     .Instructions         - a list of instructions in the block
-        //     .InboundControlFlows  - a list of inbound edges to this block in the control flow graph
-        //     .OutboundControlFlows - a list of outbound edges from this block in the control flow graph
-        //
-        Object bbs = disassembler.CallMethod(L"DisassembleFunction", codeEntryVa)
-                                 .KeyValue(L"BasicBlocks");
-
-        //
-        // Make sure that the list of basic blocks is ordered by their start address...  then go find how much
-        // of the code is contiguous forwards in VA space from the entry point VA.  Some optimizations or things
-        // like a BBT will cause discontiguous code.
+        // From that, go find how much of the code is contiguous forwards in VA space from the entry point VA.
+        // Some optimizations or things like a BBT will cause discontiguous code.
         //
         // We cannot *YET* express that in the *SAMPLE* but will be able to eventually.  In either case, the
         // primary block (with the entry point VA) is the base of the function and we need to know that.
         //
-        Object bbsOrdered = bbs.CallMethod(L"OrderBy", [&](_In_ const Object& /*ctx*/, _In_ Object bb)
-                                                       { return bb.KeyValue(L"StartAddress"); });
+        RangeBuilder builder;
+        std::shared_ptr<FunctionCode const> spFunctionCode = builder.GetFunctionCode(pSymbolSet, codeEntryVa);
 
         ULONG64 contigEndVa = codeEntryVa;
         bool foundPrimaryBlock = false;
 
-        for(Object bb : bbsOrdered)
+        for (auto&& bb : spFunctionCode->BasicBlocks)
         {
-            ULONG64 blockStart = (ULONG64)bb.KeyValue(L"StartAddress");
-            ULONG64 blockEnd = (ULONG64)bb.KeyValue(L"EndAddress");
+            ULONG64 blockStart = bb.StartAddress;
+            ULONG64 blockEnd = bb.EndAddress;
 
             //
             // Bear in mind certain transformations might put some of the function *BEFORE* the "base"
@@ -2827,7 +3035,7 @@ Object PublicObject::PromoteToFunction(_In_ const Object& publicObject,
             }
             
             //
-            // As we *GUARANTEED* the basic blocks are sorted by start address in calling .OrderBy,
+            // As the basic blocks are *GUARANTEED* to be sorted by start address,
             // it's only contiguous under the simple condition given below.
             //
             else if (blockStart == contigEndVa)
@@ -2928,6 +3136,27 @@ SymbolSetObject::SymbolSetObject() :
 
     AddReadOnlyProperty(L"Types", this, &SymbolSetObject::GetTypes,
                         Metadata(L"Help", DeferredResourceString { SYMBOLBUILDER_IDS_SYMBOLSET_TYPES }));
+
+    AddReadOnlyProperty(L"CacheInvalidationCount", this, &SymbolSetObject::GetCacheInvalidationCount,
+                        Metadata(L"Help", DeferredResourceString { SYMBOLBUILDER_IDS_SYMBOLSET_CACHEINVALIDATIONCOUNT }));
+
+    AddReadOnlyProperty(L"DecodedFunctionCount", this, &SymbolSetObject::GetDecodedFunctionCount,
+                        Metadata(L"Help", DeferredResourceString { SYMBOLBUILDER_IDS_SYMBOLSET_DECODEDFUNCTIONCOUNT }));
+
+    AddMethod(L"BeginBatch", this, &SymbolSetObject::BeginBatch,
+              Metadata(L"Help", DeferredResourceString { SYMBOLBUILDER_IDS_SYMBOLSET_BEGINBATCH }));
+
+    AddMethod(L"CommitBatch", this, &SymbolSetObject::CommitBatch,
+              Metadata(L"Help", DeferredResourceString { SYMBOLBUILDER_IDS_SYMBOLSET_COMMITBATCH }));
+
+    AddMethod(L"AbortBatch", this, &SymbolSetObject::AbortBatch,
+              Metadata(L"Help", DeferredResourceString { SYMBOLBUILDER_IDS_SYMBOLSET_ABORTBATCH }));
+
+    AddMethod(L"Save", this, &SymbolSetObject::Save,
+              Metadata(L"Help", DeferredResourceString { SYMBOLBUILDER_IDS_SYMBOLSET_SAVE }));
+
+    AddMethod(L"FindSymbols", this, &SymbolSetObject::FindSymbols,
+              Metadata(L"Help", DeferredResourceString { SYMBOLBUILDER_IDS_SYMBOLSET_FINDSYMBOLS }));
 }
 
 TypesObject::TypesObject() :
@@ -3152,6 +3381,9 @@ FunctionsObject::FunctionsObject() :
               Metadata(L"Help", DeferredResourceString { SYMBOLBUILDER_IDS_FUNCTIONS_CREATE },
                        L"PreferShow", true));
 
+    AddMethod(L"PropagateLiveRangesFromCallingConvention", this, &FunctionsObject::PropagateLiveRangesFromCallingConvention,
+              Metadata(L"Help", DeferredResourceString { SYMBOLBUILDER_IDS_FUNCTIONS_PROPAGATELIVERANGESFROMCALLINGCONVENTION }));
+
     AddGeneratorFunction(this, &FunctionsObject::GetIterator);
 }
 
@@ -3288,6 +3520,9 @@ SymbolBuilderNamespace::SymbolBuilderNamespace() :
     AddMethod(L"CreateSymbols", this, &SymbolBuilderNamespace::CreateSymbols,
               Metadata(L"Help", DeferredResourceString { SYMBOLBUILDER_IDS_CREATESYMBOLS },
                        L"PreferShow", true));
+    AddMethod(L"DeleteSymbols", this, &SymbolBuilderNamespace::DeleteSymbols,
+              Metadata(L"Help", DeferredResourceString { SYMBOLBUILDER_IDS_DELETESYMBOLS },
+                       L"PreferShow", true));
 }
 
 PublicsObject::PublicsObject() :
@@ -87,7 +87,8 @@ public:
 //
 // Represents one of our symbol set objects boxed into the data model.
 //
-class SymbolSetObject : public TypedInstanceModel<ComPtr<SymbolSet>>
+class SymbolSetObject : public TypedInstanceModel<ComPtr<SymbolSet>>,
+                        public SymbolObjectHelpers
 {
 public:
 
@@ -119,6 +120,52 @@ private:
     //
     Object GetPublics(_In_ const Object& /*symbolSetObject*/, _In_ ComPtr<SymbolSet>& spSymbolSet);
 
+    // BeginBatch():
+    //
+    // Bound API which begins a batch of updates to the symbol set.  Cache invalidations and dependent
+    // layout changes are deferred until the batch is committed.
+    //
+    void BeginBatch(_In_ const Object& symbolSetObject, _In_ ComPtr<SymbolSet>& spSymbolSet);
+
+    // CommitBatch():
+    //
+    // Bound API which commits a batch of updates started with BeginBatch.
+    //
+    void CommitBatch(_In_ const Object& symbolSetObject, _In_ ComPtr<SymbolSet>& spSymbolSet);
+
+    // AbortBatch():
+    //
+    // Bound API which ends an open batch of updates after a failure.
+    //
+    void AbortBatch(_In_ const Object& symbolSetObject, _In_ ComPtr<SymbolSet>& spSymbolSet);
+
+    // GetCacheInvalidationCount():
+    //
+    // Property accessor which gets the number of cache invalidations sent for this symbol set.
+    //
+    ULONG64 GetCacheInvalidationCount(_In_ const Object& /*symbolSetObject*/, _In_ ComPtr<SymbolSet>& spSymbolSet);
+
+    // GetDecodedFunctionCount():
+    //
+    // Property accessor which gets the number of functions whose code has been decoded for this symbol set.
+    //
+    ULONG64 GetDecodedFunctionCount(_In_ const Object& /*symbolSetObject*/, _In_ ComPtr<SymbolSet>& spSymbolSet);
+
+    // Save():
+    //
+    // Bound API which saves the symbol set to a snapshot file which can be loaded by CreateSymbols.
+    //
+    void Save(_In_ const Object& symbolSetObject, _In_ ComPtr<SymbolSet>& spSymbolSet, _In_ std::wstring snapshotPath);
+
+    // FindSymbols():
+    //
+    // Bound API which finds the global symbols whose name matches a wildcard pattern.
+    //
+    std::experimental::generator<Object> FindSymbols(_In_ const Object& symbolSetObject,
+                                                     _In_ ComPtr<SymbolSet>& spSymbolSet,
+                                                     _In_ std::wstring pattern,
+                                                     _In_ std::optional<bool> caseInsensitive);
+
 };
 
 //*************************************************
@@ -789,6 +836,16 @@ private:
     std::experimental::generator<Object> GetIterator(_In_ const Object functionsObject,
                                                      _In_ ComPtr<SymbolSet>& spSymbolSet);
 
+    // PropagateLiveRangesFromCallingConvention():
+    //
+    // Bound API which does what <Function>.Parameters.PropagateLiveRangesFromCallingConvention does for every
+    // function in the symbol set which has parameters.  The functions are processed in address order as the
+    // result is iterated and each yields an object describing the progress of the walk.  Stopping the
+    // iteration (or a user interrupt) cancels the walk between functions.
+    //
+    std::experimental::generator<Object> PropagateLiveRangesFromCallingConvention(_In_ const Object& functionsObject,
+                                                                                  _In_ ComPtr<SymbolSet>& spSymbolSet);
+
 };
 
 // FunctionObject:
@@ -1303,6 +1360,23 @@ private:
                          _In_ Object moduleArg,
                          _In_ std::optional<Object> options);
 
+    // DeleteSymbols():
+    //
+    // Deletes the symbol builder set for a given module so that symbols for the module come from wherever the
+    // debugger would otherwise find them.  The module can be given in any of the forms CreateSymbols accepts.
+    //
+    void DeleteSymbols(_In_ const Object& contextObject,
+                       _In_ Object moduleArg);
+
+    // ResolveModule():
+    //
+    // Resolves a module given as a module object, base address, or name to its base address and the context
+    // in which it is loaded.
+    //
+    void ResolveModule(_In_ Object moduleArg,
+                       _Out_ ULONG64 *pModuleBase,
+                       _Out_ HostContext *pModuleContext);
+
 };
 
 //*************************************************
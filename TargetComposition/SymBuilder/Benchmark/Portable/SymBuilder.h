@@ -0,0 +1,81 @@
+//**************************************************************************
+//
+// SymBuilder.h (Portable)
+//
+// A stand-in for the plug-in's core header which allows the symbol builder's
+// string arena (StringArena.cpp) to be built without the debugger or Windows
+// headers so that it can be benchmarked on any host.  Only what the arena
+// itself uses is provided.
+//
+//**************************************************************************
+//
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+//
+//**************************************************************************
+
+#ifndef __PORTABLE_SYMBUILDER_H__
+#define __PORTABLE_SYMBUILDER_H__
+
+//
+// This stands in for the real SymBuilder.h.  Defining its include guard makes the #include "SymBuilder.h" at the
+// top of the plug-in's sources a no-op.
+//
+#define __SYMBUILDER_H__
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <cwchar>
+
+#include <utility>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <algorithm>
+#include <functional>
+
+//*************************************************
+// Types and Annotations:
+//
+
+typedef int32_t HRESULT;
+typedef uint64_t ULONG64;
+typedef const wchar_t *PCWSTR;
+
+#define _In_
+#define _In_opt_
+#define _Out_
+
+#define S_OK ((HRESULT)0)
+#define E_FAIL ((HRESULT)0x80004005)
+#define E_OUTOFMEMORY ((HRESULT)0x8007000E)
+#define SUCCEEDED(hr) (((HRESULT)(hr)) >= 0)
+#define FAILED(hr) (((HRESULT)(hr)) < 0)
+
+template<typename FN>
+HRESULT ConvertException(const FN& fn)
+{
+    HRESULT hr;
+    try
+    {
+        hr = fn();
+    }
+    catch(const std::bad_alloc&)
+    {
+        hr = E_OUTOFMEMORY;
+    }
+    catch(...)
+    {
+        hr = E_FAIL;
+    }
+
+    return hr;
+}
+
+#include "../../StringArena.h"
+
+#endif // __PORTABLE_SYMBUILDER_H__
@@ -0,0 +1,14 @@
+//**************************************************************************
+//
+// PortableStringArena.cpp
+//
+// Builds the plug-in's StringArena.cpp against the portable stand-in header.
+//
+//**************************************************************************
+//
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+//
+//**************************************************************************
+
+#include "Portable/SymBuilder.h"
+#include "../StringArena.cpp"
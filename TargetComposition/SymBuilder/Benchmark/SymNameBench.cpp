@@ -0,0 +1,492 @@
+//**************************************************************************
+//
+// SymNameBench.cpp
+//
+// Measures the memory which the names of symbols take in a symbol set after a
+// large synthetic import, and the cost of looking symbols up by name.  This
+// compares the symbol builder's interned names (see StringArena.h) against
+// every symbol and index owning its own copy of each name.
+//
+// Only the name storage of a symbol set is modeled: the names of each symbol,
+// the map of qualified names to global symbols, and the sorted name index.  Everything
+// else a symbol holds is the same either way and is not counted.
+//
+//**************************************************************************
+//
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+//
+//**************************************************************************
+
+#include "Portable/SymBuilder.h"
+
+#include <chrono>
+#include <new>
+#include <random>
+
+using namespace Debugger::TargetComposition::Services::SymbolBuilder;
+
+//*************************************************
+// Heap Accounting:
+//
+// Every allocation is prefixed with its size so that the bytes live on the heap can be tracked exactly.
+//
+
+namespace
+{
+
+size_t g_heapBytes = 0;
+constexpr size_t HeapHeaderSize = 16;
+
+void *CountedAlloc(size_t size)
+{
+    void *p = malloc(size + HeapHeaderSize);
+    if (p == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    *reinterpret_cast<size_t *>(p) = size;
+    g_heapBytes += size;
+    return reinterpret_cast<char *>(p) + HeapHeaderSize;
+}
+
+void CountedFree(void *p)
+{
+    if (p != nullptr)
+    {
+        void *pBlock = reinterpret_cast<char *>(p) - HeapHeaderSize;
+        g_heapBytes -= *reinterpret_cast<size_t *>(pBlock);
+        free(pBlock);
+    }
+}
+
+}
+
+void *operator new(size_t size) { return CountedAlloc(size); }
+void *operator new[](size_t size) { return CountedAlloc(size); }
+void operator delete(void *p) noexcept { CountedFree(p); }
+void operator delete[](void *p) noexcept { CountedFree(p); }
+void operator delete(void *p, size_t) noexcept { CountedFree(p); }
+void operator delete[](void *p, size_t) noexcept { CountedFree(p); }
+
+namespace
+{
+
+// BenchmarkOptions:
+//
+// How to run the benchmark.  See Usage() for the meaning of each.
+//
+struct BenchmarkOptions
+{
+    uint64_t Symbols = 1000000;
+    uint64_t Lookups = 1000000;
+    uint64_t Seed = 1;
+};
+
+void Usage()
+{
+    fprintf(stderr,
+            "usage: SymNameBench [options]\n"
+            "\n"
+            "    --symbols <n>       approximate number of symbols to import (default 1000000)\n"
+            "    --lookups <n>       number of lookups of global symbols by name (default 1000000)\n"
+            "    --seed <n>          random seed (default 1)\n");
+}
+
+bool ParseOptions(int argc, char **argv, BenchmarkOptions *pOptions)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const char *pArg = argv[i];
+        if (strncmp(pArg, "--", 2) != 0 || i + 1 >= argc)
+        {
+            return false;
+        }
+
+        char *pEnd;
+        uint64_t value = strtoull(argv[++i], &pEnd, 0);
+        if (*pEnd != '\0')
+        {
+            return false;
+        }
+
+        if (strcmp(pArg, "--symbols") == 0 && value > 0)
+        {
+            pOptions->Symbols = value;
+        }
+        else if (strcmp(pArg, "--lookups") == 0)
+        {
+            pOptions->Lookups = value;
+        }
+        else if (strcmp(pArg, "--seed") == 0)
+        {
+            pOptions->Seed = value;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Stopwatch:
+//
+// Elapsed wall clock time.
+//
+class Stopwatch
+{
+public:
+
+    Stopwatch() : m_start(std::chrono::steady_clock::now()) { }
+
+    double Seconds() const
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+    }
+
+private:
+
+    std::chrono::steady_clock::time_point m_start;
+};
+
+//*************************************************
+// Synthetic Import:
+//
+
+// SyntheticSymbol:
+//
+// The names of one imported symbol.  An empty qualified name means the symbol only has a name (as with fields,
+// parameters, and locals).
+//
+struct SyntheticSymbol
+{
+    std::wstring Name;
+    std::wstring QualifiedName;
+    bool IsGlobal;
+};
+
+PCWSTR const g_fieldNames[] =
+{
+    L"m_size", L"m_count", L"m_capacity", L"m_flags", L"m_pData", L"m_pNext", L"m_pPrev", L"m_refCount",
+    L"m_name", L"m_id", L"m_state", L"m_lock", L"m_pOwner", L"m_options", L"m_buffer", L"m_length"
+};
+
+PCWSTR const g_methodNames[] =
+{
+    L"Initialize", L"Uninitialize", L"GetValue", L"SetValue", L"AddRef", L"Release", L"QueryInterface",
+    L"Reset", L"GetNext", L"Create", L"Destroy", L"Open", L"Close", L"Read", L"Write", L"ToString"
+};
+
+PCWSTR const g_localNames[] =
+{
+    L"this", L"hr", L"i", L"size", L"pResult", L"flags", L"index", L"count", L"value", L"result", L"p", L"name"
+};
+
+// SyntheticImport:
+//
+// Produces the symbols an import of a large C++ module brings into a symbol set: for each class, its type,
+// a pointer to it, its fields, and its methods along with their publics, parameters, and locals.  Field,
+// method, parameter, and local names repeat across classes as they do in real code.
+//
+class SyntheticImport
+{
+public:
+
+    SyntheticImport(_In_ uint64_t symbols, _In_ uint64_t seed) :
+        m_random(static_cast<std::mt19937_64::result_type>(seed))
+    {
+        GenerateAll(symbols);
+    }
+
+    std::vector<SyntheticSymbol> const& GetSymbols() const { return m_symbols; }
+    std::vector<std::wstring> const& GetGlobalNames() const { return m_globalNames; }
+
+private:
+
+    void Add(_In_ std::wstring name, _In_ std::wstring qualifiedName, _In_ bool isGlobal)
+    {
+        if (isGlobal)
+        {
+            m_globalNames.push_back(qualifiedName.empty() ? name : qualifiedName);
+        }
+        m_symbols.push_back( { std::move(name), std::move(qualifiedName), isGlobal } );
+    }
+
+    template<size_t N>
+    PCWSTR Pick(_In_ PCWSTR const (&names)[N])
+    {
+        return names[m_random() % N];
+    }
+
+    void GenerateAll(_In_ uint64_t symbols)
+    {
+        uint64_t classIndex = 0;
+        while (m_symbols.size() < symbols)
+        {
+            std::wstring ns = L"Contoso::Component" + std::to_wstring(classIndex / 64);
+            std::wstring className = L"Widget" + std::to_wstring(classIndex) + L"Impl";
+            std::wstring qualifiedClassName = ns + L"::" + className;
+
+            Add(className, qualifiedClassName, true);
+            Add(className + L" *", qualifiedClassName + L" *", true);
+
+            size_t fieldCount = 4 + m_random() % 8;
+            for (size_t field = 0; field < fieldCount; ++field)
+            {
+                Add(Pick(g_fieldNames), std::wstring(), false);
+            }
+
+            size_t methodCount = 2 + m_random() % 8;
+            for (size_t method = 0; method < methodCount; ++method)
+            {
+                std::wstring methodName = Pick(g_methodNames);
+                std::wstring qualifiedMethodName = qualifiedClassName + L"::" + methodName;
+                Add(methodName, qualifiedMethodName, true);
+
+                std::wstring decoratedName = L"?" + methodName + L"@" + className + L"@Component" +
+                                             std::to_wstring(classIndex / 64) + L"@Contoso@@QEAAJXZ";
+                Add(decoratedName, std::wstring(), true);
+
+                size_t localCount = 1 + m_random() % 5;
+                for (size_t local = 0; local < localCount; ++local)
+                {
+                    Add(Pick(g_localNames), std::wstring(), false);
+                }
+            }
+
+            ++classIndex;
+        }
+    }
+
+    std::mt19937_64 m_random;
+    std::vector<SyntheticSymbol> m_symbols;
+    std::vector<std::wstring> m_globalNames;
+};
+
+//*************************************************
+// Name Storage:
+//
+
+// OwnedNames:
+//
+// Every symbol owns its name and qualified name and every index owns a copy of the names it is keyed by.
+// A lookup by PCWSTR must construct a temporary string for the key.
+//
+class OwnedNames
+{
+public:
+
+    void Add(_In_ SyntheticSymbol const& symbol)
+    {
+        ULONG64 id = m_symbols.size() + 1;
+        m_symbols.push_back( { symbol.Name, symbol.QualifiedName } );
+
+        if (symbol.IsGlobal)
+        {
+            std::wstring const& qualifiedName = symbol.QualifiedName.empty() ? symbol.Name : symbol.QualifiedName;
+            m_nameMap.insert( { qualifiedName, id } );
+            m_nameIndex.insert( { qualifiedName, id } );
+            if (!symbol.QualifiedName.empty())
+            {
+                m_nameIndex.insert( { symbol.Name, id } );
+            }
+        }
+    }
+
+    ULONG64 Find(_In_ PCWSTR pwszName) const
+    {
+        std::wstring name = pwszName;
+        auto it = m_nameMap.find(name);
+        return (it == m_nameMap.end() ? 0 : it->second);
+    }
+
+private:
+
+    struct Names
+    {
+        std::wstring Name;
+        std::wstring QualifiedName;
+    };
+
+    std::vector<Names> m_symbols;
+    std::unordered_map<std::wstring, ULONG64> m_nameMap;
+    std::multimap<std::wstring, ULONG64> m_nameIndex;
+};
+
+// InternedNames:
+//
+// Every distinct name is stored once in a string arena.  Symbols and indexes hold handles into it and a lookup
+// by PCWSTR is a lookup by string view.
+//
+class InternedNames
+{
+public:
+
+    bool Add(_In_ SyntheticSymbol const& symbol)
+    {
+        ULONG64 id = m_symbols.size() + 1;
+
+        Names names;
+        if (FAILED(m_arena.Intern(symbol.Name, &names.Name)) ||
+            FAILED(m_arena.Intern(symbol.QualifiedName, &names.QualifiedName)))
+        {
+            return false;
+        }
+        m_symbols.push_back(names);
+
+        if (symbol.IsGlobal)
+        {
+            InternedString qualifiedName = names.QualifiedName.empty() ? names.Name : names.QualifiedName;
+            m_nameMap.insert( { qualifiedName.view(), id } );
+            m_nameIndex.insert( { qualifiedName.view(), id } );
+            if (!names.QualifiedName.empty())
+            {
+                m_nameIndex.insert( { names.Name.view(), id } );
+            }
+        }
+
+        return true;
+    }
+
+    ULONG64 Find(_In_ PCWSTR pwszName) const
+    {
+        auto it = m_nameMap.find(std::wstring_view(pwszName));
+        return (it == m_nameMap.end() ? 0 : it->second);
+    }
+
+    StringArena const& GetArena() const { return m_arena; }
+
+private:
+
+    struct Names
+    {
+        InternedString Name;
+        InternedString QualifiedName;
+    };
+
+    StringArena m_arena;
+    std::vector<Names> m_symbols;
+    std::unordered_map<std::wstring_view, ULONG64> m_nameMap;
+    std::multimap<std::wstring_view, ULONG64> m_nameIndex;
+};
+
+// LookupRate():
+//
+// Looks up 'lookups' random global names and returns millions of lookups per second.
+//
+template<typename TNames>
+double LookupRate(_In_ TNames const& names,
+                  _In_ std::vector<PCWSTR> const& queries,
+                  _In_ uint64_t lookups,
+                  _In_ uint64_t seed,
+                  _Out_ uint64_t *pFound)
+{
+    std::mt19937_64 random(static_cast<std::mt19937_64::result_type>(seed));
+    uint64_t found = 0;
+
+    Stopwatch stopwatch;
+    for (uint64_t i = 0; i < lookups; ++i)
+    {
+        if (names.Find(queries[random() % queries.size()]) != 0)
+        {
+            ++found;
+        }
+    }
+    double seconds = stopwatch.Seconds();
+
+    *pFound = found;
+    return static_cast<double>(lookups) / seconds / 1e6;
+}
+
+double MB(_In_ size_t bytes)
+{
+    return static_cast<double>(bytes) / (1024.0 * 1024.0);
+}
+
+}
+
+int main(int argc, char **argv)
+{
+    BenchmarkOptions options;
+    if (!ParseOptions(argc, argv, &options))
+    {
+        Usage();
+        return 1;
+    }
+
+    SyntheticImport import(options.Symbols, options.Seed);
+    std::vector<SyntheticSymbol> const& symbols = import.GetSymbols();
+    std::vector<std::wstring> const& globalNames = import.GetGlobalNames();
+
+    std::vector<PCWSTR> queries;
+    for (auto&& globalName : globalNames)
+    {
+        queries.push_back(globalName.c_str());
+    }
+
+    printf("symbols:            %zu (%zu global)\n", symbols.size(), globalNames.size());
+
+    //*************************************************
+    // Owned Names:
+    //
+
+    {
+        size_t heapBefore = g_heapBytes;
+        Stopwatch stopwatch;
+        std::unique_ptr<OwnedNames> spNames(new OwnedNames);
+        for (auto&& symbol : symbols)
+        {
+            spNames->Add(symbol);
+        }
+        double seconds = stopwatch.Seconds();
+        size_t heapBytes = g_heapBytes - heapBefore;
+
+        uint64_t found;
+        double rate = LookupRate(*spNames, queries, options.Lookups, options.Seed, &found);
+
+        printf("owned names:        %.1f MB (%.1f bytes/symbol), import %.3f s, lookup %.1f M/s (%llu found)\n",
+               MB(heapBytes),
+               static_cast<double>(heapBytes) / static_cast<double>(symbols.size()),
+               seconds,
+               rate,
+               static_cast<unsigned long long>(found));
+    }
+
+    //*************************************************
+    // Interned Names:
+    //
+
+    {
+        size_t heapBefore = g_heapBytes;
+        Stopwatch stopwatch;
+        std::unique_ptr<InternedNames> spNames(new InternedNames);
+        for (auto&& symbol : symbols)
+        {
+            if (!spNames->Add(symbol))
+            {
+                fprintf(stderr, "unable to intern names\n");
+                return 1;
+            }
+        }
+        double seconds = stopwatch.Seconds();
+        size_t heapBytes = g_heapBytes - heapBefore;
+
+        uint64_t found;
+        double rate = LookupRate(*spNames, queries, options.Lookups, options.Seed, &found);
+
+        printf("interned names:     %.1f MB (%.1f bytes/symbol), import %.3f s, lookup %.1f M/s (%llu found)\n",
+               MB(heapBytes),
+               static_cast<double>(heapBytes) / static_cast<double>(symbols.size()),
+               seconds,
+               rate,
+               static_cast<unsigned long long>(found));
+
+        StringArena const& arena = spNames->GetArena();
+        printf("string arena:       %zu distinct strings, %.1f MB of blocks\n",
+               arena.GetStringCount(),
+               MB(arena.GetBlockCharacters() * sizeof(wchar_t)));
+    }
+
+    return 0;
+}
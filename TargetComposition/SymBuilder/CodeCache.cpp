@@ -0,0 +1,115 @@
+//**************************************************************************
+//
+// CodeCache.cpp
+//
+// A per-module cache of the decoded code of functions.
+//
+//**************************************************************************
+//
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+//
+//**************************************************************************
+
+#include "SymBuilder.h"
+
+namespace Debugger
+{
+namespace TargetComposition
+{
+namespace Services
+{
+namespace SymbolBuilder
+{
+
+HRESULT FunctionCodeCache::ComputeCodeHash(_In_ SymbolSet *pSymbolSet,
+                                           _In_ FunctionCode const& functionCode,
+                                           _Out_ ULONG64 *pCodeHash)
+{
+    HRESULT hr = S_OK;
+    *pCodeHash = 0;
+
+    SymbolBuilderProcess *pProcess = pSymbolSet->GetOwningProcess();
+
+    //
+    // FNV-1a over the bytes of each basic block in address order.  Any byte which cannot be read makes the
+    // hash (and hence the cache entry) unusable.
+    //
+    ULONG64 codeHash = 14695981039346656037ull;
+    BYTE buffer[512];
+    for (auto&& block : functionCode.BasicBlocks)
+    {
+        ULONG64 address = block.StartAddress;
+        while (address < block.EndAddress)
+        {
+            ULONG64 readSize = (std::min)(block.EndAddress - address, static_cast<ULONG64>(sizeof(buffer)));
+
+            ULONG64 bytesRead;
+            IfFailedReturn(pProcess->ReadMemory(address, buffer, readSize, &bytesRead));
+            if (bytesRead != readSize)
+            {
+                return E_FAIL;
+            }
+
+            for (ULONG64 i = 0; i < bytesRead; ++i)
+            {
+                codeHash ^= buffer[i];
+                codeHash *= 1099511628211ull;
+            }
+
+            address += bytesRead;
+        }
+    }
+
+    *pCodeHash = codeHash;
+    return hr;
+}
+
+HRESULT FunctionCodeCache::FindFunction(_In_ SymbolSet *pSymbolSet,
+                                        _In_ ULONG64 entryAddress,
+                                        _Out_ std::shared_ptr<FunctionCode const> *pFunctionCode)
+{
+    pFunctionCode->reset();
+
+    auto it = m_functions.find(entryAddress);
+    if (it == m_functions.end())
+    {
+        return S_FALSE;
+    }
+
+    //
+    // If the code bytes cannot be read or have changed since the function was decoded, the decoding is stale.
+    //
+    ULONG64 codeHash;
+    if (FAILED(ComputeCodeHash(pSymbolSet, *(it->second), &codeHash)) || codeHash != it->second->CodeHash)
+    {
+        m_functions.erase(it);
+        return S_FALSE;
+    }
+
+    *pFunctionCode = it->second;
+    return S_OK;
+}
+
+HRESULT FunctionCodeCache::AddFunction(_In_ SymbolSet *pSymbolSet,
+                                       _In_ std::shared_ptr<FunctionCode> functionCode)
+{
+    HRESULT hr = S_OK;
+    ++m_decodedFunctionCount;
+    IfFailedReturn(ComputeCodeHash(pSymbolSet, *functionCode, &(functionCode->CodeHash)));
+
+    //
+    // We cannot let a C++ exception escape.
+    //
+    auto fn = [&]()
+    {
+        ULONG64 entryAddress = functionCode->EntryAddress;
+        m_functions[entryAddress] = std::move(functionCode);
+        return S_OK;
+    };
+    return ConvertException(fn);
+}
+
+} // SymbolBuilder
+} // Services
+} // TargetComposition
+} // Debugger
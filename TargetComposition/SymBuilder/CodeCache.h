@@ -0,0 +1,180 @@
+//**************************************************************************
+//
+// CodeCache.h
+//
+// A per-module cache of the decoded code of functions.  Disassembling a function through
+// the data model disassembler and classifying each of its instructions is expensive.  Anything
+// which needs the basic blocks or instructions of a function (the range builder, promotion of
+// a public symbol to a function, etc...) goes through this cache so that the work is done once
+// for as long as the code bytes of the function are unchanged.
+//
+//**************************************************************************
+//
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+//
+//**************************************************************************
+
+#ifndef __CODECACHE_H__
+#define __CODECACHE_H__
+
+namespace Debugger
+{
+namespace TargetComposition
+{
+namespace Services
+{
+namespace SymbolBuilder
+{
+
+class SymbolSet;
+
+// RecognizedInstruction:
+//
+// Defines instructions that we recognize for specific purposes.
+//
+enum class RecognizedInstruction
+{
+    Unknown,
+    Mov,
+    Push,
+    Pop,
+    Add,
+    Sub,
+    Lea
+};
+
+enum OperandFlags
+{
+    OperandInput = 0x00000001,
+    OperandOutput = 0x000000002,
+    OperandRegister = 0x00000004,
+    OperandMemory = 0x00000008,
+    OperandImmediate = 0x00000010,
+};
+
+// OperandInfo:
+//
+// Information about an operand
+//
+struct OperandInfo
+{
+    ULONG Flags;                // OperandFlags set
+    ULONG Regs[3];              // Canonical register ids or (ULONG)-1 if not present
+    ULONG ScalingFactor;        // regs[0] * scalingFactor (1)
+    LONG64 ConstantValue;       // immediate
+};
+
+// InstructionInfo:
+//
+// Information about an instruction
+//
+struct InstructionInfo
+{
+    ULONG64 Address;
+    ULONG64 Length;
+    RecognizedInstruction Instr;
+    bool IsCall;
+    size_t NumOperands;
+    OperandInfo Operands[4];
+};
+
+// ControlFlowInfo:
+//
+// An outbound control flow (whether a branch or fall through) from a basic block.
+//
+struct ControlFlowInfo
+{
+    ULONG64 DestinationBlockAddress;
+    ULONG64 SourceInstructionAddress;
+};
+
+// BasicBlockCode:
+//
+// The decoded code of a basic block: the half-open range [StartAddress, EndAddress), its instructions, and its
+// outbound control flows.
+//
+struct BasicBlockCode
+{
+    ULONG64 StartAddress;
+    ULONG64 EndAddress;
+    std::vector<InstructionInfo> Instructions;
+    std::vector<ControlFlowInfo> OutboundControlFlows;
+};
+
+// FunctionCode:
+//
+// The decoded code of a function as found by a flow analysis starting at its entry point.  The basic blocks are
+// sorted by start address.  All addresses are virtual addresses.
+//
+struct FunctionCode
+{
+    ULONG64 EntryAddress;
+    std::vector<BasicBlockCode> BasicBlocks;
+
+    // A hash of the code bytes of every basic block at the time the function was decoded.
+    ULONG64 CodeHash;
+};
+
+// FunctionCodeCache:
+//
+// The cache of decoded functions for a module (symbol set) keyed by the entry point of each function.  A
+// cached function is only handed back if the hash of its code bytes still matches.  If the code has been
+// written (e.g.: patched or unpacked) since it was decoded, the entry is discarded and the caller decodes the
+// function again.
+//
+class FunctionCodeCache
+{
+public:
+
+    FunctionCodeCache() :
+        m_decodedFunctionCount(0)
+    {
+    }
+
+    // FindFunction():
+    //
+    // Finds the decoded code of the function whose entry point is at 'entryAddress'.  If the function is not
+    // cached or its code has changed, S_FALSE is returned along with an empty pointer.
+    //
+    HRESULT FindFunction(_In_ SymbolSet *pSymbolSet,
+                         _In_ ULONG64 entryAddress,
+                         _Out_ std::shared_ptr<FunctionCode const> *pFunctionCode);
+
+    // AddFunction():
+    //
+    // Computes the hash of the code bytes of a newly decoded function and adds it to the cache.  Any prior
+    // entry for the same entry point is replaced.
+    //
+    HRESULT AddFunction(_In_ SymbolSet *pSymbolSet,
+                        _In_ std::shared_ptr<FunctionCode> functionCode);
+
+    // GetDecodedFunctionCount():
+    //
+    // Gets the number of functions which have been decoded and handed to AddFunction (whether or not they could
+    // be cached).  A use of a cached function does not count.
+    //
+    ULONG64 GetDecodedFunctionCount() const
+    {
+        return m_decodedFunctionCount;
+    }
+
+private:
+
+    // ComputeCodeHash():
+    //
+    // Computes a hash of the code bytes of every basic block of a function.
+    //
+    HRESULT ComputeCodeHash(_In_ SymbolSet *pSymbolSet,
+                            _In_ FunctionCode const& functionCode,
+                            _Out_ ULONG64 *pCodeHash);
+
+    std::unordered_map<ULONG64, std::shared_ptr<FunctionCode const>> m_functions;
+    ULONG64 m_decodedFunctionCount;
+};
+
+} // SymbolBuilder
+} // Services
+} // TargetComposition
+} // Debugger
+
+#endif // __CODECACHE_H__
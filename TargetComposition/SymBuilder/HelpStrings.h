@@ -19,6 +19,7 @@
 
 #define SYMBOLBUILDER_IDS_MODULE_SYMBOLBUILDERSYMBOLS 100
 #define SYMBOLBUILDER_IDS_CREATESYMBOLS 101
+#define SYMBOLBUILDER_IDS_DELETESYMBOLS 102
 
 //*************************************************
 // Type Related Objects:
@@ -32,6 +33,13 @@
 #define SYMBOLBUILDER_IDS_SYMBOLSET_DATA 201
 #define SYMBOLBUILDER_IDS_SYMBOLSET_FUNCTIONS 202
 #define SYMBOLBUILDER_IDS_SYMBOLSET_PUBLICS 203
+#define SYMBOLBUILDER_IDS_SYMBOLSET_BEGINBATCH 204
+#define SYMBOLBUILDER_IDS_SYMBOLSET_COMMITBATCH 205
+#define SYMBOLBUILDER_IDS_SYMBOLSET_SAVE 206
+#define SYMBOLBUILDER_IDS_SYMBOLSET_FINDSYMBOLS 207
+#define SYMBOLBUILDER_IDS_SYMBOLSET_ABORTBATCH 208
+#define SYMBOLBUILDER_IDS_SYMBOLSET_CACHEINVALIDATIONCOUNT 209
+#define SYMBOLBUILDER_IDS_SYMBOLSET_DECODEDFUNCTIONCOUNT 210
 
 //
 // <SymbolSet>.Types:
@@ -153,6 +161,7 @@
 //
 
 #define SYMBOLBUILDER_IDS_FUNCTIONS_CREATE 2200
+#define SYMBOLBUILDER_IDS_FUNCTIONS_PROPAGATELIVERANGESFROMCALLINGCONVENTION 2201
 
 //
 // <Function>.*
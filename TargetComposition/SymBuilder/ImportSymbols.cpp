@@ -1412,39 +1412,11 @@ HRESULT SymbolImporter_DbgHelp::ImportSymbol(_In_ ULONG symIndex, _Out_ ULONG64
 
 bool SymbolImporter_DbgHelp::LegacyReadMemory(_Inout_ IMAGEHLP_CBA_READ_MEMORY *pReadMemory)
 {
-    auto pOwningProcess = m_pOwningSet->GetOwningProcess();
-    auto pVirtualMemory = pOwningProcess->GetVirtualMemory();
-    bool isKernel = pOwningProcess->IsKernel();
-    ULONG64 processKey = pOwningProcess->GetProcessKey();
-
-    //
-    // If we have a generalized view of the kernel and not a specific "process context", we can go and ask
-    // for the generalized kernel address context in which to perform any memory reads.
-    //
-    ComPtr<ISvcAddressContext> spAddrCtx;
-    if (isKernel && processKey == 0)
-    {
-        if (FAILED(pOwningProcess->GetSymbolBuilderManager()->GetKernelAddressContext(&spAddrCtx)))
-        {
-            return false;
-        }
-    }
-    else
-    {
-        ComPtr<ISvcProcess> spProcess;
-        if (FAILED(pOwningProcess->GetSymbolBuilderManager()->ProcessKeyToProcess(processKey, &spProcess)) ||
-            FAILED(spProcess.As(&spAddrCtx)))
-        {
-            return false;
-        }
-    }
-
     ULONG64 bytesRead;
-    HRESULT hr = pVirtualMemory->ReadMemory(spAddrCtx.Get(),
-                                            pReadMemory->addr,
-                                            pReadMemory->buf,
-                                            pReadMemory->bytes,
-                                            &bytesRead);
+    HRESULT hr = m_pOwningSet->GetOwningProcess()->ReadMemory(pReadMemory->addr,
+                                                              pReadMemory->buf,
+                                                              pReadMemory->bytes,
+                                                              &bytesRead);
 
     if (SUCCEEDED(hr))
     {
@@ -1499,6 +1471,12 @@ HRESULT SymbolImporter_DbgHelp::ImportForOffsetQuery(_In_ SvcSymbolKind searchKi
     //
     m_pOwningSet->SetCacheInvalidationDisable(true);
 
+    //
+    // An import may bring in a large number of symbols.  Defer sorting them into the address tables until
+    // the import is complete.
+    //
+    (void)m_pOwningSet->SetBulkLoad(true);
+
     auto fn = [&]()
     {
         //
@@ -1510,51 +1488,105 @@ HRESULT SymbolImporter_DbgHelp::ImportForOffsetQuery(_In_ SvcSymbolKind searchKi
         }
 
         //
-        // If we've already done this for a given offset, don't ever bother doing it again.
+        // If we've already answered a query for this offset (or for another offset which DbgHelp would have
+        // resolved the same way), don't ever bother doing it again.  Disassembly and stack walks tend to ask
+        // about many addresses within the same few functions.
         //
-        auto it = m_addressQueries.find(offset);
-        if (it != m_addressQueries.end())
+        if (IsOffsetResolved(offset))
         {
             return S_FALSE;
         }
 
+        //
+        // SymFromAddr finds the symbol with the greatest address at or below the query address.  Every offset
+        // from the start of that symbol through the query offset (as well as anything else within the symbol)
+        // resolves to the same symbol which we import now.
+        //
         ULONG64 displacement;
         if (!SymFromAddrW(m_symHandle,
                           m_moduleBase + offset,
                           &displacement,
                           m_pSymInfo))
         {
+            //
+            // A failure says nothing about any *OTHER* offset.  Callers may well ask about offsets which are
+            // outside the module entirely (e.g.: the target of a call into another module) and DbgHelp fails
+            // those the same way.  Only remember that there is no symbol at this exact offset and only if that
+            // is what DbgHelp said.  Anything else (e.g.: running out of memory) may succeed if asked again.
+            //
+            DWORD lastError = GetLastError();
+            if (lastError == ERROR_MOD_NOT_FOUND || lastError == ERROR_INVALID_ADDRESS)
+            {
+                AddResolvedRange(offset, offset + 1);
+            }
             return S_FALSE;
         }
 
         ULONG64 importedId;
         (void)ImportSymbol(m_pSymInfo, &importedId);
 
-        m_addressQueries.insert(offset);
+        ULONG64 symbolStart = offset - displacement;
+        ULONG64 symbolEnd = symbolStart + m_pSymInfo->Size;
+        if (displacement > offset || m_pSymInfo->Address != m_moduleBase + symbolStart)
+        {
+            //
+            // DbgHelp gave us something we do not understand.  Only remember the exact offset.
+            //
+            symbolStart = offset;
+            symbolEnd = offset + 1;
+        }
+
+        AddResolvedRange(symbolStart, (std::max)(symbolEnd, offset + 1));
 
         return S_OK;
     };
     HRESULT hr = ConvertException(fn);
 
+    HRESULT hrLoad = m_pOwningSet->SetBulkLoad(false);
+    if (SUCCEEDED(hr) && FAILED(hrLoad))
+    {
+        hr = hrLoad;
+    }
+
     m_pOwningSet->SetCacheInvalidationDisable(false);
     return hr;
 }
 
-HRESULT SymbolImporter_DbgHelp::ImportForNameQuery(_In_ SvcSymbolKind searchKind,
-                                                   _In_opt_ PCWSTR pwszName)
+void SymbolImporter_DbgHelp::AddResolvedRange(_In_ ULONG64 start, _In_ ULONG64 end)
 {
+    if (start >= end)
+    {
+        return;
+    }
+
     //
-    // **FOR NOW**: Do not allow a full import by name.  If there's a search for everything,
-    //              we are *NOT* going to pull the entire contents across into the symbol builder.
-    //              Yes...  that means you can do a query by name and see things that won't appear with
-    //              a global query.  It prevents a number of huge performance pains around checking
-    //              nested types or our lack of RegEx support.
+    // Find the first range which could overlap or touch [start, end) and fold every such range into the new
+    // one before inserting it.
     //
-    if (pwszName == nullptr)
+    auto it = m_resolvedRanges.upper_bound(start);
+    if (it != m_resolvedRanges.begin())
     {
-        return E_NOTIMPL;
+        auto prev = std::prev(it);
+        if (prev->second >= start)
+        {
+            it = prev;
+        }
     }
 
+    while (it != m_resolvedRanges.end() && it->first <= end)
+    {
+        start = (std::min)(start, it->first);
+        end = (std::max)(end, it->second);
+        it = m_resolvedRanges.erase(it);
+    }
+
+    m_resolvedRanges.emplace_hint(it, start, end);
+}
+
+HRESULT SymbolImporter_DbgHelp::ImportForMaskQuery(_In_ SvcSymbolKind searchKind,
+                                                   _In_opt_ PCWSTR pwszMask,
+                                                   _In_ bool maskIsRegEx)
+{
     //
     // This is happening at type query time as part of the *TARGET COMPOSITION* layer.  We 
     // *ABSOLUTELY CANNOT* send a cache invalidation at this time.  To do so might flush caches that
@@ -1562,34 +1594,18 @@ HRESULT SymbolImporter_DbgHelp::ImportForNameQuery(_In_ SvcSymbolKind searchKind
     //
     m_pOwningSet->SetCacheInvalidationDisable(true);
 
+    //
+    // An import may bring in a large number of symbols.  Defer sorting them into the address tables until
+    // the import is complete.
+    //
+    (void)m_pOwningSet->SetBulkLoad(true);
+
     auto fn = [&]()
     {
-        //
-        // If we've done a full import, don't ever bother checking again.
-        //
-        if (m_fullGlobalImport)
-        {
-            return S_FALSE;
-        }
-
-        std::wstring searchName;
-        if (pwszName != nullptr)
-        {
-            //
-            // If we've already done this for a given name, don't ever bother doing it again.
-            //
-            searchName = pwszName;
-            auto it = m_nameQueries.find(searchName);
-            if (it != m_nameQueries.end())
-            {
-                return S_FALSE;
-            }
-        }
-
         SymbolQueryCallbackInformation info { };
         info.Query.SearchKind = searchKind;
-        info.Query.SearchMask = pwszName;
-        info.Query.MaskIsRegEx = false;
+        info.Query.SearchMask = pwszMask;
+        info.Query.MaskIsRegEx = maskIsRegEx;
         info.Query.QueryOffset = 0;
         info.Importer = this;
 
@@ -1597,7 +1613,7 @@ HRESULT SymbolImporter_DbgHelp::ImportForNameQuery(_In_ SvcSymbolKind searchKind
         {
             if (!SymEnumSymbolsExW(m_symHandle,
                                    m_moduleBase,
-                                   pwszName,
+                                   pwszMask,
                                    &SymbolImporter_DbgHelp::LegacySymbolEnumerateBridge,
                                    reinterpret_cast<void *>(&info),
                                    SYMENUM_OPTIONS_DEFAULT))
@@ -1610,7 +1626,7 @@ HRESULT SymbolImporter_DbgHelp::ImportForNameQuery(_In_ SvcSymbolKind searchKind
         {
             if (!SymEnumTypesByNameW(m_symHandle,
                                      m_moduleBase,
-                                     pwszName,
+                                     pwszMask,
                                      &SymbolImporter_DbgHelp::LegacySymbolEnumerateBridge,
                                      reinterpret_cast<void *>(&info)))
             {
@@ -1618,21 +1634,100 @@ HRESULT SymbolImporter_DbgHelp::ImportForNameQuery(_In_ SvcSymbolKind searchKind
             }
         }
 
-        if (pwszName != nullptr)
+        return S_OK;
+    };
+    HRESULT hr = ConvertException(fn);
+
+    HRESULT hrLoad = m_pOwningSet->SetBulkLoad(false);
+    if (SUCCEEDED(hr) && FAILED(hrLoad))
+    {
+        hr = hrLoad;
+    }
+
+    m_pOwningSet->SetCacheInvalidationDisable(false);
+    return hr;
+}
+
+HRESULT SymbolImporter_DbgHelp::ImportForNameQuery(_In_ SvcSymbolKind searchKind,
+                                                   _In_opt_ PCWSTR pwszName)
+{
+    //
+    // **FOR NOW**: Do not allow a full import by name.  If there's a search for everything,
+    //              we are *NOT* going to pull the entire contents across into the symbol builder.
+    //              Yes...  that means you can do a query by name and see things that won't appear with
+    //              a global query.  It prevents a number of huge performance pains around checking
+    //              nested types.
+    //
+    if (pwszName == nullptr)
+    {
+        return E_NOTIMPL;
+    }
+
+    //
+    // If we've done a full import or already done this for a given name, don't ever bother doing it again.
+    //
+    if (m_fullGlobalImport)
+    {
+        return S_FALSE;
+    }
+
+    //
+    // We cannot let a C++ exception escape.
+    //
+    auto fn = [&]()
+    {
+        std::wstring searchName = pwszName;
+        if (m_nameQueries.find(searchName) != m_nameQueries.end())
+        {
+            return S_FALSE;
+        }
+
+        HRESULT hr = ImportForMaskQuery(searchKind, pwszName, false);
+        if (hr == S_OK)
         {
             m_nameQueries.insert(searchName);
         }
-        else
+        return hr;
+    };
+    return ConvertException(fn);
+}
+
+HRESULT SymbolImporter_DbgHelp::ImportForRegExQuery(_In_ SvcSymbolKind searchKind,
+                                                    _In_opt_ PCWSTR pwszRegEx)
+{
+    //
+    // A pattern which starts with a wildcard is, for all intents and purposes, a full import.  Refuse it
+    // for the same reason we refuse a full import by name.
+    //
+    if (pwszRegEx == nullptr || *pwszRegEx == L'*' || *pwszRegEx == L'?')
+    {
+        return E_NOTIMPL;
+    }
+
+    if (m_fullGlobalImport)
+    {
+        return S_FALSE;
+    }
+
+    //
+    // We cannot let a C++ exception escape.
+    //
+    auto fn = [&]()
+    {
+        std::wstring searchPattern = pwszRegEx;
+        if (m_patternQueries.find(searchPattern) != m_patternQueries.end())
         {
-            m_fullGlobalImport = true;
+            return S_FALSE;
         }
 
-        return S_OK;
+        HRESULT hr = ImportForMaskQuery(searchKind, pwszRegEx, true);
+        if (hr == S_OK)
+        {
+            m_patternQueries.insert(searchPattern);
+        }
+        return hr;
     };
-    HRESULT hr = ConvertException(fn);
-
-    m_pOwningSet->SetCacheInvalidationDisable(false);
-    return hr;
+    return ConvertException(fn);
 }
 
 } // SymbolBuilder
@@ -164,7 +164,8 @@ public:
     // ImportForRegExQuery():
     //
     // Imports the necessary symbols to handle a regex query.  If the necessary imports have already occurred,
-    // this method may return S_FALSE and do nothing. 
+    // this method may return S_FALSE and do nothing.  The "regex" is a wildcard pattern in which '*' matches
+    // any sequence of characters and '?' matches any single character.
     //
     virtual HRESULT ImportForRegExQuery(_In_ SvcSymbolKind searchKind,
                                         _In_opt_ PCWSTR pwszRegEx) =0;
@@ -253,13 +254,11 @@ public:
     // ImportForRegExQuery():
     //
     // Imports the necessary symbols to handle a regex query.  If the necessary imports have already occurred,
-    // this method may return S_FALSE and do nothing. 
+    // this method may return S_FALSE and do nothing.  The "regex" is a wildcard pattern which is handed to
+    // DbgHelp as a search mask.
     //
-    virtual HRESULT ImportForRegExQuery(_In_ SvcSymbolKind /*searchKind*/,
-                                        _In_opt_ PCWSTR /*pwszRegEx*/)
-    {
-        return S_FALSE;
-    }
+    virtual HRESULT ImportForRegExQuery(_In_ SvcSymbolKind searchKind,
+                                        _In_opt_ PCWSTR pwszRegEx);
 
     // GetImporterDescription():
     //
@@ -318,6 +317,36 @@ private:
     //
     HRESULT InternalConnectToSource();
 
+    // ImportForMaskQuery():
+    //
+    // Imports every symbol matching a DbgHelp search mask (or everything if there is no mask).  This is
+    // the shared implementation of name and wildcard queries.  The caller is responsible for memoizing the query.
+    //
+    HRESULT ImportForMaskQuery(_In_ SvcSymbolKind searchKind, _In_opt_ PCWSTR pwszMask, _In_ bool maskIsRegEx);
+
+    // IsOffsetResolved():
+    //
+    // Indicates whether an offset query has already been answered: the offset falls within the range of a
+    // symbol which was already imported or is an offset at which DbgHelp has already said there is no symbol.
+    //
+    bool IsOffsetResolved(_In_ ULONG64 offset) const
+    {
+        auto it = m_resolvedRanges.upper_bound(offset);
+        if (it == m_resolvedRanges.begin())
+        {
+            return false;
+        }
+        --it;
+        return offset < it->second;
+    }
+
+    // AddResolvedRange():
+    //
+    // Records that offset queries within [start, end) have been answered.  Overlapping and adjacent ranges
+    // are merged.
+    //
+    void AddResolvedRange(_In_ ULONG64 start, _In_ ULONG64 end);
+
     //********************
     // General Symbol Import:
     //
@@ -563,9 +592,13 @@ private:
 
     bool m_fullGlobalImport;
     std::unordered_set<std::wstring> m_nameQueries;
-    std::unordered_set<ULONG64> m_addressQueries;
+    std::unordered_set<std::wstring> m_patternQueries;
     std::unordered_map<ULONG, ULONG64> m_importedIndexMap;
 
+    // The module offsets for which offset queries have been answered (see IsOffsetResolved): a map of disjoint
+    // ranges from the start of each range to its end.
+    std::map<ULONG64, ULONG64> m_resolvedRanges;
+
 };
 
 } // SymbolBuilder
@@ -38,7 +38,9 @@ bool LocationsAreEquivalent(_In_ const SvcSymbolLocation &a, _In_ const SvcSymbo
             a.Offset == b.Offset);
 }
 
-RangeBuilder::RangeBuilder()
+RangeBuilder::RangeBuilder() :
+    m_pSymbolSet(nullptr),
+    m_pFunction(nullptr)
 {
     //
     // Go and create an instance of the disassembler we can use for our walk of the disassembly.  This
@@ -51,7 +53,7 @@ RangeBuilder::RangeBuilder()
 
 ULONG RangeBuilder::GetBaseRegister(_In_ ULONG canonId)
 {
-    auto pSymManager = m_pFunction->InternalGetSymbolSet()->GetSymbolBuilderManager();
+    auto pSymManager = m_pSymbolSet->GetSymbolBuilderManager();
     for(;;)
     {
         RegisterInformation *pRegInfo;
@@ -75,7 +77,7 @@ ULONG RangeBuilder::GetCanonicalRegisterId(_In_ Object regObj)
         // If we haven't seen this register yet, we need to look it up by NAME.
         //
         std::wstring regName = regObj.ToDisplayString();
-        auto pSymManager = m_pFunction->InternalGetSymbolSet()->GetSymbolBuilderManager();
+        auto pSymManager = m_pSymbolSet->GetSymbolBuilderManager();
 
         RegisterInformation *pRegInfo;
         CheckHr(pSymManager->FindInformationForRegister(regName.c_str(), &pRegInfo));
@@ -147,12 +149,10 @@ bool RangeBuilder::UsesRegister(_In_ SvcSymbolLocation const& location, _In_ ULO
     return false;
 }
 
-bool RangeBuilder::CheckAddAlias(_In_ ULONG64 instrAddr,
-                                 _In_ ULONG64 instrLen,
-                                 _In_ OperandInfo const& outputInfo,
+bool RangeBuilder::CheckAddAlias(_In_ OperandInfo const& outputInfo,
                                  _In_ OperandInfo const& inputInfo,
-                                 _In_ LocationRange const& lr,
-                                 _Inout_ ParameterRanges& ranges)
+                                 _In_ SvcSymbolLocation const& location,
+                                 _Out_ SvcSymbolLocation *pAliasLocation)
 {
     SvcSymbolLocation inputLoc;
     SvcSymbolLocation outputLoc;
@@ -162,13 +162,10 @@ bool RangeBuilder::CheckAddAlias(_In_ ULONG64 instrAddr,
     //    like mov rdx, rcx.  This would alias rdx to rcx.
     //
     if (OperandToLocation(inputInfo, &inputLoc) && 
-        LocationsAreEquivalent(lr.ParamLocation.ParamLocation, inputLoc) &&
+        LocationsAreEquivalent(location, inputLoc) &&
         OperandToLocation(outputInfo, &outputLoc))
     {
-        ranges.push_back({ instrAddr + instrLen, 
-                           instrAddr + instrLen, 
-                           { outputLoc, lr.ParamLocation.TraversalCountSlot }, 
-                           LiveState::Live });
+        *pAliasLocation = outputLoc;
         return true;
     }
 
@@ -182,15 +179,12 @@ bool RangeBuilder::CheckAddAlias(_In_ ULONG64 instrAddr,
              ((inputInfo.Flags & OperandImmediate) != 0) &&
              ((inputInfo.Flags & OperandMemory) == 0) &&
              outputInfo.Regs[0] == inputInfo.Regs[0] &&
-             lr.ParamLocation.ParamLocation.Kind == SvcSymbolLocationRegisterRelative &&
-             UsesRegister(lr.ParamLocation.ParamLocation, outputInfo.Regs[0]))
+             location.Kind == SvcSymbolLocationRegisterRelative &&
+             UsesRegister(location, outputInfo.Regs[0]))
     {
-        SvcSymbolLocation newLoc = lr.ParamLocation.ParamLocation;
+        SvcSymbolLocation newLoc = location;
         newLoc.Offset = static_cast<ULONG64>(static_cast<LONG64>(newLoc.Offset) - inputInfo.ConstantValue);
-        ranges.push_back({ instrAddr + instrLen, 
-                           instrAddr + instrLen, 
-                           { newLoc, lr.ParamLocation.TraversalCountSlot }, 
-                           LiveState::Live });
+        *pAliasLocation = newLoc;
         return true;
     }
 
@@ -202,26 +196,23 @@ bool RangeBuilder::CheckAddAlias(_In_ ULONG64 instrAddr,
     else if (((outputInfo.Flags & OperandRegister) != 0) &&
              ((inputInfo.Flags & (OperandRegister | OperandImmediate)) != 0) &&
              ((inputInfo.Flags & OperandMemory) == 0) &&
-             lr.ParamLocation.ParamLocation.Kind == SvcSymbolLocationRegisterRelative &&
+             location.Kind == SvcSymbolLocationRegisterRelative &&
              inputInfo.Regs[0] != NoRegister && 
-             UsesRegister(lr.ParamLocation.ParamLocation, inputInfo.Regs[0]))
+             UsesRegister(location, inputInfo.Regs[0]))
     {
         SvcSymbolLocation newLoc;
         newLoc.Kind = SvcSymbolLocationRegisterRelative;
         newLoc.RegInfo.Number = outputInfo.Regs[0];
         newLoc.RegInfo.Size = 8;                                // pointer-sized memory ref
-        newLoc.Offset = static_cast<ULONG64>(lr.ParamLocation.ParamLocation.Offset - inputInfo.ConstantValue);
-        ranges.push_back({ instrAddr + instrLen, 
-                           instrAddr + instrLen, 
-                           { newLoc, lr.ParamLocation.TraversalCountSlot }, 
-                           LiveState::Live });
+        newLoc.Offset = static_cast<ULONG64>(location.Offset - inputInfo.ConstantValue);
+        *pAliasLocation = newLoc;
         return true;
     }
 
     return false;
 }
 
-bool RangeBuilder::CheckForKill(_In_ OperandInfo const& opInfo, _In_ LocationRange const &lr)
+bool RangeBuilder::CheckForKill(_In_ OperandInfo const& opInfo, _In_ SvcSymbolLocation const& location)
 {
     //
     // If the destination is a register and the live range uses that register, it is a kill.  Note that this
@@ -253,7 +244,7 @@ bool RangeBuilder::CheckForKill(_In_ OperandInfo const& opInfo, _In_ LocationRan
     {
         if ((opInfo.Flags & (OperandRegister | OperandMemory)) == OperandRegister)
         {
-            if (UsesRegister(lr.ParamLocation.ParamLocation, opInfo.Regs[0]))
+            if (UsesRegister(location, opInfo.Regs[0]))
             {
                 return true;
             }
@@ -392,7 +383,7 @@ void RangeBuilder::GetInstructionInfo(_In_ Object& instr, _Out_ InstructionInfo
     }
 }
 
-RangeBuilder::OperandInfo const *RangeBuilder::FindFirstInput(_In_ InstructionInfo const& instructionInfo)
+OperandInfo const *RangeBuilder::FindFirstInput(_In_ InstructionInfo const& instructionInfo)
 {
     for (size_t i = 0; i < instructionInfo.NumOperands; ++i)
     {
@@ -404,7 +395,7 @@ RangeBuilder::OperandInfo const *RangeBuilder::FindFirstInput(_In_ InstructionIn
     return nullptr;
 }
 
-RangeBuilder::OperandInfo const *RangeBuilder::FindFirstOutput(_In_ InstructionInfo const& instructionInfo)
+OperandInfo const *RangeBuilder::FindFirstOutput(_In_ InstructionInfo const& instructionInfo)
 {
     for (size_t i = 0; i < instructionInfo.NumOperands; ++i)
     {
@@ -416,7 +407,7 @@ RangeBuilder::OperandInfo const *RangeBuilder::FindFirstOutput(_In_ InstructionI
     return nullptr;
 }
 
-RangeBuilder::OperandInfo const *RangeBuilder::FindFirstImmediate(_In_ InstructionInfo const& instructionInfo)
+OperandInfo const *RangeBuilder::FindFirstImmediate(_In_ InstructionInfo const& instructionInfo)
 {
     for (size_t i = 0; i < instructionInfo.NumOperands; ++i)
     {
@@ -429,536 +420,674 @@ RangeBuilder::OperandInfo const *RangeBuilder::FindFirstImmediate(_In_ Instructi
     return nullptr;
 }
 
-bool RangeBuilder::CarryoverLiveRange(_In_ BasicBlockInfo& bbTo,
-                                      _In_ size_t paramNum,
-                                      _In_ LocationRange const& liveRange)
+RecognizedInstruction RangeBuilder::GetRecognizedInstruction(_In_ std::wstring const& mnemonic)
 {
-    bool matched = false;
-    ULONG64 bbToStart = bbTo.StartAddress;
-
-    ParameterRanges& pr = bbTo.BlockParameterRanges[paramNum];
-    for (size_t i = 0; i < pr.size(); ++i)
+    if (wcscmp(mnemonic.c_str(), L"mov") == 0) { return RecognizedInstruction::Mov; }
+    if (wcscmp(mnemonic.c_str(), L"push") == 0) { return RecognizedInstruction::Push; }
+    if (wcscmp(mnemonic.c_str(), L"pop") == 0) { return RecognizedInstruction::Pop; }
+    if (wcscmp(mnemonic.c_str(), L"add") == 0) { return RecognizedInstruction::Add; }
+    if (wcscmp(mnemonic.c_str(), L"sub") == 0) { return RecognizedInstruction::Sub; }
+    if (wcscmp(mnemonic.c_str(), L"lea") == 0) { return RecognizedInstruction::Lea; }
+    else
     {
-        LocationRange &lrTo = pr[i];
-        if (lrTo.StartAddress == bbTo.StartAddress)
-        {
-            //
-            // Is this the same...?
-            //
-            if (LocationsAreEquivalent(lrTo.ParamLocation.ParamLocation, liveRange.ParamLocation.ParamLocation))
-            {
-                matched = true;
-                bbTo.TraversalCountSlots[lrTo.ParamLocation.TraversalCountSlot]++;
-            }
-        }
+        return RecognizedInstruction::Unknown;
     }
+}
 
-    if (!matched)
+void RangeBuilder::ReduceInstruction(_In_ size_t blockIndex, _In_ size_t instrIndex, _Out_ InstructionTransfer *pTransfer)
+{
+    auto pSymManager = m_pSymbolSet->GetSymbolBuilderManager();
+    ULONG spId = m_pConvention->GetSpId();
+    InstructionInfo const& curInstr = m_bbInfo[blockIndex].Code->Instructions[instrIndex];
+
+    pTransfer->Reduced = true;
+    pTransfer->HasImplicit = false;
+    pTransfer->MovCount = 0;
+    pTransfer->Locations.clear();
+
+    //
+    // A call neither has implicit operands nor aliases anything.  What it does to a location depends only on the
+    // calling convention.
+    //
+    if (curInstr.IsCall)
     {
-        bbTo.TraversalCountSlots.push_back(1);
-        size_t traversalCountSlot = bbTo.TraversalCountSlots.size() - 1;
-
-        pr.push_back(
-            { 
-                bbTo.StartAddress,                  // [StartAddress, StartAddress) -- "empty" until traversed
-                bbTo.StartAddress,
-                { liveRange.ParamLocation.ParamLocation, traversalCountSlot },
-                LiveState::Live
-            });
+        return;
     }
 
-    return !matched;
-}
-
-bool RangeBuilder::CarryoverLiveRanges(_In_ BasicBlockInfo& bbFrom, 
-                                       _In_ BasicBlockInfo& bbTo,
-                                       _In_ TraversalEntry const& entry)
-{
-    bool firstEntry = (bbTo.TraversalCount == 0);
-    bool changedRanges = false;
+    OperandInfo const *pInput = FindFirstInput(curInstr);
+    OperandInfo const *pOutput = FindFirstOutput(curInstr);
+    OperandInfo const *pImmediate = FindFirstImmediate(curInstr);
 
     //
-    // If this is the first entry into this basic block, initialize the parameter lists.
+    // Are there implicit operands we need to deal with.  A "push rcx" instruction, for instance, will
+    // only have "rcx" as an operand but there is an implicit write to "rsp" in doing so.
     //
-    if (firstEntry)
+    switch(curInstr.Instr)
     {
-        bbTo.BlockParameterRanges.resize(bbFrom.BlockParameterRanges.size());
+        case RecognizedInstruction::Push:
+        case RecognizedInstruction::Pop:
+            BuildOperand(spId, true, pTransfer->Implicit);
+            pTransfer->HasImplicit = true;
+            break;
+        default:
+            break;
     }
 
     //
-    // Find every parameter live range in bbFrom at entry.SourceBlockInstructionAddress and compare it against
-    // what's already in bbTo.  If necessary, add or modify ranges in bbTo.
+    // Deal with any instruction level semantics that might cause aliasing or other such semantics...
+    //
+    // Each recognized instruction is considered as (up to two) equivalent movs.  Every location which is
+    // live before the instruction is later checked against each of those movs for aliasing.
     //
-    for (size_t p = 0; p < bbFrom.BlockParameterRanges.size(); ++p)
+    OperandInfo op1, op2, op3;
+    OperandInfo const *pMovOutputs[2] = { nullptr, nullptr };
+    OperandInfo const *pMovInputs[2] = { nullptr, nullptr };
+    size_t movCount = 0;
+
+    switch(curInstr.Instr)
     {
-        ParameterRanges& pr = bbFrom.BlockParameterRanges[p];
-        for (size_t i = 0; i < pr.size(); ++i)
+        case RecognizedInstruction::Mov:
+        {
+            pMovOutputs[0] = pOutput;
+            pMovInputs[0] = pInput;
+            movCount = 1;
+            break;
+        }
+
+        case RecognizedInstruction::Lea:
+        {
+            //
+            // Slightly different semantic.  Instead of:
+            //
+            //     lea x, [y + z]
+            //
+            // Consider:
+            //
+            //     mov x, y + z
+            //
+            // And generate the appropriate aliasing for such.
+            //
+            op1 = *pInput;
+            op1.Flags &= ~OperandMemory;
+            op1.Flags |= OperandRegister | OperandImmediate;
+            pMovOutputs[0] = pOutput;
+            pMovInputs[0] = &op1;
+            movCount = 1;
+            break;
+        }
+
+        case RecognizedInstruction::Push:
+        {
+            //
+            // Slightly different semantic.  Instead of:
+            //
+            //     push x
+            //
+            // Consider:
+            //
+            //     sub rsp, 8           ==> mov rsp, rsp - 8
+            //     mov [rsp], x
+            //
+            // And generate the appropriate aliasing for such
+            //
+            BuildOperand(spId, true, op1);                              // in: rsp
+            BuildOperand(spId, false, op2, -8);                         // in: rsp - 8
+            BuildOperand(spId, false, op3, 0, true);                    // out: [rsp]
+            pMovOutputs[0] = &op1;
+            pMovInputs[0] = &op2;
+            pMovOutputs[1] = &op3;
+            pMovInputs[1] = pInput;
+            movCount = 2;
+            break;
+        }
+
+        case RecognizedInstruction::Pop:
         {
             //
-            // Does pr[i] include the one byte at entry.SourceBlockInstructionAddress...?
+            // Slightly different semantic.  Instead of:
+            //
+            //     pop x
+            //
+            // Consider:
+            //
+            //     mov x, [rsp]
+            //     add rsp, 8           ==> mov rsp, rsp + 8
+            //
+            BuildOperand(spId, false, op1, 0, true);                    // in: [rsp]
+            BuildOperand(spId, true, op2);                              // out: rsp
+            BuildOperand(spId, false, op3, 8);                          // in: rsp + 8
+            pMovOutputs[0] = pOutput;
+            pMovInputs[0] = &op1;
+            pMovOutputs[1] = &op2;
+            pMovInputs[1] = &op3;
+            movCount = 2;
+            break;
+        }
+
+        case RecognizedInstruction::Sub:
+        case RecognizedInstruction::Add:
+        {
             //
-            LocationRange const& lr = pr[i];
-            if (lr.StartAddress <= entry.SourceBlockInstructionAddress &&
-                lr.EndAddress > entry.SourceBlockInstructionAddress &&
-                lr.State == LiveState::LiveAtEndOfBlock)
+            // There are some very recognizable patterns around __chkstk which will seriously
+            // impact our ability to propagate parameter ranges without a deep understanding
+            // of the semantics of the method.  We will specially encode this hand-assembly
+            // coded function that appears in many places and this pattern:
+            //
+            //     mov [eax/rax], <size>
+            //     call __chkstk
+            //     sub rsp, rax
+            //
+            // We will instead rewrite the sub instruction (for the purposes of aliasing) as:
+            //
+            //     sub rsp, <size>
+            //
+            // If we recognize this pattern and symbol.
+            //
+            if (pOutput && !pImmediate && pInput == pOutput &&
+                curInstr.NumOperands == 2 &&
+                curInstr.Instr == RecognizedInstruction::Sub &&
+                (curInstr.Operands[1].Flags & (OperandRegister | OperandInput | OperandMemory)) ==
+                    (OperandRegister | OperandInput) &&
+                pOutput->Regs[0] == spId)
             {
-                changedRanges = CarryoverLiveRange(bbTo, p, lr);
+                //
+                // At this point, we've seen a sub rsp, <register>.  Look for the pattern.
+                //
+                InstructionInfo const *pNMinus1 = GetPreviousInstructionN(blockIndex, instrIndex, 1);
+                InstructionInfo const *pNMinus2 = GetPreviousInstructionN(blockIndex, instrIndex, 2);
+
+                if (pNMinus1 && pNMinus2 &&
+                    pNMinus2->Address + pNMinus2->Length == pNMinus1->Address &&
+                    pNMinus1->Address + pNMinus1->Length == curInstr.Address &&
+                    pNMinus2->Instr == RecognizedInstruction::Mov &&
+                    pNMinus1->IsCall)
+                {
+                    //
+                    // At this point, we have a recognized
+                    //
+                    // mov <reg1>, <size>
+                    // call <something>
+                    // sub rsp, <reg2>
+                    //
+                    OperandInfo const *pOutputNMinus2 = FindFirstOutput(*pNMinus2);
+                    OperandInfo const *pImmNMinus2 = FindFirstImmediate(*pNMinus2);
+                    OperandInfo const *pImmNMinus1 = FindFirstImmediate(*pNMinus1);
+                    if (pImmNMinus2 && pOutputNMinus2 && pImmNMinus1)
+                    {
+                        RegisterInformation *pSrc;
+                        RegisterInformation *pDest;
+                        CheckHr(pSymManager->FindInformationForRegisterById(pOutputNMinus2->Regs[0], &pSrc));
+                        CheckHr(pSymManager->FindInformationForRegisterById(curInstr.Operands[1].Regs[0], &pDest));
+
+                        if (pOutputNMinus2->Regs[0] == curInstr.Operands[1].Regs[0] ||
+                            GetBaseRegister(pOutputNMinus2->Regs[0]) == curInstr.Operands[1].Regs[0])
+                        {
+                            bool isChkStk = false;
+                            ULONG64 offs = pImmNMinus1->ConstantValue - m_modBase;
+                            ComPtr<ISvcSymbol> spSymbol;
+                            ULONG64 displacement;
+                            HRESULT hrSym = m_pSymbolSet->FindSymbolByOffset(offs,
+                                                                             true,
+                                                                             &spSymbol,
+                                                                             &displacement);
+                            if (SUCCEEDED(hrSym) && displacement == 0)
+                            {
+                                BSTR symName;
+                                if (SUCCEEDED(spSymbol->GetName(&symName)))
+                                {
+                                    isChkStk = (wcscmp(symName, L"__chkstk") == 0);
+                                    SysFreeString(symName);
+                                }
+                            }
+
+                            if (isChkStk)
+                            {
+                                //
+                                // We've recognized the pattern.  Substitute the <reg2> with
+                                // the immediate from the mov <reg1>, <size> for the purposes
+                                // of handling the sub.
+                                //
+                                op2 = *pImmNMinus2;
+                                pImmediate = &op2;
+                            }
+                        }
+                    }
+                }
             }
+
+            //
+            // Slightly different semantic.  Instead of:
+            //
+            //     add x, y
+            //
+            // Consider:
+            //
+            //     mov x, x + y
+            //
+            // And generate the appropriate aliasing for such (assuming that 'y' is an
+            // immediate and 'x' is a register)
+            //
+            // Note that the first operand "x" will be Input | Output.  Find the immediate only
+            // operand if such exists.
+            //
+            if (pOutput && pImmediate && pInput == pOutput &&
+                (pOutput->Flags & (OperandRegister | OperandMemory)) == OperandRegister)
+            {
+                op1 = *pOutput;
+                op1.ConstantValue = (curInstr.Instr == RecognizedInstruction::Add ?
+                                         pImmediate->ConstantValue : -pImmediate->ConstantValue);
+                op1.Flags |= OperandImmediate;
+                pMovOutputs[0] = pOutput;
+                pMovInputs[0] = &op1;
+                movCount = 1;
+            }
+
+            break;
         }
+
+        default:
+            break;
     }
 
-    return (changedRanges && !firstEntry);
+    for (size_t m = 0; m < movCount; ++m)
+    {
+        if (pMovOutputs[m] != nullptr && pMovInputs[m] != nullptr)
+        {
+            pTransfer->MovOutputs[pTransfer->MovCount] = *(pMovOutputs[m]);
+            pTransfer->MovInputs[pTransfer->MovCount] = *(pMovInputs[m]);
+            ++pTransfer->MovCount;
+        }
+    }
 }
 
-RangeBuilder::RecognizedInstruction RangeBuilder::GetRecognizedInstruction(_In_ std::wstring const& mnemonic)
+RangeBuilder::LocationTransfer RangeBuilder::GetLocationTransfer(_In_ InstructionInfo const& curInstr,
+                                                                 _Inout_ InstructionTransfer& transfer,
+                                                                 _In_ size_t locationIndex)
 {
-    if (wcscmp(mnemonic.c_str(), L"mov") == 0) { return RecognizedInstruction::Mov; }
-    if (wcscmp(mnemonic.c_str(), L"push") == 0) { return RecognizedInstruction::Push; }
-    if (wcscmp(mnemonic.c_str(), L"pop") == 0) { return RecognizedInstruction::Pop; }
-    if (wcscmp(mnemonic.c_str(), L"add") == 0) { return RecognizedInstruction::Add; }
-    if (wcscmp(mnemonic.c_str(), L"sub") == 0) { return RecognizedInstruction::Sub; }
-    if (wcscmp(mnemonic.c_str(), L"lea") == 0) { return RecognizedInstruction::Lea; }
-    else
+    if (locationIndex >= transfer.Locations.size())
     {
-        return RecognizedInstruction::Unknown;
+        transfer.Locations.resize(locationIndex + 1);
     }
-}
 
-void RangeBuilder::UpdateRangesForInstruction(_In_ BasicBlockInfo& block, _In_ Object instr)
-{
-    auto pSymbolSet = m_pFunction->InternalGetSymbolSet();
-    auto pSymManager = pSymbolSet->GetSymbolBuilderManager();
-    ULONG spId = m_pConvention->GetSpId();
+    if (transfer.Locations[locationIndex].Computed)
+    {
+        return transfer.Locations[locationIndex];
+    }
 
-    InstructionInfo curInstr;
-    GetInstructionInfo(instr, &curInstr);
+    //
+    // Note that the location is copied.  Finding the index of an alias may add to (and reallocate) m_locations.
+    //
+    SvcSymbolLocation const location = m_locations[locationIndex];
+
+    LocationTransfer result;
+    result.Computed = true;
+    result.Killed = false;
+    result.Aliases[0] = result.Aliases[1] = NoLocationIndex;
 
     if (curInstr.IsCall)
     {
         //
-        // A call is only guaranteed to preserve registers which are non-volatile by calling convention.
-        // Go through any parameter register ranges which are currently live as of this instruction in this basic 
-        // block and only carry forward ones which are held by non-volatiles.
+        // A call is only guaranteed to preserve registers which are non-volatile by calling convention.  Any
+        // parameter register location which is not held by a non-volatile is dead as of this instruction.  Do not
+        // carry it forward past the end of this instruction.
         //
-        for (size_t p = 0; p < block.BlockParameterRanges.size(); ++p)
-        {
-            ParameterRanges& pr = block.BlockParameterRanges[p];
-            for (size_t i = 0; i < pr.size(); ++i)
-            {
-                LocationRange &lr = pr[i];
-                if (lr.State == LiveState::Live &&
-                    (lr.ParamLocation.ParamLocation.Kind == SvcSymbolLocationRegister ||
-                     lr.ParamLocation.ParamLocation.Kind == SvcSymbolLocationRegisterRelative))
-                {
-                    ULONG regRefId = lr.ParamLocation.ParamLocation.RegInfo.Number;
-                    if (!m_pConvention->IsNonVolatile(regRefId))
-                    {
-                        //
-                        // This range is now dead as of this instruction.  Do not carry it forward past the
-                        // end of this instruction.
-                        //
-                        lr.State = LiveState::MarkedForKill;
-                    }
-                    lr.EndAddress += curInstr.Length;
-                }
-            }
-        }
+        result.Killed = ((location.Kind == SvcSymbolLocationRegister ||
+                          location.Kind == SvcSymbolLocationRegisterRelative) &&
+                         !m_pConvention->IsNonVolatile(location.RegInfo.Number));
 
         //
-        // @TODO: We need to ask something about how many caller pushed arguments the callee restores so we can
-        //        adjust aliasing as needed for this.   For now, we simply assume there aren't any...  which means
-        //        that stack referenced arguments will be wrong after a call which has stack based arguments that
-        //        the callee pops.
+        // KNOWN LIMITATION: The stack pointer is assumed to be the same after the call as before it.  A callee
+        // which pops caller pushed arguments on return would leave every stack pointer relative location wrong
+        // after the call.  That cannot happen with the only calling convention we understand (Windows AMD64,
+        // where the caller always cleans up) and there is nothing here which tells us how many bytes a callee
+        // pops.  Adding a convention where callees do (e.g.: x86 __stdcall) must deal with this.
         //
     }
     else
     {
-        OperandInfo implicit;
-        OperandInfo const *pImplicit = nullptr;
-        OperandInfo const *pInput = FindFirstInput(curInstr);
-        OperandInfo const *pOutput = FindFirstOutput(curInstr);
-        OperandInfo const *pImmediate = FindFirstImmediate(curInstr);
+        for (size_t o = 0; o < curInstr.NumOperands && !result.Killed; ++o)
+        {
+            result.Killed = CheckForKill(curInstr.Operands[o], location);
+        }
 
         //
-        // Are there implicit operands we need to deal with.  A "push rcx" instruction, for instance, will
-        // only have "rcx" as an operand but there is an implicit write to "rsp" in doing so.
+        // The "implicit operand" if any might cause a kill too.  For instance, a "push rcx" would implicitly
+        // alter rsp and kill any references that are at [rsp + N].  We would later recognize the creation of an
+        // alias to [rsp + N + M]
         //
-        switch(curInstr.Instr)
+        if (!result.Killed && transfer.HasImplicit)
         {
-            case RecognizedInstruction::Push:
-            case RecognizedInstruction::Pop:
-                BuildOperand(spId, true, implicit);
-                pImplicit = &implicit;
-                break;
-            default:
-                break;
+            result.Killed = CheckForKill(transfer.Implicit, location);
         }
 
-        //
-        // Look at all ranges that are presently live up to this instruction within this basic block 
-        // and see if they are live after this instruction.
-        //
-        for (size_t p = 0; p < block.BlockParameterRanges.size(); ++p)
+        for (size_t m = 0; m < transfer.MovCount; ++m)
         {
-            ParameterRanges& pr = block.BlockParameterRanges[p];
-            for (size_t i = 0; i < pr.size(); ++i)
+            SvcSymbolLocation aliasLoc;
+            if (CheckAddAlias(transfer.MovOutputs[m], transfer.MovInputs[m], location, &aliasLoc))
             {
-                LocationRange &lr = pr[i];
-                if (lr.State == LiveState::Live)
-                {
-                    for (size_t o = 0; o < curInstr.NumOperands; ++o)
-                    {
-                        OperandInfo& opInfo = curInstr.Operands[o];
-                        if (CheckForKill(opInfo, lr))
-                        {
-                            lr.State = LiveState::MarkedForKill;
-                        }
-                    }
+                result.Aliases[m] = GetLocationIndex(aliasLoc);
+            }
+        }
+    }
 
-                    //
-                    // The "implicit operand" if any might cause a kill too.  For instance, a "push rcx" would
-                    // implicitly alter rsp and kill any references that are at [rsp + N].  We would later recognize
-                    // the creation of an alias to [rsp + N + M]
-                    //
-                    if (pImplicit != nullptr && CheckForKill(*pImplicit, lr))
-                    {
-                        lr.State = LiveState::MarkedForKill;
-                    }
+    transfer.Locations[locationIndex] = result;
+    return result;
+}
 
-                    lr.EndAddress += curInstr.Length;
-                }
-            }
+void RangeBuilder::UpdateLocationsForInstruction(_In_ InstructionInfo const& curInstr,
+                                                 _Inout_ InstructionTransfer& transfer,
+                                                 _Inout_ LocationSet& liveLocations)
+{
+    size_t paramCount = m_parameters.size();
+
+    m_killBits.clear();
+    m_genBits.clear();
+
+    //
+    // Look at all locations that are presently live as of this instruction and see if they are live after this
+    // instruction and what they are aliased to.  None of this depends on which parameter is in the location, so
+    // it is only ever figured out once per instruction and location.
+    //
+    for (size_t bit = liveLocations.FindNext(0); bit != NoLocationBit; bit = liveLocations.FindNext(bit + 1))
+    {
+        size_t paramNum = bit % paramCount;
+        LocationTransfer locTransfer = GetLocationTransfer(curInstr, transfer, bit / paramCount);
+
+        if (locTransfer.Killed)
+        {
+            m_killBits.push_back(bit);
         }
 
-        //
-        // Deal with any instruction level semantics that might cause aliasing or other such semantics...
-        //
-        if (curInstr.Instr != RecognizedInstruction::Unknown)
+        for (size_t a = 0; a < ARRAYSIZE(locTransfer.Aliases); ++a)
         {
-            for (size_t p = 0; p < block.BlockParameterRanges.size(); ++p)
+            if (locTransfer.Aliases[a] != NoLocationIndex)
             {
-                bool handled = false;
-                ParameterRanges& pr = block.BlockParameterRanges[p];
-                for (size_t i = 0; i < pr.size(); ++i)
-                {
-                    LocationRange &lr = pr[i];
-                    if (lr.State != LiveState::Dead && lr.State != LiveState::LiveAtEndOfBlock &&
-                        curInstr.Address >= lr.StartAddress && curInstr.Address < lr.EndAddress)
-                    {
-                        OperandInfo op1, op2, op3;
-                        
-                        switch(curInstr.Instr)
-                        {
-                            case RecognizedInstruction::Mov:
-                            {
-                                CheckAddAlias(curInstr.Address, curInstr.Length, *pOutput, *pInput, lr, pr);
-                                handled = true;
-                                break;
-                            }
+                m_genBits.push_back(locTransfer.Aliases[a] * paramCount + paramNum);
+            }
+        }
+    }
 
-                            case RecognizedInstruction::Lea:
-                            {
-                                //
-                                // Slightly different semantic.  Instead of:
-                                //
-                                //     lea x, [y + z]
-                                //
-                                // Consider:
-                                //
-                                //     mov x, y + z
-                                //
-                                // And generate the appropriate aliasing for such.
-                                //
-                                op1 = *pInput;
-                                op1.Flags &= ~OperandMemory;
-                                op1.Flags |= OperandRegister | OperandImmediate;
-                                CheckAddAlias(curInstr.Address, curInstr.Length, *pOutput, op1, lr, pr);
-                                handled = true;
-                                break;
-                            }
+    //
+    // Apply the kills and then the aliases.  A location which is both killed and aliased by the same instruction
+    // (e.g.: mov rcx, rcx) simply stays live.  What is left in m_killBits and m_genBits are the locations which
+    // actually stop or start at this instruction.
+    //
+    for (auto&& bit : m_killBits)
+    {
+        liveLocations.Reset(bit);
+    }
 
-                            case RecognizedInstruction::Push:
-                            {
-                                //
-                                // Slightly different semantic.  Instead of:
-                                //
-                                //     push x
-                                //
-                                // Consider:
-                                //
-                                //     sub rsp, 8           ==> mov rsp, rsp - 8
-                                //     mov [rsp], x
-                                //
-                                // And generate the appropriate aliasing for such
-                                //
-                                BuildOperand(spId, true, op1);                              // in: rsp
-                                BuildOperand(spId, false, op2, -8);                         // in: rsp - 8
-                                BuildOperand(spId, false, op3, 0, true);                    // out: [rsp]
-                                CheckAddAlias(curInstr.Address, curInstr.Length, op1, op2, lr, pr);
-                                CheckAddAlias(curInstr.Address, curInstr.Length, op3, *pInput, lr, pr);
-                                handled = true;
-                                break;
-                            }
+    size_t genCount = 0;
+    for (size_t i = 0; i < m_genBits.size(); ++i)
+    {
+        size_t bit = m_genBits[i];
+        if (liveLocations.Test(bit))
+        {
+            continue;
+        }
 
-                            case RecognizedInstruction::Pop:
-                            {
-                                //
-                                // Slightly different semantic.  Instead of:
-                                //
-                                //     pop x
-                                //
-                                // Consider:
-                                //
-                                //     mov x, [rsp]
-                                //     add rsp, 8           ==> mov rsp, rsp + 8
-                                //
-                                BuildOperand(spId, false, op1, 0, true);                    // in: [rsp]
-                                BuildOperand(spId, true, op2);                              // out: rsp
-                                BuildOperand(spId, false, op3, 8);                          // in: rsp + 8
-                                CheckAddAlias(curInstr.Address, curInstr.Length, *pOutput, op1, lr, pr);
-                                CheckAddAlias(curInstr.Address, curInstr.Length, op2, op3, lr, pr);
-                                handled = true;
-                                break;
-                            }
+        liveLocations.Set(bit);
+        auto itKill = std::find(m_killBits.begin(), m_killBits.end(), bit);
+        if (itKill != m_killBits.end())
+        {
+            m_killBits.erase(itKill);
+        }
+        else
+        {
+            m_genBits[genCount++] = bit;
+        }
+    }
+    m_genBits.resize(genCount);
+}
 
-                            case RecognizedInstruction::Sub:
-                            case RecognizedInstruction::Add:
-                            {
-                                //
-                                // There are some very recognizable patterns around __chkstk which will seriously
-                                // impact our ability to propagate parameter ranges without a deep understanding
-                                // of the semantics of the method.  We will specially encode this hand-assembly 
-                                // coded function that appears in many places and this pattern:
-                                //
-                                //     mov [eax/rax], <size>
-                                //     call __chkstk
-                                //     sub rsp, rax
-                                //
-                                // We will instead rewrite the sub instruction (for the purposes of aliasing) as:
-                                //
-                                //     sub rsp, <size>
-                                //
-                                // If we recognize this pattern and symbol.
-                                //
-                                if (pOutput && !pImmediate && pInput == pOutput &&  
-                                    curInstr.NumOperands == 2 && 
-                                    curInstr.Instr == RecognizedInstruction::Sub &&
-                                    (curInstr.Operands[1].Flags & (OperandRegister | OperandInput | OperandMemory)) ==
-                                        (OperandRegister | OperandInput) &&
-                                    pOutput->Regs[0] == spId)
-                                {
-                                    //
-                                    // At this point, we've seen a sub rsp, <register>.  Look for the pattern.
-                                    //
-                                    InstructionInfo *pNMinus1 = GetPreviousInstructionN(1);
-                                    InstructionInfo *pNMinus2 = GetPreviousInstructionN(2);
-
-                                    if (pNMinus1 && pNMinus2 &&
-                                        pNMinus2->Address + pNMinus2->Length == pNMinus1->Address &&
-                                        pNMinus1->Address + pNMinus1->Length == curInstr.Address &&
-                                        pNMinus2->Instr == RecognizedInstruction::Mov &&
-                                        pNMinus1->IsCall)
-                                    {
-                                        //
-                                        // At this point, we have a recognized
-                                        //
-                                        // mov <reg1>, <size>
-                                        // call <something>
-                                        // sub rsp, <reg2>
-                                        //
-                                        OperandInfo const *pOutputNMinus2 = FindFirstOutput(*pNMinus2);
-                                        OperandInfo const *pImmNMinus2 = FindFirstImmediate(*pNMinus2);
-                                        OperandInfo const *pImmNMinus1 = FindFirstImmediate(*pNMinus1);
-                                        if (pImmNMinus2 && pOutputNMinus2 && pImmNMinus1)
-                                        {
-                                            RegisterInformation *pSrc;
-                                            RegisterInformation *pDest;
-                                            CheckHr(pSymManager->FindInformationForRegisterById(pOutputNMinus2->Regs[0], &pSrc));
-                                            CheckHr(pSymManager->FindInformationForRegisterById(curInstr.Operands[1].Regs[0], &pDest));
-
-                                            if (pOutputNMinus2->Regs[0] == curInstr.Operands[1].Regs[0] ||
-                                                GetBaseRegister(pOutputNMinus2->Regs[0]) == curInstr.Operands[1].Regs[0])
-                                            {
-                                                bool isChkStk = false;
-                                                ULONG64 offs = pImmNMinus1->ConstantValue - m_modBase;
-                                                ComPtr<ISvcSymbol> spSymbol;
-                                                ULONG64 displacement;
-                                                HRESULT hrSym = pSymbolSet->FindSymbolByOffset(offs,
-                                                                                               true,
-                                                                                               &spSymbol,
-                                                                                               &displacement);
-                                                if (SUCCEEDED(hrSym) && displacement == 0)
-                                                {
-                                                    BSTR symName;
-                                                    if (SUCCEEDED(spSymbol->GetName(&symName)))
-                                                    {
-                                                        isChkStk = (wcscmp(symName, L"__chkstk") == 0);
-                                                        SysFreeString(symName);
-                                                    }
-                                                }
-
-                                                if (isChkStk)
-                                                {
-                                                    //
-                                                    // We've recognized the pattern.  Substitute the <reg2> with
-                                                    // the immediate from the mov <reg1>, <size> for the purposes
-                                                    // of handling the sub.
-                                                    //
-                                                    op2 = *pImmNMinus2;
-                                                    pImmediate = &op2;
-                                                }
-                                            }
-                                        }
-                                    }
-                                }
+void RangeBuilder::TransferBasicBlock(_In_ BasicBlockInfo& block, _In_ bool recordRanges)
+{
+    size_t paramCount = m_parameters.size();
+    ULONG64 curAddress = block.StartAddress;
 
-                                //
-                                // Slightly different semantic.  Instead of:
-                                //
-                                //     add x, y
-                                //
-                                // Consider:
-                                //
-                                //     mov x, x + y
-                                //
-                                // And generate the appropriate aliasing for such (assuming that 'y' is an
-                                // immediate and 'x' is a register)
-                                //
-                                // Note that the first operand "x" will be Input | Output.  Find the immediate only
-                                // operand if such exists.
-                                //
-                                if (pOutput && pImmediate && pInput == pOutput &&
-                                    (pOutput->Flags & (OperandRegister | OperandMemory)) == OperandRegister)
-                                {
-                                    op1 = *pOutput;
-                                    op1.ConstantValue = (curInstr.Instr == RecognizedInstruction::Add ? 
-                                                             pImmediate->ConstantValue : -pImmediate->ConstantValue);
-                                    op1.Flags |= OperandImmediate;
-                                    CheckAddAlias(curInstr.Address, curInstr.Length, *pOutput, op1, lr, pr);
-                                    handled = true;
-                                }
+    auto openRange = [&](_In_ size_t bit, _In_ ULONG64 startAddress)
+    {
+        if (bit >= m_rangeStarts.size())
+        {
+            m_rangeStarts.resize(bit + 1);
+        }
+        m_rangeStarts[bit] = startAddress;
+    };
 
+    auto closeRange = [&](_In_ size_t bit, _In_ ULONG64 endAddress)
+    {
+        ULONG64 startAddress = m_rangeStarts[bit];
+        if (endAddress > startAddress)
+        {
+            block.BlockParameterRanges[bit % paramCount].push_back(
+                { startAddress, endAddress, m_locations[bit / paramCount] });
+        }
+    };
 
-                                break;
-                            }
-                        }
-                    }
-                }
-            }
+    m_liveLocations = block.EntryLocations;
+
+    if (recordRanges)
+    {
+        for (size_t bit = m_liveLocations.FindNext(0); bit != NoLocationBit; bit = m_liveLocations.FindNext(bit + 1))
+        {
+            openRange(bit, curAddress);
         }
     }
 
     //
-    // At the end of processing for this instruction, perform a final sweep and change any MarkedForKill
-    // to a Dead state.  No further processing is ever required.
+    // Walk each instruction in the block and update the locations of parameters as appropriate based on what the
+    // instructions are doing.
     //
-    for (size_t p = 0; p < block.BlockParameterRanges.size(); ++p)
+    size_t blockIndex = static_cast<size_t>(&block - m_bbInfo.data());
+    for (size_t i = 0; i < block.Code->Instructions.size(); ++i)
     {
-        ParameterRanges& pr = block.BlockParameterRanges[p];
-        for (size_t i = 0; i < pr.size(); ++i)
+        InstructionInfo const& instr = block.Code->Instructions[i];
+        InstructionTransfer& transfer = block.Transfers[i];
+        if (!transfer.Reduced)
+        {
+            ReduceInstruction(blockIndex, i, &transfer);
+        }
+
+        UpdateLocationsForInstruction(instr, transfer, m_liveLocations);
+        curAddress = instr.Address + instr.Length;
+
+        if (recordRanges)
         {
-            LocationRange &lr = pr[i];
-            if (lr.State == LiveState::MarkedForKill)
+            //
+            // A location which is killed by this instruction is still live through the end of it.  An alias
+            // created by this instruction starts immediately after it.
+            //
+            for (auto&& bit : m_killBits)
+            {
+                closeRange(bit, curAddress);
+            }
+            for (auto&& bit : m_genBits)
             {
-                lr.State = LiveState::Dead;
+                openRange(bit, curAddress);
             }
         }
     }
 
-    //
-    // Update the processing window so that we can go back and deal with some particular patterns that might
-    // be interesting.
-    //
-    m_processingWindow[m_processingWindowCur] = curInstr;
-    m_processingWindowCur = (m_processingWindowCur + 1) % ARRAYSIZE(m_processingWindow);
-    if (m_processingWindowSize < ARRAYSIZE(m_processingWindow))
+    if (recordRanges)
     {
-        ++m_processingWindowSize;
+        for (size_t bit = m_liveLocations.FindNext(0); bit != NoLocationBit; bit = m_liveLocations.FindNext(bit + 1))
+        {
+            closeRange(bit, curAddress);
+        }
     }
 }
 
-void RangeBuilder::TraverseBasicBlock(_In_ TraversalEntry const& entry)
+size_t RangeBuilder::GetLocationIndex(_In_ SvcSymbolLocation const& location)
 {
     //
-    // We should already have traversed the basic block list, so nothing should ever "not be found"
+    // A function only has a handful of distinct parameter locations (the placements from the calling convention
+    // and wherever the code copies or spills them to).  A linear search is as good as any index here.
     //
-    auto itbbAddr = m_bbInfo.find(entry.BlockAddress);
-    if (itbbAddr == m_bbInfo.end())
+    for (size_t i = 0; i < m_locations.size(); ++i)
     {
-        throw std::logic_error("Unexpected failure to find basic block");
+        if (LocationsAreEquivalent(m_locations[i], location))
+        {
+            return i;
+        }
     }
-    BasicBlockInfo& bbInfo = itbbAddr->second;
 
-    bool changedRanges = false;
-    if (entry.SourceBlockAddress != 0)
+    m_locations.push_back(location);
+    return m_locations.size() - 1;
+}
+
+size_t RangeBuilder::FindBasicBlock(_In_ ULONG64 startAddress)
+{
+    auto it = std::lower_bound(m_bbInfo.begin(), m_bbInfo.end(), startAddress,
+                               [&](_In_ BasicBlockInfo const& bb, _In_ ULONG64 address)
+                               {
+                                   return bb.StartAddress < address;
+                               });
+
+    if (it == m_bbInfo.end() || it->StartAddress != startAddress)
     {
-        auto itbbFrom = m_bbInfo.find(entry.SourceBlockAddress);
-        if (itbbFrom == m_bbInfo.end())
-        {
-            throw std::logic_error("Unexpected failure to find basic block");
-        }
-        BasicBlockInfo& bbInfoFrom = itbbFrom->second;
-        changedRanges = CarryoverLiveRanges(bbInfoFrom, bbInfo, entry);
+        return m_bbInfo.size();
     }
 
-    bool firstTraversal = (bbInfo.TraversalCount == 0);
+    return static_cast<size_t>(it - m_bbInfo.begin());
+}
 
-    if (++bbInfo.TraversalCount > MaximumTraversalCount)
+void RangeBuilder::BuildControlFlowGraph(_In_ size_t entryBlock)
+{
+    //
+    // Link each outbound control flow (whether it is a fall through flow, a branch flow, ...) of every block.
+    // We should already have the entire basic block list, so no destination should ever "not be found"
+    //
+    for (size_t b = 0; b < m_bbInfo.size(); ++b)
     {
-        throw std::runtime_error("Unable to propagate live ranges: maximum basic block traversal count exceeded");
+        for (auto&& outboundFlow : m_bbInfo[b].Code->OutboundControlFlows)
+        {
+            size_t dest = FindBasicBlock(outboundFlow.DestinationBlockAddress);
+            if (dest == m_bbInfo.size())
+            {
+                throw std::logic_error("Unexpected failure to find basic block");
+            }
+
+            m_bbInfo[b].Successors.push_back(dest);
+            m_bbInfo[dest].Predecessors.push_back(b);
+        }
     }
 
     //
-    // We only want to traverse this block if it's the first time we've hit this block *OR* there has been
-    // some change in the list of live ranges entering the block from a different control flow.
+    // Compute the reverse postorder of every block reachable from the entry block with an iterative depth
+    // first walk.  Each entry on the walk stack is a block and the index of its next successor to walk.
     //
-    if (firstTraversal || changedRanges)
+    std::vector<bool> visited(m_bbInfo.size(), false);
+    std::vector<std::pair<size_t, size_t>> walkStack;
+
+    m_bbOrder.clear();
+    visited[entryBlock] = true;
+    walkStack.push_back({ entryBlock, 0 });
+    while (!walkStack.empty())
     {
-        //
-        // Walk each instruction in the block and update live range information as appropriate based on
-        // what the instructions are doing.
-        //
-        Object instrs = bbInfo.BasicBlock.KeyValue(L"Instructions");
-        for (auto&& instr : instrs)
+        size_t b = walkStack.back().first;
+        size_t nextSuccessor = walkStack.back().second;
+        std::vector<size_t> const& successors = m_bbInfo[b].Successors;
+
+        if (nextSuccessor < successors.size())
+        {
+            ++walkStack.back().second;
+            size_t succ = successors[nextSuccessor];
+            if (!visited[succ])
+            {
+                visited[succ] = true;
+                walkStack.push_back({ succ, 0 });
+            }
+        }
+        else
         {
-            UpdateRangesForInstruction(bbInfo, instr);
+            m_bbOrder.push_back(b);
+            walkStack.pop_back();
         }
+    }
 
-        //
-        // At the end of the basic block, mark every range as "live at end of block" so that a subsequent traversal 
-        // inbound from another basic block does not attempt to update those ranges again.
-        //
-        for (size_t p = 0; p < bbInfo.BlockParameterRanges.size(); ++p)
+    std::reverse(m_bbOrder.begin(), m_bbOrder.end());
+}
+
+void RangeBuilder::SolveParameterLocations(_In_ size_t entryBlock)
+{
+    bool changed = true;
+    for (ULONG pass = 0; changed; ++pass)
+    {
+        if (pass >= MaximumSolverPassCount)
+        {
+            throw std::runtime_error("Unable to propagate live ranges: parameter locations did not converge");
+        }
+
+        changed = false;
+        for (auto&& b : m_bbOrder)
         {
-            ParameterRanges& pr = bbInfo.BlockParameterRanges[p];
-            for (size_t i = 0; i < pr.size(); ++i)
+            BasicBlockInfo& bb = m_bbInfo[b];
+
+            //
+            // The meet: the locations on entry to the block are those on exit from every visited predecessor
+            // (and, for the entry block, the placements from the calling convention).  A predecessor which has
+            // not been visited yet is the top of the lattice and does not constrain anything.
+            //
+            bool hasMeet = false;
+            if (b == entryBlock)
+            {
+                m_meetLocations = m_entryLocations;
+                hasMeet = true;
+            }
+
+            for (auto&& pred : bb.Predecessors)
             {
-                LocationRange & lr = pr[i];
-                if (lr.State == LiveState::Live)
+                BasicBlockInfo const& predInfo = m_bbInfo[pred];
+                if (!predInfo.Visited)
+                {
+                    continue;
+                }
+
+                if (!hasMeet)
+                {
+                    m_meetLocations = predInfo.ExitLocations;
+                    hasMeet = true;
+                }
+                else
                 {
-                    lr.State = LiveState::LiveAtEndOfBlock;
+                    m_meetLocations.IntersectWith(predInfo.ExitLocations);
                 }
             }
-        }
 
-        //
-        // Add each outbound control flow to the list of blocks to traverse (whether it is a fall through
-        // flow, a branch flow, ...)
-        //
-        Object outboundFlows = bbInfo.BasicBlock.KeyValue(L"OutboundControlFlows");
-        for (auto&& outboundFlow : outboundFlows)
-        {
-            Object destBlock = outboundFlow.KeyValue(L"LinkedBlock");
-            Object linkageInstr = outboundFlow.KeyValue(L"SourceInstruction");
-            ULONG64 linkageInstrAddr = (ULONG64)linkageInstr.KeyValue(L"Address");
-            ULONG64 destAddr = (ULONG64)destBlock.KeyValue(L"StartAddress");
-            m_bbTrav.push( { destAddr, bbInfo.StartAddress, linkageInstrAddr });
+            //
+            // In reverse postorder, every reachable block other than the entry has a visited predecessor (its
+            // parent in the depth first walk) by the time we get to it.
+            //
+            if (!hasMeet)
+            {
+                throw std::logic_error("Unexpected basic block with no visited predecessor");
+            }
+
+            bool firstVisit = !bb.Visited;
+            if (!firstVisit && m_meetLocations == bb.EntryLocations)
+            {
+                continue;
+            }
+
+            std::swap(bb.EntryLocations, m_meetLocations);
+            bb.Visited = true;
+
+            //
+            // The first visit of a block changes its exit locations from the top of the lattice even if the
+            // result happens to be identical to the initial (empty) set.  Any successor which was already
+            // visited on this pass must see it.
+            //
+            TransferBasicBlock(bb, false);
+            if (firstVisit || m_liveLocations != bb.ExitLocations)
+            {
+                std::swap(bb.ExitLocations, m_liveLocations);
+                changed = true;
+            }
         }
     }
 }
 
-void RangeBuilder::InitializeParameterLocations(_In_ CallingConvention *pConvention, 
-                                                _In_ BasicBlockInfo &entryBlock)
+void RangeBuilder::InitializeParameterLocations(_In_ CallingConvention *pConvention)
 {
     std::vector<SvcSymbolLocation> entryLocations(m_parameters.size());
 
@@ -966,21 +1095,10 @@ void RangeBuilder::InitializeParameterLocations(_In_ CallingConvention *pConvent
                                         const_cast<VariableSymbol const **>(& m_parameters[0]),
                                         &entryLocations[0]);
 
-    entryBlock.BlockParameterRanges.resize(m_parameters.size());
+    m_entryLocations.Clear();
     for (size_t i = 0; i < m_parameters.size(); ++i)
     {
-        ParameterRanges& ranges = entryBlock.BlockParameterRanges[i];
-
-        entryBlock.TraversalCountSlots.push_back(1);
-        size_t traversalCountSlot = entryBlock.TraversalCountSlots.size() - 1;
-
-        ranges.push_back(
-            { 
-                entryBlock.StartAddress,                // [StartAddress, StartAddress) -- "empty" until traversed
-                entryBlock.StartAddress,
-                { entryLocations[i], traversalCountSlot },
-                LiveState::Live
-            });
+        m_entryLocations.Set(GetLocationIndex(entryLocations[i]) * m_parameters.size() + i);
     }
 }
 
@@ -988,13 +1106,10 @@ void RangeBuilder::PropagateParameterRanges(_In_ FunctionSymbol *pFunction,
                                             _In_ CallingConvention *pConvention)
 {
     m_bbInfo.clear();
-    {
-        decltype(m_bbTrav) emptyQueue;
-        std::swap(m_bbTrav, emptyQueue);
-    }
+    m_bbOrder.clear();
     m_parameters.clear();
-
-    m_processingWindowCur = m_processingWindowSize = 0;
+    m_locations.clear();
+    m_spFunctionCode.reset();
 
     //
     // Build a quick index of the parameters of the function.  If there are none, we need do nothing.
@@ -1015,6 +1130,7 @@ void RangeBuilder::PropagateParameterRanges(_In_ FunctionSymbol *pFunction,
 
     if (m_parameters.size() > 0)
     {
+        m_pSymbolSet = pFunction->InternalGetSymbolSet();
         m_pFunction = pFunction;
         m_pConvention = pConvention;
         CheckHr(pFunction->GetOffset(&m_functionOffset));
@@ -1029,35 +1145,35 @@ void RangeBuilder::PropagateParameterRanges(_In_ FunctionSymbol *pFunction,
             pParam->InternalDeleteAllLiveRanges();
         }
 
-        Object disResult = m_dis.CallMethod(L"DisassembleFunction", m_modBase + m_functionOffset);
-        Object bbs = disResult.KeyValue(L"BasicBlocks");
+        m_spFunctionCode = GetFunctionCode(m_pSymbolSet, m_modBase + m_functionOffset);
 
         //
-        // Walk the basic block list and build our quick index.
+        // Walk the basic block list (which is sorted by address) and build our quick index.
         //
-        for(auto&& bb : bbs)
+        m_bbInfo.reserve(m_spFunctionCode->BasicBlocks.size());
+        for (auto&& bb : m_spFunctionCode->BasicBlocks)
         {
-            ULONG64 startAddress = (ULONG64)bb.KeyValue(L"StartAddress");
-            m_bbInfo.insert( { startAddress, bb } );
+            m_bbInfo.push_back(BasicBlockInfo(&bb));
+            m_bbInfo.back().BlockParameterRanges.resize(m_parameters.size());
         }
 
-        auto itbbFirst = m_bbInfo.find(m_modBase + m_functionOffset);
-        if (itbbFirst == m_bbInfo.end())
+        size_t entryBlock = FindBasicBlock(m_modBase + m_functionOffset);
+        if (entryBlock == m_bbInfo.size())
         {
             throw std::runtime_error("Unable to find entry basic block to function");
         }
-        InitializeParameterLocations(pConvention, itbbFirst->second);
+
+        InitializeParameterLocations(pConvention);
+        BuildControlFlowGraph(entryBlock);
 
         //
-        // Start at the entry basic block and keep walking control flows until we reach a state where
-        // we have no more control flows with different variable locations on entry.
+        // Solve for the locations of every parameter on entry to each basic block and then make one final walk
+        // of each reachable block to turn those into ranges.
         //
-        m_bbTrav.push({ m_modBase + m_functionOffset, 0, 0 });
-        while (!m_bbTrav.empty())
+        SolveParameterLocations(entryBlock);
+        for (auto&& b : m_bbOrder)
         {
-            TraversalEntry entry = m_bbTrav.front();
-            m_bbTrav.pop();
-            TraverseBasicBlock(entry);
+            TransferBasicBlock(m_bbInfo[b], true);
         }
 
         //
@@ -1067,6 +1183,75 @@ void RangeBuilder::PropagateParameterRanges(_In_ FunctionSymbol *pFunction,
     }
 }
 
+std::shared_ptr<FunctionCode const> RangeBuilder::GetFunctionCode(_In_ SymbolSet *pSymbolSet,
+                                                                 _In_ ULONG64 entryAddress)
+{
+    FunctionCodeCache& codeCache = pSymbolSet->InternalGetCodeCache();
+
+    std::shared_ptr<FunctionCode const> spCachedCode;
+    CheckHr(codeCache.FindFunction(pSymbolSet, entryAddress, &spCachedCode));
+    if (spCachedCode != nullptr)
+    {
+        return spCachedCode;
+    }
+
+    //
+    // Register canonicalization of operands goes through the symbol set's manager.
+    //
+    m_pSymbolSet = pSymbolSet;
+
+    //
+    // Calling .DisassembleFunction will have the data model disassembler perform a disassembly across the
+    // entire function doing flow analysis to form a basic block graph.  Decode every block and instruction
+    // of that graph once so that nothing needs to go back to the data model for this function again.
+    //
+    auto spFunctionCode = std::make_shared<FunctionCode>();
+    spFunctionCode->EntryAddress = entryAddress;
+    spFunctionCode->CodeHash = 0;
+
+    Object disResult = m_dis.CallMethod(L"DisassembleFunction", entryAddress);
+    Object bbs = disResult.KeyValue(L"BasicBlocks");
+    for (auto&& bb : bbs)
+    {
+        BasicBlockCode blockCode;
+        blockCode.StartAddress = (ULONG64)bb.KeyValue(L"StartAddress");
+        blockCode.EndAddress = (ULONG64)bb.KeyValue(L"EndAddress");
+
+        Object instrs = bb.KeyValue(L"Instructions");
+        for (auto&& instr : instrs)
+        {
+            InstructionInfo instrInfo;
+            GetInstructionInfo(instr, &instrInfo);
+            blockCode.Instructions.push_back(instrInfo);
+        }
+
+        Object outboundFlows = bb.KeyValue(L"OutboundControlFlows");
+        for (auto&& outboundFlow : outboundFlows)
+        {
+            Object destBlock = outboundFlow.KeyValue(L"LinkedBlock");
+            Object linkageInstr = outboundFlow.KeyValue(L"SourceInstruction");
+            ULONG64 linkageInstrAddr = (ULONG64)linkageInstr.KeyValue(L"Address");
+            ULONG64 destAddr = (ULONG64)destBlock.KeyValue(L"StartAddress");
+            blockCode.OutboundControlFlows.push_back( { destAddr, linkageInstrAddr });
+        }
+
+        spFunctionCode->BasicBlocks.push_back(std::move(blockCode));
+    }
+
+    std::sort(spFunctionCode->BasicBlocks.begin(), spFunctionCode->BasicBlocks.end(),
+              [&](_In_ BasicBlockCode const& a, _In_ BasicBlockCode const& b)
+              {
+                  return a.StartAddress < b.StartAddress;
+              });
+
+    //
+    // If the code bytes cannot be read to validate a later use of the cache entry, the decoding is still
+    // perfectly good for this use.  It just will not be cached.
+    //
+    (void)codeCache.AddFunction(pSymbolSet, spFunctionCode);
+    return spFunctionCode;
+}
+
 bool RangeBuilder::AddParameterRangeToFunction(_In_ size_t paramNum,
                                                _In_ ULONG64 &startAddress,
                                                _In_ ULONG64 &endAddress,
@@ -1104,37 +1289,22 @@ void RangeBuilder::CreateLiveRangeSets()
     //
     //       At (2), the variable is live in both rbx and rcx.  We must pick one.
     //
-    // It makes this a bit easier if we first sort all the basic blocks by their start address.
+    // The basic blocks are already sorted by their start address which makes this a bit easier.
     //
-    std::vector<BasicBlockInfo *> bbsByAddress;
-    for (auto&& kvp : m_bbInfo)
-    {
-        bbsByAddress.push_back(&kvp.second);
-    }
-    std::sort(bbsByAddress.begin(), bbsByAddress.end(),
-              [&](_In_ BasicBlockInfo const* a, _In_ BasicBlockInfo const* b)
-              {
-                  return a->StartAddress < b->StartAddress;
-              });
-
     for (size_t p = 0; p < m_parameters.size(); ++p)
     {
-        ULONG64 instrp = bbsByAddress[0]->StartAddress;
+        ULONG64 instrp = m_bbInfo[0].StartAddress;
         ULONG64 curRangeStart = 0;
         ULONG64 curRangeEnd = 0;
         SvcSymbolLocation curLocation;
 
-        for (auto&& pbb : bbsByAddress)
+        for (auto&& bb : m_bbInfo)
         {
-            BasicBlockInfo &bb = *pbb;
-            ULONG traversalCount = bb.TraversalCount;
-
             auto&& pr = bb.BlockParameterRanges[p];
-            auto&& tc = bb.TraversalCountSlots;
 
             //
-            // Ranges may have gotten out of order linearly depending on how many control flows entered the 
-            // block.  Sort them to make it easier to figure out.
+            // Ranges are recorded in the order in which they end rather than the order in which they start.
+            // Sort them to make it easier to figure out.
             //
             std::sort(pr.begin(), pr.end(),
                       [&](_In_ const LocationRange& a, _In_ const LocationRange& b)
@@ -1153,12 +1323,12 @@ void RangeBuilder::CreateLiveRangeSets()
                 for (size_t i = 0; i < pr.size(); ++i)
                 {
                     //
-                    // @TODO: For now, we are choosing to ignore control flow dependent locations.  In reality, if
-                    //        there are no better options, we should be able to plumb this upward.
+                    // @TODO: For now, we are choosing to ignore control flow dependent locations (the meet of the
+                    //        solve drops any location which does not hold on every control flow into a block).
+                    //        In reality, if there are no better options, we should be able to plumb this upward.
                     //
                     LocationRange const& lr = pr[i];
-                    if (tc[lr.ParamLocation.TraversalCountSlot] == traversalCount && lr.EndAddress > instrp &&
-                        lr.EndAddress > lr.StartAddress)
+                    if (lr.EndAddress > instrp && lr.EndAddress > lr.StartAddress)
                     {
                         pLR = &lr;
                         break;
@@ -1182,7 +1352,7 @@ void RangeBuilder::CreateLiveRangeSets()
                             curRangeStart = instrp;
                         }
                         curRangeEnd = pLR->EndAddress;
-                        curLocation = pLR->ParamLocation.ParamLocation;
+                        curLocation = pLR->Location;
                         instrp = pLR->EndAddress;
                     }
                     else
@@ -1190,7 +1360,7 @@ void RangeBuilder::CreateLiveRangeSets()
                         if (pLR->StartAddress >= curRangeStart &&
                             pLR->StartAddress <= curRangeEnd &&
                             pLR->EndAddress > curRangeEnd &&
-                            LocationsAreEquivalent(curLocation, pLR->ParamLocation.ParamLocation))
+                            LocationsAreEquivalent(curLocation, pLR->Location))
                         {
                             curRangeEnd = pLR->EndAddress;
                             instrp = pLR->EndAddress;
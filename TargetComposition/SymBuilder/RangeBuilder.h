@@ -30,6 +30,12 @@ using namespace Debugger::DataModel::ClientEx;
 //
 // The main range builder class.
 //
+// Known limitations:
+//
+//     - A call is assumed to leave the stack pointer where it was.  Stack pointer relative locations are wrong
+//       after a call to a callee which pops its own arguments.  This does not arise with the Windows AMD64
+//       calling convention (the only one presently understood).
+//
 class RangeBuilder
 {
 public:
@@ -42,19 +48,32 @@ public:
     void PropagateParameterRanges(_In_ FunctionSymbol *pFunction,
                                   _In_ CallingConvention *pConvention);
 
+    // GetFunctionCode():
+    //
+    // Gets the decoded code (basic blocks and classified instructions) of the function whose entry point is at
+    // the virtual address 'entryAddress' within the module of the given symbol set.  This comes from the symbol
+    // set's code cache if possible; otherwise, the function is disassembled, decoded, and added to the cache.
+    //
+    std::shared_ptr<FunctionCode const> GetFunctionCode(_In_ SymbolSet *pSymbolSet, _In_ ULONG64 entryAddress);
+
 private:
 
-    // The maximum number of times that a basic block can be traversed before we consider it an error.  There
-    // are circumstances where we might not understand call semantics (e.g.: callee cleaned stack) which might cause
-    // us to keep seeing alternate stack locations in a basic block.
-    //
-    // If we hit this, we consider it a failure to propagate the live ranges.
+    // The maximum number of reverse postorder passes over the basic blocks of a function before we consider it
+    // an error.  The locations of parameters only ever shrink at a block once it has been visited, so the solve
+    // converges in a handful of passes (roughly the loop nesting depth plus two).  Hitting this indicates a bug
+    // in the transfer of locations across instructions rather than a pathological function.
     //
-    static constexpr ULONG MaximumTraversalCount = 1024;
+    static constexpr ULONG MaximumSolverPassCount = 1024;
 
     // A constant defining no register
     static constexpr ULONG NoRegister = static_cast<ULONG>(-1);
 
+    // A constant defining no bit within a location set
+    static constexpr size_t NoLocationBit = static_cast<size_t>(-1);
+
+    // A constant defining no index within m_locations
+    static constexpr size_t NoLocationIndex = static_cast<size_t>(-1);
+
     //*************************************************
     // Permanent State:
     //
@@ -67,39 +86,15 @@ private:
     //
 
     //
-    // Information about the function/module we are currently building parameter ranges for:
+    // Information about the function/module we are currently building parameter ranges for (or decoding the
+    // code of):
     //
+    SymbolSet *m_pSymbolSet;
     FunctionSymbol *m_pFunction;
     CallingConvention *m_pConvention;
     ULONG64 m_functionOffset;
     ULONG64 m_modBase;
 
-    // LocationInfo:
-    //
-    // Information about the location of a variable at a particular instruction.
-    //
-    struct LocationInfo
-    {
-        SvcSymbolLocation ParamLocation;
-        size_t TraversalCountSlot;
-    };
-
-    enum class LiveState
-    {
-        // The given location is still live
-        Live,
-        
-        // The given location is marked for kill during the processing of an instruction.  After the instruction
-        // finishes processing, it will change to dead.
-        MarkedForKill,
-
-        // The given location is dead.  No further processing or aliasing is required.
-        Dead,
-
-        // The given location is live as of the end of the block.
-        LiveAtEndOfBlock
-    };
-
     // LocationRange:
     //
     // Defines a location over a range of instructions defined by a half-open set [StartAddress, EndAddress)
@@ -108,8 +103,7 @@ private:
     {
         ULONG64 StartAddress;
         ULONG64 EndAddress;
-        LocationInfo ParamLocation;
-        LiveState State;
+        SvcSymbolLocation Location;
     };
 
     // ParameterRanges:
@@ -118,117 +112,231 @@ private:
     //
     using ParameterRanges = std::vector<LocationRange>;
 
-    // BasicBlockInfo:
+    // LocationSet:
     //
-    // Records information about a particular basic block.
+    // The lattice value of the dataflow solve: a set of (parameter, location) pairs, each of which says that the
+    // given location holds the value of the given parameter.  Every pair is a single bit whose index is
+    // (location index * parameter count + parameter number) where the location index is into m_locations.
+    // Keeping the location in the high part of the index means that discovering a new location only ever
+    // appends bits.
     //
-    struct BasicBlockInfo
+    class LocationSet
     {
-        //*************************************************
-        // Data:
-        //
+    public:
 
-        // The disassembler's representation of a basic block.
-        Object BasicBlock;
-        ULONG64 StartAddress;
-        ULONG64 EndAddress;
+        bool Test(_In_ size_t bit) const
+        {
+            size_t word = bit / 64;
+            return (word < m_words.size() && (m_words[word] & (1ull << (bit % 64))) != 0);
+        }
+
+        void Set(_In_ size_t bit)
+        {
+            size_t word = bit / 64;
+            if (word >= m_words.size())
+            {
+                m_words.resize(word + 1, 0);
+            }
+            m_words[word] |= (1ull << (bit % 64));
+        }
+
+        void Reset(_In_ size_t bit)
+        {
+            size_t word = bit / 64;
+            if (word < m_words.size())
+            {
+                m_words[word] &= ~(1ull << (bit % 64));
+            }
+        }
 
+        void Clear()
+        {
+            m_words.clear();
+        }
+
+        // FindNext():
         //
-        // The locations of parameters within this basic block.
+        // Finds the first bit at or above 'bit' which is set.  If there is none, NoLocationBit is returned.
         //
-        std::vector<ParameterRanges> BlockParameterRanges;
-        std::vector<ULONG> TraversalCountSlots;
-
-        // How many times has our traversal entered this basic block.
-        ULONG TraversalCount;
+        size_t FindNext(_In_ size_t bit) const
+        {
+            size_t word = bit / 64;
+            if (word >= m_words.size())
+            {
+                return NoLocationBit;
+            }
+
+            ULONG64 bits = m_words[word] & (~0ull << (bit % 64));
+            for(;;)
+            {
+                if (bits != 0)
+                {
+                    size_t pos = 0;
+                    while ((bits & 1) == 0)
+                    {
+                        bits >>= 1;
+                        ++pos;
+                    }
+                    return word * 64 + pos;
+                }
+
+                if (++word >= m_words.size())
+                {
+                    return NoLocationBit;
+                }
+                bits = m_words[word];
+            }
+        }
 
-        //*************************************************
-        // Constructors:
+        // IntersectWith():
         //
+        // The meet of the lattice.  Intersects this set in place with 'other'.
+        //
+        void IntersectWith(_In_ LocationSet const& other)
+        {
+            size_t commonWords = (std::min)(m_words.size(), other.m_words.size());
+            for (size_t i = 0; i < commonWords; ++i)
+            {
+                m_words[i] &= other.m_words[i];
+            }
+            m_words.resize(commonWords);
+        }
 
-        // Constructs a basic block info
-        BasicBlockInfo(_In_ Object basicBlock) :
-            BasicBlock(std::move(basicBlock))
+        bool operator==(_In_ LocationSet const& other) const
         {
-            StartAddress = (ULONG64)BasicBlock.KeyValue(L"StartAddress");
-            EndAddress = (ULONG64)BasicBlock.KeyValue(L"EndAddress");
-            TraversalCount = 0;
+            //
+            // The sets may have a different number of words.  Any word which is missing from one of them is zero.
+            //
+            size_t maxWords = (std::max)(m_words.size(), other.m_words.size());
+            for (size_t i = 0; i < maxWords; ++i)
+            {
+                ULONG64 a = (i < m_words.size() ? m_words[i] : 0);
+                ULONG64 b = (i < other.m_words.size() ? other.m_words[i] : 0);
+                if (a != b)
+                {
+                    return false;
+                }
+            }
+            return true;
         }
-    };
 
-    // RecognizedInstruction:
-    //
-    // Defines instructions that we recognize for specific purposes.
-    //
-    enum class RecognizedInstruction
-    {
-        Unknown,
-        Mov,
-        Push,
-        Pop,
-        Add,
-        Sub,
-        Lea
+        bool operator!=(_In_ LocationSet const& other) const
+        {
+            return !(*this == other);
+        }
+
+    private:
+
+        std::vector<ULONG64> m_words;
     };
 
-    // TraversalEntry
-    //
-    // Describes the need to traverse BlockAddress as entered from the basic block starting at SourceBlockAddress.
-    // The instruction which transferred control between blocks (whether a branch or fall through) is
-    // SourceBlockInstructionAddress.
+    // LocationTransfer:
     //
-    // The initial block will have 0 for source block fields.
+    // What a single instruction does to a single location: whether it kills the location and which locations
+    // (as indices into m_locations) it aliases the location to.  This does not depend on which parameter is in the
+    // location or on what else is live.
     //
-    struct TraversalEntry
-    {
-        ULONG64 BlockAddress;
-        ULONG64 SourceBlockAddress;
-        ULONG64 SourceBlockInstructionAddress;
-    };
-
-    enum OperandFlags
+    struct LocationTransfer
     {
-        OperandInput = 0x00000001,
-        OperandOutput = 0x000000002,
-        OperandRegister = 0x00000004,
-        OperandMemory = 0x00000008,
-        OperandImmediate = 0x00000010,
+        bool Computed;
+        bool Killed;
+        size_t Aliases[2];                                          // NoLocationIndex if there is no alias
     };
 
-    // OperandInfo:
+    // InstructionTransfer:
     //
-    // Information about an operand
+    // An instruction reduced to what the transfer of locations through it needs: the operand it implicitly writes
+    // (if any) and the (up to two) equivalent movs it is considered as for aliasing with the __chkstk rewrite of
+    // "sub rsp, <reg>" already applied.  An instruction is reduced the first time it is walked and what it does to
+    // a location is kept the first time that location is live across it.  Later passes of the solve and the walk
+    // which records ranges only look these up.
     //
-    struct OperandInfo
+    struct InstructionTransfer
     {
-        ULONG Flags;                // OperandFlags set
-        ULONG Regs[3];              // NoRegister if not present
-        ULONG ScalingFactor;        // regs[0] * scalingFactor (1)
-        LONG64 ConstantValue;       // immediate
+        bool Reduced;
+        bool HasImplicit;
+        OperandInfo Implicit;
+        size_t MovCount;
+        OperandInfo MovOutputs[2];
+        OperandInfo MovInputs[2];
+        std::vector<LocationTransfer> Locations;                    // Indexed by location index
     };
 
-    // InstructionInfo:
+    // BasicBlockInfo:
     //
-    // Information about an instruction
+    // Records information about a particular basic block.
     //
-    struct InstructionInfo
+    struct BasicBlockInfo
     {
-        ULONG64 Address;
-        ULONG64 Length;
-        RecognizedInstruction Instr;
-        bool IsCall;
-        size_t NumOperands;
-        OperandInfo Operands[4];
+        //*************************************************
+        // Data:
+        //
+
+        // The decoded code of the basic block.
+        BasicBlockCode const *Code;
+        ULONG64 StartAddress;
+        ULONG64 EndAddress;
+
+        // The control flow graph (as indices into m_bbInfo).
+        std::vector<size_t> Predecessors;
+        std::vector<size_t> Successors;
+
+        // Has the solve visited this block yet.  Until it has, its exit locations are the top of the lattice
+        // and do not take part in the meet at its successors.
+        bool Visited;
+
+        //
+        // The locations of parameters on entry to and exit from this basic block.
+        //
+        LocationSet EntryLocations;
+        LocationSet ExitLocations;
+
+        //
+        // The ranges of parameter locations within this basic block.  These are only built once the solve
+        // has converged.
+        //
+        std::vector<ParameterRanges> BlockParameterRanges;
+
+        //
+        // The reduced transfer of each instruction of the block (parallel to Code->Instructions).
+        //
+        std::vector<InstructionTransfer> Transfers;
+
+        //*************************************************
+        // Constructors:
+        //
+
+        // Constructs a basic block info
+        BasicBlockInfo(_In_ BasicBlockCode const *pCode) :
+            Code(pCode),
+            Transfers(pCode->Instructions.size())
+        {
+            StartAddress = Code->StartAddress;
+            EndAddress = Code->EndAddress;
+            Visited = false;
+        }
     };
 
-    std::unordered_map<ULONG64, BasicBlockInfo> m_bbInfo;
-    std::queue<TraversalEntry> m_bbTrav;
+    // The decoded code of the function we are currently building parameter ranges for.  The basic block
+    // information in m_bbInfo points into this.
+    std::shared_ptr<FunctionCode const> m_spFunctionCode;
+
+    std::vector<BasicBlockInfo> m_bbInfo;                           // Sorted by start address
+    std::vector<size_t> m_bbOrder;                                  // Reverse postorder of reachable blocks
     std::vector<VariableSymbol *> m_parameters;
+    std::vector<SvcSymbolLocation> m_locations;                     // Every location seen in the function
     std::unordered_map<ULONG, ULONG> m_disRegToCanonical;           // Maps disassembler IDs to canonical ones
 
-    InstructionInfo m_processingWindow[3];                          // Window of last three instructions walked
-    size_t m_processingWindowCur;
-    size_t m_processingWindowSize;
+    //
+    // Scratch state of the solve.  This is kept across blocks (and functions) so that the transfer of locations
+    // through a block does not allocate once the buffers have grown.
+    //
+    LocationSet m_entryLocations;                                   // Parameter placements at function entry
+    LocationSet m_meetLocations;                                    // Result of the meet at a block
+    LocationSet m_liveLocations;                                    // Locations as of the current instruction
+    std::vector<size_t> m_killBits;                                 // Bits which stop at the current instruction
+    std::vector<size_t> m_genBits;                                  // Bits which start after the current instruction
+    std::vector<ULONG64> m_rangeStarts;                             // Start address of the open range of each bit
 
     //*************************************************
     // Private Methods:
@@ -262,49 +370,71 @@ private:
 
     // InitializeParameterLocations():
     //
-    // Creates the initial placement of parameters via calling convention on the first instruction in the given
-    // basic block (which should be the entry block into the given function).
+    // Creates the initial placement of parameters via calling convention on entry to the function.
+    //
+    void InitializeParameterLocations(_In_ CallingConvention *pConvention);
+
+    // GetLocationIndex():
+    //
+    // Gets the index of a location within m_locations, adding it if this is the first time it has been seen.
+    //
+    size_t GetLocationIndex(_In_ SvcSymbolLocation const& location);
+
+    // FindBasicBlock():
+    //
+    // Finds the index within m_bbInfo of the basic block starting at 'startAddress'.
+    //
+    size_t FindBasicBlock(_In_ ULONG64 startAddress);
+
+    // BuildControlFlowGraph():
+    //
+    // Links the predecessors and successors of every basic block and computes the reverse postorder of the
+    // blocks reachable from the block at index 'entryBlock'.
     //
-    void InitializeParameterLocations(_In_ CallingConvention *pConvention, _In_ BasicBlockInfo &entryBlock);
-    
-    // TraverseBasicBlock():
+    void BuildControlFlowGraph(_In_ size_t entryBlock);
+
+    // SolveParameterLocations():
     //
-    // Walks through the instructions in the basic block starting at 'entry.BlockAddress' until it hits the end of the
-    // basic block.  During the instruction traversal, propagate information we have about the state of parameters
-    // at the start of the basic block through to the end of the basic block.
+    // Performs a forward "must" dataflow solve of the locations of every parameter.  The locations on entry to
+    // a block are the intersection of the locations on exit from each of its visited predecessors.  Blocks are
+    // walked in reverse postorder (so every block but a loop header sees all of its predecessors on the first
+    // pass) until no block's exit locations change.
     //
-    // If 'entry.SourceBlock*' is not 0, the state from the end of that block will carry into the start of the 
-    // traversal.  If this does not change the live ranges at the start of 'entry.BlockAddress', the traversal is
-    // considered complete.  Otherwise, the block will be traversed again to find and propagate any control flow 
-    // dependent locations.
+    void SolveParameterLocations(_In_ size_t entryBlock);
+
+    // TransferBasicBlock():
     //
-    // If the block starting at 'entry.BlockAddress' is traversed, this will add outbound control flows from the 
-    // traversed block to the traversal queue.
+    // Walks the instructions of the basic block starting from its entry locations, leaving its exit locations
+    // in m_liveLocations.  If 'recordRanges' is true, the range of each location within the block is added to
+    // the block's parameter ranges.
     //
-    void TraverseBasicBlock(_In_ TraversalEntry const& entry);
+    void TransferBasicBlock(_In_ BasicBlockInfo& block, _In_ bool recordRanges);
 
-    // UpdateRangesForInstruction():
+    // UpdateLocationsForInstruction():
     // 
-    // Updates parameter live range information *WITHIN* this basic block given the disassembled instruction
-    // "instr".
+    // Updates the locations of parameters in 'liveLocations' given the decoded instruction "curInstr" and its
+    // reduced transfer.  On return, m_killBits holds the bits which were live before the instruction and are not
+    // after it, and m_genBits holds the bits which were not live before the instruction and are after it.
     //
-    void UpdateRangesForInstruction(_In_ BasicBlockInfo& block, _In_ Object instr);
+    void UpdateLocationsForInstruction(_In_ InstructionInfo const& curInstr,
+                                       _Inout_ InstructionTransfer& transfer,
+                                       _Inout_ LocationSet& liveLocations);
 
-    // CarryoverLiveRange():
+    // ReduceInstruction():
     //
-    // Takes a given live range and carries it into bbTo.  This returns whether or not a change was made
-    // to 'bbTo'
+    // Reduces the instruction at index 'instrIndex' of the basic block at index 'blockIndex' within m_bbInfo to
+    // its implicit operand and equivalent movs.
     //
-    bool CarryoverLiveRange(_In_ BasicBlockInfo& bbTo,
-                            _In_ size_t paramNum,
-                            _In_ LocationRange const& liveRange);
+    void ReduceInstruction(_In_ size_t blockIndex, _In_ size_t instrIndex, _Out_ InstructionTransfer *pTransfer);
 
-    // CarryoverLiveRanges():
+    // GetLocationTransfer():
     //
-    // Takes the live ranges at the end of 'bbFrom' and carries them into 'bbTo'.  If this changes any live
-    // ranges at the start of 'bbTo', this returns true; otherwise, this returns false.
+    // Gets what the instruction "curInstr" does to the location at index 'locationIndex' within m_locations,
+    // computing it the first time it is asked for.
     //
-    bool CarryoverLiveRanges(_In_ BasicBlockInfo& bbFrom, _In_ BasicBlockInfo& bbTo, _In_ TraversalEntry const& entry);
+    LocationTransfer GetLocationTransfer(_In_ InstructionInfo const& curInstr,
+                                         _Inout_ InstructionTransfer& transfer,
+                                         _In_ size_t locationIndex);
 
     // AddParameterRangeToFunction()
     //
@@ -318,22 +448,20 @@ private:
 
     // CheckForKill():
     //
-    // Checks whether a given operand as a destination will kill the live range given by lr.
+    // Checks whether a given operand as a destination will kill the given location.
     //
-    bool CheckForKill(_In_ OperandInfo const& opInfo, _In_ LocationRange const &lr);
+    bool CheckForKill(_In_ OperandInfo const& opInfo, _In_ SvcSymbolLocation const& location);
 
     // CheckAddAlias():
     //
-    // For the instruction at 'instrAddr' where that instruction is functionally a mov of inputInfo to outputInfo, 
-    // see if this creates an aliasing of 'lr'.  If so, add such aliasing to 'ranges' starting at 
-    // 'instrAddr' + 'instrLen' and return true; otherwise, return false.
+    // For an instruction which is functionally a mov of inputInfo to outputInfo, see if this creates an aliasing
+    // of 'location'.  If so, return the aliased location in 'pAliasLocation' and return true; otherwise, return
+    // false.
     //
-    bool CheckAddAlias(_In_ ULONG64 instrAddr,
-                       _In_ ULONG64 instrLen,
-                       _In_ OperandInfo const& outputInfo,
+    bool CheckAddAlias(_In_ OperandInfo const& outputInfo,
                        _In_ OperandInfo const& intputInfo,
-                       _In_ LocationRange const& lr,
-                       _Inout_ ParameterRanges& ranges);
+                       _In_ SvcSymbolLocation const& location,
+                       _Out_ SvcSymbolLocation *pAliasLocation);
 
     // GetOperandInfo():
     //
@@ -403,20 +531,25 @@ private:
 
     // GetPreviousInstructionN():
     //
-    // Gets the Nth previous instruction which was processed where 'n' defaults to 1.  If such instruction is
-    // not in the cache, nullptr is returned.  Note that it is assumed that the current instruction is not in
-    // the processing window.
+    // Gets the Nth instruction before the instruction at index 'instrIndex' of the basic block at index
+    // 'blockIndex' within m_bbInfo.  This continues into the block immediately before in the address space only if
+    // that block ends exactly where this one starts.  If there is no such instruction, nullptr is returned.
     //
-    InstructionInfo *GetPreviousInstructionN(_In_ size_t nback = 1)
+    InstructionInfo const *GetPreviousInstructionN(_In_ size_t blockIndex,
+                                                   _In_ size_t instrIndex,
+                                                   _In_ size_t nback = 1)
     {
-        if (m_processingWindowSize < nback)
+        while (nback > instrIndex)
         {
-            return nullptr;
+            if (blockIndex == 0 || m_bbInfo[blockIndex - 1].EndAddress != m_bbInfo[blockIndex].StartAddress)
+            {
+                return nullptr;
+            }
+            nback -= instrIndex;
+            --blockIndex;
+            instrIndex = m_bbInfo[blockIndex].Code->Instructions.size();
         }
-        size_t pos = m_processingWindowCur;
-        if (pos < nback) { pos += ARRAYSIZE(m_processingWindow); }
-        pos -= nback;
-        return &(m_processingWindow[pos]);
+        return &(m_bbInfo[blockIndex].Code->Instructions[instrIndex - nback]);
     }
 
 };
@@ -0,0 +1,94 @@
+//**************************************************************************
+//
+// StringArena.cpp
+//
+// An arena of interned strings used for the names of symbols.
+//
+//**************************************************************************
+//
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+//
+//**************************************************************************
+
+#include "SymBuilder.h"
+
+namespace Debugger
+{
+namespace TargetComposition
+{
+namespace Services
+{
+namespace SymbolBuilder
+{
+
+HRESULT StringArena::Intern(_In_ std::wstring_view str, _Out_ InternedString *pHandle)
+{
+    *pHandle = InternedString();
+    if (str.empty())
+    {
+        return S_OK;
+    }
+
+    //
+    // We cannot let a C++ exception escape.
+    //
+    auto fn = [&]()
+    {
+        auto it = m_strings.find(str);
+        if (it != m_strings.end())
+        {
+            *pHandle = InternedString(*it);
+            return S_OK;
+        }
+
+        size_t needed = str.size() + 1;
+        wchar_t *pDest;
+        bool fromCurrentBlock = true;
+
+        if (needed > LargeStringSize)
+        {
+            std::unique_ptr<wchar_t[]> block(new wchar_t[needed]);
+            pDest = block.get();
+            m_blocks.push_back(std::move(block));
+            m_blockCharacters += needed;
+            fromCurrentBlock = false;
+        }
+        else
+        {
+            if (needed > m_remaining)
+            {
+                std::unique_ptr<wchar_t[]> block(new wchar_t[BlockSize]);
+                m_pCur = block.get();
+                m_remaining = BlockSize;
+                m_blocks.push_back(std::move(block));
+                m_blockCharacters += BlockSize;
+            }
+            pDest = m_pCur;
+        }
+
+        wmemcpy(pDest, str.data(), str.size());
+        pDest[str.size()] = L'\0';
+
+        std::wstring_view interned(pDest, str.size());
+        m_strings.insert(interned);
+
+        //
+        // Only consume the space once the string is in the set.  If the insertion throws, the space is reused
+        // by the next string.
+        //
+        if (fromCurrentBlock)
+        {
+            m_pCur += needed;
+            m_remaining -= needed;
+        }
+
+        *pHandle = InternedString(interned);
+        return S_OK;
+    };
+    return ConvertException(fn);
+}
+
+} // SymbolBuilder
+} // Services
+} // TargetComposition
+} // Debugger
@@ -0,0 +1,136 @@
+//**************************************************************************
+//
+// StringArena.h
+//
+// An arena of interned strings.  Each symbol set interns the names of its symbols
+// here so that a name which appears many times (a field name in many structs, the
+// qualified name of a symbol and the key for it in the name indexes, etc...) is
+// stored exactly once.
+//
+//**************************************************************************
+//
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+//
+//**************************************************************************
+
+#ifndef __STRINGARENA_H__
+#define __STRINGARENA_H__
+
+namespace Debugger
+{
+namespace TargetComposition
+{
+namespace Services
+{
+namespace SymbolBuilder
+{
+
+class StringArena;
+
+// InternedString:
+//
+// A handle to a string interned in a StringArena.  The handle is no larger than a string view and is valid
+// for as long as the arena which produced it.  The characters are always null terminated.  A default
+// constructed handle is the empty string.
+//
+class InternedString
+{
+public:
+
+    InternedString() :
+        m_view(L"", 0)
+    {
+    }
+
+    PCWSTR c_str() const { return m_view.data(); }
+    bool empty() const { return m_view.empty(); }
+    size_t size() const { return m_view.size(); }
+    std::wstring_view view() const { return m_view; }
+    operator std::wstring_view() const { return m_view; }
+
+    bool operator==(_In_ InternedString const& other) const
+    {
+        //
+        // Two handles from the same arena are equal if and only if they are the same pointer.  Handles
+        // from different arenas must compare characters.
+        //
+        return m_view.data() == other.m_view.data() || m_view == other.m_view;
+    }
+
+    bool operator!=(_In_ InternedString const& other) const
+    {
+        return !(*this == other);
+    }
+
+private:
+
+    friend class StringArena;
+
+    InternedString(_In_ std::wstring_view view) :
+        m_view(view)
+    {
+    }
+
+    std::wstring_view m_view;
+};
+
+// StringArena:
+//
+// Stores each distinct string exactly once in large character blocks.  Nothing is ever freed until the arena
+// itself is destroyed: the name of a deleted or renamed symbol stays in the arena.
+//
+class StringArena
+{
+public:
+
+    StringArena() :
+        m_pCur(nullptr),
+        m_remaining(0),
+        m_blockCharacters(0)
+    {
+    }
+
+    StringArena(StringArena const&) = delete;
+    StringArena& operator=(StringArena const&) = delete;
+
+    // Intern():
+    //
+    // Gets the handle for a string, copying it into the arena if it is not already there.
+    //
+    HRESULT Intern(_In_ std::wstring_view str, _Out_ InternedString *pHandle);
+
+    // GetStringCount():
+    //
+    // Gets the number of distinct strings in the arena.
+    //
+    size_t GetStringCount() const { return m_strings.size(); }
+
+    // GetBlockCharacters():
+    //
+    // Gets the number of characters allocated for the blocks of the arena (whether used or not).
+    //
+    size_t GetBlockCharacters() const { return m_blockCharacters; }
+
+private:
+
+    // The size of a normal block.  Any string which would use more than a quarter of a block gets a block
+    // of its own so that the remainder of the current block is not wasted.
+    static constexpr size_t BlockSize = 32768;
+    static constexpr size_t LargeStringSize = BlockSize / 4;
+
+    // The blocks of the arena and the free space in the current one.
+    std::vector<std::unique_ptr<wchar_t[]>> m_blocks;
+    wchar_t *m_pCur;
+    size_t m_remaining;
+    size_t m_blockCharacters;
+
+    // Every distinct string in the arena.  The views point into m_blocks.
+    std::unordered_set<std::wstring_view> m_strings;
+};
+
+} // SymbolBuilder
+} // Services
+} // TargetComposition
+} // Debugger
+
+#endif // __STRINGARENA_H__
@@ -29,10 +29,12 @@
 #include <utility>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <stack>
 #include <queue>
 #include <map>
+#include <set>
 #include <unordered_map>
 #include <unordered_set>
 #include <algorithm>
@@ -162,12 +164,15 @@ HRESULT DiagnosticLog(_In_opt_ ISvcDiagnosticLogging *pDiagnosticLogging,
 
 #include "InternalGuids.h"
 #include "HelpStrings.h"
+#include "StringArena.h"
 #include "SymbolBase.h"
 #include "SymbolData.h"
 #include "SymbolTypes.h"
 #include "SymbolFunction.h"
 #include "ImportSymbols.h"
+#include "CodeCache.h"
 #include "SymbolSet.h"
+#include "SymbolSnapshot.h"
 #include "CallingConvention.h"
 #include "SymManager.h"
 #include "SymbolServices.h"
@@ -147,6 +147,32 @@ function __getUniqueName(baseName)
     return (baseName + "__" + id.toString());
 }
 
+// __int32Bytes:
+//
+// Returns the little endian bytes of a 32-bit value (e.g.: the displacement of a relative call).
+//
+function __int32Bytes(value)
+{
+    return [value & 0xFF, (value >> 8) & 0xFF, (value >> 16) & 0xFF, (value >> 24) & 0xFF];
+}
+
+// __writeCode:
+//
+// Writes code bytes at an offset into a module and returns the bytes which were there before.  Passing those
+// back to __writeCode puts the module back the way it was.
+//
+function __writeCode(moduleName, offset, bytes)
+{
+    var address = host.currentProcess.Modules.getValueAt(moduleName).BaseAddress.add(offset);
+    var original = [];
+    for (var val of host.memory.readMemoryValues(address, bytes.length, 1))
+    {
+        original.push(val);
+    }
+    host.memory.writeMemoryValues(address, bytes.length, bytes, 1);
+    return original;
+}
+
 //**************************************************************************
 // Test Cases
 //
@@ -167,6 +193,73 @@ function Test_VerifyBuilderSymbols()
     return true;
 }
 
+// Test_FindSymbolsByPattern:
+//
+// Verifies that FindSymbols on the symbol set finds global symbols by wildcard pattern with and without
+// regard to case.
+//
+function Test_FindSymbolsByPattern()
+{
+    var baseName = __getUniqueName("find");
+    var fooA = __symbolBuilderSymbols.Types.Create(baseName + "_a");
+    var fooB = __symbolBuilderSymbols.Types.Create(baseName + "_B");
+    var other = __symbolBuilderSymbols.Types.Create(__getUniqueName("other"));
+
+    var countOf = function(symbols)
+    {
+        var count = 0;
+        for (var sym of symbols)
+        {
+            ++count;
+        }
+        return count;
+    };
+
+    __VERIFY(countOf(__symbolBuilderSymbols.FindSymbols(baseName + "_*")) == 2, "unexpected match count for '*'");
+    __VERIFY(countOf(__symbolBuilderSymbols.FindSymbols(baseName + "_?")) == 2, "unexpected match count for '?'");
+    __VERIFY(countOf(__symbolBuilderSymbols.FindSymbols(baseName + "_b")) == 0, "unexpected case sensitive match");
+    __VERIFY(countOf(__symbolBuilderSymbols.FindSymbols(baseName + "_b", true)) == 1, "missing case insensitive match");
+
+    fooB.Delete();
+    __VERIFY(countOf(__symbolBuilderSymbols.FindSymbols(baseName + "_*")) == 1, "deleted symbol still found");
+
+    fooA.Delete();
+    other.Delete();
+    return true;
+}
+
+// Test_DeleteWhileIteratingTypes:
+//
+// Verifies that deleting the type which an iteration of the types of a symbol set is on does not cause the
+// iteration to skip the type created after it.
+//
+function Test_DeleteWhileIteratingTypes()
+{
+    var baseName = __getUniqueName("iter");
+    var names = [baseName + "_a", baseName + "_b", baseName + "_c"];
+    var types = names.map(function(name) { return __symbolBuilderSymbols.Types.Create(name); });
+
+    var seen = [];
+    for (var type of __symbolBuilderSymbols.Types)
+    {
+        if (names.indexOf(type.Name) != -1)
+        {
+            seen.push(type.Name);
+            if (type.Name == names[0])
+            {
+                types[0].Delete();
+            }
+        }
+    }
+
+    __VERIFY(seen.length == 3, "iteration skipped a type after a delete");
+    __VERIFY(seen[1] == names[1] && seen[2] == names[2], "iteration out of order after a delete");
+
+    types[1].Delete();
+    types[2].Delete();
+    return true;
+}
+
 // Test_CreateAndDestroyEmptyUdt:
 //
 // Verifies that we can create and verify an empty UDT (getting back at it with standard type system APIs in
@@ -352,6 +445,172 @@ function Test_NestedStructsWithAutoAlignment()
     return true;
 }
 
+// Test_NestedStructsInBatch:
+//
+// Verifies that changes made inside nested BeginBatch / CommitBatch pairs are laid out correctly once the
+// batch commits, including the relayout of a type which contains a type changed within the batch, and that
+// exactly one cache invalidation is sent when the outermost batch commits.
+//
+function Test_NestedStructsInBatch()
+{
+    var fooName = __getUniqueName("foo");
+    var barName = __getUniqueName("bar");
+
+    var bar = __symbolBuilderSymbols.Types.Create(barName);
+    var barFldJ = bar.Fields.Add("j", "int");           // [0, 4)
+
+    var foo = __symbolBuilderSymbols.Types.Create(fooName);
+    var fooFldA = foo.Fields.Add("a", "char");          // [0, 1)
+    var fooFldB = foo.Fields.Add("b", bar);             // [4, 8) --> [4, 12) once bar grows
+
+    var invalidations = __symbolBuilderSymbols.CacheInvalidationCount;
+
+    __symbolBuilderSymbols.BeginBatch();
+    var barFldK = bar.Fields.Add("k", "char");          // [4, 5) <-- +pad to 8
+    __symbolBuilderSymbols.BeginBatch();
+    var fooFldC = foo.Fields.Add("c", "int");           // [12, 16)
+    __symbolBuilderSymbols.CommitBatch();
+    __VERIFY(__symbolBuilderSymbols.CacheInvalidationCount == invalidations,
+             "cache invalidation sent before the outermost batch committed");
+    __symbolBuilderSymbols.CommitBatch();
+    __VERIFY(__symbolBuilderSymbols.CacheInvalidationCount == invalidations + 1,
+             "unexpected number of cache invalidations for the batch");
+
+    __VERIFY(barFldJ.Offset == 0 && barFldK.Offset == 4 && bar.Size == 8 && bar.Alignment == 4,
+             "unexpected layout of 'bar' type");
+
+    __VERIFY(fooFldA.Offset == 0, "unexpected offset of 'a'");
+    __VERIFY(fooFldB.Offset == 4, "unexpected offset of 'b'");
+    __VERIFY(fooFldC.Offset == 12, "unexpected offset of 'c'");
+    __VERIFY(foo.Size == 16, "unexpected size of 'foo'");
+
+    var fooTy = host.getModuleType("notepad.exe", fooName);
+    __VERIFY(fooTy.size == 16, "unexpected type system size of 'foo'");
+    __VERIFY(fooTy.fields.c.offset == 12, "unexpected type system offset of 'c'");
+
+    foo.Delete();
+    bar.Delete();
+    return true;
+}
+
+// Test_AbortBatchOnException:
+//
+// Verifies that a batch abandoned by an exception is ended by AbortBatch: the changes made before the failure
+// are kept and laid out, a single cache invalidation is sent, and later changes are no longer batched.
+//
+function Test_AbortBatchOnException()
+{
+    var fooName = __getUniqueName("foo");
+    var barName = __getUniqueName("bar");
+
+    var bar = __symbolBuilderSymbols.Types.Create(barName);
+    bar.Fields.Add("j", "char");                        // [0, 1)
+
+    var foo = __symbolBuilderSymbols.Types.Create(fooName);
+    var fooFldB = foo.Fields.Add("b", bar);             // [0, 1) --> [0, 8) once bar grows
+    var fooFldC = foo.Fields.Add("c", "char");          // [1, 2) --> [8, 9) once bar grows
+
+    var invalidations = __symbolBuilderSymbols.CacheInvalidationCount;
+
+    var threw = false;
+    __symbolBuilderSymbols.BeginBatch();
+    try
+    {
+        __symbolBuilderSymbols.BeginBatch();
+        bar.Fields.Add("k", "int");                     // [4, 8)
+        throw new Error("failure in the middle of the batch");
+    }
+    catch(e)
+    {
+        threw = true;
+    }
+    finally
+    {
+        __symbolBuilderSymbols.AbortBatch();
+    }
+
+    __VERIFY(threw, "the batch did not throw");
+    __VERIFY(__symbolBuilderSymbols.CacheInvalidationCount == invalidations + 1,
+             "unexpected number of cache invalidations for the aborted batch");
+    __VERIFY(bar.Size == 8, "change made before the failure was lost");
+    __VERIFY(fooFldB.Offset == 0 && fooFldC.Offset == 8 && foo.Size == 12, "unexpected layout of 'foo'");
+
+    //
+    // The batch is over: a change now invalidates the caches immediately.
+    //
+    foo.Fields.Add("d", "int");                         // [12, 16)
+    __VERIFY(__symbolBuilderSymbols.CacheInvalidationCount > invalidations + 1,
+             "change after AbortBatch is still batched");
+
+    foo.Delete();
+    bar.Delete();
+    return true;
+}
+
+// Test_DiamondNestedStructs:
+//
+// Verifies that a type which contains a changed type along several paths is laid out correctly both for
+// individual changes and for changes made in a batch.
+//
+function Test_DiamondNestedStructs()
+{
+    var innerName = __getUniqueName("inner");
+    var leftName = __getUniqueName("left");
+    var rightName = __getUniqueName("right");
+    var outerName = __getUniqueName("outer");
+
+    var inner = __symbolBuilderSymbols.Types.Create(innerName);
+    inner.Fields.Add("i", "char");                      // [0, 1)
+
+    var left = __symbolBuilderSymbols.Types.Create(leftName);
+    left.Fields.Add("a", inner);                        // [0, 1)
+    var leftFldB = left.Fields.Add("b", "char");        // [1, 2)
+
+    var right = __symbolBuilderSymbols.Types.Create(rightName);
+    right.Fields.Add("c", "char");                      // [0, 1)
+    var rightFldD = right.Fields.Add("d", inner);       // [1, 2)
+
+    var outer = __symbolBuilderSymbols.Types.Create(outerName);
+    var outerFldL = outer.Fields.Add("l", left);        // [0, 2)
+    var outerFldR = outer.Fields.Add("r", right);       // [2, 4)
+    var outerFldX = outer.Fields.Add("x", inner);       // [4, 5)
+
+    __VERIFY(outerFldR.Offset == 2 && outerFldX.Offset == 4 && outer.Size == 5, "unexpected layout of 'outer'");
+
+    //
+    // Growing 'inner' to { char i; int j; } (size 8, alignment 4) changes everything which contains it.
+    //
+    inner.Fields.Add("j", "int");
+
+    __VERIFY(left.Size == 12 && leftFldB.Offset == 8, "unexpected layout of 'left'");
+    __VERIFY(right.Size == 12 && rightFldD.Offset == 4, "unexpected layout of 'right'");
+    __VERIFY(outerFldL.Offset == 0 && outerFldR.Offset == 12 && outerFldX.Offset == 24 && outer.Size == 32,
+             "unexpected layout of 'outer'");
+
+    //
+    // Do the same in a batch by growing 'inner' to { char i; int j; __int64 k; } (size 16, alignment 8).
+    //
+    __symbolBuilderSymbols.BeginBatch();
+    inner.Fields.Add("k", "__int64");
+    __symbolBuilderSymbols.CommitBatch();
+
+    __VERIFY(inner.Size == 16 && inner.Alignment == 8, "unexpected layout of 'inner'");
+    __VERIFY(left.Size == 24 && leftFldB.Offset == 16, "unexpected layout of 'left'");
+    __VERIFY(right.Size == 24 && rightFldD.Offset == 8, "unexpected layout of 'right'");
+    __VERIFY(outerFldL.Offset == 0 && outerFldR.Offset == 24 && outerFldX.Offset == 48 && outer.Size == 64,
+             "unexpected layout of 'outer'");
+
+    var outerTy = host.getModuleType("notepad.exe", outerName);
+    __VERIFY(outerTy.size == 64, "unexpected type system size of 'outer'");
+    __VERIFY(outerTy.fields.x.offset == 48, "unexpected type system offset of 'x'");
+
+    outer.Delete();
+    right.Delete();
+    left.Delete();
+    inner.Delete();
+    return true;
+}
+
 // Test_StructManualLayout:
 //
 // Verifies that we can manually layout a struct.
@@ -1159,6 +1418,187 @@ function Test_BitfieldMoveField()
     return true;
 }
 
+// Test_SnapshotRoundTrip:
+//
+// Verifies that a symbol set saved to a snapshot can be loaded back for the same module with the same types,
+// data, and functions and that the snapshot cannot be loaded for a different module.  This uses kernel32 rather
+// than notepad so that the symbol set for notepad which the other tests use is left alone.
+//
+function Test_SnapshotRoundTrip()
+{
+    var fs = host.namespace.Debugger.Utility.FileSystem;
+    var snapshotPath = fs.TempDirectory.Path + "\\" + __getUniqueName("snapshot") + ".sbss";
+
+    var udtName = __getUniqueName("snap_struct");
+    var enumName = __getUniqueName("snap_enum");
+    var dataName = __getUniqueName("snap_data");
+    var funcName = __getUniqueName("snap_func");
+
+    var kernel32 = host.currentProcess.Modules.getValueAt("kernel32.dll");
+    var kernel32Base = kernel32.BaseAddress;
+
+    //
+    // Create and save the symbols:
+    //
+    var original = __symBuilder.CreateSymbols("kernel32.dll");
+    var udt = original.Types.Create(udtName);
+    udt.Fields.Add("a", "int");
+    udt.Fields.Add("b", "char");
+    udt.Fields.Add("next", udtName + " *");
+    var fruit = original.Types.CreateEnum(enumName);
+    fruit.Enumerants.Add("apple");
+    fruit.Enumerants.Add("pear");
+    original.Data.CreateGlobal(dataName, udtName, 0x1000);
+    original.Functions.Create(funcName, "int", 0x2000, 0x20, funcName, { Name: "p", Type: udtName + " *" });
+
+    var udtSize = udt.Size;
+    original.Save(snapshotPath);
+    __symBuilder.DeleteSymbols("kernel32.dll");
+    __VERIFY(kernel32.SymbolBuilderSymbols === undefined, "symbol set still present after DeleteSymbols");
+
+    //
+    // The symbols of a deleted set which are still held stay readable but the set can no longer change.
+    //
+    __VERIFY(udt.Name == udtName, "unexpected name of a symbol of a deleted set");
+    var addThrew = false;
+    try
+    {
+        udt.Fields.Add("c", "int");
+    }
+    catch(e)
+    {
+        addThrew = true;
+    }
+    __VERIFY(addThrew, "added a field to a symbol of a deleted set");
+
+    try
+    {
+        //
+        // A snapshot saved from kernel32 must not load for some other module.  The failed load must not leave
+        // an empty symbol set behind.
+        //
+        var threw = false;
+        try
+        {
+            __symBuilder.CreateSymbols("kernelbase.dll", { LoadSnapshot: snapshotPath });
+        }
+        catch(e)
+        {
+            threw = true;
+        }
+        __VERIFY(threw, "snapshot loaded for the wrong module");
+        __VERIFY(host.currentProcess.Modules.getValueAt("kernelbase.dll").SymbolBuilderSymbols === undefined,
+                 "failed snapshot load left a symbol set behind");
+
+        //
+        // Load it back and compare through the type system:
+        //
+        var loaded = __symBuilder.CreateSymbols("kernel32.dll", { LoadSnapshot: snapshotPath });
+        __ctl.ExecuteCommand(".reload");
+
+        try
+        {
+            var udtTy = host.getModuleType("kernel32.dll", udtName);
+            __VERIFY(udtTy != null, "struct not found after snapshot load");
+            __VERIFY(udtTy.size == udtSize, "unexpected struct size after snapshot load");
+            __VERIFY(udtTy.fields.a.type.name == "int", "unexpected type of field 'a' after snapshot load");
+            __VERIFY(udtTy.fields.b.type.name == "char", "unexpected type of field 'b' after snapshot load");
+            __VERIFY(udtTy.fields.b.offset == 4, "unexpected offset of field 'b' after snapshot load");
+            __VERIFY(udtTy.fields.next.type.typeKind == "pointer", "unexpected type of field 'next' after snapshot load");
+            __VERIFY(udtTy.fields.next.type.baseType.name == udtName, "unexpected base type of field 'next' after snapshot load");
+
+            var enumTy = host.getModuleType("kernel32.dll", enumName);
+            __VERIFY(enumTy != null && enumTy.typeKind == "enum", "enum not found after snapshot load");
+            __VERIFY(__COUNTOF(Object.getOwnPropertyNames(enumTy.fields)) == 2, "unexpected enumerant count after snapshot load");
+
+            __VERIFY(host.getModuleSymbolAddress("kernel32.dll", dataName).compareTo(kernel32Base.add(0x1000)) == 0,
+                     "unexpected data address after snapshot load");
+            __VERIFY(host.getModuleSymbolAddress("kernel32.dll", funcName).compareTo(kernel32Base.add(0x2000)) == 0,
+                     "unexpected function address after snapshot load");
+
+            var func = null;
+            for (var sym of loaded.FindSymbols(funcName))
+            {
+                func = sym;
+            }
+            __VERIFY(func != null, "function not found in the loaded symbol set");
+            __VERIFY(__COUNTOF(func.Parameters) == 1, "unexpected parameter count after snapshot load");
+        }
+        finally
+        {
+            __symBuilder.DeleteSymbols("kernel32.dll");
+        }
+    }
+    finally
+    {
+        __ctl.ExecuteCommand(".reload");
+        fs.DeleteFile(snapshotPath);
+    }
+
+    return true;
+}
+
+// Test_AutoImportBelowFailedOffset:
+//
+// Verifies that an offset query which DbgHelp cannot answer does not stop a later query for a lower offset
+// from importing the symbol there.  The failed query is the one the range builder makes for the target of a
+// call while looking for __chkstk.  Here that target is past the end of the module.
+//
+function Test_AutoImportBelowFailedOffset()
+{
+    var moduleName = "kernelbase.dll";
+    var module = host.currentProcess.Modules.getValueAt(moduleName);
+
+    //
+    // Find a function in the module before symbol builder symbols take over for it.
+    //
+    var knownAddress = host.getModuleSymbolAddress(moduleName, "CreateFileW");
+    __VERIFY(knownAddress != null, "unable to find CreateFileW");
+
+    //
+    // The code goes into the padding after the module's headers:
+    //
+    //     mov eax, 2000h
+    //     call <past the end of the module>
+    //     sub rsp, rax
+    //     add rsp, rax
+    //     ret
+    //
+    var codeOffset = 0x800;
+    var callTarget = module.Size + 0x1000;
+    var code = [0xB8, 0x00, 0x20, 0x00, 0x00, 0xE8].concat(__int32Bytes(callTarget - (codeOffset + 10)),
+                                                            [0x48, 0x2B, 0xE0, 0x48, 0x03, 0xE0, 0xC3]);
+
+    var symbols = __symBuilder.CreateSymbols(moduleName, { AutoImportSymbols: true });
+    __ctl.ExecuteCommand(".reload");
+    var original = __writeCode(moduleName, codeOffset, code);
+
+    try
+    {
+        var func = symbols.Functions.Create(__getUniqueName("chkstk_caller"), "void", codeOffset, code.length);
+        func.Parameters.Add("p", "int");
+        func.Parameters.PropagateLiveRangesFromCallingConvention();
+
+        var found = false;
+        for (var line of __ctl.ExecuteCommand("ln 0x" + knownAddress.toString(16)))
+        {
+            if (line.indexOf("!CreateFileW") != -1)
+            {
+                found = true;
+            }
+        }
+        __VERIFY(found, "lookup below a failed offset did not import the symbol");
+    }
+    finally
+    {
+        __writeCode(moduleName, codeOffset, original);
+        __symBuilder.DeleteSymbols(moduleName);
+        __ctl.ExecuteCommand(".reload");
+    }
+
+    return true;
+}
+
 //**************************************************************************
 // Initialization:
 //
@@ -1174,6 +1614,10 @@ var __testSuite =
     // General Tests:
     //
     { Name: "VerifyBuilderSymbols", Code: Test_VerifyBuilderSymbols },
+    { Name: "FindSymbolsByPattern", Code: Test_FindSymbolsByPattern },
+    { Name: "DeleteWhileIteratingTypes", Code: Test_DeleteWhileIteratingTypes },
+    { Name: "SnapshotRoundTrip", Code: Test_SnapshotRoundTrip },
+    { Name: "AutoImportBelowFailedOffset", Code: Test_AutoImportBelowFailedOffset },
 
     //
     // UDT Specific Tests:
@@ -1182,6 +1626,9 @@ var __testSuite =
     { Name: "UdtWithBasicFields", Code: Test_UdtWithBasicFields },
     { Name: "AutoLayoutAlignment", Code: Test_AutoLayoutAlignment },
     { Name: "NestedStructsWithAutoAlignment", Code: Test_NestedStructsWithAutoAlignment },
+    { Name: "NestedStructsInBatch", Code: Test_NestedStructsInBatch },
+    { Name: "AbortBatchOnException", Code: Test_AbortBatchOnException },
+    { Name: "DiamondNestedStructs", Code: Test_DiamondNestedStructs },
     { Name: "StructManualLayout", Code: Test_StructManualLayout },
     { Name: "StructMixedManualAutoLayout", Code: Test_StructMixedManualAutoLayout },
     { Name: "StructDeleteFields", Code: Test_StructDeleteFields },
@@ -0,0 +1,521 @@
+"use strict";
+//
+// [Harness: run notepad.exe]
+//
+
+//**************************************************************************
+// RangeBuilderTests.js
+//
+// Unit tests for the propagation of parameter live ranges from the calling convention (the range builder).
+//
+// Each test writes a small function of hand assembled x64 code into the padding after notepad's headers and
+// checks where the range builder says the function's parameter lives at particular instructions.
+//
+// NOTE: The test harness will read the script before opening the engine and having it execute it.
+//       During that process, it will read any comment lines at the beginning of the file (after any
+//       optional "use strict";) and will interpret // [Harness: <something>] as a command to the
+//       test harness.  Here, this script will be executed against "notepad.exe" because of the
+//       harness command.
+//
+// Any method named Test_* is a test case.  The "TestSuite" global array is what the test runner will
+// pick up on.  It has the format of { Name: <test name>, Code: <test function> }.  All tests will be
+// executed in the order specified in that array.
+//
+// The reason tests here are "Test_*" is that it makes the script easy to pick up in a regular debugger
+// install and understand what is going wrong.  You can step through the script:
+//
+//     .scriptload RangeBuilderTests.js
+//     .scriptdebug RangeBuilderTests.js
+//         <In the script debugger, set your breakpoints / q>
+//     dx @$t = @$scriptContents.initializeTests()
+//     dx @$scriptContents.Test_X();
+//         <When broken into the script debugger, do what is needed>
+//
+// You can also attach an outer NATIVE debugger to the debugger and set corresponding breakpoints in
+// SymbolBuilderComposition.dll.
+//
+
+var __symbolBuilderSymbols = null;
+var __ctl = null;
+var __symBuilder = null;
+
+var __uniqueId = 0;
+
+//**************************************************************************
+// Utility:
+//
+// Right now, these helpers are included in each script to make writing tests easier.  It would be nice
+// if the infrastructure could inject some of these into the test script context instead of duplicating
+// them into each test script.
+//
+
+// __Errorinfo:
+//
+// Parses the stack from an error to yield file names, line numbers, etc...
+// Note that this is ChakraCore specific and may need to change if the engine underneath
+// JsProvider ever changes.
+//
+class __Errorinfo
+{
+    constructor(err)
+    {
+        this.__err = err;
+        this.__errstack = err.stack;
+        this.__errlines = this.__errstack.split("\n");
+    }
+
+    *[Symbol.iterator]()
+    {
+        for (var line of this.__errlines)
+        {
+            var re = /at (\S+) \(([^:]*):(\d+):(\d+)\)/;
+            var result = re.exec(line);
+            if (result)
+            {
+                yield { FunctionName: result[1],
+                        SourceFile: result[2],
+                        SourceLine: result[3],
+                        SourceColumn: result[4] };
+            }
+        }
+    }
+}
+
+// __formerror:
+//
+// Takes an existing error object for a verification failure (and its stack) and reforms it into a new
+// one with a slightly different message.
+//
+function __formerror(e, str)
+{
+    var info = new __Errorinfo(e);
+    var callerInfo = null;
+    var idx = 0;
+    for (var frame of info)
+    {
+        if (++idx == 2)
+        {
+            callerInfo = frame;
+            break;
+        }
+    }
+
+    var msg = "Verification FAILED";
+    if (callerInfo)
+    {
+        msg += " @ ";
+        msg += callerInfo.FunctionName;
+        msg += ":";
+        msg += callerInfo.SourceLine;
+        msg += ":";
+        msg += callerInfo.SourceColumn;
+    }
+
+    if (str !== undefined)
+    {
+        msg += " (";
+        msg += str;
+        msg += ")";
+    }
+
+    return new Error(msg);
+}
+
+// __VERIFY:
+//
+// Helper to verify a boolean condition and throw an error (with optional message) if the verification
+// fails.
+//
+function __VERIFY(val, excStr)
+{
+    if (!val)
+    {
+        throw __formerror(new Error("VERIFICATION FAILED"), excStr);
+    }
+}
+
+function __COUNTOF(data)
+{
+    var count = 0;
+    for (var datum of data)
+    {
+        ++count;
+    }
+    return count;
+}
+
+function __getUniqueName(baseName)
+{
+    var id = ++__uniqueId;
+    return (baseName + "__" + id.toString());
+}
+
+// __writeCode:
+//
+// Writes code bytes at an offset into a module and returns the bytes which were there before.  Passing those
+// back to __writeCode puts the module back the way it was.
+//
+function __writeCode(moduleName, offset, bytes)
+{
+    var address = host.currentProcess.Modules.getValueAt(moduleName).BaseAddress.add(offset);
+    var original = [];
+    for (var val of host.memory.readMemoryValues(address, bytes.length, 1))
+    {
+        original.push(val);
+    }
+    host.memory.writeMemoryValues(address, bytes.length, bytes, 1);
+    return original;
+}
+
+// __isX64:
+//
+// Indicates whether the target is x64.  The code which the tests write is x64 code.
+//
+function __isX64()
+{
+    for (var line of __ctl.ExecuteCommand(".effmach"))
+    {
+        if (line.indexOf("x64") != -1)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// __locationAt:
+//
+// Returns the location of the live range of a variable which covers a function relative offset (or null if
+// the variable has no location there).
+//
+function __locationAt(variable, offset)
+{
+    for (var range of variable.LiveRanges)
+    {
+        if (offset >= range.Offset && offset < range.Offset + range.Size)
+        {
+            return range.Location;
+        }
+    }
+    return null;
+}
+
+// __propagateRanges:
+//
+// Writes the given code into notepad, creates a function over it with a single pointer sized parameter (which
+// the calling convention places in rcx), and propagates the live ranges of that parameter.  The original bytes
+// are put back before returning the parameter.
+//
+function __propagateRanges(codeOffset, code)
+{
+    var original = __writeCode("notepad.exe", codeOffset, code);
+    try
+    {
+        var func = __symbolBuilderSymbols.Functions.Create(__getUniqueName("func"), "void", codeOffset, code.length);
+        var param = func.Parameters.Add("p", "int *");
+        func.Parameters.PropagateLiveRangesFromCallingConvention();
+        return param;
+    }
+    finally
+    {
+        __writeCode("notepad.exe", codeOffset, original);
+    }
+}
+
+//**************************************************************************
+// Test Cases
+//
+
+// Test_StraightLineCode:
+//
+// Verifies that a parameter follows the copies made of it through code with no control flow:
+//
+//     0:  mov rax, rcx
+//     3:  xor rcx, rcx
+//     6:  mov rdx, rax
+//     9:  xor rax, rax
+//     c:  ret
+//
+function Test_StraightLineCode()
+{
+    if (!__isX64())
+    {
+        return true;
+    }
+
+    var param = __propagateRanges(0x800, [0x48, 0x8B, 0xC1,
+                                          0x48, 0x33, 0xC9,
+                                          0x48, 0x8B, 0xD0,
+                                          0x48, 0x33, 0xC0,
+                                          0xC3]);
+
+    __VERIFY(__locationAt(param, 0x0) == "@rcx", "parameter not in rcx on entry");
+    __VERIFY(__locationAt(param, 0x3) == "@rcx", "parameter not in rcx through the instruction which kills it");
+    __VERIFY(__locationAt(param, 0x6) == "@rax", "parameter not in rax after rcx is killed");
+    __VERIFY(__locationAt(param, 0xC) == "@rdx", "parameter not in rdx after rax is killed");
+    return true;
+}
+
+// Test_DiamondKillsRegister:
+//
+// Verifies that a register which is killed on only one side of a diamond is not live where the two sides
+// join, but is live throughout the side which leaves it alone:
+//
+//     0:  test rdx, rdx
+//     3:  je a
+//     5:  xor rcx, rcx
+//     8:  jmp b
+//     a:  nop
+//     b:  nop
+//     c:  ret
+//
+function Test_DiamondKillsRegister()
+{
+    if (!__isX64())
+    {
+        return true;
+    }
+
+    var param = __propagateRanges(0x880, [0x48, 0x85, 0xD2,
+                                          0x74, 0x05,
+                                          0x48, 0x33, 0xC9,
+                                          0xEB, 0x01,
+                                          0x90,
+                                          0x90,
+                                          0xC3]);
+
+    __VERIFY(__locationAt(param, 0x0) == "@rcx", "parameter not in rcx on entry");
+    __VERIFY(__locationAt(param, 0x5) == "@rcx", "parameter not in rcx through the instruction which kills it");
+    __VERIFY(__locationAt(param, 0x8) == null, "parameter still has a location after it is killed");
+    __VERIFY(__locationAt(param, 0xA) == "@rcx", "parameter not in rcx on the side which does not kill it");
+    __VERIFY(__locationAt(param, 0xB) == null, "parameter has a location where only one side kept it");
+    __VERIFY(__locationAt(param, 0xC) == null, "parameter has a location where only one side kept it");
+    return true;
+}
+
+// Test_LoopSpillsParameter:
+//
+// Verifies that a parameter spilled to its home slot before a loop which reuses its register is found in the
+// home slot (and not in the register) throughout the loop:
+//
+//     0:  mov [rsp+8], rcx
+//     5:  xor rax, rax
+//     8:  inc rax
+//     b:  xor rcx, rcx
+//     e:  cmp rax, 10h
+//     12: jl 8
+//     14: mov rcx, [rsp+8]
+//     19: ret
+//
+function Test_LoopSpillsParameter()
+{
+    if (!__isX64())
+    {
+        return true;
+    }
+
+    var param = __propagateRanges(0x900, [0x48, 0x89, 0x4C, 0x24, 0x08,
+                                          0x48, 0x33, 0xC0,
+                                          0x48, 0xFF, 0xC0,
+                                          0x48, 0x33, 0xC9,
+                                          0x48, 0x83, 0xF8, 0x10,
+                                          0x7C, 0xF4,
+                                          0x48, 0x8B, 0x4C, 0x24, 0x08,
+                                          0xC3]);
+
+    __VERIFY(__locationAt(param, 0x0) == "@rcx", "parameter not in rcx on entry");
+    __VERIFY(__locationAt(param, 0x8) == "[@rsp + 8]", "parameter not in its home slot at the loop head");
+    __VERIFY(__locationAt(param, 0xE) == "[@rsp + 8]", "parameter not in its home slot after rcx is killed");
+    __VERIFY(__locationAt(param, 0x12) == "[@rsp + 8]", "parameter not in its home slot at the back edge");
+    __VERIFY(__locationAt(param, 0x14) == "[@rsp + 8]", "parameter not in its home slot after the loop");
+    return true;
+}
+
+// Test_PropagateAllFunctions:
+//
+// Verifies the walk of every function made by Functions.PropagateLiveRangesFromCallingConvention.  Five functions
+// of the same code (mov rax, rcx / ret) are created in reverse address order.  The walk must report them in
+// address order with a progress object for each, skip the one deleted while the walk is underway, and stop
+// when the iteration is stopped:
+//
+//     a00: A       a40: B       a80: D (deleted during the walk)       ac0: C (stop here)       b00: E
+//
+function Test_PropagateAllFunctions()
+{
+    if (!__isX64())
+    {
+        return true;
+    }
+
+    var code = [0x48, 0x8B, 0xC1,
+                0xC3];
+
+    var offsets = [0xB00, 0xAC0, 0xA80, 0xA40, 0xA00];
+    var labels = ["E", "C", "D", "B", "A"];
+    var originals = [];
+    for (var i = 0; i < offsets.length; ++i)
+    {
+        originals.push(__writeCode("notepad.exe", offsets[i], code));
+    }
+
+    try
+    {
+        var funcs = {};
+        var params = {};
+        var labelOf = {};
+        for (var i = 0; i < offsets.length; ++i)
+        {
+            var name = __getUniqueName("walk" + labels[i]);
+            funcs[labels[i]] = __symbolBuilderSymbols.Functions.Create(name, "void", offsets[i], code.length);
+            params[labels[i]] = funcs[labels[i]].Parameters.Add("p", "int *");
+            labelOf[name] = labels[i];
+        }
+
+        var seen = [];
+        var lastCompleted = 0;
+        var totalAtA = 0;
+        var totalAtC = 0;
+        for (var progress of __symbolBuilderSymbols.Functions.PropagateLiveRangesFromCallingConvention())
+        {
+            __VERIFY(progress.Completed == lastCompleted + 1, "progress did not complete one function at a time");
+            __VERIFY(progress.Completed <= progress.Total, "progress completed more functions than the total");
+            lastCompleted = progress.Completed;
+
+            var label = labelOf[progress.Function.Name];
+            if (label === undefined)
+            {
+                continue;
+            }
+
+            __VERIFY(progress.Succeeded, "unable to propagate the ranges of a walked function");
+            seen.push(label);
+
+            if (label == "A")
+            {
+                totalAtA = progress.Total;
+                funcs["D"].Delete();
+            }
+            else if (label == "C")
+            {
+                totalAtC = progress.Total;
+                break;
+            }
+        }
+
+        __VERIFY(seen.join() == "A,B,C", "functions not walked in address order without the deleted one");
+        __VERIFY(totalAtC == totalAtA - 1, "total not reduced for the deleted function");
+        __VERIFY(__locationAt(params["A"], 0x0) == "@rcx", "parameter of a walked function has no ranges");
+        __VERIFY(__locationAt(params["C"], 0x3) == "@rax", "parameter of a walked function has no ranges");
+        __VERIFY(__COUNTOF(params["E"].LiveRanges) == 0, "function after the stopped iteration was walked");
+    }
+    finally
+    {
+        for (var i = 0; i < offsets.length; ++i)
+        {
+            __writeCode("notepad.exe", offsets[i], originals[i]);
+        }
+    }
+
+    return true;
+}
+
+// Test_CodeCacheReuseAndRewrite:
+//
+// Verifies that the decoded code of a function is reused by PromoteToFunction and by later propagations while
+// its code bytes are unchanged, and that writing new code bytes with 'eb' has the function decoded again:
+//
+//     0:  mov rax, rcx             ==> (eb) mov rdx, rcx
+//     3:  ret
+//
+function Test_CodeCacheReuseAndRewrite()
+{
+    if (!__isX64())
+    {
+        return true;
+    }
+
+    var codeOffset = 0xC00;
+    var original = __writeCode("notepad.exe", codeOffset, [0x48, 0x8B, 0xC1,
+                                                           0xC3]);
+    try
+    {
+        var pub = __symbolBuilderSymbols.Publics.Create(__getUniqueName("func"), codeOffset);
+        var decodes = __symbolBuilderSymbols.DecodedFunctionCount;
+
+        var func = pub.PromoteToFunction(0);
+        __VERIFY(__symbolBuilderSymbols.DecodedFunctionCount == decodes + 1,
+                 "function not decoded to find its extent");
+
+        var param = func.Parameters.Add("p", "int *");
+        func.Parameters.PropagateLiveRangesFromCallingConvention();
+        __VERIFY(__symbolBuilderSymbols.DecodedFunctionCount == decodes + 1,
+                 "propagation did not reuse the code decoded by PromoteToFunction");
+        __VERIFY(__locationAt(param, 0x3) == "@rax", "parameter not in rax after the copy");
+
+        func.Parameters.PropagateLiveRangesFromCallingConvention();
+        __VERIFY(__symbolBuilderSymbols.DecodedFunctionCount == decodes + 1,
+                 "second propagation did not reuse the decoded code");
+
+        var address = host.currentProcess.Modules.getValueAt("notepad.exe").BaseAddress.add(codeOffset);
+        __ctl.ExecuteCommand("eb 0x" + address.toString(16) + " 48 8b d1");
+
+        func.Parameters.PropagateLiveRangesFromCallingConvention();
+        __VERIFY(__symbolBuilderSymbols.DecodedFunctionCount == decodes + 2,
+                 "rewritten code was not decoded again");
+        __VERIFY(__locationAt(param, 0x3) == "@rdx", "parameter ranges do not follow the rewritten code");
+    }
+    finally
+    {
+        __writeCode("notepad.exe", codeOffset, original);
+    }
+
+    return true;
+}
+
+//**************************************************************************
+// Initialization:
+//
+
+// __testSuite:
+//
+// Defines the test suite that we are going to run in the order it will be run.  This is returned
+// from the initializeTests() method to tell the harness what to run and what each test should be called.
+//
+var __testSuite =
+[
+    { Name: "StraightLineCode", Code: Test_StraightLineCode },
+    { Name: "DiamondKillsRegister", Code: Test_DiamondKillsRegister },
+    { Name: "LoopSpillsParameter", Code: Test_LoopSpillsParameter },
+    { Name: "PropagateAllFunctions", Code: Test_PropagateAllFunctions },
+    { Name: "CodeCacheReuseAndRewrite", Code: Test_CodeCacheReuseAndRewrite }
+];
+
+// initializeTests:
+//
+// The initializer that will be called to initialize the test suite.  It must return an array
+// of test cases.
+//
+function initializeTests()
+{
+    //
+    // For test initialization, we will ensure that the symbol builder extension is loaded
+    // and subsequently create symbol builder symbols for notepad.  The functions which the tests
+    // create all live in notepad.
+    //
+    __ctl = host.namespace.Debugger.Utility.Control;
+    __ctl.ExecuteCommand(".load SymbolBuilderComposition.dll");
+    __symBuilder = host.namespace.Debugger.Utility.SymbolBuilder;
+    __symbolBuilderSymbols = __symBuilder.CreateSymbols("notepad.exe");
+    __ctl.ExecuteCommand(".reload");
+
+    return __testSuite;
+}
+
+//**************************************************************************
+// General JS Initialization:
+//
+
+function initializeScript()
+{
+    return [new host.apiVersionSupport(1, 7)];
+}
@@ -39,6 +39,39 @@ ISvcMemoryAccess *SymbolBuilderProcess::GetVirtualMemory() const
     return m_pOwningManager->GetVirtualMemory();
 }
 
+HRESULT SymbolBuilderProcess::ReadMemory(_In_ ULONG64 address,
+                                         _Out_writes_(bufferSize) void *pBuffer,
+                                         _In_ ULONG64 bufferSize,
+                                         _Out_ ULONG64 *pBytesRead) const
+{
+    HRESULT hr = S_OK;
+    *pBytesRead = 0;
+
+    ISvcMemoryAccess *pVirtualMemory = GetVirtualMemory();
+    if (pVirtualMemory == nullptr)
+    {
+        return E_UNEXPECTED;
+    }
+
+    //
+    // If we have a generalized view of the kernel and not a specific "process context", we can go and ask
+    // for the generalized kernel address context in which to perform any memory reads.
+    //
+    ComPtr<ISvcAddressContext> spAddrCtx;
+    if (m_isKernel && m_processKey == 0)
+    {
+        IfFailedReturn(m_pOwningManager->GetKernelAddressContext(&spAddrCtx));
+    }
+    else
+    {
+        ComPtr<ISvcProcess> spProcess;
+        IfFailedReturn(m_pOwningManager->ProcessKeyToProcess(m_processKey, &spProcess));
+        IfFailedReturn(spProcess.As(&spAddrCtx));
+    }
+
+    return pVirtualMemory->ReadMemory(spAddrCtx.Get(), address, pBuffer, bufferSize, pBytesRead);
+}
+
 HRESULT SymbolBuilderProcess::CreateSymbolsForModule(_In_ ISvcModule *pModule,
                                                      _In_ ULONG64 moduleKey,
                                                      _COM_Outptr_ SymbolSet **ppSymbols)
@@ -73,6 +106,21 @@ HRESULT SymbolBuilderProcess::CreateSymbolsForModule(_In_ ISvcModule *pModule,
     return hr;
 }
 
+bool SymbolBuilderProcess::RemoveSymbolsForModule(_In_ ULONG64 moduleKey)
+{
+    auto it = m_symbols.find(moduleKey);
+    if (it == m_symbols.end())
+    {
+        return false;
+    }
+
+    ComPtr<SymbolSet> spSymbolSet = it->second;
+    m_detachedSymbols.push_back(spSymbolSet);
+    m_symbols.erase(it);
+    spSymbolSet->Detach();
+    return true;
+}
+
 HRESULT SymbolBuilderManager::TrackProcessForKey(_In_ bool isKernel,
                                                  _In_ ULONG64 processKey,
                                                  _COM_Outptr_ SymbolBuilderProcess **ppProcess)
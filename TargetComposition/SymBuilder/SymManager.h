@@ -68,6 +68,16 @@ public:
                                    _In_ ULONG64 moduleKey,
                                    _COM_Outptr_ SymbolSet **ppSymbols);
 
+    // RemoveSymbolsForModule():
+    //
+    // Removes the symbol set for a given module by its unique "key".  If there was no symbol set for the module,
+    // false is returned.  The set is detached (see SymbolSet::Detach) and will no longer be found for the module.
+    //
+    // Symbols only hold a weak back pointer to their set and point into its string arena.  A script may still
+    // hold some of them, so the set itself is kept until this process goes away as it always has been.
+    //
+    bool RemoveSymbolsForModule(_In_ ULONG64 moduleKey);
+
     //*************************************************
     // Internal APIs:
     //
@@ -113,6 +123,16 @@ public:
     //
     ISvcMemoryAccess *GetVirtualMemory() const;
 
+    // ReadMemory():
+    //
+    // Reads virtual memory in the context of this process (or of the kernel if this represents the kernel and
+    // its set of modules).
+    //
+    HRESULT ReadMemory(_In_ ULONG64 address,
+                       _Out_writes_(bufferSize) void *pBuffer,
+                       _In_ ULONG64 bufferSize,
+                       _Out_ ULONG64 *pBytesRead) const;
+
     // GetProcessKey():
     //
     // Gets the process key for this process.  This will be zero if this represents the kernel and its
@@ -138,6 +158,9 @@ private:
     // of module "keys" to symbol sets within the context of this process.
     std::unordered_map<ULONG64, Microsoft::WRL::ComPtr<SymbolSet>> m_symbols;
 
+    // The symbol sets which have been removed from their modules (see RemoveSymbolsForModule).
+    std::vector<Microsoft::WRL::ComPtr<SymbolSet>> m_detachedSymbols;
+
     // Weak pointer back to our owning manager.
     SymbolBuilderManager *m_pOwningManager;
 };
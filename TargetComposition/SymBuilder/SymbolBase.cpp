@@ -30,6 +30,11 @@ namespace SymbolBuilder
 // Base Symbols:
 //
 
+HRESULT BaseSymbol::InternName(_In_ PCWSTR pwszName, _Out_ InternedString *pName)
+{
+    return m_pSymbolSet->InternalGetStringArena().Intern(pwszName, pName);
+}
+
 HRESULT BaseSymbol::InitializeNewSymbol(_In_ ULONG64 reservedId)
 {
     return m_pSymbolSet->AddNewSymbol(this, &m_id, reservedId);
@@ -159,18 +164,29 @@ HRESULT BaseSymbol::EnumerateChildren(_In_ SvcSymbolKind kind,
 HRESULT BaseSymbol::NotifyDependentChange()
 {
     HRESULT hr = S_OK;
+    SymbolSet *pSymbolSet = InternalGetSymbolSet();
+
+    //
+    // If we are being notified as part of a propagation pass, everything which depends upon us (directly or
+    // indirectly) is already part of that pass and will be notified after us.
+    //
+    if (pSymbolSet->InternalIsPropagatingDependentChanges())
+    {
+        return S_OK;
+    }
+
     for (auto&& kvp : m_dependentNotifySymbols)
     {
-        ULONG64 uniqueId = kvp.first;
-        BaseSymbol *pNotifySymbol = InternalGetSymbolSet()->InternalGetSymbol(uniqueId);
-        if (pNotifySymbol != nullptr)
-        {
-            hr = pNotifySymbol->NotifyDependentChange();
-            if (FAILED(hr))
-            {
-                return hr;
-            }
-        }
+        IfFailedReturn(pSymbolSet->InternalDeferDependentNotify(kvp.first));
+    }
+
+    //
+    // If a batch of updates is in progress, dependents are notified once when the batch commits instead
+    // of after every individual change.
+    //
+    if (!pSymbolSet->InternalIsBatchActive())
+    {
+        IfFailedReturn(pSymbolSet->InternalPropagateDependentChanges());
     }
 
     return hr;
@@ -246,7 +262,7 @@ HRESULT ChildEnumerator::GetNext(_COM_Outptr_ ISvcSymbol **ppSymbol)
             continue;
         }
 
-        if (!m_name.empty() && m_name != pBaseSymbol->InternalGetName())
+        if (!m_name.empty() && m_name != pBaseSymbol->InternalGetName().view())
         {
             continue;
         }
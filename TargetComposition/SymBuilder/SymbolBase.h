@@ -204,16 +204,17 @@ public:
         //
         auto fn = [&]()
         {
+            HRESULT hr = S_OK;
             m_pSymbolSet = pSymbolSet;
             m_parentId = parentId;
             m_kind = kind;
             if (pwszSymbolName != nullptr)
             {
-                m_name = pwszSymbolName;
+                IfFailedReturn(InternName(pwszSymbolName, &m_name));
             }
             if (pwszQualifiedName != nullptr)
             {
-                m_qualifiedName = pwszQualifiedName;
+                IfFailedReturn(InternName(pwszQualifiedName, &m_qualifiedName));
             }
             if (newSymbol)
             {
@@ -239,6 +240,17 @@ public:
     //
     virtual HRESULT NotifyDependentChange();
 
+    // NotifyChildAppended():
+    //
+    // Called when a child is appended to this symbol.  By default, this is no different than any other change.
+    // Derived classes which can cheaply account for a new last child (e.g.: a UDT placing a new field) may
+    // override this.
+    //
+    virtual HRESULT NotifyChildAppended(_In_ ULONG64 /*childId*/)
+    {
+        return NotifyDependentChange();
+    }
+
     // IsGlobal():
     //
     // Returns whether or not the symbol is "global".  A global symbol will be indexed by name.  Child symbols
@@ -279,7 +291,7 @@ public:
         auto fn = [&]()
         {
             m_children.push_back(uniqueId);
-            return NotifyDependentChange();
+            return NotifyChildAppended(uniqueId);
         };
         return ConvertException(fn);
     }
@@ -402,8 +414,8 @@ public:
     //
 
     SymbolSet *InternalGetSymbolSet() const { return m_pSymbolSet; }
-    std::wstring const& InternalGetName() const { return m_name; }
-    std::wstring const& InternalGetQualifiedName() const
+    InternedString InternalGetName() const { return m_name; }
+    InternedString InternalGetQualifiedName() const
     {
         return m_qualifiedName.empty() ? m_name : m_qualifiedName;
     }
@@ -411,12 +423,13 @@ public:
     ULONG64 InternalGetId() const { return m_id; }
     ULONG64 InternalGetParentId() const { return m_parentId; }
     std::vector<ULONG64> const& InternalGetChildren() { return m_children; }
+    std::unordered_map<ULONG64, ULONG64> const& InternalGetDependentNotifySymbols() const
+    {
+        return m_dependentNotifySymbols;
+    }
     bool InternalSetName(_In_opt_ PCWSTR pwszName)
     {
-        return SUCCEEDED(ConvertException([&](){
-            m_name = pwszName;
-            return S_OK;
-        }));
+        return SUCCEEDED(InternName(pwszName == nullptr ? L"" : pwszName, &m_name));
     }
 
 protected:
@@ -430,9 +443,9 @@ protected:
     // The kind of this symbol
     SvcSymbolKind m_kind;
 
-    // The names of this symbol
-    std::wstring m_name;
-    std::wstring m_qualifiedName;
+    // The names of this symbol (interned in the string arena of the owning symbol set)
+    InternedString m_name;
+    InternedString m_qualifiedName;
 
     // Index of children of this symbol
     std::vector<ULONG64> m_children;
@@ -450,6 +463,12 @@ protected:
 
 private:
 
+    // InternName():
+    //
+    // Interns a name in the string arena of the owning symbol set.
+    //
+    HRESULT InternName(_In_ PCWSTR pwszName, _Out_ InternedString *pName);
+
     // InitializeNewSymbol():
     //
     // Called to initialize a new symbol.  This adds it to the symbol set's list, assigns a unique id,
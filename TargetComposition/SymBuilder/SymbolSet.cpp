@@ -32,6 +32,11 @@ namespace SymbolBuilder
 
 bool PublicList::FindNearestSymbols(_In_ ULONG64 address, _Out_ SymbolList const** pSymbolList)
 {
+    if (FAILED(FlushPendingSymbols()))
+    {
+        return false;
+    }
+
     if (m_addresses.size() == 0)
     {
         return false;
@@ -65,11 +70,27 @@ bool PublicList::FindNearestSymbols(_In_ ULONG64 address, _Out_ SymbolList const
 
 HRESULT PublicList::AddSymbol(_In_ ULONG64 address, _In_ ULONG64 symbol)
 {
+    HRESULT hr = S_OK;
+
+    //
+    // In bulk load mode, defer the sorted insertion until the entire batch can be sorted at once.
+    //
+    if (!m_bulkLoad)
+    {
+        IfFailedReturn(FlushPendingSymbols());
+    }
+
     //
     // We cannot let a C++ exception escape.
     //
     auto fn = [&]()
     {
+        if (m_bulkLoad)
+        {
+            m_pendingSymbols.push_back( { address, symbol } );
+            return S_OK;
+        }
+
         auto it = std::lower_bound(m_addresses.begin(), m_addresses.end(), address,
                                    [&](_In_ const Address& symAddr, _In_ ULONG64 address)
                                    {
@@ -108,6 +129,9 @@ HRESULT PublicList::AddSymbol(_In_ ULONG64 address, _In_ ULONG64 symbol)
 
 HRESULT PublicList::RemoveSymbol(_In_ ULONG64 address, _In_ ULONG64 symbol)
 {
+    HRESULT hr = S_OK;
+    IfFailedReturn(FlushPendingSymbols());
+
     //
     // We cannot let a C++ exception escape.
     //
@@ -145,8 +169,71 @@ HRESULT PublicList::RemoveSymbol(_In_ ULONG64 address, _In_ ULONG64 symbol)
     return ConvertException(fn);
 }
 
+HRESULT PublicList::FlushPendingSymbols()
+{
+    if (m_pendingSymbols.empty())
+    {
+        return S_OK;
+    }
+
+    //
+    // We cannot let a C++ exception escape.
+    //
+    auto fn = [&]()
+    {
+        //
+        // The sort must be stable so that multiple symbols at the same address retain the order in which
+        // they were added.
+        //
+        std::stable_sort(m_pendingSymbols.begin(), m_pendingSymbols.end(),
+                         [&](_In_ const std::pair<ULONG64, ULONG64>& a, _In_ const std::pair<ULONG64, ULONG64>& b)
+                         {
+                             return a.first < b.first;
+                         });
+
+        //
+        // Merge the (already sorted) table and the pending list.  An existing entry at the same address as
+        // pending symbols comes first so that the new symbols are appended to its list exactly as AddSymbol
+        // would have done.
+        //
+        std::vector<Address> merged;
+        merged.reserve(m_addresses.size() + m_pendingSymbols.size());
+
+        auto itExisting = m_addresses.begin();
+        auto itPending = m_pendingSymbols.begin();
+        while (itExisting != m_addresses.end() || itPending != m_pendingSymbols.end())
+        {
+            if (itPending == m_pendingSymbols.end() ||
+                (itExisting != m_addresses.end() && itExisting->Addr <= itPending->first))
+            {
+                merged.push_back(std::move(*itExisting));
+                ++itExisting;
+                continue;
+            }
+
+            if (merged.empty() || merged.back().Addr != itPending->first)
+            {
+                merged.push_back( { itPending->first, { } } );
+            }
+
+            merged.back().Symbols.push_back(itPending->second);
+            ++itPending;
+        }
+
+        m_addresses = std::move(merged);
+        m_pendingSymbols.clear();
+        return S_OK;
+    };
+    return ConvertException(fn);
+}
+
 bool SymbolRangeList::FindSymbols(_In_ ULONG64 address, _Out_ SymbolList const** pSymbolList)
 {
+    if (FAILED(FlushPendingRanges()))
+    {
+        return false;
+    }
+
     auto it = std::lower_bound(m_ranges.begin(), m_ranges.end(), address,
                                [&](_In_ const AddressRange& rng, _In_ ULONG64 address)
                                {
@@ -164,11 +251,27 @@ bool SymbolRangeList::FindSymbols(_In_ ULONG64 address, _Out_ SymbolList const**
 
 HRESULT SymbolRangeList::AddSymbol(_In_ ULONG64 start, _In_ ULONG64 end, _In_ ULONG64 symbol)
 {
+    HRESULT hr = S_OK;
+
+    //
+    // In bulk load mode, defer the splitting and insertion until the entire batch can be swept at once.
+    //
+    if (!m_bulkLoad)
+    {
+        IfFailedReturn(FlushPendingRanges());
+    }
+
     //
     // We cannot let a C++ exception escape.
     //
     auto fn = [&]()
     {
+        if (m_bulkLoad)
+        {
+            m_pendingRanges.push_back( { start, end, symbol } );
+            return S_OK;
+        }
+
         //
         // We must find the proper position within the address range to place the symbol in sorted
         // order.  If there is no overlap, this is easy.  If there is overlap, we must split the ranges
@@ -311,6 +414,9 @@ HRESULT SymbolRangeList::AddSymbol(_In_ ULONG64 start, _In_ ULONG64 end, _In_ UL
 
 HRESULT SymbolRangeList::RemoveSymbol(_In_ ULONG64 start, _In_ ULONG64 end, _In_ ULONG64 symbol)
 {
+    HRESULT hr = S_OK;
+    IfFailedReturn(FlushPendingRanges());
+
     //
     // We cannot let a C++ exception escape.
     //
@@ -413,6 +519,242 @@ HRESULT SymbolRangeList::RemoveSymbol(_In_ ULONG64 start, _In_ ULONG64 end, _In_
     return ConvertException(fn);
 }
 
+HRESULT SymbolRangeList::FlushPendingRanges()
+{
+    if (m_pendingRanges.empty())
+    {
+        return S_OK;
+    }
+
+    //
+    // We cannot let a C++ exception escape.
+    //
+    auto fn = [&]()
+    {
+        //
+        // Every start and end of an existing or pending range is a potential split point.  Between any two
+        // adjacent split points, the set of ranges covering the addresses is constant.  Empty pending ranges
+        // cover nothing and are ignored.
+        //
+        std::vector<ULONG64> bounds;
+        bounds.reserve(2 * (m_ranges.size() + m_pendingRanges.size()));
+        for (auto const& rng : m_ranges)
+        {
+            bounds.push_back(rng.Start);
+            bounds.push_back(rng.End);
+        }
+
+        std::vector<size_t> pendingByStart;
+        pendingByStart.reserve(m_pendingRanges.size());
+        for (size_t i = 0; i < m_pendingRanges.size(); ++i)
+        {
+            PendingRange const& pending = m_pendingRanges[i];
+            if (pending.Start < pending.End)
+            {
+                bounds.push_back(pending.Start);
+                bounds.push_back(pending.End);
+                pendingByStart.push_back(i);
+            }
+        }
+
+        std::sort(bounds.begin(), bounds.end());
+        bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+
+        std::sort(pendingByStart.begin(), pendingByStart.end(),
+                  [&](_In_ size_t a, _In_ size_t b)
+                  {
+                      return m_pendingRanges[a].Start < m_pendingRanges[b].Start;
+                  });
+
+        //
+        // Sweep the split points in order.  The active set of pending ranges is keyed by the order in which
+        // they were added so that each resulting symbol list has the existing symbols first followed by the
+        // new ones in insertion order -- the same lists incremental addition would have produced.
+        //
+        using EndEntry = std::pair<ULONG64, size_t>;
+        std::priority_queue<EndEntry, std::vector<EndEntry>, std::greater<EndEntry>> activeEnds;
+        std::map<size_t, ULONG64> active;
+
+        std::vector<AddressRange> swept;
+        swept.reserve(m_ranges.size() + pendingByStart.size());
+
+        size_t curExisting = 0;
+        size_t curPending = 0;
+        for (size_t b = 0; b + 1 < bounds.size(); ++b)
+        {
+            ULONG64 pieceStart = bounds[b];
+            ULONG64 pieceEnd = bounds[b + 1];
+
+            while (!activeEnds.empty() && activeEnds.top().first <= pieceStart)
+            {
+                active.erase(activeEnds.top().second);
+                activeEnds.pop();
+            }
+
+            while (curPending < pendingByStart.size() &&
+                   m_pendingRanges[pendingByStart[curPending]].Start == pieceStart)
+            {
+                size_t idx = pendingByStart[curPending];
+                active.insert( { idx, m_pendingRanges[idx].Symbol } );
+                activeEnds.push( { m_pendingRanges[idx].End, idx } );
+                ++curPending;
+            }
+
+            while (curExisting < m_ranges.size() && m_ranges[curExisting].End <= pieceStart)
+            {
+                ++curExisting;
+            }
+
+            bool existingCovers = (curExisting < m_ranges.size() && m_ranges[curExisting].Start <= pieceStart);
+            if (!existingCovers && active.empty())
+            {
+                continue;
+            }
+
+            AddressRange piece { pieceStart, pieceEnd, { } };
+            if (existingCovers)
+            {
+                piece.Symbols = m_ranges[curExisting].Symbols;
+            }
+
+            for (auto const& activeSymbol : active)
+            {
+                piece.Symbols.push_back(activeSymbol.second);
+            }
+
+            swept.push_back(std::move(piece));
+        }
+
+        m_ranges = std::move(swept);
+        m_pendingRanges.clear();
+        return S_OK;
+    };
+    return ConvertException(fn);
+}
+
+HRESULT SymbolNameIndex::AddSymbol(_In_ InternedString name, _In_ ULONG64 symbol)
+{
+    //
+    // We cannot let a C++ exception escape.
+    //
+    auto fn = [&]()
+    {
+        m_names.insert( { name.view(), symbol } );
+        return S_OK;
+    };
+    return ConvertException(fn);
+}
+
+HRESULT SymbolNameIndex::RemoveSymbol(_In_ InternedString name, _In_ ULONG64 symbol)
+{
+    //
+    // The names in the range differ from 'name' at most in case.  Only remove the exact entry.
+    //
+    auto range = m_names.equal_range(name.view());
+    for (auto it = range.first; it != range.second; ++it)
+    {
+        if (it->second == symbol && it->first == name.view())
+        {
+            m_names.erase(it);
+            return S_OK;
+        }
+    }
+
+    return E_BOUNDS;
+}
+
+HRESULT SymbolNameIndex::FindSymbols(_In_ PCWSTR pwszPattern,
+                                     _In_ bool wildcard,
+                                     _In_ bool caseInsensitive,
+                                     _Out_ SymbolList *pSymbols) const
+{
+    //
+    // We cannot let a C++ exception escape.
+    //
+    auto fn = [&]()
+    {
+        pSymbols->clear();
+
+        //
+        // Everything up to the first wildcard must match literally.  As names are ordered without regard to case,
+        // all of the names starting with that prefix (in any case) are contiguous and begin at its lower bound.
+        // A pattern which starts with a wildcard has no prefix and must look at every name.
+        //
+        size_t prefixLength = wildcard ? wcscspn(pwszPattern, L"*?") : wcslen(pwszPattern);
+        std::wstring_view prefix(pwszPattern, prefixLength);
+
+        for (auto it = m_names.lower_bound(prefix);
+             it != m_names.end() &&
+                 it->first.size() >= prefixLength &&
+                 _wcsnicmp(it->first.data(), pwszPattern, prefixLength) == 0;
+             ++it)
+        {
+            bool isMatch;
+            if (wildcard)
+            {
+                isMatch = MatchesWildcard(pwszPattern, it->first.data(), caseInsensitive);
+            }
+            else
+            {
+                isMatch = (caseInsensitive ? _wcsicmp(it->first.data(), pwszPattern)
+                                           : wcscmp(it->first.data(), pwszPattern)) == 0;
+            }
+
+            if (isMatch)
+            {
+                pSymbols->push_back(it->second);
+            }
+        }
+
+        std::sort(pSymbols->begin(), pSymbols->end());
+        pSymbols->erase(std::unique(pSymbols->begin(), pSymbols->end()), pSymbols->end());
+        return S_OK;
+    };
+    return ConvertException(fn);
+}
+
+bool SymbolNameIndex::MatchesWildcard(_In_ PCWSTR pwszPattern, _In_ PCWSTR pwszName, _In_ bool caseInsensitive)
+{
+    //
+    // A greedy match which, on a mismatch, backtracks to let the most recent '*' consume one more character.
+    // This is linear in the length of the name for all but pathological patterns.
+    //
+    PCWSTR pStar = nullptr;
+    PCWSTR pStarName = nullptr;
+    while (*pwszName != L'\0')
+    {
+        if (*pwszPattern == L'*')
+        {
+            pStar = pwszPattern++;
+            pStarName = pwszName;
+        }
+        else if (*pwszPattern != L'\0' &&
+                 (*pwszPattern == L'?' ||
+                  *pwszPattern == *pwszName ||
+                  (caseInsensitive && towlower(*pwszPattern) == towlower(*pwszName))))
+        {
+            ++pwszPattern;
+            ++pwszName;
+        }
+        else if (pStar != nullptr)
+        {
+            pwszPattern = pStar + 1;
+            pwszName = ++pStarName;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    while (*pwszPattern == L'*')
+    {
+        ++pwszPattern;
+    }
+
+    return *pwszPattern == L'\0';
+}
+
 IDebugServiceManager* SymbolSet::GetServiceManager() const
 {
     return m_pOwningProcess->GetServiceManager();
@@ -470,6 +812,12 @@ HRESULT SymbolSet::AddNewSymbol(_In_ BaseSymbol *pBaseSymbol, _Out_ ULONG64 *pUn
     //
     auto fn = [&]()
     {
+        HRESULT hr = S_OK;
+        if (m_detached)
+        {
+            return E_ILLEGAL_METHOD_CALL;
+        }
+
         ULONG64 uniqueId = (reservedId == 0 ? GetUniqueId() : reservedId);
         if (uniqueId > std::numeric_limits<size_t>::max())
         {
@@ -490,10 +838,18 @@ HRESULT SymbolSet::AddNewSymbol(_In_ BaseSymbol *pBaseSymbol, _Out_ ULONG64 *pUn
 
         if (pBaseSymbol->IsGlobal())
         {
-            m_globalSymbols.push_back(uniqueId);
+            GlobalKindIndex& kindIndex = m_globalKindIndexes[pBaseSymbol->InternalGetKind()];
+            m_globalSymbols.insert(uniqueId);
+            kindIndex.Symbols.insert(uniqueId);
             if (!pBaseSymbol->InternalGetQualifiedName().empty())
             {
-                m_symbolNameMap.insert( { pBaseSymbol->InternalGetQualifiedName(), uniqueId });
+                m_symbolNameMap.insert( { pBaseSymbol->InternalGetQualifiedName().view(), uniqueId });
+                IfFailedReturn(kindIndex.NameIndex.AddSymbol(pBaseSymbol->InternalGetQualifiedName(), uniqueId));
+            }
+            if (!pBaseSymbol->InternalGetName().empty() &&
+                pBaseSymbol->InternalGetName() != pBaseSymbol->InternalGetQualifiedName())
+            {
+                IfFailedReturn(kindIndex.NameIndex.AddSymbol(pBaseSymbol->InternalGetName(), uniqueId));
             }
         }
 
@@ -511,6 +867,25 @@ HRESULT SymbolSet::AddNewSymbol(_In_ BaseSymbol *pBaseSymbol, _Out_ ULONG64 *pUn
     return ConvertException(fn);
 }
 
+void SymbolSet::Detach()
+{
+    if (m_detached)
+    {
+        return;
+    }
+
+    m_detached = true;
+
+    //
+    // Nothing may pull new symbols into the set once it is detached.
+    //
+    if (HasImporter())
+    {
+        m_spImporter->DisconnectFromSource();
+        m_spImporter.reset();
+    }
+}
+
 HRESULT SymbolSet::DeleteExistingSymbol(_In_ ULONG64 uniqueId)
 {
     //
@@ -527,27 +902,35 @@ HRESULT SymbolSet::DeleteExistingSymbol(_In_ ULONG64 uniqueId)
             return E_INVALIDARG;
         }
 
+        if (m_detached)
+        {
+            return E_ILLEGAL_METHOD_CALL;
+        }
+
         BaseSymbol *pSymbol = InternalGetSymbol(uniqueId);
         if (pSymbol != nullptr)
         {
             if (pSymbol->IsGlobal())
             {
-                for (auto itg = m_globalSymbols.begin(); itg != m_globalSymbols.end(); ++itg)
-                {
-                    if (*itg == uniqueId)
-                    {
-                        m_globalSymbols.erase(itg);
-                        break;
-                    }
-                }
+                m_globalSymbols.erase(uniqueId);
+
+                GlobalKindIndex& kindIndex = m_globalKindIndexes[pSymbol->InternalGetKind()];
+                kindIndex.Symbols.erase(uniqueId);
 
                 if (!pSymbol->InternalGetQualifiedName().empty())
                 {
-                    auto itn = m_symbolNameMap.find(pSymbol->InternalGetQualifiedName());
+                    auto itn = m_symbolNameMap.find(pSymbol->InternalGetQualifiedName().view());
                     if (itn != m_symbolNameMap.end())
                     {
                         m_symbolNameMap.erase(itn);
                     }
+
+                    (void)kindIndex.NameIndex.RemoveSymbol(pSymbol->InternalGetQualifiedName(), uniqueId);
+                }
+                if (!pSymbol->InternalGetName().empty() &&
+                    pSymbol->InternalGetName() != pSymbol->InternalGetQualifiedName())
+                {
+                    (void)kindIndex.NameIndex.RemoveSymbol(pSymbol->InternalGetName(), uniqueId);
                 }
             }
 
@@ -642,6 +1025,15 @@ HRESULT SymbolSet::InvalidateExternalCaches()
     //
     if (!m_cacheInvalidationDisabled)
     {
+        //
+        // If a batch of updates is in progress, the invalidation is sent once when the batch commits.
+        //
+        if (m_batchDepth > 0)
+        {
+            m_batchInvalidationPending = true;
+            return S_OK;
+        }
+
         IDebugServiceManager *pServiceManager = GetServiceManager();
         if (pServiceManager == nullptr)
         {
@@ -653,6 +1045,7 @@ HRESULT SymbolSet::InvalidateExternalCaches()
 
         HRESULT hrEvent;
         IfFailedReturn(pServiceManager->FireEventNotification(DEBUG_SVCEVENT_SYMBOLCACHEINVALIDATE, spArgs.Get(), &hrEvent));
+        ++m_cacheInvalidationCount;
     }
 
     //
@@ -662,6 +1055,187 @@ HRESULT SymbolSet::InvalidateExternalCaches()
     return hr;
 }
 
+HRESULT SymbolSet::InternalDeferDependentNotify(_In_ ULONG64 uniqueId)
+{
+    //
+    // We cannot let a C++ exception escape.
+    //
+    auto fn = [&]()
+    {
+        if (m_pendingNotifySet.insert(uniqueId).second)
+        {
+            m_pendingNotify.push_back(uniqueId);
+        }
+        return S_OK;
+    };
+    return ConvertException(fn);
+}
+
+HRESULT SymbolSet::InternalPropagateDependentChanges()
+{
+    if (m_propagatingDependentChanges || m_pendingNotify.empty())
+    {
+        return S_OK;
+    }
+
+    std::vector<ULONG64> notifyOrder;
+
+    //
+    // We cannot let a C++ exception escape.
+    //
+    auto fn = [&]()
+    {
+        //
+        // Gather everything which must be notified: the queued symbols and, transitively, everything which
+        // depends upon them.  Each is mapped to the number of things it depends upon within the pass.
+        //
+        std::vector<ULONG64> affected;
+        std::unordered_map<ULONG64, size_t> pendingDependencies;
+        for (ULONG64 uniqueId : m_pendingNotify)
+        {
+            if (pendingDependencies.insert( { uniqueId, 0 }).second)
+            {
+                affected.push_back(uniqueId);
+            }
+        }
+
+        for (size_t i = 0; i < affected.size(); ++i)
+        {
+            BaseSymbol *pSymbol = InternalGetSymbol(affected[i]);
+            if (pSymbol == nullptr)
+            {
+                continue;
+            }
+
+            for (auto&& kvp : pSymbol->InternalGetDependentNotifySymbols())
+            {
+                auto result = pendingDependencies.insert( { kvp.first, 0 });
+                if (result.second)
+                {
+                    affected.push_back(kvp.first);
+                }
+                ++(result.first->second);
+            }
+        }
+
+        //
+        // Order the pass so that a symbol is only notified after everything it depends upon within the pass
+        // (e.g.: a struct is laid out after every struct it embeds has been).  Anything left over is part of
+        // a dependency cycle (which a well formed set of types cannot have); such symbols are notified last
+        // in the order they were found.
+        //
+        notifyOrder.reserve(affected.size());
+        for (ULONG64 uniqueId : affected)
+        {
+            if (pendingDependencies[uniqueId] == 0)
+            {
+                notifyOrder.push_back(uniqueId);
+            }
+        }
+
+        for (size_t i = 0; i < notifyOrder.size(); ++i)
+        {
+            BaseSymbol *pSymbol = InternalGetSymbol(notifyOrder[i]);
+            if (pSymbol == nullptr)
+            {
+                continue;
+            }
+
+            for (auto&& kvp : pSymbol->InternalGetDependentNotifySymbols())
+            {
+                size_t& remaining = pendingDependencies[kvp.first];
+                if (remaining > 0 && --remaining == 0)
+                {
+                    notifyOrder.push_back(kvp.first);
+                }
+            }
+        }
+
+        if (notifyOrder.size() < affected.size())
+        {
+            for (ULONG64 uniqueId : affected)
+            {
+                if (pendingDependencies[uniqueId] > 0)
+                {
+                    notifyOrder.push_back(uniqueId);
+                }
+            }
+        }
+
+        return S_OK;
+    };
+
+    HRESULT hr = ConvertException(fn);
+    m_pendingNotify.clear();
+    m_pendingNotifySet.clear();
+    if (FAILED(hr))
+    {
+        return hr;
+    }
+
+    //
+    // Deliver the notifications.  While the pass is in progress, a notified symbol does not notify its own
+    // dependents; they are already later in the pass.
+    //
+    m_propagatingDependentChanges = true;
+    for (ULONG64 uniqueId : notifyOrder)
+    {
+        BaseSymbol *pNotifySymbol = InternalGetSymbol(uniqueId);
+        if (pNotifySymbol != nullptr)
+        {
+            HRESULT hrNotify = pNotifySymbol->NotifyDependentChange();
+            if (FAILED(hrNotify) && SUCCEEDED(hr))
+            {
+                hr = hrNotify;
+            }
+        }
+    }
+    m_propagatingDependentChanges = false;
+
+    return hr;
+}
+
+HRESULT SymbolSet::CommitBatch()
+{
+    if (m_batchDepth == 0)
+    {
+        return E_UNEXPECTED;
+    }
+
+    if (m_batchDepth > 1)
+    {
+        --m_batchDepth;
+        return S_OK;
+    }
+
+    //
+    // Deliver the deferred dependency notifications while still inside the batch.  No matter how many of the
+    // things a symbol depends upon changed during the batch, it is notified once (e.g.: a type is laid out
+    // once after everything it contains has been).
+    //
+    HRESULT hr = InternalPropagateDependentChanges();
+
+    HRESULT hrLoad = SetBulkLoad(false);
+    if (FAILED(hrLoad) && SUCCEEDED(hr))
+    {
+        hr = hrLoad;
+    }
+
+    m_batchDepth = 0;
+
+    //
+    // Send the single advisory notification upwards for everything which changed in the batch.  As with
+    // individual changes, do not consider this a failure of the batch.
+    //
+    if (m_batchInvalidationPending)
+    {
+        m_batchInvalidationPending = false;
+        (void)InvalidateExternalCaches();
+    }
+
+    return hr;
+}
+
 HRESULT SymbolSet::FindTypeByName(_In_ std::wstring const& typeName,
                                   _Out_ ULONG64 *pTypeId,
                                   _Outptr_ BaseTypeSymbol **ppTypeSymbol,
@@ -908,8 +1482,7 @@ HRESULT SymbolSet::FindSymbolByName(_In_ PCWSTR symbolName, _COM_Outptr_ ISvcSym
     //
     auto fn = [&]()
     {
-        std::wstring name = symbolName;
-        auto it = m_symbolNameMap.find(name);
+        auto it = m_symbolNameMap.find(std::wstring_view(symbolName));
         if (it == m_symbolNameMap.end())
         {
             return E_BOUNDS;
@@ -928,6 +1501,54 @@ HRESULT SymbolSet::FindSymbolByName(_In_ PCWSTR symbolName, _COM_Outptr_ ISvcSym
     return ConvertException(fn);
 }
 
+HRESULT SymbolSet::FindGlobalSymbols(_In_ PCWSTR pwszPattern,
+                                     _In_ bool caseInsensitive,
+                                     _Out_ std::vector<ULONG64> *pSymbols)
+{
+    //
+    // Give any underlying importer a chance to bring in what matches.  A literal name goes down the same
+    // path as any other name query; a wildcard pattern goes down the importer's pattern path.
+    //
+    if (HasImporter())
+    {
+        //
+        // Failure to import should NOT trigger failure in the rest of the symbol builder!
+        //
+        if (SymbolNameIndex::IsWildcardPattern(pwszPattern))
+        {
+            (void)m_spImporter->ImportForRegExQuery(SvcSymbol, pwszPattern);
+        }
+        else
+        {
+            (void)m_spImporter->ImportForNameQuery(SvcSymbol, pwszPattern);
+        }
+    }
+
+    //
+    // We cannot let a C++ exception escape.
+    //
+    auto fn = [&]()
+    {
+        HRESULT hr = S_OK;
+        pSymbols->clear();
+
+        //
+        // Every global symbol is in the name index of exactly one kind.  The union of what each kind matches
+        // therefore has no duplicates and only needs to be put back in id order.
+        //
+        SymbolNameIndex::SymbolList kindSymbols;
+        for (auto&& kvp : m_globalKindIndexes)
+        {
+            IfFailedReturn(kvp.second.NameIndex.FindSymbols(pwszPattern, true, caseInsensitive, &kindSymbols));
+            pSymbols->insert(pSymbols->end(), kindSymbols.begin(), kindSymbols.end());
+        }
+
+        std::sort(pSymbols->begin(), pSymbols->end());
+        return hr;
+    };
+    return ConvertException(fn);
+}
+
 HRESULT SymbolSet::FindSymbolByOffset(_In_ ULONG64 moduleOffset,
                                       _In_ bool exactMatchOnly,
                                       _COM_Outptr_ ISvcSymbol **ppSymbol,
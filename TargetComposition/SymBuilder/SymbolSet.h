@@ -42,11 +42,18 @@ public:
 
     using SymbolList = std::vector<ULONG64>;
 
+    struct Address
+    {
+        ULONG64 Addr;
+        SymbolList Symbols;
+    };
+
     // PublicList():
     //
     // Creates a new public symbol list.  Initially, there are no symbols in the list.
     //
-    PublicList()
+    PublicList() :
+        m_bulkLoad(false)
     {
     }
 
@@ -69,13 +76,48 @@ public:
     //
     HRESULT RemoveSymbol(_In_ ULONG64 address, _In_ ULONG64 symbol);
 
-private:
-    
-    struct Address
+    // BeginBulkLoad():
+    //
+    // Places the list in bulk load mode.  Until EndBulkLoad is called, AddSymbol simply appends to an
+    // unordered pending list rather than inserting in sorted order.  The pending list is sorted and merged
+    // into the table in a single pass at EndBulkLoad (or the next time the table must be searched).
+    //
+    void BeginBulkLoad()
     {
-        ULONG64 Addr;
-        SymbolList Symbols;
-    };
+        m_bulkLoad = true;
+    }
+
+    // EndBulkLoad():
+    //
+    // Leaves bulk load mode and merges any pending symbols into the sorted table.
+    //
+    HRESULT EndBulkLoad()
+    {
+        m_bulkLoad = false;
+        return FlushPendingSymbols();
+    }
+
+    // GetAddresses():
+    //
+    // Gets the sorted table of addresses and the symbols at each.  Any symbols pending from a bulk load are
+    // merged into the table first.
+    //
+    HRESULT GetAddresses(_Out_ std::vector<Address> const** ppAddresses)
+    {
+        HRESULT hr = FlushPendingSymbols();
+        *ppAddresses = &m_addresses;
+        return hr;
+    }
+
+private:
+
+    // FlushPendingSymbols():
+    //
+    // Sorts any symbols added in bulk load mode and merges them into the sorted table.  Symbols at the same
+    // address are coalesced into a single entry in the order they were added (after any symbols which were
+    // already in the table).
+    //
+    HRESULT FlushPendingSymbols();
 
     // RemoveSymbolFromList():
     //
@@ -95,6 +137,10 @@ private:
 
     std::vector<Address> m_addresses;
 
+    // Symbols added in bulk load mode which have not yet been merged into m_addresses: pair< address, symbol >
+    std::vector<std::pair<ULONG64, ULONG64>> m_pendingSymbols;
+    bool m_bulkLoad;
+
 };
 
 // SymbolRangeList:
@@ -108,12 +154,20 @@ public:
 
     using SymbolList = std::vector<ULONG64>;
 
+    struct AddressRange
+    {
+        ULONG64 Start;
+        ULONG64 End;
+        SymbolList Symbols;
+    };
+
     // SymbolRangeList():
     //
     // Creates a new symbol range list covering the half-open set [start, end).  Initially, there
     // are no symbols in the list.
     //
-    SymbolRangeList()
+    SymbolRangeList() :
+        m_bulkLoad(false)
     {
     }
 
@@ -137,15 +191,55 @@ public:
     //
     HRESULT RemoveSymbol(_In_ ULONG64 start, _In_ ULONG64 end, _In_ ULONG64 symbol);
 
+    // BeginBulkLoad():
+    //
+    // Places the list in bulk load mode.  Until EndBulkLoad is called, AddSymbol simply appends to an
+    // unordered pending list rather than splitting and inserting ranges in place.  The pending list is
+    // swept into the table in a single pass at EndBulkLoad (or the next time the table must be searched).
+    //
+    void BeginBulkLoad()
+    {
+        m_bulkLoad = true;
+    }
+
+    // EndBulkLoad():
+    //
+    // Leaves bulk load mode and merges any pending ranges into the sorted table.
+    //
+    HRESULT EndBulkLoad()
+    {
+        m_bulkLoad = false;
+        return FlushPendingRanges();
+    }
+
+    // GetRanges():
+    //
+    // Gets the sorted table of non-overlapping address ranges and the symbols covering each.  Any ranges pending
+    // from a bulk load are swept into the table first.
+    //
+    HRESULT GetRanges(_Out_ std::vector<AddressRange> const** ppRanges)
+    {
+        HRESULT hr = FlushPendingRanges();
+        *ppRanges = &m_ranges;
+        return hr;
+    }
+
 private:
-    
-    struct AddressRange
+
+    struct PendingRange
     {
         ULONG64 Start;
         ULONG64 End;
-        SymbolList Symbols;
+        ULONG64 Symbol;
     };
 
+    // FlushPendingRanges():
+    //
+    // Sorts any ranges added in bulk load mode and sweeps them into the sorted table, splitting wherever
+    // ranges overlap.  The result is identical to having added each range in turn through AddSymbol.
+    //
+    HRESULT FlushPendingRanges();
+
     // RemoveSymbolFromList():
     //
     // Removes a symbol from the given list.
@@ -164,6 +258,105 @@ private:
 
     std::vector<AddressRange> m_ranges;
 
+    // Ranges added in bulk load mode which have not yet been swept into m_ranges (in the order added).
+    std::vector<PendingRange> m_pendingRanges;
+    bool m_bulkLoad;
+
+};
+
+// SymbolNameIndex:
+//
+// Provides an index of names in sorted order which can be searched for exact names, prefixes, or wildcard
+// patterns.  Names are ordered without regard to case so that every name beginning with a given prefix (in any
+// case) is contiguous.  A search therefore only visits the names sharing the literal prefix of what is being
+// searched for, whether or not the search itself is case sensitive.
+//
+class SymbolNameIndex
+{
+public:
+
+    using SymbolList = std::vector<ULONG64>;
+
+    // AddSymbol():
+    //
+    // Adds a name for a symbol to the index.  A symbol may be indexed under more than one name.
+    //
+    HRESULT AddSymbol(_In_ InternedString name, _In_ ULONG64 symbol);
+
+    // RemoveSymbol():
+    //
+    // Removes a name for a symbol from the index.
+    //
+    HRESULT RemoveSymbol(_In_ InternedString name, _In_ ULONG64 symbol);
+
+    // FindSymbols():
+    //
+    // Finds the symbols with a name matching a pattern.  If 'wildcard' is true, a '*' in the pattern matches
+    // any sequence of characters and a '?' matches any single character.  Otherwise, the pattern is matched
+    // literally.  The resulting list is sorted by symbol id and has no duplicates.
+    //
+    HRESULT FindSymbols(_In_ PCWSTR pwszPattern,
+                        _In_ bool wildcard,
+                        _In_ bool caseInsensitive,
+                        _Out_ SymbolList *pSymbols) const;
+
+    // IsWildcardPattern():
+    //
+    // Indicates whether a pattern contains any wildcard characters.
+    //
+    static bool IsWildcardPattern(_In_ PCWSTR pwszPattern)
+    {
+        return pwszPattern[wcscspn(pwszPattern, L"*?")] != L'\0';
+    }
+
+    // MatchesWildcard():
+    //
+    // Indicates whether a name matches a wildcard pattern.
+    //
+    static bool MatchesWildcard(_In_ PCWSTR pwszPattern, _In_ PCWSTR pwszName, _In_ bool caseInsensitive);
+
+private:
+
+    // NameOrder:
+    //
+    // Orders names without regard to case.
+    //
+    struct NameOrder
+    {
+        bool operator()(_In_ std::wstring_view a, _In_ std::wstring_view b) const
+        {
+            int result = _wcsnicmp(a.data(), b.data(), (std::min)(a.size(), b.size()));
+            return result < 0 || (result == 0 && a.size() < b.size());
+        }
+    };
+
+    // The names are interned (see StringArena) and are therefore null terminated.
+    std::multimap<std::wstring_view, ULONG64, NameOrder> m_names;
+};
+
+// GlobalKindIndex:
+//
+// The global symbols of a single kind (see BaseSymbol::IsGlobal): their ids in ascending order and an index
+// of their names and qualified names.  Anything which only wants the functions (or data, types, etc...) of a
+// symbol set walks this rather than every symbol in the set.  The ids are kept ordered so that a symbol can be
+// removed without a linear search and so that a walk which may see deletions between steps can resume after
+// the last id it returned (see GlobalKindIndex::NextSymbol) rather than at a position which may have shifted.
+//
+struct GlobalKindIndex
+{
+    // NextSymbol():
+    //
+    // Gets the first id in 'symbols' which is at or after 'startId' or 0 if there is no such id.  As unique
+    // ids start at 1, a walk begins with a 'startId' of 0 and continues with one past the last id it returned.
+    //
+    static ULONG64 NextSymbol(_In_ std::set<ULONG64> const& symbols, _In_ ULONG64 startId)
+    {
+        auto it = symbols.lower_bound(startId);
+        return (it == symbols.end() ? 0 : *it);
+    }
+
+    std::set<ULONG64> Symbols;
+    SymbolNameIndex NameIndex;
 };
 
 // SymbolSet:
@@ -192,7 +385,13 @@ public:
         m_nextId(0),
         m_demandCreatePointerTypes(true),
         m_demandCreateArrayTypes(true),
-        m_cacheInvalidationDisabled(false)
+        m_cacheInvalidationDisabled(false),
+        m_batchDepth(0),
+        m_batchInvalidationPending(false),
+        m_cacheInvalidationCount(0),
+        m_bulkLoadDepth(0),
+        m_propagatingDependentChanges(false),
+        m_detached(false)
     {
     }
 
@@ -356,6 +555,14 @@ public:
     //
     HRESULT DeleteExistingSymbol(_In_ ULONG64 uniqueId);
 
+    // Detach():
+    //
+    // Called when the symbol set is removed from its module (see SymbolBuilderProcess::RemoveSymbolsForModule).
+    // A script may still hold symbols of the set and they keep working against it; however, the set no longer
+    // imports, creates, or deletes symbols.  Such changes fail with E_ILLEGAL_METHOD_CALL.
+    //
+    void Detach();
+
     // InvalidateExternalCaches():
     //
     // Fires an event notification to any listeners indicating that their caching of symbols from this
@@ -374,6 +581,15 @@ public:
                            _COM_Outptr_opt_ BaseTypeSymbol **ppTypeSymbol,
                            _In_ bool allowAutoCreations = true);
 
+    // FindGlobalSymbols():
+    //
+    // Finds the global symbols whose name or qualified name matches a wildcard pattern ('*' matches any sequence
+    // of characters and '?' any single character).  The resulting list is sorted by symbol id.
+    //
+    HRESULT FindGlobalSymbols(_In_ PCWSTR pwszPattern,
+                              _In_ bool caseInsensitive,
+                              _Out_ std::vector<ULONG64> *pSymbols);
+
     // GetScopeBindingId():
     //
     // Gets a new ID for a scope binding.
@@ -409,6 +625,95 @@ public:
         m_cacheInvalidationDisabled = disable;
     }
 
+    // BeginBatch():
+    //
+    // Begins a batch of updates to the symbol set.  Until the outermost batch is committed, cache invalidation
+    // notifications are coalesced and change notifications to dependent symbols (e.g.: the relayout of a
+    // type which contains a modified type) are deferred.  Batches may nest.
+    //
+    HRESULT BeginBatch()
+    {
+        if (m_batchDepth++ == 0)
+        {
+            return SetBulkLoad(true);
+        }
+        return S_OK;
+    }
+
+    // CommitBatch():
+    //
+    // Commits a batch of updates started with BeginBatch.  When the outermost batch commits, any deferred
+    // dependency notifications are delivered and, if anything changed, a single cache invalidation is sent.
+    //
+    HRESULT CommitBatch();
+
+    // AbortBatch():
+    //
+    // Ends every open level of a batch of updates after a failure (e.g.: a script which threw in the middle
+    // of a batch).  There is no rollback: the changes made so far are kept, so the deferred dependency
+    // notifications are still delivered and a single cache invalidation is sent as on CommitBatch.  Calling
+    // this without an open batch does nothing.
+    //
+    HRESULT AbortBatch()
+    {
+        if (m_batchDepth == 0)
+        {
+            return S_OK;
+        }
+        m_batchDepth = 1;
+        return CommitBatch();
+    }
+
+    // GetCacheInvalidationCount():
+    //
+    // Gets the number of symbol cache invalidations which have been sent for this symbol set.
+    //
+    ULONG64 GetCacheInvalidationCount() const
+    {
+        return m_cacheInvalidationCount;
+    }
+
+    // SaveSnapshot():
+    //
+    // Saves the symbol set to a binary snapshot file which can later be loaded on demand via
+    // SymbolImporter_Snapshot (see SymbolSnapshot.h).
+    //
+    HRESULT SaveSnapshot(_In_ PCWSTR pwszSnapshotPath);
+
+    // SetBulkLoad():
+    //
+    // Turns on / off bulk loading of the address tables.  While on, public addresses and symbol ranges
+    // are appended unordered and are sorted into place once when bulk loading is turned back off.  This
+    // is intended for importers which may bring in large numbers of symbols at once.  Calls nest (e.g.: an
+    // import within a batch): only turning off the outermost bulk load sorts the tables.
+    //
+    HRESULT SetBulkLoad(_In_ bool bulkLoad)
+    {
+        if (bulkLoad)
+        {
+            if (m_bulkLoadDepth++ == 0)
+            {
+                m_symbolRanges.BeginBulkLoad();
+                m_publicAddresses.BeginBulkLoad();
+            }
+            return S_OK;
+        }
+
+        if (m_bulkLoadDepth == 0)
+        {
+            return E_UNEXPECTED;
+        }
+
+        if (--m_bulkLoadDepth > 0)
+        {
+            return S_OK;
+        }
+
+        HRESULT hrRanges = m_symbolRanges.EndBulkLoad();
+        HRESULT hrPublics = m_publicAddresses.EndBulkLoad();
+        return FAILED(hrRanges) ? hrRanges : hrPublics;
+    }
+
     //*************************************************
     // Internal Accessors:
     //
@@ -433,7 +738,7 @@ public:
     //
     // Finds a symbol by its fully qualified name.  Returns 0 as a symbol id if no such symbol can be found.
     //
-    ULONG64 InternalGetSymbolIdByName(_In_ std::wstring const& symbolName)
+    ULONG64 InternalGetSymbolIdByName(_In_ std::wstring_view symbolName)
     {
         auto it = m_symbolNameMap.find(symbolName);
         if (it == m_symbolNameMap.end())
@@ -479,8 +784,55 @@ public:
         return m_publicAddresses.RemoveSymbol(address, symbol);
     }
 
+    // InternalIsBatchActive():
+    //
+    // Indicates whether a batch of updates (see BeginBatch) is in progress.
+    //
+    bool InternalIsBatchActive() const { return m_batchDepth > 0; }
+
+    // InternalIsPropagatingDependentChanges():
+    //
+    // Indicates whether dependency change notifications are currently being delivered (see
+    // InternalPropagateDependentChanges).
+    //
+    bool InternalIsPropagatingDependentChanges() const { return m_propagatingDependentChanges; }
+
+    // InternalDeferDependentNotify():
+    //
+    // Queues a dependency change notification for the given symbol until the next propagation pass (at the end
+    // of the change or when the current batch commits).  A symbol is only queued once no matter how many of the
+    // things it depends upon change.
+    //
+    HRESULT InternalDeferDependentNotify(_In_ ULONG64 uniqueId);
+
+    // InternalPropagateDependentChanges():
+    //
+    // Delivers the queued dependency change notifications in a single pass.  Every symbol which depends (directly
+    // or indirectly) upon a queued symbol is notified exactly once and only after everything it depends upon
+    // within the pass.  A type which contains a changed type through several paths is laid out once and only
+    // after those paths have settled.
+    //
+    HRESULT InternalPropagateDependentChanges();
+
     std::vector<Microsoft::WRL::ComPtr<ISvcSymbol>> const& InternalGetSymbols() { return m_symbols; }
-    std::vector<ULONG64> const& InternalGetGlobalSymbols() const { return m_globalSymbols; }
+    std::set<ULONG64> const& InternalGetGlobalSymbols() const { return m_globalSymbols; }
+
+    // InternalGetGlobalSymbols() / InternalGetSymbolNameIndex():
+    //
+    // Gets the ids of the global symbols of a given kind (in ascending order) / the index of their names.  A
+    // kind which has no global symbols has an empty list and index.
+    //
+    std::set<ULONG64> const& InternalGetGlobalSymbols(_In_ SvcSymbolKind kind) const
+    {
+        return InternalGetGlobalKindIndex(kind).Symbols;
+    }
+    SymbolNameIndex const& InternalGetSymbolNameIndex(_In_ SvcSymbolKind kind) const
+    {
+        return InternalGetGlobalKindIndex(kind).NameIndex;
+    }
+
+    StringArena& InternalGetStringArena() { return m_stringArena; }
+    FunctionCodeCache& InternalGetCodeCache() { return m_codeCache; }
     IDebugServiceManager* GetServiceManager() const;
     ISvcMachineArchitecture* GetArchInfo() const;
     SymbolBuilderManager* GetSymbolBuilderManager() const;
@@ -502,20 +854,34 @@ private:
         return ++m_nextId;
     }
 
+    GlobalKindIndex const& InternalGetGlobalKindIndex(_In_ SvcSymbolKind kind) const
+    {
+        static GlobalKindIndex const s_emptyIndex;
+        auto it = m_globalKindIndexes.find(kind);
+        return (it == m_globalKindIndexes.end() ? s_emptyIndex : it->second);
+    }
+
     // The next "unique id" that we will hand out when a new symbol is constructed
     ULONG64 m_nextId;
 
+    // The names of every symbol (and the keys of the name indexes below).  This must outlive the symbols.
+    StringArena m_stringArena;
+
     // The master index of all symbols by their assigned unique id.
     std::vector<Microsoft::WRL::ComPtr<ISvcSymbol>> m_symbols;
 
     // The master index of "global" symbols
-    std::vector<ULONG64> m_globalSymbols;
+    std::set<ULONG64> m_globalSymbols;
+
+    // The global symbols (and a sorted index of their names and qualified names for prefix and wildcard
+    // searches) split by kind.
+    std::unordered_map<SvcSymbolKind, GlobalKindIndex> m_globalKindIndexes;
 
     // Scope bindings: pair< variable id, moduleOffset > 
     std::vector<std::pair<ULONG64, ULONG64>> m_scopeBindings;
 
     // The master index of names -> global symbol IDs
-    std::unordered_map<std::wstring, ULONG64> m_symbolNameMap;
+    std::unordered_map<std::wstring_view, ULONG64> m_symbolNameMap;
 
     // The module for which we are the symbols
     Microsoft::WRL::ComPtr<ISvcModule> m_spModule;
@@ -529,6 +895,9 @@ private:
     // Tracks the addresses associated with public symbols.
     PublicList m_publicAddresses;
 
+    // The decoded code of functions in the module (see CodeCache.h).
+    FunctionCodeCache m_codeCache;
+
     // If we have an importer that will automatically pull in underlying symbols, this points
     // to it. 
     std::unique_ptr<SymbolImporter> m_spImporter;
@@ -536,12 +905,90 @@ private:
     // An indication of whether cache invalidation is disabled or not.
     bool m_cacheInvalidationDisabled;
 
+    // Batch state (see BeginBatch / CommitBatch): the nesting depth and whether a cache invalidation was
+    // suppressed during the batch.
+    ULONG m_batchDepth;
+    bool m_batchInvalidationPending;
+
+    // The number of cache invalidations sent upwards (see InvalidateExternalCaches).
+    ULONG64 m_cacheInvalidationCount;
+
+    // The nesting depth of bulk loading of the address tables (see SetBulkLoad).
+    ULONG m_bulkLoadDepth;
+
+    // Dependency change notifications (see InternalPropagateDependentChanges): the symbols with queued
+    // notifications (in the order they were queued) and whether a propagation pass is in progress.
+    std::vector<ULONG64> m_pendingNotify;
+    std::unordered_set<ULONG64> m_pendingNotifySet;
+    bool m_propagatingDependentChanges;
+
+    // Whether the set has been removed from its module (see Detach).
+    bool m_detached;
+
     // Configuration options:
     bool m_demandCreatePointerTypes;
     bool m_demandCreateArrayTypes;
     
 };
 
+// SymbolSetBatch:
+//
+// Scopes a batch of updates to a symbol set (see SymbolSet::BeginBatch).  If the scope is left without
+// Commit having been called (e.g.: because of an exception), the level of the batch which this began is
+// committed.  Any outer level (e.g.: one a script began) is left open for its owner to end.
+//
+class SymbolSetBatch
+{
+public:
+
+    SymbolSetBatch(_In_ SymbolSet *pSymbolSet) :
+        m_pSymbolSet(pSymbolSet),
+        m_active(false)
+    {
+    }
+
+    ~SymbolSetBatch()
+    {
+        if (m_active)
+        {
+            (void)m_pSymbolSet->CommitBatch();
+        }
+    }
+
+    SymbolSetBatch(SymbolSetBatch const&) = delete;
+    SymbolSetBatch& operator=(SymbolSetBatch const&) = delete;
+
+    // Begin():
+    //
+    // Begins the batch.
+    //
+    HRESULT Begin()
+    {
+        HRESULT hr = m_pSymbolSet->BeginBatch();
+        m_active = SUCCEEDED(hr);
+        return hr;
+    }
+
+    // Commit():
+    //
+    // Commits the batch.
+    //
+    HRESULT Commit()
+    {
+        if (!m_active)
+        {
+            return E_UNEXPECTED;
+        }
+        m_active = false;
+        return m_pSymbolSet->CommitBatch();
+    }
+
+private:
+
+    SymbolSet *m_pSymbolSet;
+    bool m_active;
+};
+
 // BaseSymbolEnumerator:
 //
 // A base class for symbol enumeration which provides certain helpers.
@@ -712,10 +1159,55 @@ public:
         //
         auto&& symbols = m_spSymbolSet->InternalGetSymbols();
 
-        while (m_pos < symbols.size())
+        //
+        // A search for a kind of global symbol only needs to look at the global symbols of that kind (or, for a
+        // search by name, the candidates pulled from that kind's name index at initialization) rather than every
+        // symbol in the set.  The list of global symbols of a kind is refetched on every call.  It may have
+        // changed since the last one (symbols may have been added or deleted) so our position within it is not
+        // stable.  For that source, m_pos is instead the id to resume at: one past the last id we looked at.
+        //
+        if (m_source == EnumerationSource::GlobalKind)
         {
-            ISvcSymbol *pSymbol = symbols[m_pos].Get();
+            auto&& globalSymbols = m_spSymbolSet->InternalGetGlobalSymbols(m_searchKind);
+            for(;;)
+            {
+                ULONG64 id = GlobalKindIndex::NextSymbol(globalSymbols, m_pos);
+                if (id == 0)
+                {
+                    break;
+                }
+                m_pos = static_cast<size_t>(id + 1);
+
+                BaseSymbol *pBaseSymbol = m_spSymbolSet->InternalGetSymbol(id);
+                if (pBaseSymbol != nullptr && SymbolMatchesSearchCriteria(pBaseSymbol))
+                {
+                    Microsoft::WRL::ComPtr<ISvcSymbol> spSymbol = pBaseSymbol;
+                    *ppSymbol = spSymbol.Detach();
+                    return S_OK;
+                }
+            }
+
+            return E_BOUNDS;
+        }
+
+        std::vector<ULONG64> const *pIds = nullptr;
+        switch(m_source)
+        {
+            case EnumerationSource::NameCandidates:
+                pIds = &m_candidates;
+                break;
+            default:
+                break;
+        }
+
+        size_t count = (pIds != nullptr ? pIds->size() : symbols.size());
+
+        while (m_pos < count)
+        {
+            size_t id = (pIds != nullptr ? static_cast<size_t>((*pIds)[m_pos]) : m_pos);
             ++m_pos;
+
+            ISvcSymbol *pSymbol = (id < symbols.size() ? symbols[id].Get() : nullptr);
             if (pSymbol != nullptr)
             {
                 BaseSymbol *pBaseSymbol = static_cast<BaseSymbol *>(pSymbol);
@@ -735,6 +1227,11 @@ public:
     // Internal APIs:
     //
 
+    GlobalEnumerator() :
+        m_source(EnumerationSource::AllSymbols)
+    {
+    }
+
     HRESULT RuntimeClassInitialize(_In_ SymbolSet *pSymbolSet)
     {
         return BaseInitialize(pSymbolSet);
@@ -745,8 +1242,54 @@ public:
                                    _In_opt_ PCWSTR pwszName,
                                    _In_opt_ SvcSymbolSearchInfo *pSearchInfo)
     {
-        return BaseInitialize(pSymbolSet, symKind, pwszName, pSearchInfo);
+        HRESULT hr = S_OK;
+        IfFailedReturn(BaseInitialize(pSymbolSet, symKind, pwszName, pSearchInfo));
+
+        //
+        // Only global symbols are split by kind.  Anything else must walk the entire set.  The name index lookup
+        // is literal and case sensitive so that names which happen to contain '*' or '?' (pointer types,
+        // decorated names) keep their meaning.
+        //
+        if (symKind == SvcSymbolType || symKind == SvcSymbolData ||
+            symKind == SvcSymbolFunction || symKind == SvcSymbolPublic)
+        {
+            if (m_searchName.empty())
+            {
+                m_source = EnumerationSource::GlobalKind;
+            }
+            else
+            {
+                IfFailedReturn(pSymbolSet->InternalGetSymbolNameIndex(symKind).FindSymbols(m_searchName.c_str(),
+                                                                                           false,
+                                                                                           false,
+                                                                                           &m_candidates));
+                m_source = EnumerationSource::NameCandidates;
+            }
+        }
+
+        return hr;
     }
+
+private:
+
+    // EnumerationSource:
+    //
+    // Where the ids of the symbols which are enumerated come from.
+    //
+    enum class EnumerationSource
+    {
+        // Every symbol in the set by id
+        AllSymbols,
+
+        // The global symbols of the kind being searched for
+        GlobalKind,
+
+        // The ids pulled from the name index of the kind being searched for (m_candidates)
+        NameCandidates
+    };
+
+    EnumerationSource m_source;
+    std::vector<ULONG64> m_candidates;
 };
 
 // GlobalScope:
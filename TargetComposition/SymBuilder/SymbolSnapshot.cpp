@@ -0,0 +1,1545 @@
+//**************************************************************************
+//
+// SymbolSnapshot.cpp
+//
+// The implementation of saving a symbol set to a binary snapshot file and of loading it back on demand.
+// See SymbolSnapshot.h for a description of the file format.
+//
+//**************************************************************************
+//
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+//
+//**************************************************************************
+
+#include "SymBuilder.h"
+
+using namespace Microsoft::WRL;
+
+namespace Debugger
+{
+namespace TargetComposition
+{
+namespace Services
+{
+namespace SymbolBuilder
+{
+
+//*************************************************
+// Module Identity:
+//
+
+HRESULT GetSnapshotModuleIdentity(_In_ ISvcModule *pModule,
+                                  _Out_ ULONG *pTimeDateStamp,
+                                  _Out_ ULONG64 *pSize,
+                                  _Out_ bstr_ptr *pPath)
+{
+    HRESULT hr = S_OK;
+    *pTimeDateStamp = 0;
+    *pSize = 0;
+    pPath->reset();
+
+    IfFailedReturn(pModule->GetSize(pSize));
+
+    BSTR modulePath;
+    IfFailedReturn(pModule->GetPath(&modulePath));
+    pPath->reset(modulePath);
+
+    ComPtr<ISvcModuleWithTimestampAndChecksum> spModuleTimestamp;
+    if (SUCCEEDED(pModule->QueryInterface(IID_PPV_ARGS(&spModuleTimestamp))))
+    {
+        ULONG timeDateStamp;
+        if (SUCCEEDED(spModuleTimestamp->GetTimeDateStamp(&timeDateStamp)))
+        {
+            *pTimeDateStamp = timeDateStamp;
+        }
+    }
+
+    return hr;
+}
+
+// GetSnapshotModuleFileName():
+//
+// Gets the file name portion of a module path.
+//
+static PCWSTR GetSnapshotModuleFileName(_In_ PCWSTR pwszModulePath)
+{
+    PCWSTR pwszFileName = pwszModulePath;
+    for (PCWSTR pwsz = pwszModulePath; *pwsz != L'\0'; ++pwsz)
+    {
+        if (*pwsz == L'\\' || *pwsz == L'/' || *pwsz == L':')
+        {
+            pwszFileName = pwsz + 1;
+        }
+    }
+    return pwszFileName;
+}
+
+//*************************************************
+// Snapshot Save:
+//
+
+HRESULT SymbolSet::SaveSnapshot(_In_ PCWSTR pwszSnapshotPath)
+{
+    HRESULT hr = S_OK;
+
+    //
+    // If symbols are being imported on demand, give the importer a chance to bring in everything so that it
+    // gets saved along with the rest.  An importer may decline a full import (the DbgHelp importer does) in which
+    // case only what has already been imported is saved.
+    //
+    if (HasImporter())
+    {
+        (void)m_spImporter->ImportForNameQuery(SvcSymbol, nullptr);
+    }
+
+    std::vector<PublicList::Address> const* pAddresses;
+    std::vector<SymbolRangeList::AddressRange> const* pRanges;
+    IfFailedReturn(m_publicAddresses.GetAddresses(&pAddresses));
+    IfFailedReturn(m_symbolRanges.GetRanges(&pRanges));
+
+    //
+    // We cannot let a C++ exception escape.
+    //
+    auto fn = [&]()
+    {
+        std::vector<SnapshotSymbol> records(m_symbols.size());
+        std::vector<ULONG64> lists;
+        std::vector<SnapshotLiveRange> liveRanges;
+        std::vector<SnapshotNameEntry> names;
+        std::vector<SnapshotRangeEntry> ranges;
+        std::vector<SnapshotPublicEntry> publics;
+        std::wstring strings;
+        std::unordered_map<std::wstring_view, ULONG> stringOffsets;
+
+        //
+        // Every string written is interned in the symbol set's arena and will outlive the save.
+        //
+        auto addString = [&](InternedString str)
+        {
+            auto it = stringOffsets.find(str.view());
+            if (it != stringOffsets.end())
+            {
+                return it->second;
+            }
+
+            if (strings.size() + str.size() + 1 >= SnapshotNoString)
+            {
+                throw std::length_error("strings");
+            }
+
+            ULONG stringOffset = static_cast<ULONG>(strings.size());
+            strings.append(str.view());
+            strings.push_back(L'\0');
+            stringOffsets.insert( { str.view(), stringOffset } );
+            return stringOffset;
+        };
+
+        auto addList = [&](std::vector<ULONG64> const& ids)
+        {
+            SnapshotSection list { lists.size(), ids.size() };
+            lists.insert(lists.end(), ids.begin(), ids.end());
+            return list;
+        };
+
+        //
+        // Write one record per symbol builder id so that every reference within the snapshot is simply the
+        // id the symbol had in this symbol set.
+        //
+        for (size_t id = 0; id < m_symbols.size(); ++id)
+        {
+            SnapshotSymbol& record = records[id];
+            record = { };
+            record.Kind = SnapshotNoSymbol;
+            record.NameOffset = SnapshotNoString;
+            record.QualifiedNameOffset = SnapshotNoString;
+
+            BaseSymbol *pSymbol = InternalGetSymbol(id);
+            if (pSymbol == nullptr)
+            {
+                continue;
+            }
+
+            record.Kind = static_cast<ULONG>(pSymbol->InternalGetKind());
+            record.ParentId = pSymbol->InternalGetParentId();
+            record.Children = addList(pSymbol->InternalGetChildren());
+
+            InternedString name = pSymbol->InternalGetName();
+            InternedString qualifiedName = pSymbol->InternalGetQualifiedName();
+            if (!name.empty())
+            {
+                record.NameOffset = addString(name);
+            }
+            if (qualifiedName != name)
+            {
+                record.QualifiedNameOffset = addString(qualifiedName);
+            }
+
+            switch(pSymbol->InternalGetKind())
+            {
+                case SvcSymbolType:
+                {
+                    SvcSymbolTypeKind typeKind;
+                    IfFailedReturn(pSymbol->GetTypeKind(&typeKind));
+                    record.TypeKind = static_cast<ULONG>(typeKind);
+
+                    switch(typeKind)
+                    {
+                        case SvcSymbolTypeIntrinsic:
+                        {
+                            BasicTypeSymbol *pBasicType = static_cast<BasicTypeSymbol *>(pSymbol);
+                            record.Detail = static_cast<ULONG>(pBasicType->InternalGetIntrinsicKind());
+                            record.Size = pBasicType->InternalGetTypeSize();
+                            break;
+                        }
+
+                        case SvcSymbolTypePointer:
+                        {
+                            PointerTypeSymbol *pPointer = static_cast<PointerTypeSymbol *>(pSymbol);
+                            record.TypeId = pPointer->InternalGetPointerToTypeId();
+                            record.Detail = static_cast<ULONG>(pPointer->InternalGetPointerKind());
+                            break;
+                        }
+
+                        case SvcSymbolTypeArray:
+                        {
+                            ArrayTypeSymbol *pArray = static_cast<ArrayTypeSymbol *>(pSymbol);
+                            record.TypeId = pArray->InternalGetArrayOfTypeId();
+                            record.Size = pArray->InternalGetArraySize();
+                            break;
+                        }
+
+                        case SvcSymbolTypeTypedef:
+                        {
+                            TypedefTypeSymbol *pTypedef = static_cast<TypedefTypeSymbol *>(pSymbol);
+                            record.TypeId = pTypedef->InternalGetTypedefOfTypeId();
+                            break;
+                        }
+
+                        case SvcSymbolTypeEnum:
+                        {
+                            EnumTypeSymbol *pEnum = static_cast<EnumTypeSymbol *>(pSymbol);
+                            record.TypeId = pEnum->InternalGetEnumBasicTypeId();
+                            break;
+                        }
+
+                        case SvcSymbolTypeFunction:
+                        {
+                            FunctionTypeSymbol *pFunctionType = static_cast<FunctionTypeSymbol *>(pSymbol);
+                            record.TypeId = pFunctionType->InternalGetReturnTypeId();
+                            record.List = addList(pFunctionType->InternalGetParameterTypeIds());
+                            break;
+                        }
+
+                        default:
+                            break;
+                    }
+                    break;
+                }
+
+                case SvcSymbolField:
+                case SvcSymbolBaseClass:
+                case SvcSymbolData:
+                {
+                    BaseDataSymbol *pData = static_cast<BaseDataSymbol *>(pSymbol);
+                    record.TypeId = pData->InternalGetSymbolTypeId();
+                    record.Offset = pData->InternalGetSymbolOffset();
+                    record.BitFieldLength = pData->InternalGetBitFieldLength();
+                    record.BitFieldPosition = pData->InternalGetBitFieldPosition();
+
+                    if (record.Offset == BaseDataSymbol::ConstantValue)
+                    {
+                        //
+                        // Constant values are restricted to the numeric variant types, all of which fit
+                        // within the first 8 bytes of the variant's value union.
+                        //
+                        VARIANT const& value = pData->InternalGetSymbolValue();
+                        record.Detail = static_cast<ULONG>(value.vt);
+                        memcpy(&record.Value, &value.llVal, sizeof(record.Value));
+                    }
+                    break;
+                }
+
+                case SvcSymbolDataParameter:
+                case SvcSymbolDataLocal:
+                {
+                    VariableSymbol *pVariable = static_cast<VariableSymbol *>(pSymbol);
+                    record.TypeId = pVariable->InternalGetSymbolTypeId();
+
+                    auto&& variableRanges = pVariable->InternalGetLiveRanges();
+                    record.LiveRanges = { liveRanges.size(), variableRanges.size() };
+                    for (auto&& pRange : variableRanges)
+                    {
+                        liveRanges.push_back( { pRange->Offset, pRange->Size, pRange->VariableLocation } );
+                    }
+                    break;
+                }
+
+                case SvcSymbolFunction:
+                {
+                    FunctionSymbol *pFunction = static_cast<FunctionSymbol *>(pSymbol);
+                    record.TypeId = pFunction->InternalGetReturnTypeId();
+
+                    auto&& addressRanges = pFunction->InternalGetAddressRanges();
+                    if (!addressRanges.empty())
+                    {
+                        record.Offset = addressRanges[0].first;
+                        record.Size = addressRanges[0].second;
+                    }
+                    break;
+                }
+
+                case SvcSymbolPublic:
+                {
+                    PublicSymbol *pPublic = static_cast<PublicSymbol *>(pSymbol);
+                    record.Offset = pPublic->InternalGetOffset();
+                    break;
+                }
+
+                default:
+                    break;
+            }
+        }
+
+        //
+        // Build the sorted indexes which allow a loader to go straight to the records a query needs.
+        //
+        for (auto&& globalId : m_globalSymbols)
+        {
+            BaseSymbol *pSymbol = InternalGetSymbol(globalId);
+            if (pSymbol == nullptr || pSymbol->InternalGetQualifiedName().empty())
+            {
+                continue;
+            }
+
+            names.push_back( { globalId, addString(pSymbol->InternalGetQualifiedName()), 0 } );
+        }
+
+        PCWSTR pStrings = strings.c_str();
+        std::stable_sort(names.begin(), names.end(), [&](SnapshotNameEntry const& a, SnapshotNameEntry const& b)
+        {
+            return wcscmp(pStrings + a.NameOffset, pStrings + b.NameOffset) < 0;
+        });
+
+        for (auto&& range : *pRanges)
+        {
+            if (!range.Symbols.empty())
+            {
+                ranges.push_back( { range.Start, range.End, addList(range.Symbols) } );
+            }
+        }
+
+        for (auto&& address : *pAddresses)
+        {
+            if (!address.Symbols.empty())
+            {
+                publics.push_back( { address.Addr, addList(address.Symbols) } );
+            }
+        }
+
+        //
+        // Record which module the symbols describe so that a load can refuse to apply them to some other module
+        // (or to some other build of this one).
+        //
+        ULONG moduleTimeDateStamp;
+        ULONG64 moduleSize;
+        bstr_ptr spModulePath;
+        IfFailedReturn(GetSnapshotModuleIdentity(GetModule(), &moduleTimeDateStamp, &moduleSize, &spModulePath));
+
+        std::wstring_view modulePath(spModulePath ? spModulePath.get() : L"");
+        if (strings.size() + modulePath.size() + 1 >= SnapshotNoString)
+        {
+            throw std::length_error("strings");
+        }
+
+        ULONG modulePathOffset = static_cast<ULONG>(strings.size());
+        strings.append(modulePath);
+        strings.push_back(L'\0');
+
+        //
+        // Lay out the file.  Each section starts on an 8 byte boundary.
+        //
+        SnapshotHeader header { };
+        header.Signature = SnapshotSignature;
+        header.Version = SnapshotVersion;
+        header.HeaderSize = sizeof(SnapshotHeader);
+        header.SymbolRecordSize = sizeof(SnapshotSymbol);
+        header.LocationSize = sizeof(SvcSymbolLocation);
+        header.ModuleTimeDateStamp = moduleTimeDateStamp;
+        header.ModuleSize = moduleSize;
+        header.ModulePathOffset = modulePathOffset;
+
+        ULONG64 fileSize = sizeof(SnapshotHeader);
+        auto placeSection = [&](SnapshotSection& section, size_t count, size_t elementSize)
+        {
+            section.Offset = fileSize;
+            section.Count = count;
+            fileSize += static_cast<ULONG64>(count) * elementSize;
+            fileSize = (fileSize + 7) & ~static_cast<ULONG64>(7);
+        };
+
+        placeSection(header.Symbols, records.size(), sizeof(SnapshotSymbol));
+        placeSection(header.Lists, lists.size(), sizeof(ULONG64));
+        placeSection(header.LiveRanges, liveRanges.size(), sizeof(SnapshotLiveRange));
+        placeSection(header.Names, names.size(), sizeof(SnapshotNameEntry));
+        placeSection(header.Ranges, ranges.size(), sizeof(SnapshotRangeEntry));
+        placeSection(header.Publics, publics.size(), sizeof(SnapshotPublicEntry));
+        placeSection(header.Strings, strings.size(), sizeof(wchar_t));
+
+        if (fileSize > std::numeric_limits<size_t>::max())
+        {
+            return E_OUTOFMEMORY;
+        }
+
+        std::vector<unsigned char> image(static_cast<size_t>(fileSize));
+        auto copySection = [&](SnapshotSection const& section, void const* pData, size_t elementSize)
+        {
+            if (section.Count != 0)
+            {
+                memcpy(image.data() + section.Offset, pData, static_cast<size_t>(section.Count) * elementSize);
+            }
+        };
+
+        memcpy(image.data(), &header, sizeof(header));
+        copySection(header.Symbols, records.data(), sizeof(SnapshotSymbol));
+        copySection(header.Lists, lists.data(), sizeof(ULONG64));
+        copySection(header.LiveRanges, liveRanges.data(), sizeof(SnapshotLiveRange));
+        copySection(header.Names, names.data(), sizeof(SnapshotNameEntry));
+        copySection(header.Ranges, ranges.data(), sizeof(SnapshotRangeEntry));
+        copySection(header.Publics, publics.data(), sizeof(SnapshotPublicEntry));
+        copySection(header.Strings, strings.data(), sizeof(wchar_t));
+
+        HANDLE hFile = CreateFileW(pwszSnapshotPath,
+                                   GENERIC_WRITE,
+                                   0,
+                                   nullptr,
+                                   CREATE_ALWAYS,
+                                   FILE_ATTRIBUTE_NORMAL,
+                                   NULL);
+        if (hFile == INVALID_HANDLE_VALUE)
+        {
+            return HRESULT_FROM_WIN32(GetLastError());
+        }
+
+        HRESULT hrWrite = S_OK;
+        size_t bytesWritten = 0;
+        while (bytesWritten < image.size())
+        {
+            DWORD chunkSize = static_cast<DWORD>((std::min)(image.size() - bytesWritten, static_cast<size_t>(0x40000000)));
+            DWORD chunkWritten;
+            if (!WriteFile(hFile, image.data() + bytesWritten, chunkSize, &chunkWritten, nullptr))
+            {
+                hrWrite = HRESULT_FROM_WIN32(GetLastError());
+                break;
+            }
+            bytesWritten += chunkWritten;
+        }
+
+        CloseHandle(hFile);
+
+        if (FAILED(hrWrite))
+        {
+            (void)DeleteFileW(pwszSnapshotPath);
+        }
+
+        return hrWrite;
+    };
+    return ConvertException(fn);
+}
+
+//*************************************************
+// Snapshot Import:
+//
+
+HRESULT SymbolImporter_Snapshot::ConnectToSource()
+{
+    HRESULT hr = InternalConnectToSource();
+    if (FAILED(hr))
+    {
+        DisconnectFromSource();
+    }
+    return hr;
+}
+
+HRESULT SymbolImporter_Snapshot::InternalConnectToSource()
+{
+    HRESULT hr = S_OK;
+
+    m_hFile = CreateFileW(m_snapshotPath.c_str(),
+                          GENERIC_READ,
+                          FILE_SHARE_READ,
+                          nullptr,
+                          OPEN_EXISTING,
+                          FILE_ATTRIBUTE_NORMAL,
+                          NULL);
+    if (m_hFile == INVALID_HANDLE_VALUE)
+    {
+        return HRESULT_FROM_WIN32(GetLastError());
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(m_hFile, &fileSize))
+    {
+        return HRESULT_FROM_WIN32(GetLastError());
+    }
+
+    if (static_cast<ULONG64>(fileSize.QuadPart) < sizeof(SnapshotHeader))
+    {
+        return HRESULT_FROM_WIN32(ERROR_BAD_FORMAT);
+    }
+
+    if (static_cast<ULONG64>(fileSize.QuadPart) > std::numeric_limits<size_t>::max())
+    {
+        return E_OUTOFMEMORY;
+    }
+
+    m_hMapping = CreateFileMappingW(m_hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (m_hMapping == NULL)
+    {
+        return HRESULT_FROM_WIN32(GetLastError());
+    }
+
+    m_pView = static_cast<unsigned char const*>(MapViewOfFile(m_hMapping, FILE_MAP_READ, 0, 0, 0));
+    if (m_pView == nullptr)
+    {
+        return HRESULT_FROM_WIN32(GetLastError());
+    }
+    m_viewSize = static_cast<ULONG64>(fileSize.QuadPart);
+
+    //
+    // Everything past this point is read directly out of the mapped view.  Validate that the header is one we
+    // understand and that every section lies within the file so that no later access can walk off the end.
+    //
+    SnapshotHeader const* pHeader = reinterpret_cast<SnapshotHeader const*>(m_pView);
+    if (pHeader->Signature != SnapshotSignature ||
+        pHeader->Version != SnapshotVersion ||
+        pHeader->HeaderSize != sizeof(SnapshotHeader) ||
+        pHeader->SymbolRecordSize != sizeof(SnapshotSymbol) ||
+        pHeader->LocationSize != sizeof(SvcSymbolLocation))
+    {
+        return HRESULT_FROM_WIN32(ERROR_BAD_FORMAT);
+    }
+
+    if (!ValidateSection(pHeader->Symbols, sizeof(SnapshotSymbol)) ||
+        !ValidateSection(pHeader->Lists, sizeof(ULONG64)) ||
+        !ValidateSection(pHeader->LiveRanges, sizeof(SnapshotLiveRange)) ||
+        !ValidateSection(pHeader->Names, sizeof(SnapshotNameEntry)) ||
+        !ValidateSection(pHeader->Ranges, sizeof(SnapshotRangeEntry)) ||
+        !ValidateSection(pHeader->Publics, sizeof(SnapshotPublicEntry)) ||
+        !ValidateSection(pHeader->Strings, sizeof(wchar_t)))
+    {
+        return HRESULT_FROM_WIN32(ERROR_BAD_FORMAT);
+    }
+
+    //
+    // Every string in the pool is null terminated.  As long as the pool itself is, no string read can run
+    // past its end.
+    //
+    if (pHeader->Strings.Count != 0 &&
+        GetSection<wchar_t>(pHeader->Strings)[pHeader->Strings.Count - 1] != L'\0')
+    {
+        return HRESULT_FROM_WIN32(ERROR_BAD_FORMAT);
+    }
+
+    if (pHeader->ModulePathOffset >= pHeader->Strings.Count)
+    {
+        return HRESULT_FROM_WIN32(ERROR_BAD_FORMAT);
+    }
+
+    //
+    // The snapshot must have been saved from this module.  The same module may well be loaded from a different
+    // directory (or come from a symbol cache), so only the file name of the path is compared.  Time stamps are
+    // only compared if both the module and the snapshot have one.
+    //
+    ULONG moduleTimeDateStamp;
+    ULONG64 moduleSize;
+    bstr_ptr spModulePath;
+    IfFailedReturn(GetSnapshotModuleIdentity(m_pOwningSet->GetModule(),
+                                             &moduleTimeDateStamp,
+                                             &moduleSize,
+                                             &spModulePath));
+
+    PCWSTR pwszSnapshotModulePath = GetSection<wchar_t>(pHeader->Strings) + pHeader->ModulePathOffset;
+    PCWSTR pwszModulePath = (spModulePath ? spModulePath.get() : L"");
+    if (pHeader->ModuleSize != moduleSize ||
+        (pHeader->ModuleTimeDateStamp != 0 && moduleTimeDateStamp != 0 &&
+         pHeader->ModuleTimeDateStamp != moduleTimeDateStamp) ||
+        _wcsicmp(GetSnapshotModuleFileName(pwszSnapshotModulePath),
+                 GetSnapshotModuleFileName(pwszModulePath)) != 0)
+    {
+        return HRESULT_FROM_WIN32(ERROR_REVISION_MISMATCH);
+    }
+
+    m_pHeader = pHeader;
+    return S_OK;
+}
+
+void SymbolImporter_Snapshot::DisconnectFromSource()
+{
+    m_pHeader = nullptr;
+
+    if (m_pView != nullptr)
+    {
+        UnmapViewOfFile(m_pView);
+        m_pView = nullptr;
+        m_viewSize = 0;
+    }
+
+    if (m_hMapping != NULL)
+    {
+        CloseHandle(m_hMapping);
+        m_hMapping = NULL;
+    }
+
+    if (m_hFile != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(m_hFile);
+        m_hFile = INVALID_HANDLE_VALUE;
+    }
+}
+
+bool SymbolImporter_Snapshot::ValidateSection(_In_ SnapshotSection const& section, _In_ size_t elementSize) const
+{
+    if (section.Offset % 8 != 0 || section.Offset < sizeof(SnapshotHeader) || section.Offset > m_viewSize)
+    {
+        return false;
+    }
+
+    return section.Count <= (m_viewSize - section.Offset) / elementSize;
+}
+
+SnapshotSymbol const* SymbolImporter_Snapshot::GetRecord(_In_ ULONG64 snapshotId) const
+{
+    if (snapshotId == 0 || snapshotId >= m_pHeader->Symbols.Count)
+    {
+        return nullptr;
+    }
+
+    SnapshotSymbol const* pRecord = GetSection<SnapshotSymbol>(m_pHeader->Symbols) + snapshotId;
+    if (pRecord->Kind == SnapshotNoSymbol)
+    {
+        return nullptr;
+    }
+
+    return pRecord;
+}
+
+PCWSTR SymbolImporter_Snapshot::GetString(_In_ ULONG stringOffset) const
+{
+    if (stringOffset == SnapshotNoString || stringOffset >= m_pHeader->Strings.Count)
+    {
+        return nullptr;
+    }
+
+    return GetSection<wchar_t>(m_pHeader->Strings) + stringOffset;
+}
+
+ULONG64 const* SymbolImporter_Snapshot::GetList(_In_ SnapshotSection const& list) const
+{
+    ULONG64 listsCount = m_pHeader->Lists.Count;
+    if (list.Offset > listsCount || list.Count > listsCount - list.Offset)
+    {
+        return nullptr;
+    }
+
+    return GetSection<ULONG64>(m_pHeader->Lists) + list.Offset;
+}
+
+bool SymbolImporter_Snapshot::KindMatchesSearchCriteria(_In_ SnapshotSymbol const* pRecord,
+                                                        _In_ SvcSymbolKind searchKind)
+{
+    return (searchKind == SvcSymbol || pRecord->Kind == static_cast<ULONG>(searchKind));
+}
+
+HRESULT SymbolImporter_Snapshot::ImportChildren(_In_ SnapshotSymbol const* pRecord)
+{
+    HRESULT hr = S_OK;
+
+    ULONG64 const* pChildren = GetList(pRecord->Children);
+    if (pChildren == nullptr)
+    {
+        return ImportFailure(HRESULT_FROM_WIN32(ERROR_BAD_FORMAT));
+    }
+
+    for (ULONG64 i = 0; i < pRecord->Children.Count; ++i)
+    {
+        ULONG64 childBuilderId;
+        HRESULT hrChild = ImportFromMappedSymbol(pChildren[i], &childBuilderId);
+        if (FAILED(hrChild))
+        {
+            //
+            // If there is a child we cannot import (e.g.: a kind of symbol we do not understand), we will move on
+            // and import the rest.
+            //
+            if (hrChild != E_NOTIMPL)
+            {
+                return hrChild;
+            }
+        }
+    }
+
+    return hr;
+}
+
+HRESULT SymbolImporter_Snapshot::ImportFunctionType(_In_ ULONG64 snapshotId,
+                                                    _In_ SnapshotSymbol const* pRecord,
+                                                    _Out_ ULONG64 *pBuilderId)
+{
+    HRESULT hr = S_OK;
+
+    ULONG64 const* pParams = GetList(pRecord->List);
+    if (pParams == nullptr)
+    {
+        return ImportFailure(HRESULT_FROM_WIN32(ERROR_BAD_FORMAT));
+    }
+
+    ComPtr<FunctionTypeSymbol> spFunctionType;
+    hr = MakeAndInitialize<FunctionTypeSymbol>(&spFunctionType, m_pOwningSet);
+    if (FAILED(hr))
+    {
+        return ImportFailure(hr);
+    }
+
+    //
+    // As with an import from DbgHelp, the return or parameter types may (via some UDT) refer back to this
+    // function type.  Put the shell in the map before importing them.
+    //
+    IfFailedReturn(ConvertException([&]()
+    {
+        m_importedIdMap.insert({ snapshotId, spFunctionType->InternalGetId() });
+        return S_OK;
+    }));
+
+    ULONG64 returnTypeBuilderId;
+    IfFailedReturn(ImportFromMappedSymbol(pRecord->TypeId, &returnTypeBuilderId));
+    spFunctionType->InternalSetReturnType(returnTypeBuilderId);
+
+    std::vector<ULONG64> paramTypes;
+    IfFailedReturn(ConvertException([&]()
+    {
+        paramTypes.resize(static_cast<size_t>(pRecord->List.Count));
+        return S_OK;
+    }));
+
+    for (size_t i = 0; i < paramTypes.size(); ++i)
+    {
+        IfFailedReturn(ImportFromMappedSymbol(pParams[i], &paramTypes[i]));
+    }
+
+    IfFailedReturn(spFunctionType->InternalSetParameterTypes(paramTypes.size(), paramTypes.data()));
+
+    *pBuilderId = spFunctionType->InternalGetId();
+    return hr;
+}
+
+HRESULT SymbolImporter_Snapshot::ImportTypeSymbol(_In_ ULONG64 snapshotId,
+                                                  _In_ SnapshotSymbol const* pRecord,
+                                                  _In_ ULONG64 parentId,
+                                                  _Out_ ULONG64 *pBuilderId)
+{
+    HRESULT hr = S_OK;
+
+    PCWSTR pwszName = GetString(pRecord->NameOffset);
+    PCWSTR pwszQualifiedName = GetString(pRecord->QualifiedNameOffset);
+
+    if (pRecord->TypeKind == SvcSymbolTypeFunction)
+    {
+        return ImportFunctionType(snapshotId, pRecord, pBuilderId);
+    }
+
+    //
+    // Types which are defined in terms of another type must have that type imported first.  If that type refers
+    // back to this one (e.g.: a UDT containing a pointer to itself), the recursion will already have imported
+    // this symbol by the time we get back here.  Do *NOT* create a second copy in that case.
+    //
+    ULONG64 baseTypeBuilderId = 0;
+    if (pRecord->TypeKind == SvcSymbolTypePointer ||
+        pRecord->TypeKind == SvcSymbolTypeArray ||
+        pRecord->TypeKind == SvcSymbolTypeTypedef ||
+        pRecord->TypeKind == SvcSymbolTypeEnum)
+    {
+        IfFailedReturn(ImportSymbol(pRecord->TypeId, &baseTypeBuilderId));
+
+        auto it = m_importedIdMap.find(snapshotId);
+        if (it != m_importedIdMap.end())
+        {
+            *pBuilderId = it->second;
+            return S_FALSE;
+        }
+    }
+
+    switch(pRecord->TypeKind)
+    {
+        case SvcSymbolTypeIntrinsic:
+        {
+            if (pwszName == nullptr)
+            {
+                return ImportFailure(HRESULT_FROM_WIN32(ERROR_BAD_FORMAT));
+            }
+
+            ComPtr<BasicTypeSymbol> spBasicType;
+            hr = MakeAndInitialize<BasicTypeSymbol>(&spBasicType,
+                                                    m_pOwningSet,
+                                                    static_cast<SvcSymbolIntrinsicKind>(pRecord->Detail),
+                                                    static_cast<ULONG>(pRecord->Size),
+                                                    pwszName);
+            if (FAILED(hr))
+            {
+                return ImportFailure(hr);
+            }
+
+            *pBuilderId = spBasicType->InternalGetId();
+            break;
+        }
+
+        case SvcSymbolTypePointer:
+        {
+            ComPtr<PointerTypeSymbol> spPointer;
+            hr = MakeAndInitialize<PointerTypeSymbol>(&spPointer,
+                                                      m_pOwningSet,
+                                                      baseTypeBuilderId,
+                                                      static_cast<SvcSymbolPointerKind>(pRecord->Detail));
+            if (FAILED(hr))
+            {
+                return ImportFailure(hr);
+            }
+
+            *pBuilderId = spPointer->InternalGetId();
+            break;
+        }
+
+        case SvcSymbolTypeArray:
+        {
+            ComPtr<ArrayTypeSymbol> spArray;
+            hr = MakeAndInitialize<ArrayTypeSymbol>(&spArray, m_pOwningSet, baseTypeBuilderId, pRecord->Size);
+            if (FAILED(hr))
+            {
+                return ImportFailure(hr);
+            }
+
+            *pBuilderId = spArray->InternalGetId();
+            break;
+        }
+
+        case SvcSymbolTypeTypedef:
+        {
+            ComPtr<TypedefTypeSymbol> spTypedef;
+            hr = MakeAndInitialize<TypedefTypeSymbol>(&spTypedef,
+                                                      m_pOwningSet,
+                                                      baseTypeBuilderId,
+                                                      parentId,
+                                                      pwszName,
+                                                      pwszQualifiedName);
+            if (FAILED(hr))
+            {
+                return ImportFailure(hr);
+            }
+
+            *pBuilderId = spTypedef->InternalGetId();
+            break;
+        }
+
+        case SvcSymbolTypeEnum:
+        {
+            ComPtr<EnumTypeSymbol> spEnum;
+            hr = MakeAndInitialize<EnumTypeSymbol>(&spEnum,
+                                                   m_pOwningSet,
+                                                   baseTypeBuilderId,
+                                                   parentId,
+                                                   pwszName,
+                                                   pwszQualifiedName);
+            if (FAILED(hr))
+            {
+                return ImportFailure(hr);
+            }
+
+            IfFailedReturn(ConvertException([&]()
+            {
+                m_importedIdMap.insert({ snapshotId, spEnum->InternalGetId() });
+                return S_OK;
+            }));
+
+            IfFailedReturn(ImportChildren(pRecord));
+
+            *pBuilderId = spEnum->InternalGetId();
+            break;
+        }
+
+        case SvcSymbolTypeUDT:
+        {
+            ComPtr<UdtTypeSymbol> spUdt;
+            hr = MakeAndInitialize<UdtTypeSymbol>(&spUdt, m_pOwningSet, parentId, pwszName, pwszQualifiedName);
+            if (FAILED(hr))
+            {
+                return ImportFailure(hr);
+            }
+
+            //
+            // A UDT may contain pointers to itself.  It must be in the map before its fields are imported so that
+            // those resolve back to this UDT rather than starting an infinite import chain.
+            //
+            IfFailedReturn(ConvertException([&]()
+            {
+                m_importedIdMap.insert({ snapshotId, spUdt->InternalGetId() });
+                return S_OK;
+            }));
+
+            IfFailedReturn(ImportChildren(pRecord));
+
+            *pBuilderId = spUdt->InternalGetId();
+            break;
+        }
+
+        default:
+            return E_NOTIMPL;
+    }
+
+    return S_OK;
+}
+
+HRESULT SymbolImporter_Snapshot::ImportField(_In_ SnapshotSymbol const* pRecord,
+                                             _In_ ULONG64 parentId,
+                                             _Out_ ULONG64 *pBuilderId)
+{
+    HRESULT hr = S_OK;
+
+    //
+    // Enumerants do not have a type of their own.  They take the type of the enum.
+    //
+    ULONG64 typeBuilderId = 0;
+    if (pRecord->TypeId != 0)
+    {
+        IfFailedReturn(ImportSymbol(pRecord->TypeId, &typeBuilderId));
+    }
+
+    PCWSTR pwszName = GetString(pRecord->NameOffset);
+
+    ComPtr<FieldSymbol> spField;
+    if (pRecord->Offset == BaseDataSymbol::ConstantValue ||
+        pRecord->Offset == UdtPositionalSymbol::AutomaticIncreaseConstantValue)
+    {
+        //
+        // An empty value indicates an enumerant whose value is one more than the previous one.
+        //
+        VARIANT vtValue;
+        vtValue.vt = VT_EMPTY;
+        if (pRecord->Offset == BaseDataSymbol::ConstantValue)
+        {
+            vtValue.vt = static_cast<VARTYPE>(pRecord->Detail);
+            memcpy(&vtValue.llVal, &pRecord->Value, sizeof(pRecord->Value));
+        }
+
+        hr = MakeAndInitialize<FieldSymbol>(&spField, m_pOwningSet, parentId, typeBuilderId, &vtValue, pwszName);
+    }
+    else
+    {
+        hr = MakeAndInitialize<FieldSymbol>(&spField,
+                                            m_pOwningSet,
+                                            parentId,
+                                            pRecord->Offset,
+                                            typeBuilderId,
+                                            pwszName,
+                                            pRecord->BitFieldLength,
+                                            pRecord->BitFieldPosition);
+    }
+
+    if (FAILED(hr))
+    {
+        return ImportFailure(hr);
+    }
+
+    *pBuilderId = spField->InternalGetId();
+    return S_OK;
+}
+
+HRESULT SymbolImporter_Snapshot::ImportFunction(_In_ ULONG64 snapshotId,
+                                                _In_ SnapshotSymbol const* pRecord,
+                                                _In_ ULONG64 parentId,
+                                                _Out_ ULONG64 *pBuilderId)
+{
+    HRESULT hr = S_OK;
+
+    ULONG64 returnTypeBuilderId = 0;
+    if (pRecord->TypeId != 0)
+    {
+        IfFailedReturn(ImportSymbol(pRecord->TypeId, &returnTypeBuilderId));
+    }
+
+    ComPtr<FunctionSymbol> spFunction;
+    hr = MakeAndInitialize<FunctionSymbol>(&spFunction,
+                                           m_pOwningSet,
+                                           parentId,
+                                           returnTypeBuilderId,
+                                           pRecord->Offset,
+                                           pRecord->Size,
+                                           GetString(pRecord->NameOffset),
+                                           GetString(pRecord->QualifiedNameOffset));
+    if (FAILED(hr))
+    {
+        return ImportFailure(hr);
+    }
+
+    //
+    // The parameters and locals of the function are children of it and must find it in the map.
+    //
+    IfFailedReturn(ConvertException([&]()
+    {
+        m_importedIdMap.insert({ snapshotId, spFunction->InternalGetId() });
+        return S_OK;
+    }));
+
+    IfFailedReturn(ImportChildren(pRecord));
+
+    *pBuilderId = spFunction->InternalGetId();
+    return S_OK;
+}
+
+HRESULT SymbolImporter_Snapshot::ImportVariable(_In_ SnapshotSymbol const* pRecord,
+                                                _In_ ULONG64 parentId,
+                                                _Out_ ULONG64 *pBuilderId)
+{
+    HRESULT hr = S_OK;
+
+    ULONG64 liveRangesCount = m_pHeader->LiveRanges.Count;
+    if (pRecord->LiveRanges.Offset > liveRangesCount ||
+        pRecord->LiveRanges.Count > liveRangesCount - pRecord->LiveRanges.Offset)
+    {
+        return ImportFailure(HRESULT_FROM_WIN32(ERROR_BAD_FORMAT));
+    }
+
+    ULONG64 typeBuilderId;
+    IfFailedReturn(ImportSymbol(pRecord->TypeId, &typeBuilderId));
+
+    ComPtr<VariableSymbol> spVariable;
+    hr = MakeAndInitialize<VariableSymbol>(&spVariable,
+                                           m_pOwningSet,
+                                           static_cast<SvcSymbolKind>(pRecord->Kind),
+                                           parentId,
+                                           typeBuilderId,
+                                           GetString(pRecord->NameOffset));
+    if (FAILED(hr))
+    {
+        return ImportFailure(hr);
+    }
+
+    SnapshotLiveRange const* pLiveRanges = GetSection<SnapshotLiveRange>(m_pHeader->LiveRanges) +
+                                           pRecord->LiveRanges.Offset;
+    for (ULONG64 i = 0; i < pRecord->LiveRanges.Count; ++i)
+    {
+        ULONG64 rangeId;
+        hr = spVariable->AddLiveRange(pLiveRanges[i].Offset, pLiveRanges[i].Size, pLiveRanges[i].Location, &rangeId);
+        if (FAILED(hr))
+        {
+            return ImportFailure(hr);
+        }
+    }
+
+    *pBuilderId = spVariable->InternalGetId();
+    return S_OK;
+}
+
+HRESULT SymbolImporter_Snapshot::ImportSymbol(_In_ ULONG64 snapshotId, _Out_ ULONG64 *pBuilderId)
+{
+    HRESULT hr = S_OK;
+
+    //
+    // If we have already imported this particular symbol, just return the ID within the symbol builder
+    // of the import and be done.  S_FALSE indicates this situation.
+    //
+    auto it = m_importedIdMap.find(snapshotId);
+    if (it != m_importedIdMap.end())
+    {
+        *pBuilderId = it->second;
+        return S_FALSE;
+    }
+
+    SnapshotSymbol const* pRecord = GetRecord(snapshotId);
+    if (pRecord == nullptr)
+    {
+        return ImportFailure(HRESULT_FROM_WIN32(ERROR_BAD_FORMAT));
+    }
+
+    //
+    // A symbol cannot be created until its parent and (for most kinds) its type have been.  Reaching a symbol
+    // again while it is still waiting on those means that the snapshot has a cycle of such references (e.g.: a
+    // symbol which is its own parent or a typedef of itself).  Nothing in the cycle could ever be created.
+    //
+    if (m_importsInProgress.find(snapshotId) != m_importsInProgress.end())
+    {
+        return ImportFailure(HRESULT_FROM_WIN32(ERROR_BAD_FORMAT));
+    }
+
+    IfFailedReturn(ConvertException([&]()
+    {
+        m_importsInProgress.insert(snapshotId);
+        return S_OK;
+    }));
+
+    hr = ImportSymbolRecord(snapshotId, pRecord, pBuilderId);
+    m_importsInProgress.erase(snapshotId);
+    return hr;
+}
+
+HRESULT SymbolImporter_Snapshot::ImportFromMappedSymbol(_In_ ULONG64 snapshotId, _Out_ ULONG64 *pBuilderId)
+{
+    //
+    // Anything further up which is still waiting on its parent or type may legitimately be reached again from
+    // here (e.g.: importing a field first imports its struct, which then imports that same field as one of its
+    // children).  Such an import ends at the mapped symbol rather than looping back.
+    //
+    std::unordered_set<ULONG64> outerImports;
+    outerImports.swap(m_importsInProgress);
+
+    HRESULT hr = ImportSymbol(snapshotId, pBuilderId);
+
+    m_importsInProgress.swap(outerImports);
+    return hr;
+}
+
+HRESULT SymbolImporter_Snapshot::ImportSymbolRecord(_In_ ULONG64 snapshotId,
+                                                    _In_ SnapshotSymbol const* pRecord,
+                                                    _Out_ ULONG64 *pBuilderId)
+{
+    HRESULT hr = S_OK;
+
+    //
+    // Symbols are always created within their parent.  Importing the parent may well import this symbol as one
+    // of its children, so check again once it is done.
+    //
+    ULONG64 parentBuilderId = 0;
+    if (pRecord->ParentId != 0)
+    {
+        IfFailedReturn(ImportSymbol(pRecord->ParentId, &parentBuilderId));
+
+        auto it = m_importedIdMap.find(snapshotId);
+        if (it != m_importedIdMap.end())
+        {
+            *pBuilderId = it->second;
+            return S_FALSE;
+        }
+    }
+    else
+    {
+        //
+        // A global symbol of the same name and kind may already be in the symbol set (e.g.: the basic C types
+        // which a symbol set starts with or something added by hand).  Refer to that rather than creating
+        // a duplicate.
+        //
+        PCWSTR pwszLookupName = GetString(pRecord->QualifiedNameOffset);
+        if (pwszLookupName == nullptr)
+        {
+            pwszLookupName = GetString(pRecord->NameOffset);
+        }
+
+        if (pwszLookupName != nullptr)
+        {
+            ULONG64 existingId = 0;
+            IfFailedReturn(ConvertException([&]()
+            {
+                existingId = m_pOwningSet->InternalGetSymbolIdByName(pwszLookupName);
+                return S_OK;
+            }));
+
+            BaseSymbol *pExisting = m_pOwningSet->InternalGetSymbol(existingId);
+            if (pExisting != nullptr && static_cast<ULONG>(pExisting->InternalGetKind()) == pRecord->Kind)
+            {
+                SvcSymbolTypeKind existingTypeKind;
+                if (pRecord->Kind != SvcSymbolType ||
+                    (SUCCEEDED(pExisting->GetTypeKind(&existingTypeKind)) &&
+                     static_cast<ULONG>(existingTypeKind) == pRecord->TypeKind))
+                {
+                    IfFailedReturn(ConvertException([&]()
+                    {
+                        m_importedIdMap.insert({ snapshotId, existingId });
+                        return S_OK;
+                    }));
+
+                    *pBuilderId = existingId;
+                    return S_FALSE;
+                }
+            }
+        }
+    }
+
+    ULONG64 builderId = 0;
+    switch(pRecord->Kind)
+    {
+        case SvcSymbolType:
+            hr = ImportTypeSymbol(snapshotId, pRecord, parentBuilderId, &builderId);
+            break;
+
+        case SvcSymbolField:
+            hr = ImportField(pRecord, parentBuilderId, &builderId);
+            break;
+
+        case SvcSymbolBaseClass:
+        {
+            ULONG64 typeBuilderId;
+            IfFailedReturn(ImportSymbol(pRecord->TypeId, &typeBuilderId));
+
+            ComPtr<BaseClassSymbol> spBaseClass;
+            hr = MakeAndInitialize<BaseClassSymbol>(&spBaseClass,
+                                                    m_pOwningSet,
+                                                    parentBuilderId,
+                                                    pRecord->Offset,
+                                                    typeBuilderId);
+            if (FAILED(hr))
+            {
+                return ImportFailure(hr);
+            }
+
+            builderId = spBaseClass->InternalGetId();
+            break;
+        }
+
+        case SvcSymbolData:
+        {
+            ULONG64 typeBuilderId;
+            IfFailedReturn(ImportSymbol(pRecord->TypeId, &typeBuilderId));
+
+            ComPtr<GlobalDataSymbol> spGlobalData;
+            hr = MakeAndInitialize<GlobalDataSymbol>(&spGlobalData,
+                                                     m_pOwningSet,
+                                                     parentBuilderId,
+                                                     pRecord->Offset,
+                                                     typeBuilderId,
+                                                     GetString(pRecord->NameOffset),
+                                                     GetString(pRecord->QualifiedNameOffset));
+            if (FAILED(hr))
+            {
+                return ImportFailure(hr);
+            }
+
+            builderId = spGlobalData->InternalGetId();
+            break;
+        }
+
+        case SvcSymbolFunction:
+            hr = ImportFunction(snapshotId, pRecord, parentBuilderId, &builderId);
+            break;
+
+        case SvcSymbolDataParameter:
+        case SvcSymbolDataLocal:
+            hr = ImportVariable(pRecord, parentBuilderId, &builderId);
+            break;
+
+        case SvcSymbolPublic:
+        {
+            ComPtr<PublicSymbol> spPublic;
+            hr = MakeAndInitialize<PublicSymbol>(&spPublic,
+                                                 m_pOwningSet,
+                                                 pRecord->Offset,
+                                                 GetString(pRecord->NameOffset),
+                                                 GetString(pRecord->QualifiedNameOffset));
+            if (FAILED(hr))
+            {
+                return ImportFailure(hr);
+            }
+
+            builderId = spPublic->InternalGetId();
+            break;
+        }
+
+        default:
+            return E_NOTIMPL;
+    }
+
+    if (FAILED(hr))
+    {
+        return hr;
+    }
+
+    IfFailedReturn(ConvertException([&]()
+    {
+        m_importedIdMap.insert({ snapshotId, builderId });
+        return S_OK;
+    }));
+
+    *pBuilderId = builderId;
+    return hr;
+}
+
+HRESULT SymbolImporter_Snapshot::ImportSymbolList(_In_ SnapshotSection const& list, _In_ SvcSymbolKind searchKind)
+{
+    ULONG64 const* pIds = GetList(list);
+    if (pIds == nullptr)
+    {
+        return ImportFailure(HRESULT_FROM_WIN32(ERROR_BAD_FORMAT));
+    }
+
+    for (ULONG64 i = 0; i < list.Count; ++i)
+    {
+        SnapshotSymbol const* pRecord = GetRecord(pIds[i]);
+        if (pRecord == nullptr || !KindMatchesSearchCriteria(pRecord, searchKind))
+        {
+            continue;
+        }
+
+        ULONG64 builderId;
+        HRESULT hr = ImportSymbol(pIds[i], &builderId);
+        if (FAILED(hr) && hr != E_NOTIMPL)
+        {
+            return hr;
+        }
+    }
+
+    return S_OK;
+}
+
+HRESULT SymbolImporter_Snapshot::ImportForOffsetQuery(_In_ SvcSymbolKind /*searchKind*/,
+                                                      _In_ ULONG64 offset)
+{
+    if (m_pHeader == nullptr)
+    {
+        return E_UNEXPECTED;
+    }
+
+    //
+    // This is happening at type query time as part of the *TARGET COMPOSITION* layer.  We
+    // *ABSOLUTELY CANNOT* send a cache invalidation at this time.  To do so might flush caches that
+    // are in the middle of use!
+    //
+    m_pOwningSet->SetCacheInvalidationDisable(true);
+    (void)m_pOwningSet->SetBulkLoad(true);
+
+    auto fn = [&]()
+    {
+        HRESULT hr = S_OK;
+
+        if (m_fullGlobalImport)
+        {
+            return S_FALSE;
+        }
+
+        auto it = m_addressQueries.find(offset);
+        if (it != m_addressQueries.end())
+        {
+            return S_FALSE;
+        }
+
+        //
+        // The range index is sorted and disjoint.  The only range which can contain the offset is the last one
+        // starting at or before it.
+        //
+        SnapshotRangeEntry const* pRangesBegin = GetSection<SnapshotRangeEntry>(m_pHeader->Ranges);
+        SnapshotRangeEntry const* pRangesEnd = pRangesBegin + m_pHeader->Ranges.Count;
+        SnapshotRangeEntry const* pRange = std::upper_bound(pRangesBegin, pRangesEnd, offset,
+                                                            [](ULONG64 value, SnapshotRangeEntry const& entry)
+        {
+            return value < entry.Start;
+        });
+
+        if (pRange != pRangesBegin && offset < (pRange - 1)->End)
+        {
+            IfFailedReturn(ImportSymbolList((pRange - 1)->Symbols, SvcSymbol));
+        }
+
+        //
+        // A query by offset which misses every range falls back to the nearest public symbol at or before the
+        // offset.  Bring that in too.
+        //
+        SnapshotPublicEntry const* pPublicsBegin = GetSection<SnapshotPublicEntry>(m_pHeader->Publics);
+        SnapshotPublicEntry const* pPublicsEnd = pPublicsBegin + m_pHeader->Publics.Count;
+        SnapshotPublicEntry const* pPublic = std::upper_bound(pPublicsBegin, pPublicsEnd, offset,
+                                                              [](ULONG64 value, SnapshotPublicEntry const& entry)
+        {
+            return value < entry.Address;
+        });
+
+        if (pPublic != pPublicsBegin)
+        {
+            IfFailedReturn(ImportSymbolList((pPublic - 1)->Symbols, SvcSymbol));
+        }
+
+        m_addressQueries.insert(offset);
+        return hr;
+    };
+    HRESULT hr = ConvertException(fn);
+
+    HRESULT hrLoad = m_pOwningSet->SetBulkLoad(false);
+    if (SUCCEEDED(hr) && FAILED(hrLoad))
+    {
+        hr = hrLoad;
+    }
+
+    m_pOwningSet->SetCacheInvalidationDisable(false);
+    return hr;
+}
+
+HRESULT SymbolImporter_Snapshot::ImportForNameQuery(_In_ SvcSymbolKind searchKind,
+                                                    _In_opt_ PCWSTR pwszName)
+{
+    if (m_pHeader == nullptr)
+    {
+        return E_UNEXPECTED;
+    }
+
+    //
+    // This is happening at type query time as part of the *TARGET COMPOSITION* layer.  We
+    // *ABSOLUTELY CANNOT* send a cache invalidation at this time.  To do so might flush caches that
+    // are in the middle of use!
+    //
+    m_pOwningSet->SetCacheInvalidationDisable(true);
+    (void)m_pOwningSet->SetBulkLoad(true);
+
+    auto fn = [&]()
+    {
+        HRESULT hr = S_OK;
+
+        if (m_fullGlobalImport)
+        {
+            return S_FALSE;
+        }
+
+        if (pwszName == nullptr)
+        {
+            //
+            // Unlike DbgHelp, a full import from a snapshot is bounded by what was saved.  Import every top level
+            // symbol of the requested kind.  Anything nested comes along with its parent.
+            //
+            SnapshotSymbol const* pRecords = GetSection<SnapshotSymbol>(m_pHeader->Symbols);
+            for (ULONG64 id = 1; id < m_pHeader->Symbols.Count; ++id)
+            {
+                SnapshotSymbol const* pRecord = pRecords + id;
+                if (pRecord->Kind == SnapshotNoSymbol ||
+                    pRecord->ParentId != 0 ||
+                    !KindMatchesSearchCriteria(pRecord, searchKind))
+                {
+                    continue;
+                }
+
+                ULONG64 builderId;
+                HRESULT hrImport = ImportSymbol(id, &builderId);
+                if (FAILED(hrImport) && hrImport != E_NOTIMPL)
+                {
+                    return hrImport;
+                }
+            }
+
+            if (searchKind == SvcSymbol)
+            {
+                m_fullGlobalImport = true;
+            }
+
+            return hr;
+        }
+
+        SnapshotNameEntry const* pNamesBegin = GetSection<SnapshotNameEntry>(m_pHeader->Names);
+        SnapshotNameEntry const* pNamesEnd = pNamesBegin + m_pHeader->Names.Count;
+        auto nameOf = [&](SnapshotNameEntry const& entry)
+        {
+            PCWSTR pwszEntryName = GetString(entry.NameOffset);
+            return (pwszEntryName == nullptr ? L"" : pwszEntryName);
+        };
+
+        SnapshotNameEntry const* pFirst = std::lower_bound(pNamesBegin, pNamesEnd, pwszName,
+                                                           [&](SnapshotNameEntry const& entry, PCWSTR pwszValue)
+        {
+            return wcscmp(nameOf(entry), pwszValue) < 0;
+        });
+
+        SnapshotNameEntry const* pLast = std::upper_bound(pFirst, pNamesEnd, pwszName,
+                                                          [&](PCWSTR pwszValue, SnapshotNameEntry const& entry)
+        {
+            return wcscmp(pwszValue, nameOf(entry)) < 0;
+        });
+
+        for (SnapshotNameEntry const* pEntry = pFirst; pEntry != pLast; ++pEntry)
+        {
+            SnapshotSymbol const* pRecord = GetRecord(pEntry->SymbolId);
+            if (pRecord == nullptr || !KindMatchesSearchCriteria(pRecord, searchKind))
+            {
+                continue;
+            }
+
+            ULONG64 builderId;
+            HRESULT hrImport = ImportSymbol(pEntry->SymbolId, &builderId);
+            if (FAILED(hrImport) && hrImport != E_NOTIMPL)
+            {
+                return hrImport;
+            }
+        }
+
+        return hr;
+    };
+    HRESULT hr = ConvertException(fn);
+
+    HRESULT hrLoad = m_pOwningSet->SetBulkLoad(false);
+    if (SUCCEEDED(hr) && FAILED(hrLoad))
+    {
+        hr = hrLoad;
+    }
+
+    m_pOwningSet->SetCacheInvalidationDisable(false);
+    return hr;
+}
+
+HRESULT SymbolImporter_Snapshot::ImportForRegExQuery(_In_ SvcSymbolKind searchKind,
+                                                     _In_opt_ PCWSTR pwszRegEx)
+{
+    if (m_pHeader == nullptr)
+    {
+        return E_UNEXPECTED;
+    }
+
+    if (pwszRegEx == nullptr)
+    {
+        return ImportForNameQuery(searchKind, nullptr);
+    }
+
+    m_pOwningSet->SetCacheInvalidationDisable(true);
+    (void)m_pOwningSet->SetBulkLoad(true);
+
+    auto fn = [&]()
+    {
+        if (m_fullGlobalImport)
+        {
+            return S_FALSE;
+        }
+
+        //
+        // The name table is ordered case sensitively and the caller's search may not be.  Rather than
+        // narrowing by prefix, walk the table (which is only mapped memory) and import a superset.
+        //
+        SnapshotNameEntry const* pNamesBegin = GetSection<SnapshotNameEntry>(m_pHeader->Names);
+        SnapshotNameEntry const* pNamesEnd = pNamesBegin + m_pHeader->Names.Count;
+        for (SnapshotNameEntry const* pEntry = pNamesBegin; pEntry != pNamesEnd; ++pEntry)
+        {
+            PCWSTR pwszEntryName = GetString(pEntry->NameOffset);
+            if (pwszEntryName == nullptr || !SymbolNameIndex::MatchesWildcard(pwszRegEx, pwszEntryName, true))
+            {
+                continue;
+            }
+
+            SnapshotSymbol const* pRecord = GetRecord(pEntry->SymbolId);
+            if (pRecord == nullptr || !KindMatchesSearchCriteria(pRecord, searchKind))
+            {
+                continue;
+            }
+
+            ULONG64 builderId;
+            HRESULT hrImport = ImportSymbol(pEntry->SymbolId, &builderId);
+            if (FAILED(hrImport) && hrImport != E_NOTIMPL)
+            {
+                return hrImport;
+            }
+        }
+
+        return S_OK;
+    };
+    HRESULT hr = ConvertException(fn);
+
+    HRESULT hrLoad = m_pOwningSet->SetBulkLoad(false);
+    if (SUCCEEDED(hr) && FAILED(hrLoad))
+    {
+        hr = hrLoad;
+    }
+
+    m_pOwningSet->SetCacheInvalidationDisable(false);
+    return hr;
+}
+
+} // SymbolBuilder
+} // Services
+} // TargetComposition
+} // Debugger
+
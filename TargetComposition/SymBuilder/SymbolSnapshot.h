@@ -0,0 +1,445 @@
+//**************************************************************************
+//
+// SymbolSnapshot.h
+//
+// The header for saving a symbol set to a binary snapshot file and for loading it back on demand.
+//
+// A snapshot is a flat image of a symbol set which is designed to be memory mapped rather than parsed.  Every
+// symbol is a fixed size record indexed by its symbol builder id and every reference between symbols (parent,
+// type, children, parameters) is by that id.  Names live in a single string pool.  Sorted indexes of global
+// names, symbol address ranges, and public addresses allow a loader to find exactly the records that a given
+// query needs without touching the rest of the file.
+//
+// Loading a snapshot is done via a symbol importer (see ImportSymbols.h).  Nothing is copied into the symbol
+// set when the snapshot is opened.  Records are imported the first time a query by name or by address needs
+// them, exactly as symbols are pulled from DbgHelp on demand.
+//
+// The layout of a snapshot file is:
+//
+//     SnapshotHeader
+//     SnapshotSymbol[]         (one per symbol builder id; deleted ids are SnapshotNoSymbol)
+//     ULONG64[]                (symbol id lists: children and function type parameters)
+//     SnapshotLiveRange[]      (live ranges of parameters and locals)
+//     SnapshotNameEntry[]      (global symbols sorted by qualified name)
+//     SnapshotRangeEntry[]     (disjoint address ranges sorted by start address)
+//     SnapshotPublicEntry[]    (public addresses sorted by address)
+//     wchar_t[]                (null terminated strings)
+//
+// Each section begins on an 8 byte boundary and is described by a SnapshotSection in the header.
+//
+//**************************************************************************
+//
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+//
+//**************************************************************************
+
+#ifndef __SYMBOLSNAPSHOT_H__
+#define __SYMBOLSNAPSHOT_H__
+
+namespace Debugger
+{
+namespace TargetComposition
+{
+namespace Services
+{
+namespace SymbolBuilder
+{
+
+//*************************************************
+// Snapshot Format:
+//
+
+// 'SBSS'
+constexpr ULONG SnapshotSignature = 0x53534253;
+constexpr ULONG SnapshotVersion = 2;
+
+// SnapshotNoString:
+//
+// A string offset indicating that there is no string (e.g.: no qualified name distinct from the name).
+//
+constexpr ULONG SnapshotNoString = static_cast<ULONG>(-1);
+
+// SnapshotNoSymbol:
+//
+// The kind of a record for a symbol builder id which has no symbol (e.g.: the symbol was deleted).
+//
+constexpr ULONG SnapshotNoSymbol = static_cast<ULONG>(-1);
+
+// SnapshotSection:
+//
+// Describes the location of one section of the file.  The offset is in bytes from the start of the file and
+// the count is in elements of the section.
+//
+struct SnapshotSection
+{
+    ULONG64 Offset;
+    ULONG64 Count;
+};
+
+// SnapshotHeader:
+//
+// The header at the start of every snapshot file.
+//
+struct SnapshotHeader
+{
+    ULONG Signature;
+    ULONG Version;
+    ULONG HeaderSize;                   // sizeof(SnapshotHeader)
+    ULONG SymbolRecordSize;             // sizeof(SnapshotSymbol)
+    ULONG LocationSize;                 // sizeof(SvcSymbolLocation)
+    ULONG ModuleTimeDateStamp;          // Time stamp of the module the snapshot was saved from (0 if none)
+    ULONG64 ModuleSize;                 // Size of the module the snapshot was saved from
+    ULONG ModulePathOffset;             // Path of the module the snapshot was saved from (in the string pool)
+    ULONG Reserved;
+    SnapshotSection Symbols;
+    SnapshotSection Lists;
+    SnapshotSection LiveRanges;
+    SnapshotSection Names;
+    SnapshotSection Ranges;
+    SnapshotSection Publics;
+    SnapshotSection Strings;
+};
+
+// SnapshotSymbol:
+//
+// The record for a single symbol.  Which fields are meaningful depends on the kind of the symbol:
+//
+//     Intrinsic type:  Detail = intrinsic kind, Size = type size
+//     Pointer type:    TypeId = pointed to type, Detail = pointer kind
+//     Array type:      TypeId = element type, Size = array dimension
+//     Typedef type:    TypeId = typedef'd type
+//     Enum type:       TypeId = basic type of the enum, Children = enumerants
+//     UDT type:        Children = base classes, fields, etc...
+//     Function type:   TypeId = return type, List = parameter types
+//     Field:           TypeId, Offset (may be automatic layout or a constant value), bit field, Detail = VARTYPE
+//                      and Value = value for constants
+//     Base class:      TypeId, Offset
+//     Global data:     TypeId, Offset
+//     Function:        TypeId = return type, Offset / Size = code range, Children = parameters and locals
+//     Parameter/local: TypeId, LiveRanges
+//     Public:          Offset
+//
+struct SnapshotSymbol
+{
+    ULONG Kind;                         // SvcSymbolKind or SnapshotNoSymbol
+    ULONG TypeKind;                     // SvcSymbolTypeKind (types only)
+    ULONG Detail;
+    ULONG NameOffset;
+    ULONG QualifiedNameOffset;
+    ULONG Reserved;
+    ULONG64 ParentId;
+    ULONG64 TypeId;
+    ULONG64 Offset;
+    ULONG64 Size;
+    ULONG64 BitFieldLength;
+    ULONG64 BitFieldPosition;
+    ULONG64 Value;
+    SnapshotSection Children;           // Indexes into the list section
+    SnapshotSection List;               // Indexes into the list section
+    SnapshotSection LiveRanges;         // Indexes into the live range section
+};
+
+// SnapshotLiveRange:
+//
+// A live range of a parameter or local variable.
+//
+struct SnapshotLiveRange
+{
+    ULONG64 Offset;
+    ULONG64 Size;
+    SvcSymbolLocation Location;
+};
+
+// SnapshotNameEntry:
+//
+// An entry in the sorted index of global symbol names.
+//
+struct SnapshotNameEntry
+{
+    ULONG64 SymbolId;
+    ULONG NameOffset;
+    ULONG Reserved;
+};
+
+// SnapshotRangeEntry:
+//
+// An entry in the sorted index of symbol address ranges.  [Start, End) is covered by the symbols in the list.
+//
+struct SnapshotRangeEntry
+{
+    ULONG64 Start;
+    ULONG64 End;
+    SnapshotSection Symbols;            // Indexes into the list section
+};
+
+// SnapshotPublicEntry:
+//
+// An entry in the sorted index of public symbol addresses.
+//
+struct SnapshotPublicEntry
+{
+    ULONG64 Address;
+    SnapshotSection Symbols;            // Indexes into the list section
+};
+
+static_assert(sizeof(SnapshotHeader) % 8 == 0, "snapshot header must preserve section alignment");
+static_assert(sizeof(SnapshotSymbol) % 8 == 0, "snapshot records must preserve section alignment");
+static_assert(sizeof(SnapshotLiveRange) % 8 == 0, "snapshot records must preserve section alignment");
+static_assert(sizeof(SnapshotNameEntry) % 8 == 0, "snapshot records must preserve section alignment");
+static_assert(sizeof(SnapshotRangeEntry) % 8 == 0, "snapshot records must preserve section alignment");
+static_assert(sizeof(SnapshotPublicEntry) % 8 == 0, "snapshot records must preserve section alignment");
+
+// GetSnapshotModuleIdentity():
+//
+// Gets what a snapshot records about the module its symbols describe: the time stamp of the module (zero if it
+// does not have one), its size, and its path.
+//
+HRESULT GetSnapshotModuleIdentity(_In_ ISvcModule *pModule,
+                                  _Out_ ULONG *pTimeDateStamp,
+                                  _Out_ ULONG64 *pSize,
+                                  _Out_ bstr_ptr *pPath);
+
+//*************************************************
+// Snapshot Symbol Import:
+//
+
+// SymbolImporter_Snapshot:
+//
+// A class which imports symbols on demand from a memory mapped snapshot file previously written by
+// SymbolSet::SaveSnapshot.
+//
+class SymbolImporter_Snapshot : public SymbolImporter
+{
+public:
+
+    // SymbolImporter_Snapshot():
+    //
+    // Constructs a new importer for a snapshot file.
+    //
+    SymbolImporter_Snapshot(_In_ SymbolSet *pOwningSet,
+                            _In_ PCWSTR pwszSnapshotPath) :
+        SymbolImporter(pOwningSet),
+        m_snapshotPath(pwszSnapshotPath),
+        m_hFile(INVALID_HANDLE_VALUE),
+        m_hMapping(NULL),
+        m_pView(nullptr),
+        m_viewSize(0),
+        m_pHeader(nullptr),
+        m_fullGlobalImport(false)
+    {
+    }
+
+    ~SymbolImporter_Snapshot()
+    {
+        DisconnectFromSource();
+    }
+
+    // ConnectToSource():
+    //
+    // Maps the snapshot file and validates its header.  If this fails, the importer is not used.
+    //
+    virtual HRESULT ConnectToSource();
+
+    // DisconnectFromSource():
+    //
+    // Unmaps the snapshot file.  After this call, all Import* methods should fail.
+    //
+    virtual void DisconnectFromSource();
+
+    // ImportForOffsetQuery():
+    //
+    // Imports the symbols whose address ranges contain the offset and the nearest public symbol at or before
+    // it.  If this has already been done for the offset, this method returns S_FALSE and does nothing.
+    //
+    virtual HRESULT ImportForOffsetQuery(_In_ SvcSymbolKind searchKind,
+                                         _In_ ULONG64 offset);
+
+    // ImportForNameQuery():
+    //
+    // Imports the global symbols of the given name.  If the name is not specified, this imports every global
+    // symbol in the snapshot.
+    //
+    virtual HRESULT ImportForNameQuery(_In_ SvcSymbolKind searchKind,
+                                       _In_opt_ PCWSTR pwszName);
+
+    // ImportForRegExQuery():
+    //
+    // Imports the global symbols whose name matches a wildcard pattern ('*' and '?').  Matching ignores case
+    // so that the import covers both case sensitive and case insensitive searches of the symbol set.
+    //
+    virtual HRESULT ImportForRegExQuery(_In_ SvcSymbolKind searchKind,
+                                        _In_opt_ PCWSTR pwszRegEx);
+
+    // GetImporterDescription():
+    //
+    // Gets a description of where the import is taking place from.
+    //
+    virtual HRESULT GetImporterDescription(_Out_ std::wstring *pImporterInfo)
+    {
+        auto fn = [&]()
+        {
+            *pImporterInfo = m_snapshotPath;
+            return S_OK;
+        };
+        return ConvertException(fn);
+    }
+
+private:
+
+    //*************************************************
+    // Internal Methods:
+    //
+
+    // InternalConnectToSource():
+    //
+    // A helper for ConnectToSource.  If this fails, the outer routine will immediately call DisconnectFromSource.
+    //
+    HRESULT InternalConnectToSource();
+
+    // ValidateSection():
+    //
+    // Validates that a section of elements of the given size lies entirely within the mapped view.
+    //
+    bool ValidateSection(_In_ SnapshotSection const& section, _In_ size_t elementSize) const;
+
+    // GetSection():
+    //
+    // Gets a pointer to the first element of a (validated) section.
+    //
+    template<typename T>
+    T const* GetSection(_In_ SnapshotSection const& section) const
+    {
+        return reinterpret_cast<T const*>(m_pView + section.Offset);
+    }
+
+    // GetRecord():
+    //
+    // Gets the record for a snapshot symbol id.  Returns nullptr if there is no such symbol.
+    //
+    SnapshotSymbol const* GetRecord(_In_ ULONG64 snapshotId) const;
+
+    // GetString():
+    //
+    // Gets a string from the string pool.  Returns nullptr for SnapshotNoString or an invalid offset.
+    //
+    PCWSTR GetString(_In_ ULONG stringOffset) const;
+
+    // GetList():
+    //
+    // Gets a list of symbol ids from the list section.  Returns nullptr if the list is out of bounds.
+    //
+    ULONG64 const* GetList(_In_ SnapshotSection const& list) const;
+
+    // KindMatchesSearchCriteria():
+    //
+    // Check whether a snapshot record matches the kind of symbol(s) we are looking for.
+    //
+    static bool KindMatchesSearchCriteria(_In_ SnapshotSymbol const* pRecord, _In_ SvcSymbolKind searchKind);
+
+    //********************
+    // Symbol Import:
+    //
+
+    // ImportSymbol():
+    //
+    // Import the given snapshot symbol into the symbol builder.  This is the *ONLY* method that should be called
+    // recursively as it adds symbols to the id map as part of the import process.
+    //
+    HRESULT ImportSymbol(_In_ ULONG64 snapshotId, _Out_ ULONG64 *pBuilderId);
+
+    // ImportSymbolRecord():
+    //
+    // The body of ImportSymbol once the symbol is known not to be imported and has been marked as in progress.
+    //
+    HRESULT ImportSymbolRecord(_In_ ULONG64 snapshotId,
+                               _In_ SnapshotSymbol const* pRecord,
+                               _Out_ ULONG64 *pBuilderId);
+
+    // ImportFromMappedSymbol():
+    //
+    // Imports a symbol referred to by a symbol which is already in the id map (one of its children or, for a
+    // function type, its return or parameter types).  Nothing can be waiting on the mapped symbol, so the
+    // import starts a fresh set of in-progress imports.
+    //
+    HRESULT ImportFromMappedSymbol(_In_ ULONG64 snapshotId, _Out_ ULONG64 *pBuilderId);
+
+    // ImportChildren():
+    //
+    // Imports the children of the given snapshot symbol.  The symbol itself must already be imported.
+    //
+    HRESULT ImportChildren(_In_ SnapshotSymbol const* pRecord);
+
+    // ImportTypeSymbol():
+    //
+    // Imports the given type symbol into the symbol builder.
+    //
+    HRESULT ImportTypeSymbol(_In_ ULONG64 snapshotId,
+                             _In_ SnapshotSymbol const* pRecord,
+                             _In_ ULONG64 parentId,
+                             _Out_ ULONG64 *pBuilderId);
+
+    // ImportFunctionType():
+    //
+    // Imports the given function type into the symbol builder.
+    //
+    HRESULT ImportFunctionType(_In_ ULONG64 snapshotId,
+                               _In_ SnapshotSymbol const* pRecord,
+                               _Out_ ULONG64 *pBuilderId);
+
+    // ImportField():
+    //
+    // Imports a field (or enumerant) into the symbol builder.
+    //
+    HRESULT ImportField(_In_ SnapshotSymbol const* pRecord,
+                        _In_ ULONG64 parentId,
+                        _Out_ ULONG64 *pBuilderId);
+
+    // ImportFunction():
+    //
+    // Imports the given function and its parameters and locals into the symbol builder.
+    //
+    HRESULT ImportFunction(_In_ ULONG64 snapshotId,
+                           _In_ SnapshotSymbol const* pRecord,
+                           _In_ ULONG64 parentId,
+                           _Out_ ULONG64 *pBuilderId);
+
+    // ImportVariable():
+    //
+    // Imports a parameter or local variable and its live ranges into the symbol builder.
+    //
+    HRESULT ImportVariable(_In_ SnapshotSymbol const* pRecord,
+                           _In_ ULONG64 parentId,
+                           _Out_ ULONG64 *pBuilderId);
+
+    // ImportSymbolList():
+    //
+    // Imports the symbols of the given kind in a list from the list section.
+    //
+    HRESULT ImportSymbolList(_In_ SnapshotSection const& list, _In_ SvcSymbolKind searchKind);
+
+    // The path of the snapshot file
+    std::wstring m_snapshotPath;
+
+    // The mapping of the snapshot file
+    HANDLE m_hFile;
+    HANDLE m_hMapping;
+    unsigned char const* m_pView;
+    ULONG64 m_viewSize;
+    SnapshotHeader const* m_pHeader;
+
+    bool m_fullGlobalImport;
+    std::unordered_set<ULONG64> m_addressQueries;
+    std::unordered_map<ULONG64, ULONG64> m_importedIdMap;
+
+    // The snapshot ids of symbols being imported which are not yet in the id map.  Reaching one of these again
+    // (before some symbol in between has been mapped) means a cycle of parent or type references.
+    std::unordered_set<ULONG64> m_importsInProgress;
+
+};
+
+} // SymbolBuilder
+} // Services
+} // TargetComposition
+} // Debugger
+
+#endif // __SYMBOLSNAPSHOT_H__
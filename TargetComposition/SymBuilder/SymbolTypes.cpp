@@ -83,24 +83,11 @@ HRESULT UdtPositionalSymbol::MoveToBefore(_In_ ULONG64 position)
 
 HRESULT UdtTypeSymbol::LayoutType()
 {
-    ULONG64 curOffset = 0;
-    ULONG64 typeSize = 0;
-    ULONG64 curBitFieldPosition = 0;
-    ULONG64 maxAlignment = 1;
-
-    //
-    // Previous field being examined:
-    //
-    bool prevWasBitField = false;
-    ULONG64 prevSymTypeId = 0;
-    ULONG64 prevSymTypeSize = 0;
+    HRESULT hr = S_OK;
+    m_layoutValid = false;
 
-    //
-    // Current field being examined:
-    //
-    bool isBitField = false;
-    ULONG64 symTypeId = 0;
-    ULONG64 symTypeSize = 0; 
+    LayoutCursor cursor { };
+    cursor.MaxAlignment = 1;
 
     SvcSymbolKind passKinds[] = { SvcSymbolBaseClass, SvcSymbolField };
 
@@ -129,131 +116,187 @@ HRESULT UdtTypeSymbol::LayoutType()
                 continue;
             }
 
-            prevSymTypeId = symTypeId;
-            prevSymTypeSize = symTypeSize;
-            prevWasBitField = isBitField;
+            IfFailedReturn(LayoutChild(static_cast<UdtPositionalSymbol *>(pBaseSymbol), &cursor));
+        }
+    }
 
-            UdtPositionalSymbol *pPosSymbol = static_cast<UdtPositionalSymbol *>(pBaseSymbol);
+    CompleteLayout(cursor);
 
-            //
-            // Find the type of the field and gather basic information about size/alignment to see
-            // if we need to add requisite padding (assuming this is an auto-layout field).  If the field offset
-            // was manually specified, it goes there REGARDLESS of what the alignment says.
-            //
-            symTypeId = pPosSymbol->InternalGetSymbolTypeId();
-            BaseSymbol *pSymbolTypeBaseSymbol = InternalGetSymbolSet()->InternalGetSymbol(symTypeId);
-            if (pSymbolTypeBaseSymbol == nullptr || pSymbolTypeBaseSymbol->InternalGetKind() != SvcSymbolType)
-            {
-                return E_UNEXPECTED;
-            }
+    m_layoutCursor = cursor;
+    m_layoutChildCount = children.size();
+    m_layoutValid = true;
 
-            BaseTypeSymbol *pSymbolTypeBase = static_cast<BaseTypeSymbol *>(pSymbolTypeBaseSymbol);
+    return hr;
+}
 
-            symTypeSize = pSymbolTypeBase->InternalGetTypeSize();
-            ULONG64 symTypeAlign = pSymbolTypeBase->InternalGetTypeAlignment();
+HRESULT UdtTypeSymbol::LayoutAppendedChild(_In_ ULONG64 childId)
+{
+    HRESULT hr = S_OK;
 
-            if (symTypeAlign > maxAlignment)
-            {
-                maxAlignment = symTypeAlign;
-            }
+    //
+    // Fields are placed after all base classes and in the order of the children.  A field which was appended
+    // as the last child is therefore the last thing placed and the layout before it is unchanged.  That is
+    // only true if nothing else changed since the last layout.  Anything else which changes the type lays
+    // it out again; anything which changes a type it depends upon does the same (though during a batch of
+    // updates that is deferred until the batch commits and lays out the entire type again).
+    //
+    auto&& children = InternalGetChildren();
+    if (!m_layoutValid || children.size() != m_layoutChildCount + 1 || children.back() != childId)
+    {
+        return S_FALSE;
+    }
 
-            ULONG64 symOffset = pPosSymbol->InternalGetSymbolOffset();
-            bool autoLayoutField = (symOffset == UdtPositionalSymbol::AutomaticAppendLayout);
-
-            isBitField = (pPosSymbol->InternalIsBitField());
-            ULONG64 bitFieldPosition = pPosSymbol->InternalGetBitFieldPosition();
-            ULONG64 bitFieldLength = pPosSymbol->InternalGetBitFieldLength();
-
-            //
-            // If there was a fundamental change with respect to bitfields, we might need to move things forward
-            // early.
-            //
-            // Note that if the previous field was *NOT* a bitfield, the positioning cursor already fully moved
-            // forward!
-            //
-            if (prevWasBitField && (!isBitField || prevSymTypeId != symTypeId))
-            {
-                curOffset += prevSymTypeSize;
-                curBitFieldPosition = 0;
-                prevWasBitField = false;
-            }
+    BaseSymbol *pBaseSymbol = InternalGetSymbolSet()->InternalGetSymbol(childId);
+    if (pBaseSymbol == nullptr || pBaseSymbol->InternalGetKind() != SvcSymbolField)
+    {
+        return S_FALSE;
+    }
 
-            if (autoLayoutField)
-            {
-                //
-                // Is this a bitfield which cannot fit into the bits remaining within this particular
-                // location, advance the cursor.
-                //
-                if (isBitField && (curBitFieldPosition + bitFieldLength > symTypeSize * 8))
-                {
-                    curBitFieldPosition = 0;
-                    curOffset += symTypeSize;
-                }
-                
-                symOffset = curOffset;
-                if (symTypeAlign != 1)
-                {
-                    symOffset = ((symOffset + (symTypeAlign - 1)) / symTypeAlign) * symTypeAlign;
-                }
-                pPosSymbol->InternalSetComputedSymbolOffset(symOffset);
+    m_layoutValid = false;
+    IfFailedReturn(LayoutChild(static_cast<UdtPositionalSymbol *>(pBaseSymbol), &m_layoutCursor));
+    CompleteLayout(m_layoutCursor);
 
-                if (isBitField)
-                {
-                    pPosSymbol->InternalSetComputedBitFieldPosition(curBitFieldPosition);
-                    curBitFieldPosition += bitFieldLength;
-                }
-            }
-            else if (isBitField)
-            {
-                //
-                // For a manual layout bitfield, make sure that the field position is reset to the end
-                // of the bitfield so that the next automatic layout bitfield picks up from that point
-                // if such a field exists.
-                //
-                curBitFieldPosition = bitFieldPosition + bitFieldLength;
-            }
+    m_layoutChildCount = children.size();
+    m_layoutValid = true;
 
-            //
-            // For bitfields, do *NOT* move the positional cursor forward until we run out of bits in the
-            // field position.  Note that this may require us to do some handling at the end of field processing
-            // if we're still in the middle of filling out a bitfield!
-            //
-            if (isBitField)
-            {
-                curOffset = symOffset;
-            }
-            else
-            {
-                curOffset = symOffset + symTypeSize;
-                if (typeSize < curOffset)
-                {
-                    typeSize = curOffset;
-                }
-            }
+    return hr;
+}
+
+HRESULT UdtTypeSymbol::LayoutChild(_In_ UdtPositionalSymbol *pPosSymbol, _Inout_ LayoutCursor *pCursor)
+{
+    //
+    // Previous field being examined:
+    //
+    bool prevWasBitField = pCursor->IsBitField;
+    ULONG64 prevSymTypeId = pCursor->SymTypeId;
+    ULONG64 prevSymTypeSize = pCursor->SymTypeSize;
+
+    //
+    // Find the type of the field and gather basic information about size/alignment to see
+    // if we need to add requisite padding (assuming this is an auto-layout field).  If the field offset
+    // was manually specified, it goes there REGARDLESS of what the alignment says.
+    //
+    ULONG64 symTypeId = pPosSymbol->InternalGetSymbolTypeId();
+    BaseSymbol *pSymbolTypeBaseSymbol = InternalGetSymbolSet()->InternalGetSymbol(symTypeId);
+    if (pSymbolTypeBaseSymbol == nullptr || pSymbolTypeBaseSymbol->InternalGetKind() != SvcSymbolType)
+    {
+        return E_UNEXPECTED;
+    }
+
+    BaseTypeSymbol *pSymbolTypeBase = static_cast<BaseTypeSymbol *>(pSymbolTypeBaseSymbol);
+
+    ULONG64 symTypeSize = pSymbolTypeBase->InternalGetTypeSize();
+    ULONG64 symTypeAlign = pSymbolTypeBase->InternalGetTypeAlignment();
+
+    if (symTypeAlign > pCursor->MaxAlignment)
+    {
+        pCursor->MaxAlignment = symTypeAlign;
+    }
+
+    ULONG64 symOffset = pPosSymbol->InternalGetSymbolOffset();
+    bool autoLayoutField = (symOffset == UdtPositionalSymbol::AutomaticAppendLayout);
+
+    bool isBitField = (pPosSymbol->InternalIsBitField());
+    ULONG64 bitFieldPosition = pPosSymbol->InternalGetBitFieldPosition();
+    ULONG64 bitFieldLength = pPosSymbol->InternalGetBitFieldLength();
+
+    pCursor->IsBitField = isBitField;
+    pCursor->SymTypeId = symTypeId;
+    pCursor->SymTypeSize = symTypeSize;
+
+    //
+    // If there was a fundamental change with respect to bitfields, we might need to move things forward
+    // early.
+    //
+    // Note that if the previous field was *NOT* a bitfield, the positioning cursor already fully moved
+    // forward!
+    //
+    if (prevWasBitField && (!isBitField || prevSymTypeId != symTypeId))
+    {
+        pCursor->CurOffset += prevSymTypeSize;
+        pCursor->CurBitFieldPosition = 0;
+    }
+
+    if (autoLayoutField)
+    {
+        //
+        // Is this a bitfield which cannot fit into the bits remaining within this particular
+        // location, advance the cursor.
+        //
+        if (isBitField && (pCursor->CurBitFieldPosition + bitFieldLength > symTypeSize * 8))
+        {
+            pCursor->CurBitFieldPosition = 0;
+            pCursor->CurOffset += symTypeSize;
+        }
+
+        symOffset = pCursor->CurOffset;
+        if (symTypeAlign != 1)
+        {
+            symOffset = ((symOffset + (symTypeAlign - 1)) / symTypeAlign) * symTypeAlign;
+        }
+        pPosSymbol->InternalSetComputedSymbolOffset(symOffset);
+
+        if (isBitField)
+        {
+            pPosSymbol->InternalSetComputedBitFieldPosition(pCursor->CurBitFieldPosition);
+            pCursor->CurBitFieldPosition += bitFieldLength;
         }
     }
+    else if (isBitField)
+    {
+        //
+        // For a manual layout bitfield, make sure that the field position is reset to the end
+        // of the bitfield so that the next automatic layout bitfield picks up from that point
+        // if such a field exists.
+        //
+        pCursor->CurBitFieldPosition = bitFieldPosition + bitFieldLength;
+    }
 
     //
-    // If the last thing we processed was a bitfield, we need to move the positional cursor and type size forward
-    // to account for the bits used in the field.
+    // For bitfields, do *NOT* move the positional cursor forward until we run out of bits in the
+    // field position.  Note that this may require us to do some handling at the end of field processing
+    // if we're still in the middle of filling out a bitfield!
     //
     if (isBitField)
     {
-        curOffset += symTypeSize;
-        if (typeSize < curOffset)
+        pCursor->CurOffset = symOffset;
+    }
+    else
+    {
+        pCursor->CurOffset = symOffset + symTypeSize;
+        if (pCursor->TypeSize < pCursor->CurOffset)
         {
-            typeSize = curOffset;
+            pCursor->TypeSize = pCursor->CurOffset;
         }
     }
 
+    return S_OK;
+}
+
+void UdtTypeSymbol::CompleteLayout(_In_ LayoutCursor const& cursor)
+{
+    ULONG64 typeSize = cursor.TypeSize;
+
+    //
+    // If the last thing we processed was a bitfield, we need to account for the bits used in the field.  This
+    // is done on a copy: if another field is appended, the layout resumes in the middle of the bitfield.
+    //
+    if (cursor.IsBitField)
+    {
+        ULONG64 endOffset = cursor.CurOffset + cursor.SymTypeSize;
+        if (typeSize < endOffset)
+        {
+            typeSize = endOffset;
+        }
+    }
+
+    ULONG64 maxAlignment = cursor.MaxAlignment;
     m_typeAlignment = maxAlignment;
     if (maxAlignment != 1)
     {
         typeSize = ((typeSize + (maxAlignment - 1)) / maxAlignment) * maxAlignment;
     }
     m_typeSize = typeSize;
-
-    return S_OK;
 }
 
 //*************************************************
@@ -300,21 +343,21 @@ HRESULT PointerTypeSymbol::RuntimeClassInitialize(_In_ SymbolSet *pSymbolSet,
             return E_INVALIDARG;
         }
 
-        std::wstring const& name = pPointerToSymbol->InternalGetName();
-        std::wstring const& qualifiedName = pPointerToSymbol->InternalGetQualifiedName();
+        InternedString name = pPointerToSymbol->InternalGetName();
+        InternedString qualifiedName = pPointerToSymbol->InternalGetQualifiedName();
 
         std::wstring ptrName;
         std::wstring ptrQualifiedName;
 
         if (!name.empty())
         {
-            ptrName = name;
+            ptrName = name.view();
             AppendPtrChar(ptrName, pointerKind);
         }
 
         if (!qualifiedName.empty())
         {
-            ptrQualifiedName = qualifiedName;
+            ptrQualifiedName = qualifiedName.view();
             AppendPtrChar(ptrQualifiedName, pointerKind);
         }
 
@@ -396,21 +439,21 @@ HRESULT ArrayTypeSymbol::RuntimeClassInitialize(_In_ SymbolSet *pSymbolSet,
         ULONG64 arrayOfTypeSize = pArrayOfType->InternalGetTypeSize();
         ULONG64 arrayOfTypeAlign = pArrayOfType->InternalGetTypeAlignment();
 
-        std::wstring const& name = pArrayOfSymbol->InternalGetName();
-        std::wstring const& qualifiedName = pArrayOfSymbol->InternalGetQualifiedName();
+        InternedString name = pArrayOfSymbol->InternalGetName();
+        InternedString qualifiedName = pArrayOfSymbol->InternalGetQualifiedName();
 
         std::wstring arrayName;
         std::wstring arrayQualifiedName;
 
         if (!name.empty())
         {
-            arrayName = name;
+            arrayName = name.view();
             arrayName += arBuf;
         }
 
         if (!qualifiedName.empty())
         {
-            arrayQualifiedName = qualifiedName;
+            arrayQualifiedName = qualifiedName.view();
             arrayQualifiedName += arBuf;
         }
 
@@ -25,6 +25,8 @@ namespace Services
 namespace SymbolBuilder
 {
 
+class UdtPositionalSymbol;
+
 // BaseTypeSymbol:
 //
 // Our base class for all type symbols
@@ -337,11 +339,32 @@ public:
         return hr;
     }
 
+    // NotifyChildAppended():
+    //
+    // Called when a child is appended to the type.  Appending a field to a type whose layout is current only
+    // places the new field; it does not lay out the entire type again.
+    //
+    virtual HRESULT NotifyChildAppended(_In_ ULONG64 childId)
+    {
+        HRESULT hr = LayoutAppendedChild(childId);
+        if (hr == S_FALSE)
+        {
+            hr = LayoutType();
+        }
+        if (SUCCEEDED(hr))
+        {
+            hr = BaseSymbol::NotifyDependentChange();
+        }
+        return hr;
+    }
+
     HRESULT RuntimeClassInitialize(_In_ SymbolSet *pSymbolSet,
                                    _In_ ULONG64 parentId,
                                    _In_ PCWSTR pwszName,
                                    _In_opt_ PCWSTR pwszQualifiedName)
     {
+        m_layoutChildCount = 0;
+        m_layoutValid = false;
         return BaseInitialize(pSymbolSet, SvcSymbolType, SvcSymbolTypeUDT, parentId, pwszName, pwszQualifiedName);
     }
 
@@ -354,6 +377,52 @@ public:
 
 private:
 
+    // LayoutCursor:
+    //
+    // The state of a layout after placing some number of base classes and fields.  Placing one more field only
+    // requires this state, not the fields before it.
+    //
+    struct LayoutCursor
+    {
+        ULONG64 CurOffset;
+        ULONG64 TypeSize;
+        ULONG64 CurBitFieldPosition;
+        ULONG64 MaxAlignment;
+
+        // The last base class or field placed:
+        bool IsBitField;
+        ULONG64 SymTypeId;
+        ULONG64 SymTypeSize;
+    };
+
+    // LayoutChild():
+    //
+    // Places the next base class or field of the type and moves the layout cursor past it.
+    //
+    HRESULT LayoutChild(_In_ UdtPositionalSymbol *pPosSymbol, _Inout_ LayoutCursor *pCursor);
+
+    // CompleteLayout():
+    //
+    // Computes the size and alignment of the type from the layout cursor after the last child has been
+    // placed.  The cursor itself is left as is so that the layout can later be resumed from it.
+    //
+    void CompleteLayout(_In_ LayoutCursor const& cursor);
+
+    // LayoutAppendedChild():
+    //
+    // Places a field which was just appended to the type by resuming the layout from where the last layout left
+    // off.  This returns S_FALSE if that is not possible (there is no current layout or the child is not a field)
+    // and the entire type must be laid out again.
+    //
+    HRESULT LayoutAppendedChild(_In_ ULONG64 childId);
+
+    // The layout cursor after the last layout and the number of children which had been placed at that point.
+    // This is only valid if m_layoutValid is set.  Any change to the type other than appending a field goes
+    // through LayoutType and a layout of the entire type.
+    LayoutCursor m_layoutCursor;
+    size_t m_layoutChildCount;
+    bool m_layoutValid;
+
 };
 
 // PointerTypeSymbol:
@@ -442,6 +511,7 @@ public:
     //
     
     ULONG64 InternalGetPointerToTypeId() const { return m_pointerToId; }
+    SvcSymbolPointerKind InternalGetPointerKind() const { return m_pointerKind; }
 
 private:
 
@@ -1041,6 +1111,13 @@ public:
     HRESULT InternalSetParameterTypes(_In_ ULONG64 paramCount,
                                       _In_reads_(paramCount) ULONG64 *pParamTypes);
 
+    //*************************************************
+    // Internal Accessors():
+    //
+
+    ULONG64 InternalGetReturnTypeId() const { return m_returnType; }
+    std::vector<ULONG64> const& InternalGetParameterTypeIds() const { return m_paramTypes; }
+
 private:
 
     ULONG64 m_returnType;
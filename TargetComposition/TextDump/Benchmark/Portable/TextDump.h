@@ -0,0 +1,284 @@
+//**************************************************************************
+//
+// TextDump.h (Portable)
+//
+// A stand-in for the plug-in's core header which allows the "text dump"
+// parser (FileParser.cpp and SidecarCache.cpp) to be built without the
+// debugger or Windows headers so that it can be benchmarked on any host.
+// Only what the parser itself uses is provided.
+//
+// The Win32 file APIs here always fail.  Sidecar caches and external
+// binary memory files are therefore not available in portable builds.
+//
+//**************************************************************************
+//
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+//
+//**************************************************************************
+
+#ifndef __PORTABLE_TEXTDUMP_H__
+#define __PORTABLE_TEXTDUMP_H__
+
+//
+// This stands in for the real TextDump.h.  Defining its include guard makes the #include "TextDump.h" at the
+// top of the plug-in's sources a no-op.
+//
+#define __TEXTDUMP_H__
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <cwchar>
+#include <cwctype>
+#include <cctype>
+
+#include <unistd.h>
+
+#include <utility>
+#include <memory>
+#include <string>
+#include <vector>
+#include <stack>
+#include <map>
+#include <unordered_map>
+#include <algorithm>
+#include <functional>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <list>
+#include <numeric>
+
+//*************************************************
+// Types and Annotations:
+//
+
+typedef int32_t HRESULT;
+typedef uint32_t ULONG;
+typedef uint64_t ULONG64;
+typedef int64_t LONGLONG;
+typedef uint32_t DWORD;
+typedef int BOOL;
+typedef void *HANDLE;
+
+union LARGE_INTEGER
+{
+    int64_t QuadPart;
+};
+
+struct FILETIME
+{
+    DWORD dwLowDateTime;
+    DWORD dwHighDateTime;
+};
+
+struct WIN32_FILE_ATTRIBUTE_DATA
+{
+    DWORD dwFileAttributes;
+    FILETIME ftCreationTime;
+    FILETIME ftLastAccessTime;
+    FILETIME ftLastWriteTime;
+    DWORD nFileSizeHigh;
+    DWORD nFileSizeLow;
+};
+
+enum GET_FILEEX_INFO_LEVELS
+{
+    GetFileExInfoStandard
+};
+
+#define _In_
+#define _In_opt_
+#define _In_z_
+#define _Out_
+#define _Out_opt_
+#define _Inout_
+#define _COM_Outptr_
+#define _In_reads_(x)
+#define _In_reads_bytes_(x)
+#define _Out_writes_(x)
+#define _Out_writes_bytes_(x)
+
+#define FALSE 0
+#define TRUE 1
+#define MAX_PATH 260
+#define ARRAYSIZE(a) (sizeof(a) / sizeof((a)[0]))
+
+#define S_OK ((HRESULT)0)
+#define S_FALSE ((HRESULT)1)
+#define E_NOTIMPL ((HRESULT)0x80004001)
+#define E_FAIL ((HRESULT)0x80004005)
+#define E_BOUNDS ((HRESULT)0x8000000B)
+#define E_OUTOFMEMORY ((HRESULT)0x8007000E)
+#define E_INVALIDARG ((HRESULT)0x80070057)
+#define SUCCEEDED(hr) (((HRESULT)(hr)) >= 0)
+#define FAILED(hr) (((HRESULT)(hr)) < 0)
+
+#define ERROR_NOT_SUPPORTED 50
+#define HRESULT_FROM_WIN32(x) ((HRESULT)(0x80070000u | ((x) & 0xffff)))
+
+#define IfFailedReturn(EXPR) do { hr = (EXPR); if (FAILED(hr)) { return hr; }} while(false)
+
+template<typename FN>
+HRESULT ConvertException(const FN& fn)
+{
+    HRESULT hr;
+    try
+    {
+        hr = fn();
+    }
+    catch(const std::bad_alloc&)
+    {
+        hr = E_OUTOFMEMORY;
+    }
+    catch(...)
+    {
+        hr = E_FAIL;
+    }
+
+    return hr;
+}
+
+//*************************************************
+// Debug Source File:
+//
+
+// ISvcDebugSourceFile / ISvcDebugSourceFileMapping:
+//
+// Just enough of the debug source file interfaces for the parser.  Unlike the real interfaces, these are
+// not reference counted.  The caller owns the file and must keep it alive as long as the parser.
+//
+struct ISvcDebugSourceFile
+{
+    virtual ~ISvcDebugSourceFile() {}
+};
+
+struct ISvcDebugSourceFileMapping : public ISvcDebugSourceFile
+{
+    virtual HRESULT MapFile(_Out_ void **ppMapping, _Out_ ULONG64 *pMappingSize) = 0;
+};
+
+namespace Microsoft
+{
+namespace WRL
+{
+
+// ComPtr:
+//
+// A non-owning stand-in for the WRL smart pointer.
+//
+template<typename T>
+class ComPtr
+{
+public:
+
+    ComPtr() : m_p(nullptr) { }
+    ComPtr(_In_opt_ T *p) : m_p(p) { }
+
+    T *Get() const { return m_p; }
+    T *operator->() const { return m_p; }
+    bool operator==(std::nullptr_t) const { return m_p == nullptr; }
+    bool operator!=(std::nullptr_t) const { return m_p != nullptr; }
+
+    template<typename U>
+    HRESULT As(_Out_ ComPtr<U> *pOther) const
+    {
+        pOther->m_p = dynamic_cast<U *>(m_p);
+        return (pOther->m_p != nullptr ? S_OK : E_NOTIMPL);
+    }
+
+private:
+
+    template<typename U> friend class ComPtr;
+    T *m_p;
+};
+
+} // WRL
+} // Microsoft
+
+//*************************************************
+// Win32:
+//
+
+#define INVALID_HANDLE_VALUE (reinterpret_cast<HANDLE>(static_cast<intptr_t>(-1)))
+#define GENERIC_READ 0x80000000u
+#define GENERIC_WRITE 0x40000000u
+#define FILE_SHARE_READ 0x1
+#define FILE_SHARE_DELETE 0x4
+#define CREATE_ALWAYS 2
+#define OPEN_EXISTING 3
+#define FILE_ATTRIBUTE_NORMAL 0x80
+#define FILE_FLAG_SEQUENTIAL_SCAN 0x08000000
+#define PAGE_READONLY 0x2
+#define FILE_MAP_READ 0x4
+#define MOVEFILE_REPLACE_EXISTING 0x1
+#define CP_UTF8 65001
+#define MB_PRECOMPOSED 0x1
+
+inline DWORD GetLastError() { return ERROR_NOT_SUPPORTED; }
+inline DWORD GetCurrentProcessId() { return static_cast<DWORD>(getpid()); }
+inline HANDLE GetCurrentProcess() { return nullptr; }
+inline DWORD GetEnvironmentVariableW(const wchar_t *, wchar_t *, DWORD) { return 0; }
+inline DWORD GetMappedFileNameW(HANDLE, void *, wchar_t *, DWORD) { return 0; }
+inline BOOL GetFileAttributesExW(const wchar_t *, GET_FILEEX_INFO_LEVELS, void *) { return FALSE; }
+inline HANDLE CreateFileW(const wchar_t *, DWORD, DWORD, void *, DWORD, DWORD, HANDLE) { return INVALID_HANDLE_VALUE; }
+inline BOOL GetFileSizeEx(HANDLE, LARGE_INTEGER *) { return FALSE; }
+inline HANDLE CreateFileMappingW(HANDLE, void *, DWORD, DWORD, DWORD, const wchar_t *) { return nullptr; }
+inline void *MapViewOfFile(HANDLE, DWORD, DWORD, DWORD, size_t) { return nullptr; }
+inline BOOL UnmapViewOfFile(const void *) { return TRUE; }
+inline BOOL CloseHandle(HANDLE) { return TRUE; }
+inline BOOL WriteFile(HANDLE, const void *, DWORD, DWORD *, void *) { return FALSE; }
+inline BOOL MoveFileExW(const wchar_t *, const wchar_t *, DWORD) { return FALSE; }
+inline BOOL DeleteFileW(const wchar_t *) { return FALSE; }
+inline int _wcsicmp(const wchar_t *a, const wchar_t *b) { return wcscasecmp(a, b); }
+
+template<typename... ARGS>
+int swprintf_s(wchar_t *pBuffer, size_t bufferSize, const wchar_t *pFormat, ARGS... args)
+{
+    return swprintf(pBuffer, bufferSize, pFormat, args...);
+}
+
+// MultiByteToWideChar():
+//
+// UTF-8 to wchar_t (UTF-32 on these hosts).  Invalid sequences become U+FFFD.
+//
+inline int MultiByteToWideChar(unsigned /*codePage*/, DWORD /*flags*/, const char *pSrc, int srcLength, wchar_t *pDest, int destLength)
+{
+    const unsigned char *ps = reinterpret_cast<const unsigned char *>(pSrc);
+    const unsigned char *pe = ps + srcLength;
+    int count = 0;
+    while (ps < pe)
+    {
+        unsigned c = *ps++;
+        int extra = (c >= 0xf0) ? 3 : (c >= 0xe0) ? 2 : (c >= 0xc0) ? 1 : 0;
+        unsigned cp = (extra == 0) ? c : (c & (0x3f >> extra));
+        for (int i = 0; i < extra; ++i)
+        {
+            if (ps == pe || (*ps & 0xc0) != 0x80)
+            {
+                cp = 0xfffd;
+                break;
+            }
+            cp = (cp << 6) | (*ps++ & 0x3f);
+        }
+        if (extra == 0 && c >= 0x80)
+        {
+            cp = 0xfffd;
+        }
+
+        if (pDest != nullptr)
+        {
+            if (count >= destLength)
+            {
+                return 0;
+            }
+            pDest[count] = static_cast<wchar_t>(cp);
+        }
+        ++count;
+    }
+    return count;
+}
+
+#include "../../FileParser.h"
+
+#endif // __PORTABLE_TEXTDUMP_H__
@@ -0,0 +1,11 @@
+//**************************************************************************
+//
+// psapi.h (Portable)
+//
+// Empty stand-in for the Windows header.  See TextDump.h (Portable).
+//
+//**************************************************************************
+//
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+//
+//**************************************************************************
@@ -0,0 +1,14 @@
+//**************************************************************************
+//
+// PortableFileParser.cpp
+//
+// Builds the plug-in's FileParser.cpp against the portable stand-in headers.
+//
+//**************************************************************************
+//
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+//
+//**************************************************************************
+
+#include "Portable/TextDump.h"
+#include "../FileParser.cpp"
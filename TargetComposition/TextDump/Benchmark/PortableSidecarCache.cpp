@@ -0,0 +1,14 @@
+//**************************************************************************
+//
+// PortableSidecarCache.cpp
+//
+// Builds the plug-in's SidecarCache.cpp against the portable stand-in headers.
+//
+//**************************************************************************
+//
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+//
+//**************************************************************************
+
+#include "Portable/TextDump.h"
+#include "../SidecarCache.cpp"
@@ -0,0 +1,725 @@
+//**************************************************************************
+//
+// TextDumpBench.cpp
+//
+// Measures how the "text dump" parser scales: parse time, peak memory,
+// and the throughput of the memory, module, and stack lookups which the
+// plug-in's services are built on.  This drives TextDumpParser directly
+// (through the portable stand-in headers) so that it runs without a
+// debugger host.
+//
+//**************************************************************************
+//
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+//
+//**************************************************************************
+
+#include "Portable/TextDump.h"
+
+#include <chrono>
+#include <random>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+
+using namespace Debugger::TargetComposition::Services::TextDump;
+
+namespace
+{
+
+// BenchmarkOptions:
+//
+// How to run the benchmark.  See Usage() for the meaning of each.
+//
+struct BenchmarkOptions
+{
+    const char *InputPath = nullptr;
+    uint64_t Iterations = 5;
+    uint64_t RandomReads = 100000;
+    uint64_t ReadSize = 4096;
+    uint64_t Lookups = 1000000;
+    uint64_t Seed = 1;
+};
+
+void Usage()
+{
+    fprintf(stderr,
+            "usage: TextDumpBench <file> [options]\n"
+            "\n"
+            "    --iterations <n>    number of times to parse the file (default 5)\n"
+            "    --reads <n>         number of random memory reads (default 100000)\n"
+            "    --read-size <n>     size of each memory read (default 4096)\n"
+            "    --lookups <n>       number of random module lookups (default 1000000)\n"
+            "    --seed <n>          random seed (default 1)\n");
+}
+
+bool ParseOptions(int argc, char **argv, BenchmarkOptions *pOptions)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const char *pArg = argv[i];
+        if (strncmp(pArg, "--", 2) != 0)
+        {
+            if (pOptions->InputPath != nullptr)
+            {
+                return false;
+            }
+            pOptions->InputPath = pArg;
+            continue;
+        }
+
+        if (i + 1 >= argc)
+        {
+            return false;
+        }
+
+        char *pEnd;
+        uint64_t value = strtoull(argv[++i], &pEnd, 0);
+        if (*pEnd != '\0')
+        {
+            return false;
+        }
+
+        if (strcmp(pArg, "--iterations") == 0 && value > 0)
+        {
+            pOptions->Iterations = value;
+        }
+        else if (strcmp(pArg, "--reads") == 0)
+        {
+            pOptions->RandomReads = value;
+        }
+        else if (strcmp(pArg, "--read-size") == 0 && value > 0)
+        {
+            pOptions->ReadSize = value;
+        }
+        else if (strcmp(pArg, "--lookups") == 0)
+        {
+            pOptions->Lookups = value;
+        }
+        else if (strcmp(pArg, "--seed") == 0)
+        {
+            pOptions->Seed = value;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    return pOptions->InputPath != nullptr;
+}
+
+// MappedFile:
+//
+// The "debug source file" handed to the parser: a read only mapping of the file on disk.
+//
+class MappedFile : public ISvcDebugSourceFileMapping
+{
+public:
+
+    MappedFile() :
+        m_pMapping(nullptr),
+        m_size(0)
+    {
+    }
+
+    ~MappedFile()
+    {
+        if (m_pMapping != nullptr)
+        {
+            munmap(m_pMapping, m_size);
+        }
+    }
+
+    bool Open(_In_ const char *pPath)
+    {
+        int fd = open(pPath, O_RDONLY);
+        if (fd < 0)
+        {
+            return false;
+        }
+
+        struct stat fileStat;
+        if (fstat(fd, &fileStat) == 0 && fileStat.st_size > 0)
+        {
+            m_size = static_cast<size_t>(fileStat.st_size);
+            void *pMapping = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            m_pMapping = (pMapping == MAP_FAILED) ? nullptr : pMapping;
+        }
+
+        close(fd);
+        return m_pMapping != nullptr;
+    }
+
+    HRESULT MapFile(_Out_ void **ppMapping, _Out_ ULONG64 *pMappingSize) override
+    {
+        *ppMapping = m_pMapping;
+        *pMappingSize = m_size;
+        return S_OK;
+    }
+
+private:
+
+    void *m_pMapping;
+    size_t m_size;
+};
+
+// Stopwatch:
+//
+// Elapsed wall clock time.
+//
+class Stopwatch
+{
+public:
+
+    Stopwatch() : m_start(std::chrono::steady_clock::now()) { }
+
+    double Seconds() const
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+    }
+
+private:
+
+    std::chrono::steady_clock::time_point m_start;
+};
+
+// PeakMemoryMB():
+//
+// The peak resident set size of the process so far.  This includes the pages of the mapped file which
+// have been touched.
+//
+double PeakMemoryMB()
+{
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+    {
+        return 0.0;
+    }
+
+#if defined(__APPLE__)
+    return static_cast<double>(usage.ru_maxrss) / (1024.0 * 1024.0);
+#else
+    return static_cast<double>(usage.ru_maxrss) / 1024.0;
+#endif
+}
+
+// ReadVirtual():
+//
+// Reads memory the way VirtualMemoryService::ReadMemory does: region by region until the read is satisfied
+// or there is a gap.  Returns the number of bytes read.
+//
+uint64_t ReadVirtual(_In_ TextDumpParser &parser,
+                     _In_ ULONG64 address,
+                     _Out_writes_(size) unsigned char *pBuffer,
+                     _In_ uint64_t size)
+{
+    uint64_t bytesRead = 0;
+    while (bytesRead < size)
+    {
+        MemoryRegion const *pRegion = parser.FindMemoryRegion(address + bytesRead);
+        if (pRegion == nullptr)
+        {
+            break;
+        }
+
+        uint64_t chunkSize = (std::min)(size - bytesRead, pRegion->EndAddress - (address + bytesRead));
+        if (FAILED(parser.ReadMemory(pRegion, address + bytesRead, pBuffer + bytesRead, static_cast<size_t>(chunkSize))))
+        {
+            break;
+        }
+
+        bytesRead += chunkSize;
+    }
+
+    return bytesRead;
+}
+
+// SequentialRead():
+//
+// Reads every byte of every region in read size chunks.  Returns the throughput in MB/s.
+//
+double SequentialRead(_In_ TextDumpParser &parser, _In_ uint64_t readSize, _Out_ uint64_t *pChecksum)
+{
+    std::vector<unsigned char> buffer(static_cast<size_t>(readSize));
+    uint64_t checksum = 0;
+    uint64_t totalBytes = 0;
+
+    Stopwatch stopwatch;
+    for (auto&& region : parser.GetMemoryRegions())
+    {
+        for (ULONG64 address = region.StartAddress; address < region.EndAddress; address += readSize)
+        {
+            uint64_t bytesRead = ReadVirtual(parser, address, buffer.data(), (std::min)(readSize, region.EndAddress - address));
+            for (uint64_t i = 0; i < bytesRead; i += 64)
+            {
+                checksum += buffer[static_cast<size_t>(i)];
+            }
+            totalBytes += bytesRead;
+        }
+    }
+    double seconds = stopwatch.Seconds();
+
+    *pChecksum = checksum;
+    return (seconds > 0.0) ? static_cast<double>(totalBytes) / (1024.0 * 1024.0) / seconds : 0.0;
+}
+
+// ExpectedSection:
+//
+// A contiguous piece of memory as written in the text dump: a run of rows of a "*** MEMORY" section or the bytes
+// of a "*** MEMORY BINARY" section.
+//
+struct ExpectedSection
+{
+    ULONG64 StartAddress;
+    std::vector<unsigned char> Bytes;
+};
+
+// LoadExpectedMemory():
+//
+// Reads the memory sections of a UTF-8 text dump (in file order) with a simple line by line reader which
+// shares nothing with the parser.  This is the reference the bytes returned by the parser are checked against.
+// Returns false if the memory cannot be read this way (e.g.: a binary section in an external file).
+//
+bool LoadExpectedMemory(_In_reads_bytes_(size) char const *pData, _In_ size_t size, _Out_ std::vector<ExpectedSection> *pSections)
+{
+    pSections->clear();
+
+    std::vector<std::string> lines;
+    size_t pos = (size >= 3 && memcmp(pData, "\xef\xbb\xbf", 3) == 0) ? 3 : 0;
+    while (pos < size)
+    {
+        char const *pEol = reinterpret_cast<char const *>(memchr(pData + pos, '\n', size - pos));
+        size_t end = (pEol == nullptr) ? size : static_cast<size_t>(pEol - pData);
+        std::string line(pData + pos, end - pos);
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.pop_back();
+        }
+
+        pos = end + 1;
+        if (line == "*** BINARY DATA")
+        {
+            break;
+        }
+        lines.push_back(std::move(line));
+    }
+
+    auto isBlank = [](std::string const& line)
+    {
+        return std::all_of(line.begin(), line.end(), [](char c) { return isspace(static_cast<unsigned char>(c)) != 0; });
+    };
+
+    auto parseAddress = [](std::string const& text, ULONG64 *pAddress)
+    {
+        std::string digits;
+        for (char c : text)
+        {
+            if (c != '`')
+            {
+                digits += c;
+            }
+        }
+        char *pEnd;
+        *pAddress = strtoull(digits.c_str(), &pEnd, 16);
+        return !digits.empty() && *pEnd == '\0';
+    };
+
+    for (size_t i = 0; i < lines.size(); ++i)
+    {
+        std::string const& line = lines[i];
+        if (line == "*** MEMORY")
+        {
+            //
+            // Rows are "<address>  xx xx xx xx xx xx xx xx-xx xx xx xx xx xx xx xx  <ascii>".  A row whose address
+            // does not follow on from the previous row of the section starts a new run.
+            //
+            bool firstRow = true;
+            for (++i; i < lines.size() && !isBlank(lines[i]); ++i)
+            {
+                std::string const& row = lines[i];
+                size_t addressEnd = row.find(' ');
+                ULONG64 rowAddress;
+                if (addressEnd == std::string::npos || !parseAddress(row.substr(0, addressEnd), &rowAddress))
+                {
+                    return false;
+                }
+
+                if (firstRow || pSections->back().StartAddress + pSections->back().Bytes.size() != rowAddress)
+                {
+                    pSections->push_back({ rowAddress, {} });
+                    firstRow = false;
+                }
+
+                size_t col = row.find_first_not_of(' ', addressEnd);
+                while (col != std::string::npos && col + 2 <= row.size() &&
+                       isxdigit(static_cast<unsigned char>(row[col])) && isxdigit(static_cast<unsigned char>(row[col + 1])))
+                {
+                    pSections->back().Bytes.push_back(static_cast<unsigned char>(strtoul(row.substr(col, 2).c_str(), nullptr, 16)));
+                    col += 2;
+                    if (col == row.size() || (row[col] != ' ' && row[col] != '-') || col + 1 == row.size() || row[col + 1] == ' ')
+                    {
+                        break;
+                    }
+                    ++col;
+                }
+            }
+        }
+        else if (line.compare(0, 18, "*** MEMORY BINARY ") == 0)
+        {
+            char address[64];
+            unsigned long long length;
+            unsigned long long offset;
+            char trailing;
+            ULONG64 startAddress;
+            if (sscanf(line.c_str() + 18, "%63s %llx %llx %c", address, &length, &offset, &trailing) != 3 ||
+                !parseAddress(address, &startAddress) || offset > size || length > size - offset)
+            {
+                return false;
+            }
+
+            unsigned char const *pBytes = reinterpret_cast<unsigned char const *>(pData + offset);
+            pSections->push_back({ startAddress, std::vector<unsigned char>(pBytes, pBytes + length) });
+        }
+    }
+
+    return true;
+}
+
+// VerifyMemory():
+//
+// Reads every byte of every region in read size chunks and compares it with the bytes in the file.  Where
+// sections overlap, the first one in the file provides the bytes.  Also checks that the regions cover exactly the
+// memory in the file.  Returns the number of bytes verified or prints the first difference and returns false.
+//
+bool VerifyMemory(_In_ TextDumpParser &parser,
+                  _In_ std::vector<ExpectedSection> const& sections,
+                  _In_ uint64_t readSize,
+                  _Out_ uint64_t *pBytesVerified)
+{
+    std::vector<unsigned char> buffer(static_cast<size_t>(readSize));
+    std::vector<unsigned char> expected(static_cast<size_t>(readSize));
+    std::vector<bool> filled(static_cast<size_t>(readSize));
+    uint64_t bytesVerified = 0;
+
+    for (auto&& region : parser.GetMemoryRegions())
+    {
+        for (ULONG64 address = region.StartAddress; address < region.EndAddress; address += readSize)
+        {
+            uint64_t chunkSize = (std::min)(readSize, region.EndAddress - address);
+            if (ReadVirtual(parser, address, buffer.data(), chunkSize) != chunkSize)
+            {
+                fprintf(stderr, "verify: unable to read %llx bytes at %llx\n",
+                        static_cast<unsigned long long>(chunkSize), static_cast<unsigned long long>(address));
+                return false;
+            }
+
+            std::fill(filled.begin(), filled.end(), false);
+            for (auto&& section : sections)
+            {
+                ULONG64 sectionEnd = section.StartAddress + section.Bytes.size();
+                ULONG64 overlapStart = (std::max)(address, section.StartAddress);
+                ULONG64 overlapEnd = (std::min)(address + chunkSize, sectionEnd);
+                for (ULONG64 cur = overlapStart; cur < overlapEnd; ++cur)
+                {
+                    size_t i = static_cast<size_t>(cur - address);
+                    if (!filled[i])
+                    {
+                        expected[i] = section.Bytes[static_cast<size_t>(cur - section.StartAddress)];
+                        filled[i] = true;
+                    }
+                }
+            }
+
+            for (size_t i = 0; i < chunkSize; ++i)
+            {
+                if (!filled[i] || buffer[i] != expected[i])
+                {
+                    fprintf(stderr, "verify: byte at %llx is %02x; the file has %s\n",
+                            static_cast<unsigned long long>(address + i),
+                            buffer[i],
+                            filled[i] ? "a different value" : "no memory there");
+                    return false;
+                }
+            }
+
+            bytesVerified += chunkSize;
+        }
+    }
+
+    //
+    // Every byte which was read is in the file.  Make sure that nothing in the file was missed.
+    //
+    std::vector<std::pair<ULONG64, ULONG64>> ranges;
+    for (auto&& section : sections)
+    {
+        ranges.push_back({ section.StartAddress, section.StartAddress + section.Bytes.size() });
+    }
+    std::sort(ranges.begin(), ranges.end());
+
+    uint64_t fileBytes = 0;
+    ULONG64 coveredEnd = 0;
+    for (auto&& range : ranges)
+    {
+        ULONG64 start = (std::max)(range.first, coveredEnd);
+        if (range.second > start)
+        {
+            fileBytes += range.second - start;
+            coveredEnd = range.second;
+        }
+    }
+
+    if (fileBytes != bytesVerified)
+    {
+        fprintf(stderr, "verify: the file has %llu bytes of memory; the regions have %llu\n",
+                static_cast<unsigned long long>(fileBytes), static_cast<unsigned long long>(bytesVerified));
+        return false;
+    }
+
+    *pBytesVerified = bytesVerified;
+    return true;
+}
+
+} // anonymous namespace
+
+int main(int argc, char **argv)
+{
+    BenchmarkOptions options;
+    if (!ParseOptions(argc, argv, &options))
+    {
+        Usage();
+        return 1;
+    }
+
+    MappedFile file;
+    if (!file.Open(options.InputPath))
+    {
+        fprintf(stderr, "unable to map %s\n", options.InputPath);
+        return 1;
+    }
+
+    //
+    // The parser reads UTF-16 files as wchar_t.  That only works where wchar_t is two bytes (i.e.: Windows).
+    //
+    void *pMapping;
+    ULONG64 mappingSize;
+    file.MapFile(&pMapping, &mappingSize);
+    unsigned char const *pBom = reinterpret_cast<unsigned char const *>(pMapping);
+    if (sizeof(wchar_t) != 2 && mappingSize >= 2 && pBom[0] == 0xff && pBom[1] == 0xfe)
+    {
+        fprintf(stderr, "%s is UTF-16; UTF-16 text dumps can only be parsed where wchar_t is 2 bytes\n", options.InputPath);
+        return 1;
+    }
+
+    //*************************************************
+    // Parse:
+    //
+
+    std::vector<double> parseTimes;
+    std::unique_ptr<TextDumpParser> spParser;
+    for (uint64_t iteration = 0; iteration < options.Iterations; ++iteration)
+    {
+        spParser.reset();
+        spParser.reset(new TextDumpParser(&file));
+
+        Stopwatch stopwatch;
+        HRESULT hr = spParser->Initialize();
+        if (SUCCEEDED(hr))
+        {
+            hr = spParser->Parse();
+        }
+        parseTimes.push_back(stopwatch.Seconds());
+
+        if (FAILED(hr))
+        {
+            fprintf(stderr, "unable to parse %s (0x%08x)\n", options.InputPath, static_cast<unsigned>(hr));
+            return 1;
+        }
+    }
+
+    std::sort(parseTimes.begin(), parseTimes.end());
+    TextDumpParser &parser = *spParser;
+
+    //
+    // The memory sections of UTF-8 files are only located by Parse.  The first look at the memory regions
+    // parses their rows and builds the memory index.
+    //
+    Stopwatch indexStopwatch;
+    parser.GetMemoryRegions();
+    double indexSeconds = indexStopwatch.Seconds();
+
+    uint64_t memorySize = 0;
+    for (auto&& region : parser.GetMemoryRegions())
+    {
+        memorySize += region.EndAddress - region.StartAddress;
+    }
+
+    printf("file:               %s (%.1f MB)\n", options.InputPath, static_cast<double>(mappingSize) / (1024.0 * 1024.0));
+    printf("contents:           %zu regions (%.1f MB), %zu modules, %zu frames, %zu registers\n",
+           parser.GetMemoryRegions().size(),
+           static_cast<double>(memorySize) / (1024.0 * 1024.0),
+           parser.GetModuleInformations().size(),
+           parser.GetStackFrames().size(),
+           parser.GetRegisters().size());
+    printf("parse:              min %.2f ms, median %.2f ms (%zu iterations)\n",
+           parseTimes.front() * 1000.0,
+           parseTimes[parseTimes.size() / 2] * 1000.0,
+           parseTimes.size());
+    printf("parse throughput:   %.1f MB/s\n",
+           static_cast<double>(mappingSize) / (1024.0 * 1024.0) / parseTimes.front());
+    printf("memory index:       %.2f ms (on first memory access)\n", indexSeconds * 1000.0);
+    printf("peak memory (parse):%.1f MB\n", PeakMemoryMB());
+
+    //*************************************************
+    // Memory:
+    //
+    // The first sequential pass is cold (anything decoded on demand is decoded here).  The second may be served
+    // from the parser's cache.
+    //
+
+    if (parser.HasMemoryRegions())
+    {
+        //
+        // Check every byte against the file first.  This uses a parser of its own so that the bytes come through
+        // the same cold (decode on demand) path as the first timed pass.
+        //
+        std::vector<ExpectedSection> expectedSections;
+        if (!LoadExpectedMemory(reinterpret_cast<char const *>(pMapping), static_cast<size_t>(mappingSize), &expectedSections))
+        {
+            fprintf(stderr, "verify: unable to read the memory sections of %s\n", options.InputPath);
+            return 1;
+        }
+
+        TextDumpParser verifyParser(&file);
+        uint64_t bytesVerified;
+        if (FAILED(verifyParser.Initialize()) || FAILED(verifyParser.Parse()) ||
+            !VerifyMemory(verifyParser, expectedSections, options.ReadSize, &bytesVerified))
+        {
+            fprintf(stderr, "memory reads do not match %s\n", options.InputPath);
+            return 1;
+        }
+
+        printf("verify:             %llu bytes match the file\n", static_cast<unsigned long long>(bytesVerified));
+
+        uint64_t coldChecksum;
+        uint64_t warmChecksum;
+        double coldRate = SequentialRead(parser, options.ReadSize, &coldChecksum);
+        double warmRate = SequentialRead(parser, options.ReadSize, &warmChecksum);
+        if (coldChecksum != warmChecksum)
+        {
+            fprintf(stderr, "sequential reads returned different bytes\n");
+            return 1;
+        }
+
+        printf("sequential read:    cold %.1f MB/s, warm %.1f MB/s (%llu byte reads)\n",
+               coldRate, warmRate, static_cast<unsigned long long>(options.ReadSize));
+
+        //
+        // Random reads pick a region (uniformly) and then an offset within it.
+        //
+        std::mt19937_64 random(options.Seed);
+        std::vector<MemoryRegion> const& regions = parser.GetMemoryRegions();
+        std::vector<unsigned char> buffer(static_cast<size_t>(options.ReadSize));
+        uint64_t totalBytes = 0;
+
+        Stopwatch stopwatch;
+        for (uint64_t read = 0; read < options.RandomReads; ++read)
+        {
+            MemoryRegion const& region = regions[static_cast<size_t>(random() % regions.size())];
+            ULONG64 address = region.StartAddress + random() % (region.EndAddress - region.StartAddress);
+            totalBytes += ReadVirtual(parser, address, buffer.data(), options.ReadSize);
+        }
+        double seconds = stopwatch.Seconds();
+
+        printf("random read:        %.0f reads/s, %.1f MB/s (%llu reads)\n",
+               static_cast<double>(options.RandomReads) / seconds,
+               static_cast<double>(totalBytes) / (1024.0 * 1024.0) / seconds,
+               static_cast<unsigned long long>(options.RandomReads));
+    }
+
+    //*************************************************
+    // Modules:
+    //
+
+    if (parser.HasModuleInformations())
+    {
+        std::vector<ModuleInformation> const& modules = parser.GetModuleInformations();
+        ULONG64 lowAddress = modules.front().StartAddress;
+        ULONG64 highAddress = modules.front().EndAddress;
+        for (auto&& module : modules)
+        {
+            lowAddress = (std::min)(lowAddress, module.StartAddress);
+            highAddress = (std::max)(highAddress, module.EndAddress);
+        }
+
+        std::mt19937_64 random(options.Seed);
+        uint64_t hits = 0;
+
+        Stopwatch stopwatch;
+        for (uint64_t lookup = 0; lookup < options.Lookups; ++lookup)
+        {
+            size_t moduleIndex;
+            ULONG64 address = lowAddress + random() % (highAddress - lowAddress);
+            if (parser.FindModuleAtAddress(address, &moduleIndex))
+            {
+                ++hits;
+            }
+        }
+        double addressSeconds = stopwatch.Seconds();
+
+        Stopwatch baseStopwatch;
+        for (uint64_t lookup = 0; lookup < options.Lookups; ++lookup)
+        {
+            size_t moduleIndex;
+            if (parser.FindModuleByBaseAddress(modules[static_cast<size_t>(random() % modules.size())].StartAddress, &moduleIndex))
+            {
+                ++hits;
+            }
+        }
+        double baseSeconds = baseStopwatch.Seconds();
+
+        printf("module lookup:      by address %.1f M/s, by base %.1f M/s (%llu hits)\n",
+               static_cast<double>(options.Lookups) / addressSeconds / 1e6,
+               static_cast<double>(options.Lookups) / baseSeconds / 1e6,
+               static_cast<unsigned long long>(hits));
+    }
+
+    //*************************************************
+    // Stack:
+    //
+    // An unwind looks at each frame's return address module and reads the stack at each frame.
+    //
+
+    if (parser.HasStackFrames())
+    {
+        std::vector<StackFrame> const& frames = parser.GetStackFrames();
+        uint64_t walks = (std::max)(static_cast<uint64_t>(1), options.Lookups / frames.size());
+        uint64_t resolved = 0;
+
+        Stopwatch stopwatch;
+        for (uint64_t walk = 0; walk < walks; ++walk)
+        {
+            for (auto&& frame : frames)
+            {
+                size_t moduleIndex;
+                ULONG64 stackValue;
+                if (parser.FindModuleAtAddress(frame.RetAddr, &moduleIndex) &&
+                    ReadVirtual(parser, frame.ChildSp, reinterpret_cast<unsigned char *>(&stackValue), sizeof(stackValue)) != 0)
+                {
+                    ++resolved;
+                }
+            }
+        }
+        double seconds = stopwatch.Seconds();
+
+        printf("stack walk:         %.1f M frames/s (%zu frames, %llu resolved)\n",
+               static_cast<double>(walks * frames.size()) / seconds / 1e6,
+               frames.size(),
+               static_cast<unsigned long long>(resolved / walks));
+    }
+
+    printf("peak memory (total):%.1f MB\n", PeakMemoryMB());
+    return 0;
+}
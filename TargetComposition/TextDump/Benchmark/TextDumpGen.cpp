@@ -0,0 +1,422 @@
+//**************************************************************************
+//
+// TextDumpGen.cpp
+//
+// Generates synthetic "text dump" files of a configurable size for
+// measuring how the plug-in scales.  The output is a valid text dump
+// which the plug-in (and TextDumpBench) can open.
+//
+//**************************************************************************
+//
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+//
+//**************************************************************************
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+// GeneratorOptions:
+//
+// What to generate.  See Usage() for the meaning of each.
+//
+struct GeneratorOptions
+{
+    const char *OutputPath = nullptr;
+    uint64_t RegionCount = 64;
+    uint64_t RegionSize = 64 * 1024;
+    uint64_t ModuleCount = 32;
+    uint64_t FrameCount = 32;
+    uint64_t BinaryPercent = 0;
+    uint64_t Seed = 1;
+    bool Utf16 = false;
+};
+
+//
+// Where things are placed in the address space.  Regions are separated by a gap so that each is a distinct
+// region after parsing.  The stack lives in the first region.
+//
+const uint64_t RegionBase = 0x000000d0'00000000ull;
+const uint64_t RegionAlignment = 0x10000;
+const uint64_t ModuleBase = 0x00007ff6'00000000ull;
+const uint64_t ModuleStride = 0x100000;
+const uint64_t ModuleSize = 0x80000;
+
+//
+// The file offsets of binary memory sections are only known once all of the text is generated.  They are
+// written as fixed width offsets relative to the start of the binary data and patched at the end.
+//
+const size_t OffsetWidth = 16;
+
+void Usage()
+{
+    fprintf(stderr,
+            "usage: TextDumpGen -o <file> [options]\n"
+            "\n"
+            "    --regions <n>          number of memory regions (default 64)\n"
+            "    --region-size <bytes>  size of each memory region (default 65536)\n"
+            "    --modules <n>          number of modules (default 32)\n"
+            "    --frames <n>           stack depth (default 32)\n"
+            "    --binary <percent>     percentage of regions written as binary memory sections (default 0)\n"
+            "    --utf16                write UTF-16LE instead of UTF-8\n"
+            "    --seed <n>             random seed (default 1)\n");
+}
+
+bool ParseOptions(int argc, char **argv, GeneratorOptions *pOptions)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const char *pArg = argv[i];
+        const char *pValue = (i + 1 < argc) ? argv[i + 1] : nullptr;
+
+        auto number = [&](uint64_t *pNumber)
+        {
+            if (pValue == nullptr)
+            {
+                return false;
+            }
+            char *pEnd;
+            *pNumber = strtoull(pValue, &pEnd, 0);
+            ++i;
+            return *pEnd == '\0';
+        };
+
+        bool ok = true;
+        if (strcmp(pArg, "-o") == 0 && pValue != nullptr)
+        {
+            pOptions->OutputPath = pValue;
+            ++i;
+        }
+        else if (strcmp(pArg, "--regions") == 0)
+        {
+            ok = number(&pOptions->RegionCount);
+        }
+        else if (strcmp(pArg, "--region-size") == 0)
+        {
+            ok = number(&pOptions->RegionSize) && pOptions->RegionSize > 0;
+        }
+        else if (strcmp(pArg, "--modules") == 0)
+        {
+            ok = number(&pOptions->ModuleCount);
+        }
+        else if (strcmp(pArg, "--frames") == 0)
+        {
+            ok = number(&pOptions->FrameCount);
+        }
+        else if (strcmp(pArg, "--binary") == 0)
+        {
+            ok = number(&pOptions->BinaryPercent) && pOptions->BinaryPercent <= 100;
+        }
+        else if (strcmp(pArg, "--seed") == 0)
+        {
+            ok = number(&pOptions->Seed);
+        }
+        else if (strcmp(pArg, "--utf16") == 0)
+        {
+            pOptions->Utf16 = true;
+        }
+        else
+        {
+            ok = false;
+        }
+
+        if (!ok)
+        {
+            return false;
+        }
+    }
+
+    return pOptions->OutputPath != nullptr;
+}
+
+// Appendf():
+//
+// printf onto the end of a string.
+//
+template<typename... ARGS>
+void Appendf(std::string *pText, const char *pFormat, ARGS... args)
+{
+    char buffer[256];
+    int length = snprintf(buffer, sizeof(buffer), pFormat, args...);
+    pText->append(buffer, static_cast<size_t>(length));
+}
+
+// AppendAddress():
+//
+// Appends an address the way the debugger prints it (e.g.: 00007ff6`00000000).
+//
+void AppendAddress(std::string *pText, uint64_t address)
+{
+    Appendf(pText, "%08x`%08x", static_cast<unsigned>(address >> 32), static_cast<unsigned>(address));
+}
+
+// AppendMemoryRows():
+//
+// Appends the bytes as the rows of a 'db' command.
+//
+void AppendMemoryRows(std::string *pText, uint64_t address, std::vector<unsigned char> const& bytes)
+{
+    static const char s_hex[] = "0123456789abcdef";
+    for (size_t rowStart = 0; rowStart < bytes.size(); rowStart += 16)
+    {
+        size_t rowLength = (bytes.size() - rowStart < 16) ? bytes.size() - rowStart : 16;
+
+        AppendAddress(pText, address + rowStart);
+        pText->append("  ");
+
+        char hexColumn[48];
+        memset(hexColumn, ' ', sizeof(hexColumn));
+        char asciiColumn[16];
+        for (size_t i = 0; i < rowLength; ++i)
+        {
+            unsigned char b = bytes[rowStart + i];
+            hexColumn[i * 3] = s_hex[b >> 4];
+            hexColumn[i * 3 + 1] = s_hex[b & 0xf];
+            if (i == 7 && rowLength > 8)
+            {
+                hexColumn[i * 3 + 2] = '-';
+            }
+            asciiColumn[i] = (b >= 0x20 && b < 0x7f) ? static_cast<char>(b) : '.';
+        }
+
+        pText->append(hexColumn, 48);
+        pText->append(" ");
+        pText->append(asciiColumn, rowLength);
+        pText->append("\r\n");
+    }
+}
+
+// GenerateText():
+//
+// Generates the text of the dump.  The raw bytes of any binary memory sections are returned in pBinaryData.
+//
+void GenerateText(GeneratorOptions const& options, std::string *pText, std::vector<unsigned char> *pBinaryData)
+{
+    std::mt19937_64 random(options.Seed);
+    uint64_t regionStride = ((options.RegionSize + RegionAlignment - 1) / RegionAlignment + 1) * RegionAlignment;
+
+    std::string& text = *pText;
+    text.append("*** TEXTUAL DEMONSTRATION FILE\r\n"
+                "\r\n"
+                "# Synthetic text dump generated by TextDumpGen\r\n");
+
+    Appendf(&text, "# regions=%llu region-size=%llu modules=%llu frames=%llu binary=%llu%% seed=%llu\r\n\r\n",
+            static_cast<unsigned long long>(options.RegionCount),
+            static_cast<unsigned long long>(options.RegionSize),
+            static_cast<unsigned long long>(options.ModuleCount),
+            static_cast<unsigned long long>(options.FrameCount),
+            static_cast<unsigned long long>(options.BinaryPercent),
+            static_cast<unsigned long long>(options.Seed));
+
+    if (options.FrameCount > 0)
+    {
+        text.append("*** STACK\r\n");
+        for (uint64_t frame = 0; frame < options.FrameCount; ++frame)
+        {
+            uint64_t module = (options.ModuleCount > 0) ? random() % options.ModuleCount : 0;
+            uint64_t displacement = random() % 0x400;
+            uint64_t retAddr = ModuleBase + module * ModuleStride + 0x1000 + random() % (ModuleSize - 0x1000);
+
+            Appendf(&text, "%02llx ", static_cast<unsigned long long>(frame));
+            AppendAddress(&text, RegionBase + (frame * 0x40) % options.RegionSize);
+            text.append(" ");
+            AppendAddress(&text, retAddr);
+            Appendf(&text, "     module%llu!Function%llu+0x%llx\r\n",
+                    static_cast<unsigned long long>(module),
+                    static_cast<unsigned long long>(frame),
+                    static_cast<unsigned long long>(displacement));
+        }
+        text.append("\r\n");
+    }
+
+    if (options.ModuleCount > 0)
+    {
+        text.append("*** MODULEINFO\r\n");
+        for (uint64_t module = 0; module < options.ModuleCount; ++module)
+        {
+            uint64_t moduleStart = ModuleBase + module * ModuleStride;
+            AppendAddress(&text, moduleStart);
+            text.append(" ");
+            AppendAddress(&text, moduleStart + ModuleSize);
+            Appendf(&text, " module%llu \"C:\\Synthetic\\module%llu.dll\" %08X %08X\r\n",
+                    static_cast<unsigned long long>(module),
+                    static_cast<unsigned long long>(module),
+                    static_cast<unsigned>(random()),
+                    static_cast<unsigned>(ModuleSize));
+        }
+        text.append("\r\n");
+    }
+
+    text.append("*** REGISTERS\r\n");
+    Appendf(&text, "rax=%016llx rbx=%016llx rcx=%016llx\r\n",
+            static_cast<unsigned long long>(random()),
+            static_cast<unsigned long long>(random()),
+            static_cast<unsigned long long>(random()));
+    Appendf(&text, "rdx=%016llx rsi=%016llx rdi=%016llx\r\n",
+            static_cast<unsigned long long>(random()),
+            static_cast<unsigned long long>(random()),
+            static_cast<unsigned long long>(random()));
+    Appendf(&text, "rip=%016llx rsp=%016llx rbp=%016llx\r\n",
+            static_cast<unsigned long long>(ModuleBase + 0x1000),
+            static_cast<unsigned long long>(RegionBase),
+            static_cast<unsigned long long>(RegionBase + (options.FrameCount * 0x40) % options.RegionSize));
+    text.append("iopl=0         nv up ei pl zr na po nc\r\n"
+                "cs=0033  ss=002b  ds=002b  es=002b  fs=0053  gs=002b             efl=00000244\r\n"
+                "\r\n");
+
+    //
+    // Memory.  Runs of hex regions share a single "*** MEMORY" section.  Each binary region is its own section.
+    //
+    bool inHexSection = false;
+    std::vector<unsigned char> bytes;
+    for (uint64_t region = 0; region < options.RegionCount; ++region)
+    {
+        uint64_t regionStart = RegionBase + region * regionStride;
+
+        //
+        // Something a little more compressible than pure noise: runs of zeros, small integers, and random bytes.
+        //
+        bytes.resize(static_cast<size_t>(options.RegionSize));
+        for (size_t i = 0; i < bytes.size(); i += 8)
+        {
+            uint64_t kind = random() % 4;
+            uint64_t value = (kind == 0) ? 0 : (kind == 1) ? random() % 0x100 : random();
+            for (size_t j = 0; j < 8 && i + j < bytes.size(); ++j)
+            {
+                bytes[i + j] = static_cast<unsigned char>(value >> (j * 8));
+            }
+        }
+
+        bool isBinary = (random() % 100) < options.BinaryPercent;
+        if (isBinary)
+        {
+            if (inHexSection)
+            {
+                text.append("\r\n");
+                inHexSection = false;
+            }
+
+            text.append("*** MEMORY BINARY ");
+            AppendAddress(&text, regionStart);
+            Appendf(&text, " %llx %016llx\r\n\r\n",
+                    static_cast<unsigned long long>(bytes.size()),
+                    static_cast<unsigned long long>(pBinaryData->size()));
+
+            pBinaryData->insert(pBinaryData->end(), bytes.begin(), bytes.end());
+        }
+        else
+        {
+            if (!inHexSection)
+            {
+                text.append("*** MEMORY\r\n");
+                inHexSection = true;
+            }
+            AppendMemoryRows(&text, regionStart, bytes);
+        }
+    }
+
+    if (inHexSection)
+    {
+        text.append("\r\n");
+    }
+
+    if (!pBinaryData->empty())
+    {
+        text.append("*** BINARY DATA\r\n");
+    }
+}
+
+// PatchBinaryOffsets():
+//
+// Replaces the relative offsets of binary memory sections with absolute file offsets now that the size of the
+// text (and hence where the binary data starts) is known.
+//
+void PatchBinaryOffsets(std::string *pText, uint64_t binaryDataOffset)
+{
+    size_t pos = 0;
+    while ((pos = pText->find("*** MEMORY BINARY ", pos)) != std::string::npos)
+    {
+        size_t eol = pText->find("\r\n", pos);
+        size_t offsetPos = eol - OffsetWidth;
+        uint64_t relativeOffset = strtoull(pText->substr(offsetPos, OffsetWidth).c_str(), nullptr, 16);
+
+        char absoluteOffset[OffsetWidth + 1];
+        snprintf(absoluteOffset, sizeof(absoluteOffset), "%016llx", static_cast<unsigned long long>(binaryDataOffset + relativeOffset));
+        memcpy(&(*pText)[offsetPos], absoluteOffset, OffsetWidth);
+        pos = eol;
+    }
+}
+
+} // anonymous namespace
+
+int main(int argc, char **argv)
+{
+    GeneratorOptions options;
+    if (!ParseOptions(argc, argv, &options))
+    {
+        Usage();
+        return 1;
+    }
+
+    std::string text;
+    std::vector<unsigned char> binaryData;
+    GenerateText(options, &text, &binaryData);
+
+    //
+    // Everything in the text is ASCII.  For UTF-16, every character is two bytes.
+    //
+    uint64_t bomSize = options.Utf16 ? 2 : 3;
+    uint64_t textSize = bomSize + text.size() * (options.Utf16 ? 2 : 1);
+    PatchBinaryOffsets(&text, textSize);
+
+    FILE *pFile = fopen(options.OutputPath, "wb");
+    if (pFile == nullptr)
+    {
+        fprintf(stderr, "unable to open %s\n", options.OutputPath);
+        return 1;
+    }
+
+    bool ok;
+    if (options.Utf16)
+    {
+        std::vector<unsigned char> utf16;
+        utf16.reserve(static_cast<size_t>(textSize));
+        utf16.push_back(0xff);
+        utf16.push_back(0xfe);
+        for (char c : text)
+        {
+            utf16.push_back(static_cast<unsigned char>(c));
+            utf16.push_back(0);
+        }
+        ok = fwrite(utf16.data(), 1, utf16.size(), pFile) == utf16.size();
+    }
+    else
+    {
+        static const unsigned char s_bom[] = { 0xef, 0xbb, 0xbf };
+        ok = fwrite(s_bom, 1, sizeof(s_bom), pFile) == sizeof(s_bom) &&
+             fwrite(text.data(), 1, text.size(), pFile) == text.size();
+    }
+
+    ok = ok && fwrite(binaryData.data(), 1, binaryData.size(), pFile) == binaryData.size();
+    ok = (fclose(pFile) == 0) && ok;
+
+    if (!ok)
+    {
+        fprintf(stderr, "unable to write %s\n", options.OutputPath);
+        return 1;
+    }
+
+    printf("%s: %llu bytes of text, %llu bytes of binary data\n",
+           options.OutputPath,
+           static_cast<unsigned long long>(textSize),
+           static_cast<unsigned long long>(binaryData.size()));
+    return 0;
+}
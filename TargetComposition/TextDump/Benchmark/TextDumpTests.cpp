@@ -0,0 +1,385 @@
+//**************************************************************************
+//
+// TextDumpTests.cpp
+//
+// Functional tests for the "text dump" parser.  Each test builds a small
+// text dump in memory, parses it through TextDumpParser (using the
+// portable stand-in headers), and checks what the plug-in's services
+// would see.
+//
+//**************************************************************************
+//
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+//
+//**************************************************************************
+
+#include "Portable/TextDump.h"
+
+using namespace Debugger::TargetComposition::Services::TextDump;
+
+namespace
+{
+
+// BufferFile:
+//
+// The "debug source file" handed to the parser: a text dump held in memory.
+//
+class BufferFile : public ISvcDebugSourceFileMapping
+{
+public:
+
+    BufferFile(_In_ std::string contents) :
+        m_contents(std::move(contents))
+    {
+    }
+
+    HRESULT MapFile(_Out_ void **ppMapping, _Out_ ULONG64 *pMappingSize) override
+    {
+        *ppMapping = &(m_contents[0]);
+        *pMappingSize = m_contents.size();
+        return S_OK;
+    }
+
+private:
+
+    std::string m_contents;
+};
+
+// TextDumpBuilder:
+//
+// Builds the text of a UTF-8 text dump.  Binary memory sections have their bytes placed after the
+// "*** BINARY DATA" marker at the end of the file.
+//
+class TextDumpBuilder
+{
+public:
+
+    TextDumpBuilder() :
+        m_text("*** TEXTUAL DEMONSTRATION FILE\r\n\r\n")
+    {
+    }
+
+    // AddMemory():
+    //
+    // Adds a "*** MEMORY" section in the format of the 'db' command.
+    //
+    void AddMemory(_In_ ULONG64 address, _In_ std::vector<unsigned char> const& bytes)
+    {
+        m_text += "*** MEMORY\r\n";
+        for (size_t rowStart = 0; rowStart < bytes.size(); rowStart += 16)
+        {
+            char buffer[64];
+            ULONG64 rowAddress = address + rowStart;
+            snprintf(buffer, sizeof(buffer), "%08x`%08x ",
+                     static_cast<unsigned>(rowAddress >> 32), static_cast<unsigned>(rowAddress));
+            m_text += buffer;
+
+            size_t rowEnd = (std::min)(rowStart + 16, bytes.size());
+            for (size_t i = rowStart; i < rowEnd; ++i)
+            {
+                snprintf(buffer, sizeof(buffer), "%c%02x", (i - rowStart == 8) ? '-' : ' ', bytes[i]);
+                m_text += buffer;
+            }
+            m_text += "  ";
+            m_text.append(rowEnd - rowStart, '.');
+            m_text += "\r\n";
+        }
+        m_text += "\r\n";
+    }
+
+    // AddBinaryMemory():
+    //
+    // Adds a "*** MEMORY BINARY" section whose bytes are within the text dump.
+    //
+    void AddBinaryMemory(_In_ ULONG64 address, _In_ std::vector<unsigned char> const& bytes)
+    {
+        m_binarySections.push_back({ m_text.size(), bytes });
+        m_text += "*** MEMORY BINARY ";
+        m_text += FormatHex(address);
+        m_text += " ";
+        m_text += FormatHex(bytes.size());
+        m_text += " ";
+
+        //
+        // The file offset is patched in by Build once the size of the text is known.
+        //
+        m_text.append(OffsetWidth, '0');
+        m_text += "\r\n\r\n";
+    }
+
+    // Build():
+    //
+    // Returns the text dump.
+    //
+    std::string Build() const
+    {
+        std::string text = m_text;
+        if (m_binarySections.empty())
+        {
+            return text;
+        }
+
+        text += "*** BINARY DATA\r\n";
+        for (auto&& section : m_binarySections)
+        {
+            std::string offset = FormatHex(text.size());
+            size_t offsetPos = text.find("\r\n", section.first) - OffsetWidth;
+            text.replace(offsetPos + OffsetWidth - offset.size(), offset.size(), offset);
+            text.append(section.second.begin(), section.second.end());
+        }
+        return text;
+    }
+
+private:
+
+    static const size_t OffsetWidth = 16;
+
+    static std::string FormatHex(_In_ ULONG64 value)
+    {
+        char buffer[32];
+        snprintf(buffer, sizeof(buffer), "%llx", static_cast<unsigned long long>(value));
+        return buffer;
+    }
+
+    std::string m_text;
+    std::vector<std::pair<size_t, std::vector<unsigned char>>> m_binarySections;
+};
+
+// ParsedDump:
+//
+// A text dump and its parser.
+//
+struct ParsedDump
+{
+    ParsedDump(_In_ std::string contents) :
+        File(std::move(contents)),
+        Parser(&File)
+    {
+    }
+
+    BufferFile File;
+    TextDumpParser Parser;
+};
+
+// ParseDump():
+//
+// Parses the given text dump.  Returns nullptr if the parser rejects it.
+//
+std::unique_ptr<ParsedDump> ParseDump(_In_ std::string contents)
+{
+    std::unique_ptr<ParsedDump> spDump(new ParsedDump(std::move(contents)));
+    if (FAILED(spDump->Parser.Initialize()) || FAILED(spDump->Parser.Parse()))
+    {
+        return nullptr;
+    }
+    return spDump;
+}
+
+// ReadVirtual():
+//
+// Reads memory the way VirtualMemoryService::ReadMemory does.  The read fails unless it can be satisfied
+// entirely.
+//
+bool ReadVirtual(_In_ TextDumpParser &parser, _In_ ULONG64 address, _In_ size_t size, _Out_ std::vector<unsigned char> *pBytes)
+{
+    pBytes->resize(size);
+    size_t bytesRead = 0;
+    while (bytesRead < size)
+    {
+        MemoryRegion const *pRegion = parser.FindMemoryRegion(address + bytesRead);
+        if (pRegion == nullptr)
+        {
+            return false;
+        }
+
+        size_t chunkSize = static_cast<size_t>((std::min)(static_cast<ULONG64>(size - bytesRead),
+                                                          pRegion->EndAddress - (address + bytesRead)));
+        if (FAILED(parser.ReadMemory(pRegion, address + bytesRead, pBytes->data() + bytesRead, chunkSize)))
+        {
+            return false;
+        }
+
+        bytesRead += chunkSize;
+    }
+
+    return true;
+}
+
+#define VERIFY(expr) \
+    do { if (!(expr)) { fprintf(stderr, "    %s(%d): %s\n", __FILE__, __LINE__, #expr); return false; } } while(false)
+
+//*************************************************
+// Tests:
+//
+
+// Test_OverlapFirstInFileWins:
+//
+// A later memory section which starts below an earlier one only fills in around it.
+//
+bool Test_OverlapFirstInFileWins()
+{
+    TextDumpBuilder builder;
+    builder.AddMemory(0x1010, std::vector<unsigned char>(0x20, 0xaa));
+    builder.AddMemory(0x1000, std::vector<unsigned char>(0x40, 0xbb));
+
+    auto spDump = ParseDump(builder.Build());
+    VERIFY(spDump != nullptr);
+
+    TextDumpParser &parser = spDump->Parser;
+    VERIFY(parser.GetMemoryRegions().size() == 1);
+    VERIFY(parser.GetMemoryRegions()[0].StartAddress == 0x1000);
+    VERIFY(parser.GetMemoryRegions()[0].EndAddress == 0x1040);
+
+    std::vector<unsigned char> bytes;
+    VERIFY(ReadVirtual(parser, 0x1000, 0x40, &bytes));
+    for (size_t i = 0; i < bytes.size(); ++i)
+    {
+        VERIFY(bytes[i] == ((i >= 0x10 && i < 0x30) ? 0xaa : 0xbb));
+    }
+
+    return true;
+}
+
+// Test_OverlapSeparateRegions:
+//
+// A later memory section which spans the gap between two earlier ones fills only the gap and joins them
+// into a single region.
+//
+bool Test_OverlapSeparateRegions()
+{
+    TextDumpBuilder builder;
+    builder.AddMemory(0x2000, std::vector<unsigned char>(0x10, 0x11));
+    builder.AddMemory(0x2030, std::vector<unsigned char>(0x10, 0x22));
+    builder.AddMemory(0x1ff0, std::vector<unsigned char>(0x60, 0x33));
+
+    auto spDump = ParseDump(builder.Build());
+    VERIFY(spDump != nullptr);
+
+    TextDumpParser &parser = spDump->Parser;
+    VERIFY(parser.GetMemoryRegions().size() == 1);
+    VERIFY(parser.GetMemoryRegions()[0].StartAddress == 0x1ff0);
+    VERIFY(parser.GetMemoryRegions()[0].EndAddress == 0x2050);
+
+    std::vector<unsigned char> bytes;
+    VERIFY(ReadVirtual(parser, 0x1ff0, 0x60, &bytes));
+    for (size_t i = 0; i < bytes.size(); ++i)
+    {
+        ULONG64 address = 0x1ff0 + i;
+        unsigned char expected = (address >= 0x2000 && address < 0x2010) ? 0x11 :
+                                 (address >= 0x2030 && address < 0x2040) ? 0x22 : 0x33;
+        VERIFY(bytes[i] == expected);
+    }
+
+    return true;
+}
+
+// Test_OverlapBinarySections:
+//
+// Binary memory sections resolve overlaps in file order along with the hex memory sections: a binary section
+// only fills in around an earlier hex section and a hex section only fills in around an earlier binary section.
+//
+bool Test_OverlapBinarySections()
+{
+    TextDumpBuilder builder;
+    builder.AddMemory(0x3010, std::vector<unsigned char>(0x20, 0xaa));
+    builder.AddBinaryMemory(0x3000, std::vector<unsigned char>(0x40, 0xbb));
+    builder.AddBinaryMemory(0x4010, std::vector<unsigned char>(0x20, 0xcc));
+    builder.AddMemory(0x4000, std::vector<unsigned char>(0x40, 0xdd));
+
+    auto spDump = ParseDump(builder.Build());
+    VERIFY(spDump != nullptr);
+
+    TextDumpParser &parser = spDump->Parser;
+    VERIFY(parser.GetMemoryRegions().size() == 2);
+    VERIFY(parser.GetMemoryRegions()[0].StartAddress == 0x3000);
+    VERIFY(parser.GetMemoryRegions()[0].EndAddress == 0x3040);
+    VERIFY(parser.GetMemoryRegions()[1].StartAddress == 0x4000);
+    VERIFY(parser.GetMemoryRegions()[1].EndAddress == 0x4040);
+
+    std::vector<unsigned char> bytes;
+    VERIFY(ReadVirtual(parser, 0x3000, 0x40, &bytes));
+    for (size_t i = 0; i < bytes.size(); ++i)
+    {
+        VERIFY(bytes[i] == ((i >= 0x10 && i < 0x30) ? 0xaa : 0xbb));
+    }
+
+    VERIFY(ReadVirtual(parser, 0x4000, 0x40, &bytes));
+    for (size_t i = 0; i < bytes.size(); ++i)
+    {
+        VERIFY(bytes[i] == ((i >= 0x10 && i < 0x30) ? 0xcc : 0xdd));
+    }
+
+    return true;
+}
+
+// Test_MemoryIndexedOnFirstUse:
+//
+// Parse only checks the first row of a UTF-8 memory section.  The rest are parsed on first use.  A bad one
+// makes reads of its section fail and leaves the other sections alone.
+//
+bool Test_MemoryIndexedOnFirstUse()
+{
+    TextDumpBuilder builder;
+    builder.AddMemory(0x1000, std::vector<unsigned char>(0x40, 0xaa));
+    builder.AddMemory(0x2000, std::vector<unsigned char>(0x40, 0xbb));
+    std::string text = builder.Build();
+
+    auto spDump = ParseDump(text);
+    VERIFY(spDump != nullptr);
+    VERIFY(spDump->Parser.HasMemoryRegions());
+    VERIFY(spDump->Parser.GetMemoryRegions().size() == 2);
+
+    size_t lastRow = text.rfind("00000000`00001030");
+    VERIFY(lastRow != std::string::npos);
+    text.replace(text.find(" aa", lastRow), 3, " zz");
+
+    spDump = ParseDump(text);
+    VERIFY(spDump != nullptr);
+    VERIFY(spDump->Parser.HasMemoryRegions());
+
+    std::vector<unsigned char> bytes;
+    VERIFY(spDump->Parser.FindMemoryRegion(0x1000) != nullptr);
+    VERIFY(!ReadVirtual(spDump->Parser, 0x1000, 0x10, &bytes));
+    VERIFY(ReadVirtual(spDump->Parser, 0x2000, 0x40, &bytes));
+    VERIFY(bytes == std::vector<unsigned char>(0x40, 0xbb));
+
+    size_t firstRow = text.find("00000000`00001000");
+    VERIFY(firstRow != std::string::npos);
+    text.replace(text.find(" aa", firstRow), 3, " zz");
+    VERIFY(ParseDump(text) == nullptr);
+
+    return true;
+}
+
+struct TestCase
+{
+    const char *Name;
+    bool (*Run)();
+};
+
+const TestCase Tests[] =
+{
+    { "OverlapFirstInFileWins", Test_OverlapFirstInFileWins },
+    { "OverlapSeparateRegions", Test_OverlapSeparateRegions },
+    { "OverlapBinarySections", Test_OverlapBinarySections },
+    { "MemoryIndexedOnFirstUse", Test_MemoryIndexedOnFirstUse },
+};
+
+} // anonymous namespace
+
+int main()
+{
+    size_t failures = 0;
+    for (auto&& test : Tests)
+    {
+        bool passed = test.Run();
+        printf("%s %s\n", passed ? "PASS" : "FAIL", test.Name);
+        if (!passed)
+        {
+            ++failures;
+        }
+    }
+
+    printf("%zu of %zu tests passed\n", ARRAYSIZE(Tests) - failures, ARRAYSIZE(Tests));
+    return (failures == 0) ? 0 : 1;
+}
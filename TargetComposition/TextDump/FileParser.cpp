@@ -13,6 +13,13 @@
 
 #include "TextDump.h"
 
+#include <psapi.h>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define TEXTDUMP_SSE2_DECODE
+#endif
+
 using namespace Microsoft::WRL;
 
 namespace Debugger
@@ -24,6 +31,24 @@ namespace Services
 namespace TextDump
 {
 
+//
+// The approximate size of the pieces that large memory sections are split into for parallel decoding.
+//
+const size_t MemoryParseTaskSize = 1024 * 1024;
+
+//
+// The size of the pages that memory is decoded in on demand and the maximum amount of decoded memory which
+// is cached.
+//
+const size_t LazyMemoryPageSize = 64 * 1024;
+const size_t LazyMemoryCacheSize = 64 * 1024 * 1024;
+
+TextDumpParser::~TextDumpParser()
+{
+    ReleaseSidecar();
+    ReleaseExternalMemoryFiles();
+}
+
 HRESULT TextDumpParser::Initialize()
 {
     HRESULT hr = S_OK;
@@ -36,7 +61,7 @@ HRESULT TextDumpParser::Initialize()
     //
     // NOTE: all interfaces having to do with being the "debug source" (the thing you are debugging) are
     //       prefixed ISvcDebugSource...  The "ISvcDebugSourceFileMapping" interface should be read as
-    //       'ISvc' 'DebugSource' 'FileMapping' and not be confused with a code source file (e.g.: some C/C++ source 
+    //       'ISvc' 'DebugSource' 'FileMapping' and not be confused with a code source file (e.g.: some C/C++ source
     //       code).  The interfaces having to do with code source files are ISvcSourceFile...
     //
     ComPtr<ISvcDebugSourceFileMapping> spFileMapping;
@@ -52,12 +77,13 @@ HRESULT TextDumpParser::Initialize()
     // As a simple sample, we'll handle UTF-8 and UTF-16LE files.  If there is no BOM, assume the file
     // is UTF-8.
     //
-    if (m_mappingSize >= 3 && m_pFileMapping[0] == 0xef && m_pFileMapping[1] == 0xbb && m_pFileMapping[2] == 0xbf)
+    unsigned char const *pBom = reinterpret_cast<unsigned char const *>(m_pFileMapping);
+    if (m_mappingSize >= 3 && pBom[0] == 0xef && pBom[1] == 0xbb && pBom[2] == 0xbf)
     {
         m_isUtf8 = true;
         m_pos = 3;
     }
-    else if (m_mappingSize >= 2 && m_pFileMapping[0] == 0xff && m_pFileMapping[1] == 0xfe)
+    else if (m_mappingSize >= 2 && pBom[0] == 0xff && pBom[1] == 0xfe)
     {
         m_isUtf8 = false;
         m_pos = 2;
@@ -109,20 +135,37 @@ bool TextDumpParser::ReadLine(_Out_ std::wstring *pString)
         //
         if (m_isUtf8)
         {
-            for (posEol = m_pos; posEol < m_mappingSize; ++posEol)
+            char const *pLine;
+            size_t lineLength;
+            if (!ReadLineBytes(&pLine, &lineLength))
+            {
+                return E_BOUNDS;
+            }
+
+            //
+            // Most of these files are pure ASCII.  Only go through the UTF-8 conversion if there is something
+            // other than ASCII on the line.
+            //
+            bool isAscii = true;
+            for (size_t i = 0; i < lineLength; ++i)
             {
-                if (m_pFileMapping[posEol] == '\n' ||
-                    (posEol + 1 < m_mappingSize && m_pFileMapping[posEol] == '\r' &&  
-                                                   m_pFileMapping[posEol + 1] == '\n'))
+                if (static_cast<unsigned char>(pLine[i]) >= 0x80)
                 {
+                    isAscii = false;
                     break;
                 }
             }
 
+            if (isAscii)
+            {
+                pString->assign(pLine, pLine + lineLength);
+                return hr;
+            }
+
             int sz = MultiByteToWideChar(CP_UTF8,
                                          MB_PRECOMPOSED,
-                                         m_pFileMapping + m_pos,
-                                         static_cast<int>(posEol - m_pos),
+                                         pLine,
+                                         static_cast<int>(lineLength),
                                          nullptr,
                                          0);
 
@@ -130,8 +173,8 @@ bool TextDumpParser::ReadLine(_Out_ std::wstring *pString)
 
             int rsz = MultiByteToWideChar(CP_UTF8,
                                           MB_PRECOMPOSED,
-                                          m_pFileMapping + m_pos,
-                                          static_cast<int>(posEol - m_pos),
+                                          pLine,
+                                          static_cast<int>(lineLength),
                                           const_cast<wchar_t *>(pString->data()),
                                           sz);
 
@@ -139,18 +182,6 @@ bool TextDumpParser::ReadLine(_Out_ std::wstring *pString)
             {
                 return E_FAIL;
             }
-
-            size_t remaining = m_mappingSize - posEol;
-            if (remaining >= 2 && m_pFileMapping[posEol] == '\r' && m_pFileMapping[posEol + 1] == '\n')
-            {
-                posEol += 2;
-            }
-            else if (remaining >= 1 && m_pFileMapping[posEol] == '\n')
-            {
-                posEol += 1;
-            }
-
-            m_pos = posEol;
         }
         else
         {
@@ -186,6 +217,188 @@ bool TextDumpParser::ReadLine(_Out_ std::wstring *pString)
     return SUCCEEDED(ConvertException(fn));
 }
 
+bool TextDumpParser::ReadLineBytes(_Inout_ size_t *pPos,
+                                   _In_ size_t endPos,
+                                   _Out_ char const **ppLine,
+                                   _Out_ size_t *pLength) const
+{
+    if (*pPos >= endPos)
+    {
+        return false;
+    }
+
+    //
+    // memchr is vectorized by the CRT and is much faster than a per character scan for the line end.  Lines
+    // end in either "\n" or "\r\n".
+    //
+    char const *pLine = m_pFileMapping + *pPos;
+    size_t remaining = endPos - *pPos;
+    char const *pEol = reinterpret_cast<char const *>(memchr(pLine, '\n', remaining));
+
+    size_t length;
+    if (pEol == nullptr)
+    {
+        length = remaining;
+        *pPos = endPos;
+    }
+    else
+    {
+        length = pEol - pLine;
+        *pPos += length + 1;
+        if (length > 0 && pLine[length - 1] == '\r')
+        {
+            --length;
+        }
+    }
+
+    *ppLine = pLine;
+    *pLength = length;
+    return true;
+}
+
+bool TextDumpParser::ParseHex(_In_ char const *ps,
+                              _In_ char const *pe,
+                              _Out_ ULONG64 *pValue,
+                              _Out_ char const **ppc) const
+{
+    ULONG64 val = 0;
+    char const *pc = ps;
+    size_t sepCount = 0;
+    for (; pc < pe; ++pc)
+    {
+        if (*pc >= '0' && *pc <= '9')
+        {
+            val = (val << 4) | (*pc - '0');
+        }
+        else if (*pc >= 'a' && *pc <= 'f')
+        {
+            val = (val << 4) | (*pc - 'a' + 10);
+        }
+        else if (*pc >= 'A' && *pc <= 'F')
+        {
+            val = (val << 4) | (*pc - 'A' + 10);
+        }
+        else if (*pc != '`')
+        {
+            break;
+        }
+        else
+        {
+            ++sepCount;
+        }
+    }
+
+    if (static_cast<size_t>(pc - ps) == sepCount)
+    {
+        return false;
+    }
+
+    *pValue = val;
+    *ppc = pc;
+    return true;
+}
+
+bool TextDumpParser::DecodeMemoryRow(_In_ char const *pc,
+                                     _In_ char const *pe,
+                                     _Out_writes_(16) unsigned char *pBytes)
+{
+    //
+    // A full row is 47 characters: 16 pairs of hex digits separated by spaces (with a '-' between the 8th and
+    // 9th byte).  Anything after the row must be whitespace (the ASCII dump follows after two spaces).
+    //
+    static char const s_rowPattern[] = "00 00 00 00 00 00 00 00-00 00 00 00 00 00 00 00 ";
+    static_assert(sizeof(s_rowPattern) - 1 == 48, "unexpected row pattern length");
+
+    const ULONG64 hexPositionMask = 0x6db6db6db6dbull;        // p % 3 != 2 for p < 47
+    const ULONG64 separatorPositionMask = 0x124924924924ull;  // p % 3 == 2 for p < 47
+
+    size_t length = pe - pc;
+    if (length < 47 || (length > 47 && !isspace(static_cast<unsigned char>(pc[47]))))
+    {
+        return false;
+    }
+
+    //
+    // Always work on 48 characters.  If the row is the very last thing in the mapping, we cannot read the
+    // character after it, so copy it out and pad it.
+    //
+    char padded[48];
+    if (length == 47)
+    {
+        memcpy(padded, pc, 47);
+        padded[47] = ' ';
+        pc = padded;
+    }
+
+    unsigned char nibbles[48];
+    ULONG64 hexMask = 0;
+    ULONG64 patternMask = 0;
+
+#ifdef TEXTDUMP_SSE2_DECODE
+    const __m128i zeroChar = _mm_set1_epi8('0');
+    const __m128i nine = _mm_set1_epi8(9);
+    const __m128i lowerCase = _mm_set1_epi8(0x20);
+    const __m128i aChar = _mm_set1_epi8('a');
+    const __m128i five = _mm_set1_epi8(5);
+    const __m128i ten = _mm_set1_epi8(10);
+
+    for (int chunk = 0; chunk < 3; ++chunk)
+    {
+        __m128i chars = _mm_loadu_si128(reinterpret_cast<__m128i const *>(pc + chunk * 16));
+        __m128i pattern = _mm_loadu_si128(reinterpret_cast<__m128i const *>(s_rowPattern + chunk * 16));
+
+        //
+        // Unsigned range checks: x is in [0, n] if min(x, n) == x.
+        //
+        __m128i digits = _mm_sub_epi8(chars, zeroChar);
+        __m128i isDigit = _mm_cmpeq_epi8(_mm_min_epu8(digits, nine), digits);
+        __m128i letters = _mm_sub_epi8(_mm_or_si128(chars, lowerCase), aChar);
+        __m128i isLetter = _mm_cmpeq_epi8(_mm_min_epu8(letters, five), letters);
+
+        __m128i values = _mm_or_si128(_mm_and_si128(isDigit, digits),
+                                      _mm_and_si128(isLetter, _mm_add_epi8(letters, ten)));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(nibbles + chunk * 16), values);
+
+        ULONG64 chunkHex = static_cast<ULONG64>(_mm_movemask_epi8(_mm_or_si128(isDigit, isLetter)));
+        ULONG64 chunkPattern = static_cast<ULONG64>(_mm_movemask_epi8(_mm_cmpeq_epi8(chars, pattern)));
+        hexMask |= chunkHex << (chunk * 16);
+        patternMask |= chunkPattern << (chunk * 16);
+    }
+#else
+    for (int p = 0; p < 48; ++p)
+    {
+        char c = pc[p];
+        if (c >= '0' && c <= '9')
+        {
+            nibbles[p] = static_cast<unsigned char>(c - '0');
+            hexMask |= (1ull << p);
+        }
+        else if ((c | 0x20) >= 'a' && (c | 0x20) <= 'f')
+        {
+            nibbles[p] = static_cast<unsigned char>((c | 0x20) - 'a' + 10);
+            hexMask |= (1ull << p);
+        }
+        if (c == s_rowPattern[p])
+        {
+            patternMask |= (1ull << p);
+        }
+    }
+#endif // TEXTDUMP_SSE2_DECODE
+
+    if ((hexMask & hexPositionMask) != hexPositionMask ||
+        (patternMask & separatorPositionMask) != separatorPositionMask)
+    {
+        return false;
+    }
+
+    for (int i = 0; i < 16; ++i)
+    {
+        pBytes[i] = static_cast<unsigned char>((nibbles[i * 3] << 4) | nibbles[i * 3 + 1]);
+    }
+
+    return true;
+}
+
 bool TextDumpParser::ParseHex(_In_ wchar_t const *ps,
                               _Out_ ULONG64 *pValue,
                               _Out_ wchar_t const **ppc)
@@ -211,7 +424,7 @@ bool TextDumpParser::ParseHex(_In_ wchar_t const *ps,
         {
             ++sepCount;
         }
-        else 
+        else
         {
             if (static_cast<size_t>(pc - ps) == sepCount)
             {
@@ -235,6 +448,18 @@ bool TextDumpParser::IsEmptyLine(_In_ std::wstring const& str)
     return *pc == 0;
 }
 
+bool TextDumpParser::IsEmptyLine(_In_reads_(length) char const *pLine, _In_ size_t length)
+{
+    for (size_t i = 0; i < length; ++i)
+    {
+        if (!isspace(static_cast<unsigned char>(pLine[i])))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
 HRESULT TextDumpParser::ParseRegisters()
 {
     HRESULT hr = S_OK;
@@ -282,7 +507,7 @@ HRESULT TextDumpParser::ParseRegisters()
             }
 
             m_registerValues.push_back({ std::move(registerName), registerValue });
-            
+
             while (*pc && iswspace(*pc)) { ++pc; }
         }
     }
@@ -309,7 +534,7 @@ HRESULT TextDumpParser::ParseModuleInformation()
         wchar_t const *pc = line.c_str();
 
         // Example line:
-        // 
+        //
         //     00007ff7`79e10000 00007ff7`79e67000 notepad "C:\Windows\System32\notepad.exe" F59533D5 00057000
         //
 
@@ -363,7 +588,7 @@ HRESULT TextDumpParser::ParseModuleInformation()
         while (*pc && iswspace(*pc)) { ++pc; }
 
         ULONG64 timeStamp;
-        if (!ParseHex(pc, &timeStamp, &pc)) 
+        if (!ParseHex(pc, &timeStamp, &pc))
         {
             return E_FAIL;
         }
@@ -466,7 +691,7 @@ HRESULT TextDumpParser::ParseStackFrames()
             }
         }
 
-        m_stackFrames.push_back({ frameNumber, childSp, retAddr, 
+        m_stackFrames.push_back({ frameNumber, childSp, retAddr,
                                   std::move(moduleName), std::move(symbolName), displacement });
 
         ++curFrame;
@@ -576,39 +801,1021 @@ HRESULT TextDumpParser::ParseMemoryRegions()
     return hr;
 }
 
-HRESULT TextDumpParser::Parse()
+std::vector<TextDumpParser::MemorySegment> TextDumpParser::ResolveMemoryOverlaps(_In_ std::vector<std::pair<ULONG64, ULONG64>> const& ranges)
 {
-    auto fn = [&]()
+    std::vector<MemorySegment> segments;
+
+    //
+    // What the ranges applied so far cover: disjoint, coalesced [start, end) keyed by start.  Every covered
+    // range which a new range touches is folded into one so that each range is only skipped over once.
+    //
+    std::map<ULONG64, ULONG64> covered;
+    for (size_t i = 0; i < ranges.size(); ++i)
     {
-        HRESULT hr = S_OK;
+        ULONG64 startAddress = ranges[i].first;
+        ULONG64 endAddress = ranges[i].second;
+        if (startAddress >= endAddress)
+        {
+            continue;
+        }
 
-        std::wstring line;
-        while(ReadLine(&line))
+        auto it = covered.upper_bound(startAddress);
+        if (it != covered.begin() && std::prev(it)->second >= startAddress)
         {
-            wchar_t const *pc = line.c_str();
-            if (*pc == L'#' || IsEmptyLine(line))
-            {
-                continue;
-            }
+            --it;
+        }
 
-            if (wcscmp(pc, L"*** MEMORY") == 0)
-            {
-                IfFailedReturn(ParseMemoryRegions());
-            }
-            else if (wcscmp(pc, L"*** STACK") == 0)
+        ULONG64 coveredStart = startAddress;
+        ULONG64 coveredEnd = endAddress;
+        ULONG64 curAddress = startAddress;
+        while (it != covered.end() && it->first <= endAddress)
+        {
+            if (it->first > curAddress)
             {
-                IfFailedReturn(ParseStackFrames());
+                segments.push_back({ curAddress, it->first, i });
             }
-            else if (wcscmp(pc, L"*** MODULEINFO") == 0)
+
+            curAddress = (std::max)(curAddress, it->second);
+            coveredStart = (std::min)(coveredStart, it->first);
+            coveredEnd = (std::max)(coveredEnd, it->second);
+            it = covered.erase(it);
+        }
+
+        if (curAddress < endAddress)
+        {
+            segments.push_back({ curAddress, endAddress, i });
+        }
+
+        covered.emplace(coveredStart, coveredEnd);
+    }
+
+    std::sort(segments.begin(), segments.end(),
+              [](MemorySegment const& a, MemorySegment const& b) { return a.StartAddress < b.StartAddress; });
+    return segments;
+}
+
+void TextDumpParser::BuildMemoryRegionIndex()
+{
+    std::vector<std::pair<ULONG64, ULONG64>> ranges;
+    ranges.reserve(m_memoryRegions.size());
+    for (auto&& region : m_memoryRegions)
+    {
+        ranges.push_back({ region.StartAddress, region.EndAddress });
+    }
+
+    std::vector<MemoryRegion> mergedRegions;
+    for (auto&& segment : ResolveMemoryOverlaps(ranges))
+    {
+        //
+        // Copy in the bytes of the region which provides this piece, appending to the previous region if
+        // the two are adjacent.
+        //
+        MemoryRegion const& region = m_memoryRegions[segment.RunIndex];
+        auto itStart = region.Data.begin() + static_cast<size_t>(segment.StartAddress - region.StartAddress);
+        auto itEnd = region.Data.begin() + static_cast<size_t>(segment.EndAddress - region.StartAddress);
+
+        if (!mergedRegions.empty() && mergedRegions.back().EndAddress == segment.StartAddress)
+        {
+            MemoryRegion &prevRegion = mergedRegions.back();
+            prevRegion.Data.insert(prevRegion.Data.end(), itStart, itEnd);
+            prevRegion.EndAddress = segment.EndAddress;
+        }
+        else
+        {
+            mergedRegions.push_back({ segment.StartAddress, segment.EndAddress, std::vector<unsigned char>(itStart, itEnd) });
+        }
+    }
+
+    m_memoryRegions = std::move(mergedRegions);
+}
+
+MemoryRegion const *TextDumpParser::FindMemoryRegion(_In_ ULONG64 address,
+                                                     _Out_opt_ MemoryRegion const **ppNextRegion)
+{
+    if (ppNextRegion != nullptr)
+    {
+        *ppNextRegion = nullptr;
+    }
+
+    EnsureMemoryIndex();
+
+    //
+    // The regions are sorted and disjoint (see BuildMemoryRegionIndex).  Find the first region which starts
+    // above the address.  The only region which can contain the address is the one just before it.
+    //
+    auto it = std::upper_bound(m_memoryRegions.begin(), m_memoryRegions.end(), address,
+                               [](ULONG64 addr, MemoryRegion const& region) { return addr < region.StartAddress; });
+
+    if (it != m_memoryRegions.begin())
+    {
+        auto itPrev = std::prev(it);
+        if (address < itPrev->EndAddress)
+        {
+            return &(*itPrev);
+        }
+    }
+
+    if (ppNextRegion != nullptr && it != m_memoryRegions.end())
+    {
+        *ppNextRegion = &(*it);
+    }
+
+    return nullptr;
+}
+
+void TextDumpParser::BuildModuleIndex()
+{
+    m_moduleIndex.resize(m_moduleInfos.size());
+    for (size_t i = 0; i < m_moduleIndex.size(); ++i)
+    {
+        m_moduleIndex[i] = i;
+    }
+
+    std::stable_sort(m_moduleIndex.begin(), m_moduleIndex.end(),
+                     [&](size_t a, size_t b) { return m_moduleInfos[a].StartAddress < m_moduleInfos[b].StartAddress; });
+}
+
+bool TextDumpParser::FindModuleAtAddress(_In_ ULONG64 address, _Out_ size_t *pModuleIndex) const
+{
+    //
+    // Modules do not overlap.  The only module which can contain the address is the last one which
+    // starts at or below it.
+    //
+    auto it = std::upper_bound(m_moduleIndex.begin(), m_moduleIndex.end(), address,
+                               [&](ULONG64 addr, size_t idx) { return addr < m_moduleInfos[idx].StartAddress; });
+
+    if (it == m_moduleIndex.begin())
+    {
+        return false;
+    }
+
+    size_t idx = *std::prev(it);
+    if (address >= m_moduleInfos[idx].EndAddress)
+    {
+        return false;
+    }
+
+    *pModuleIndex = idx;
+    return true;
+}
+
+bool TextDumpParser::FindModuleByBaseAddress(_In_ ULONG64 baseAddress, _Out_ size_t *pModuleIndex) const
+{
+    auto it = std::lower_bound(m_moduleIndex.begin(), m_moduleIndex.end(), baseAddress,
+                               [&](size_t idx, ULONG64 addr) { return m_moduleInfos[idx].StartAddress < addr; });
+
+    if (it == m_moduleIndex.end() || m_moduleInfos[*it].StartAddress != baseAddress)
+    {
+        return false;
+    }
+
+    *pModuleIndex = *it;
+    return true;
+}
+
+HRESULT TextDumpParser::QueueMemorySection(_Inout_ std::vector<MemoryParseTask> *pTasks)
+{
+    //
+    // Find the end of the section (a blank line).  Only the first row is decoded so that something which is not
+    // in our format is still rejected at parse time.  The rest are left for EnsureMemoryIndex.
+    //
+    size_t sectionStart = m_pos;
+    size_t sectionEnd = m_pos;
+    size_t rowCount = 0;
+    char const *pLine;
+    size_t lineLength;
+    while(ReadLineBytes(&pLine, &lineLength))
+    {
+        if (IsEmptyLine(pLine, lineLength))
+        {
+            break;
+        }
+
+        if (rowCount == 0)
+        {
+            ULONG64 lineAddr;
+            std::vector<unsigned char> rowBytes;
+            if (!DecodeMemoryLine(pLine, lineLength, &lineAddr, &rowBytes))
             {
-                IfFailedReturn(ParseModuleInformation());
+                return E_FAIL;
             }
-            else if (wcscmp(pc, L"*** REGISTERS") == 0)
+        }
+
+        sectionEnd = m_pos;
+        ++rowCount;
+    }
+
+    if (rowCount == 0)
+    {
+        return E_FAIL;
+    }
+
+    size_t section = (pTasks->empty() ? 0 : pTasks->back().Section + 1);
+
+    //
+    // Split the section into pieces of roughly MemoryParseTaskSize bytes.  Each split point is moved forward
+    // to the start of the next row.
+    //
+    size_t pieceStart = sectionStart;
+    while (pieceStart < sectionEnd)
+    {
+        size_t pieceEnd = sectionEnd;
+        if (sectionEnd - pieceStart > MemoryParseTaskSize)
+        {
+            char const *pSplit = m_pFileMapping + pieceStart + MemoryParseTaskSize;
+            char const *pEol = reinterpret_cast<char const *>(memchr(pSplit, '\n', m_pFileMapping + sectionEnd - pSplit));
+            if (pEol != nullptr)
             {
-                IfFailedReturn(ParseRegisters());
+                pieceEnd = (pEol - m_pFileMapping) + 1;
             }
         }
 
+        pTasks->push_back({ pieceStart, pieceEnd, section, S_OK, {} });
+        pieceStart = pieceEnd;
+    }
+
+    return S_OK;
+}
+
+bool TextDumpParser::DecodeMemoryLine(_In_reads_(length) char const *pLine,
+                                      _In_ size_t length,
+                                      _Out_ ULONG64 *pAddress,
+                                      _Inout_ std::vector<unsigned char> *pBytes) const
+{
+    char const *pc = pLine;
+    char const *pe = pLine + length;
+
+    // Example line:
+    //
+    //     00000072`a512ee18  ee d1 22 33 ff 7f 00 00-ff ff ff ff 00 00 00 00  .."3............
+    //
+    if (!ParseHex(pc, pe, pAddress, &pc))
+    {
+        return false;
+    }
+
+    while (pc < pe && isspace(static_cast<unsigned char>(*pc))) { ++pc; }
+
+    pBytes->resize(16);
+    if (DecodeMemoryRow(pc, pe, pBytes->data()))
+    {
+        return true;
+    }
+
+    //
+    // Not a full row (e.g.: the last row of a 'db' with a length which is not a multiple of 16).  Parse it
+    // byte by byte.
+    //
+    pBytes->clear();
+    for (;;)
+    {
+        ULONG64 byteData;
+        char const *pn;
+        if (ParseHex(pc, pe, &byteData, &pn) &&  pn - pc == 2)
+        {
+            pBytes->push_back(static_cast<unsigned char>(byteData));
+            pc = pn;
+        }
+        else
+        {
+            //
+            // It's not our expected format.
+            //
+            return false;
+        }
+
+        if (pc < pe && (isspace(static_cast<unsigned char>(*pc)) || *pc == '-'))
+        {
+            ++pc;
+        }
+
+        if (pc == pe || isspace(static_cast<unsigned char>(*pc)))
+        {
+            return true;
+        }
+    }
+}
+
+HRESULT TextDumpParser::ParseMemoryRows(_Inout_ MemoryParseTask *pTask) const
+{
+    HRESULT hr = S_OK;
+
+    //
+    // Every row is decoded here to validate the format and to find how many bytes it holds; however, the
+    // bytes themselves are thrown away.  See ParseMemoryRegions for the details of how regions (runs) are formed.
+    // A run which spans pieces is joined back together in ParseMemoryTasks.
+    //
+    std::vector<unsigned char> rowBytes;
+    MemoryRun *pRun = nullptr;
+
+    size_t pos = pTask->StartPos;
+    for(;;)
+    {
+        size_t rowPos = pos;
+        char const *pLine;
+        size_t lineLength;
+        if (!ReadLineBytes(&pos, pTask->EndPos, &pLine, &lineLength))
+        {
+            break;
+        }
+
+        ULONG64 lineAddr;
+        if (!DecodeMemoryLine(pLine, lineLength, &lineAddr, &rowBytes))
+        {
+            return E_FAIL;
+        }
+
+        if (pRun == nullptr || lineAddr != pRun->EndAddress)
+        {
+            if (pRun != nullptr)
+            {
+                pRun->EndPos = rowPos;
+            }
+
+            pTask->Runs.push_back({ lineAddr, lineAddr, 0, {}, nullptr, S_OK });
+            pRun = &(pTask->Runs.back());
+        }
+
+        //
+        // Record this row for every page of the run which starts within it.
+        //
+        ULONG64 rowOffset = pRun->EndAddress - pRun->StartAddress;
+        ULONG64 rowEnd = rowOffset + rowBytes.size();
+        while (static_cast<ULONG64>(pRun->Checkpoints.size()) * LazyMemoryPageSize < rowEnd)
+        {
+            pRun->Checkpoints.push_back({ rowOffset, rowPos });
+        }
+
+        pRun->EndAddress += rowBytes.size();
+    }
+
+    if (pRun != nullptr)
+    {
+        pRun->EndPos = pos;
+    }
+
+    return hr;
+}
+
+HRESULT TextDumpParser::ParseMemoryTasks(_Inout_ std::vector<MemoryParseTask> &tasks)
+{
+    HRESULT hr = S_OK;
+
+    //
+    // Each worker pulls the next piece to decode until there are none left.  The calling thread is one of the
+    // workers, so a small file never creates any threads at all.
+    //
+    std::atomic<size_t> nextTask(0);
+    auto worker = [&]()
+    {
+        for(;;)
+        {
+            size_t taskIndex = nextTask++;
+            if (taskIndex >= tasks.size())
+            {
+                break;
+            }
+
+            MemoryParseTask *pTask = &(tasks[taskIndex]);
+            pTask->Result = ConvertException([&](){ return ParseMemoryRows(pTask); });
+        }
+    };
+
+    size_t threadCount = std::min<size_t>(tasks.size(), (std::max)(1u, std::thread::hardware_concurrency()));
+    std::vector<std::thread> threads;
+    try
+    {
+        threads.reserve(threadCount - 1);
+        for (size_t i = 1; i < threadCount; ++i)
+        {
+            threads.emplace_back(worker);
+        }
+    }
+    catch(...)
+    {
+        //
+        // If we cannot create (all) the threads, the ones we have (including this one) will do the work.
+        //
+    }
+
+    worker();
+
+    for (auto&& thread : threads)
+    {
+        thread.join();
+    }
+
+    //
+    // Gather in file order so that the result (and which run "wins" on overlap) does not depend on the
+    // order in which the pieces were parsed.  The pieces of a section are adjacent.  If any of them failed,
+    // every run of the section is marked with the failure.  The runs before the bad row still cover the
+    // section's memory so that reads there fail rather than find no memory (or memory from a later section).
+    //
+    size_t runCount = m_memoryRuns.size();
+    std::vector<HRESULT> sectionResults;
+    for (auto&& task : tasks)
+    {
+        if (sectionResults.size() <= task.Section)
+        {
+            sectionResults.resize(task.Section + 1, S_OK);
+        }
+        if (FAILED(task.Result) && SUCCEEDED(sectionResults[task.Section]))
+        {
+            sectionResults[task.Section] = task.Result;
+        }
+        runCount += task.Runs.size();
+    }
+
+    m_memoryRuns.reserve(runCount);
+    for (auto&& task : tasks)
+    {
+        HRESULT sectionResult = sectionResults[task.Section];
+        if (FAILED(sectionResult) && SUCCEEDED(hr))
+        {
+            hr = sectionResult;
+        }
+
+        for (auto&& run : task.Runs)
+        {
+            run.Result = sectionResult;
+
+            //
+            // If the previous piece of the same section ended in the middle of this run, join the two back together
+            // so that overlaps between runs resolve the same way regardless of where the section was split.
+            //
+            if (!m_memoryRuns.empty() &&
+                m_memoryRuns.back().BinaryData == nullptr &&
+                run.BinaryData == nullptr &&
+                m_memoryRuns.back().Result == run.Result &&
+                m_memoryRuns.back().EndPos == task.StartPos &&
+                m_memoryRuns.back().EndAddress == run.StartAddress &&
+                &run == &(task.Runs.front()))
+            {
+                MemoryRun &prevRun = m_memoryRuns.back();
+                ULONG64 prevLength = prevRun.EndAddress - prevRun.StartAddress;
+                for (auto&& checkpoint : run.Checkpoints)
+                {
+                    prevRun.Checkpoints.push_back({ checkpoint.RowOffset + prevLength, checkpoint.FilePos });
+                }
+                prevRun.EndAddress = run.EndAddress;
+                prevRun.EndPos = run.EndPos;
+                continue;
+            }
+
+            m_memoryRuns.push_back(std::move(run));
+        }
+    }
+
+    return hr;
+}
+
+HRESULT TextDumpParser::ParseBinaryMemorySection(_In_ wchar_t const *pc, _Inout_ std::vector<MemoryParseTask> *pTasks)
+{
+    HRESULT hr = S_OK;
+
+    // Example lines:
+    //
+    //     *** MEMORY BINARY 00000072`a5120000 10000 4a2f0
+    //     *** MEMORY BINARY 00007ff6`3c210000 2000 notepad_text.bin
+    //
+    // The first is 0x10000 bytes at file offset 0x4a2f0 of this file (typically after the "*** BINARY DATA"
+    // marker).  The second is 0x2000 bytes at the start of notepad_text.bin next to this file.
+    //
+    ULONG64 address;
+    ULONG64 length;
+
+    while (iswspace(*pc)) { ++pc; }
+    if (!ParseHex(pc, &address, &pc) || !iswspace(*pc))
+    {
+        return E_FAIL;
+    }
+
+    while (iswspace(*pc)) { ++pc; }
+    if (!ParseHex(pc, &length, &pc) || !iswspace(*pc) || length == 0 || address + length < address)
+    {
+        return E_FAIL;
+    }
+
+    while (iswspace(*pc)) { ++pc; }
+    std::wstring source = pc;
+    while (!source.empty() && iswspace(source.back()))
+    {
+        source.pop_back();
+    }
+
+    if (source.empty())
+    {
+        return E_FAIL;
+    }
+
+    unsigned char const *pData;
+    ULONG64 dataOffset;
+    wchar_t const *pn;
+    if (ParseHex(source.c_str(), &dataOffset, &pn) && *pn == L'\0')
+    {
+        if (dataOffset > m_mappingSize || length > m_mappingSize - dataOffset)
+        {
+            return E_FAIL;
+        }
+
+        pData = reinterpret_cast<unsigned char const *>(m_pFileMapping) + dataOffset;
+    }
+    else
+    {
+        ULONG64 fileSize;
+        IfFailedReturn(MapExternalMemoryFile(source, &pData, &fileSize));
+        if (length > fileSize)
+        {
+            return E_FAIL;
+        }
+    }
+
+    if (m_isUtf8)
+    {
+        //
+        // There are no rows to parse.  The section is queued (rather than added as a run right away) so that
+        // overlaps with the hex memory sections resolve in file order.
+        //
+        MemoryParseTask task = { m_pos, m_pos, (pTasks->empty() ? 0 : pTasks->back().Section + 1), S_OK, {} };
+        task.Runs.push_back({ address, address + length, 0, {}, pData, S_OK });
+        pTasks->push_back(std::move(task));
+    }
+    else
+    {
+        //
+        // The memory of UTF-16 files is all decoded at parse time.  Just copy the bytes in.  The region is added in
+        // file order along with the hex memory regions so that BuildMemoryRegionIndex resolves overlaps between them
+        // in file order.
+        //
+        if (length > static_cast<ULONG64>(SIZE_MAX))
+        {
+            return E_FAIL;
+        }
+
+        m_memoryRegions.push_back({ address, address + length, std::vector<unsigned char>(pData, pData + length) });
+    }
+
+    return hr;
+}
+
+HRESULT TextDumpParser::MapExternalMemoryFile(_In_ std::wstring const& fileName,
+                                              _Out_ unsigned char const **ppData,
+                                              _Out_ ULONG64 *pSize)
+{
+    HRESULT hr = S_OK;
+    *ppData = nullptr;
+    *pSize = 0;
+
+    for (auto&& externalFile : m_externalMemoryFiles)
+    {
+        if (_wcsicmp(externalFile.FileName.c_str(), fileName.c_str()) == 0)
+        {
+            *ppData = reinterpret_cast<unsigned char const *>(externalFile.View);
+            *pSize = externalFile.Size;
+            return S_OK;
+        }
+    }
+
+    //
+    // The file name is relative to the directory of the text file.
+    //
+    std::wstring path;
+    IfFailedReturn(GetSourceFilePath(&path));
+
+    size_t separator = path.find_last_of(L"\\/");
+    if (separator == std::wstring::npos)
+    {
+        return E_FAIL;
+    }
+
+    path.resize(separator + 1);
+    path += fileName;
+
+    //
+    // Make sure that adding the file cannot fail after its handles are open.
+    //
+    m_externalMemoryFiles.reserve(m_externalMemoryFiles.size() + 1);
+
+    ExternalMemoryFile externalFile = { fileName, INVALID_HANDLE_VALUE, nullptr, nullptr, 0 };
+    auto cleanup = [&]()
+    {
+        if (externalFile.View != nullptr)
+        {
+            UnmapViewOfFile(externalFile.View);
+        }
+        if (externalFile.Mapping != nullptr)
+        {
+            CloseHandle(externalFile.Mapping);
+        }
+        if (externalFile.File != INVALID_HANDLE_VALUE)
+        {
+            CloseHandle(externalFile.File);
+        }
+    };
+
+    externalFile.File = CreateFileW(path.c_str(),
+                                    GENERIC_READ,
+                                    FILE_SHARE_READ | FILE_SHARE_DELETE,
+                                    nullptr,
+                                    OPEN_EXISTING,
+                                    FILE_ATTRIBUTE_NORMAL,
+                                    nullptr);
+    if (externalFile.File == INVALID_HANDLE_VALUE)
+    {
+        return HRESULT_FROM_WIN32(GetLastError());
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(externalFile.File, &fileSize) || fileSize.QuadPart == 0 ||
+        static_cast<ULONG64>(fileSize.QuadPart) > static_cast<ULONG64>(SIZE_MAX))
+    {
+        cleanup();
+        return E_FAIL;
+    }
+
+    externalFile.Size = static_cast<ULONG64>(fileSize.QuadPart);
+    externalFile.Mapping = CreateFileMappingW(externalFile.File, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (externalFile.Mapping != nullptr)
+    {
+        externalFile.View = MapViewOfFile(externalFile.Mapping, FILE_MAP_READ, 0, 0, 0);
+    }
+
+    if (externalFile.View == nullptr)
+    {
+        hr = HRESULT_FROM_WIN32(GetLastError());
+        cleanup();
+        return hr;
+    }
+
+    *ppData = reinterpret_cast<unsigned char const *>(externalFile.View);
+    *pSize = externalFile.Size;
+    m_externalMemoryFiles.push_back(std::move(externalFile));
+    return hr;
+}
+
+void TextDumpParser::ReleaseExternalMemoryFiles()
+{
+    for (auto&& externalFile : m_externalMemoryFiles)
+    {
+        UnmapViewOfFile(externalFile.View);
+        CloseHandle(externalFile.Mapping);
+        CloseHandle(externalFile.File);
+    }
+
+    m_externalMemoryFiles.clear();
+}
+
+HRESULT TextDumpParser::GetSourceFilePath(_Out_ std::wstring *pPath)
+{
+    //
+    // The debugger only hands us the file as a source of bytes.  If those bytes are a mapped view of a file on
+    // disk, the memory manager can tell us which file.  That comes back as a device path (e.g.:
+    // \Device\HarddiskVolume3\dumps\foo.txt) which can be opened through the \\?\GLOBALROOT prefix.
+    //
+    wchar_t devicePath[MAX_PATH * 2];
+    DWORD length = GetMappedFileNameW(GetCurrentProcess(), m_pFileMapping, devicePath, ARRAYSIZE(devicePath));
+    if (length == 0 || length >= ARRAYSIZE(devicePath))
+    {
+        return E_FAIL;
+    }
+
+    std::wstring path = L"\\\\?\\GLOBALROOT";
+    path.append(devicePath, length);
+
+    *pPath = std::move(path);
+    return S_OK;
+}
+
+void TextDumpParser::BuildLazyMemoryIndex()
+{
+    std::vector<std::pair<ULONG64, ULONG64>> ranges;
+    ranges.reserve(m_memoryRuns.size());
+    for (auto&& run : m_memoryRuns)
+    {
+        ranges.push_back({ run.StartAddress, run.EndAddress });
+    }
+
+    m_memorySegments = ResolveMemoryOverlaps(ranges);
+
+    m_memoryRegions.clear();
+    for (auto&& segment : m_memorySegments)
+    {
+        if (!m_memoryRegions.empty() && m_memoryRegions.back().EndAddress == segment.StartAddress)
+        {
+            m_memoryRegions.back().EndAddress = segment.EndAddress;
+        }
+        else
+        {
+            m_memoryRegions.push_back({ segment.StartAddress, segment.EndAddress, {} });
+        }
+    }
+}
+
+HRESULT TextDumpParser::EnsureMemoryIndex()
+{
+    std::call_once(m_memoryIndexOnce, [&]()
+    {
+        if (m_pendingMemoryTasks.empty())
+        {
+            return;
+        }
+
+        //
+        // A section which fails to parse still has its runs gathered (see ParseMemoryTasks), so the index is
+        // built regardless.  Only something like running out of memory leaves the file without memory.
+        //
+        bool indexBuilt = false;
+        auto fn = [&]()
+        {
+            HRESULT hr = ParseMemoryTasks(m_pendingMemoryTasks);
+            BuildLazyMemoryIndex();
+            indexBuilt = true;
+            return hr;
+        };
+
+        m_memoryIndexResult = ConvertException(fn);
+        if (!indexBuilt)
+        {
+            m_memoryRuns.clear();
+            m_memorySegments.clear();
+            m_memoryRegions.clear();
+        }
+
+        std::vector<MemoryParseTask>().swap(m_pendingMemoryTasks);
+    });
+
+    return m_memoryIndexResult;
+}
+
+HRESULT TextDumpParser::DecodeRunBytes(_In_ MemoryRun const& run,
+                                       _In_ ULONG64 runOffset,
+                                       _Out_writes_(size) unsigned char *pBuffer,
+                                       _In_ size_t size) const
+{
+    //
+    // Start at the last checkpoint at or before the offset and decode forward.
+    //
+    auto it = std::upper_bound(run.Checkpoints.begin(), run.Checkpoints.end(), runOffset,
+                               [](ULONG64 offset, MemoryRowCheckpoint const& checkpoint) { return offset < checkpoint.RowOffset; });
+    if (it == run.Checkpoints.begin())
+    {
+        return E_FAIL;
+    }
+    --it;
+
+    size_t pos = it->FilePos;
+    ULONG64 rowOffset = it->RowOffset;
+
+    std::vector<unsigned char> rowBytes;
+    size_t bytesDecoded = 0;
+    while (bytesDecoded < size)
+    {
+        char const *pLine;
+        size_t lineLength;
+        ULONG64 lineAddr;
+        if (!ReadLineBytes(&pos, run.EndPos, &pLine, &lineLength) ||
+            !DecodeMemoryLine(pLine, lineLength, &lineAddr, &rowBytes))
+        {
+            return E_FAIL;
+        }
+
+        ULONG64 rowEnd = rowOffset + rowBytes.size();
+        ULONG64 copyOffset = runOffset + bytesDecoded;
+        if (rowEnd > copyOffset)
+        {
+            size_t copySize = static_cast<size_t>((std::min)(rowEnd - copyOffset, static_cast<ULONG64>(size - bytesDecoded)));
+            memcpy(pBuffer + bytesDecoded, &(rowBytes[static_cast<size_t>(copyOffset - rowOffset)]), copySize);
+            bytesDecoded += copySize;
+        }
+
+        rowOffset = rowEnd;
+    }
+
+    return S_OK;
+}
+
+HRESULT TextDumpParser::GetMemoryPage(_In_ size_t segmentIndex,
+                                      _In_ ULONG64 pageNumber,
+                                      _Out_ unsigned char const **ppData,
+                                      _Out_ size_t *pSize)
+{
+    HRESULT hr = S_OK;
+
+    auto key = std::make_pair(segmentIndex, pageNumber);
+    auto itIndex = m_pageCacheIndex.find(key);
+    if (itIndex != m_pageCacheIndex.end())
+    {
+        m_pageCache.splice(m_pageCache.begin(), m_pageCache, itIndex->second);
+        *ppData = m_pageCache.front().Data.data();
+        *pSize = m_pageCache.front().Data.size();
+        return S_OK;
+    }
+
+    MemorySegment const& segment = m_memorySegments[segmentIndex];
+    MemoryRun const& run = m_memoryRuns[segment.RunIndex];
+
+    ULONG64 segmentOffset = pageNumber * LazyMemoryPageSize;
+    size_t pageSize = static_cast<size_t>((std::min)(static_cast<ULONG64>(LazyMemoryPageSize),
+                                                     segment.EndAddress - segment.StartAddress - segmentOffset));
+
+    std::vector<unsigned char> data(pageSize);
+    IfFailedReturn(DecodeRunBytes(run, segment.StartAddress - run.StartAddress + segmentOffset, data.data(), pageSize));
+
+    //
+    // Evict the least recently used pages to stay within the size of the cache.
+    //
+    while (!m_pageCache.empty() && m_pageCacheSize + pageSize > LazyMemoryCacheSize)
+    {
+        CachedMemoryPage const& lruPage = m_pageCache.back();
+        m_pageCacheSize -= lruPage.Data.size();
+        m_pageCacheIndex.erase(std::make_pair(lruPage.SegmentIndex, lruPage.PageNumber));
+        m_pageCache.pop_back();
+    }
+
+    m_pageCache.push_front({ segmentIndex, pageNumber, std::move(data) });
+    m_pageCacheIndex[key] = m_pageCache.begin();
+    m_pageCacheSize += pageSize;
+
+    *ppData = m_pageCache.front().Data.data();
+    *pSize = pageSize;
+    return hr;
+}
+
+HRESULT TextDumpParser::ReadMemory(_In_ MemoryRegion const *pRegion,
+                                   _In_ ULONG64 address,
+                                   _Out_writes_(size) unsigned char *pBuffer,
+                                   _In_ size_t size)
+{
+    if (m_memorySource == MemorySource::Decoded)
+    {
+        memcpy(pBuffer, &(pRegion->Data[static_cast<size_t>(address - pRegion->StartAddress)]), size);
+        return S_OK;
+    }
+    else if (m_memorySource == MemorySource::Sidecar)
+    {
+        ULONG64 dataOffset = m_sidecarRegionOffsets[pRegion - m_memoryRegions.data()] + (address - pRegion->StartAddress);
+        memcpy(pBuffer, m_pSidecarMemory + dataOffset, size);
+        return S_OK;
+    }
+
+    auto fn = [&]()
+    {
+        HRESULT hr = S_OK;
+
+        ULONG64 curAddress = address;
+        unsigned char *pCurBuffer = pBuffer;
+        size_t remaining = size;
+        while (remaining > 0)
+        {
+            //
+            // A region is made of adjacent segments.  Find the one containing the address.
+            //
+            auto it = std::upper_bound(m_memorySegments.begin(), m_memorySegments.end(), curAddress,
+                                       [](ULONG64 addr, MemorySegment const& segment) { return addr < segment.StartAddress; });
+            if (it == m_memorySegments.begin() || curAddress >= std::prev(it)->EndAddress)
+            {
+                return E_FAIL;
+            }
+            --it;
+
+            size_t copySize;
+            MemoryRun const& run = m_memoryRuns[it->RunIndex];
+            if (FAILED(run.Result))
+            {
+                return run.Result;
+            }
+            else if (run.BinaryData != nullptr)
+            {
+                //
+                // Binary memory sections are read straight out of the file mapping.  There is nothing to decode
+                // and nothing to cache.
+                //
+                copySize = static_cast<size_t>((std::min)(static_cast<ULONG64>(remaining), it->EndAddress - curAddress));
+                memcpy(pCurBuffer, run.BinaryData + (curAddress - run.StartAddress), copySize);
+            }
+            else
+            {
+                ULONG64 segmentOffset = curAddress - it->StartAddress;
+                size_t pageOffset = static_cast<size_t>(segmentOffset % LazyMemoryPageSize);
+
+                std::lock_guard<std::mutex> lock(m_pageCacheLock);
+
+                unsigned char const *pPage;
+                size_t pageSize;
+                IfFailedReturn(GetMemoryPage(it - m_memorySegments.begin(), segmentOffset / LazyMemoryPageSize, &pPage, &pageSize));
+
+                copySize = (std::min)(remaining, pageSize - pageOffset);
+                memcpy(pCurBuffer, pPage + pageOffset, copySize);
+            }
+
+            remaining -= copySize;
+            pCurBuffer += copySize;
+            curAddress += copySize;
+        }
+
+        return hr;
+    };
+    return ConvertException(fn);
+}
+
+HRESULT TextDumpParser::Parse()
+{
+    auto fn = [&]()
+    {
+        HRESULT hr = S_OK;
+
+        //
+        // If there is a valid sidecar cache for this file, there is nothing to parse.
+        //
+        std::wstring sidecarPath;
+        ULONG64 lastWriteTime = 0;
+        ULONG64 sourceHash = 0;
+        bool useSidecar = IsSidecarCacheEnabled() &&
+                          SUCCEEDED(GetSourceFileInformation(&sidecarPath, &lastWriteTime, &sourceHash));
+        if (useSidecar)
+        {
+            sidecarPath += L".tdcache";
+            if (SUCCEEDED(LoadSidecar(sidecarPath, lastWriteTime, sourceHash)))
+            {
+                BuildModuleIndex();
+                return hr;
+            }
+        }
+
+        //
+        // Memory sections in UTF-8 files are only located on this pass.  Their rows are parsed in parallel
+        // the first time that memory is asked for (see EnsureMemoryIndex).
+        //
+        std::vector<MemoryParseTask> memoryTasks;
+
+        std::wstring line;
+        while(ReadLine(&line))
+        {
+            wchar_t const *pc = line.c_str();
+            if (*pc == L'#' || IsEmptyLine(line))
+            {
+                continue;
+            }
+
+            if (wcscmp(pc, L"*** MEMORY") == 0)
+            {
+                if (m_isUtf8)
+                {
+                    IfFailedReturn(QueueMemorySection(&memoryTasks));
+                }
+                else
+                {
+                    IfFailedReturn(ParseMemoryRegions());
+                }
+            }
+            else if (wcsncmp(pc, L"*** MEMORY BINARY", 17) == 0 && iswspace(pc[17]))
+            {
+                IfFailedReturn(ParseBinaryMemorySection(pc + 17, &memoryTasks));
+            }
+            else if (wcscmp(pc, L"*** BINARY DATA") == 0)
+            {
+                //
+                // Everything after this marker is the raw bytes of binary memory sections.  There is no more
+                // text to parse.
+                //
+                break;
+            }
+            else if (wcscmp(pc, L"*** STACK") == 0)
+            {
+                IfFailedReturn(ParseStackFrames());
+            }
+            else if (wcscmp(pc, L"*** MODULEINFO") == 0)
+            {
+                IfFailedReturn(ParseModuleInformation());
+            }
+            else if (wcscmp(pc, L"*** REGISTERS") == 0)
+            {
+                IfFailedReturn(ParseRegisters());
+            }
+        }
+
+        if (!memoryTasks.empty())
+        {
+            m_pendingMemoryTasks = std::move(memoryTasks);
+            m_memorySource = MemorySource::OnDemand;
+        }
+        else
+        {
+            BuildMemoryRegionIndex();
+        }
+
+        BuildModuleIndex();
+
+        //
+        // Failing to write the sidecar cache is not fatal.  The next open will simply parse again.  The sidecar
+        // is only validated against the text file.  If memory comes from other files, it could silently go stale
+        // so there is no sidecar at all.
+        //
+        if (useSidecar && m_externalMemoryFiles.empty())
+        {
+            (void)WriteSidecar(sidecarPath, lastWriteTime, sourceHash);
+        }
+
         return hr;
     };
     return ConvertException(fn);
@@ -37,6 +37,12 @@ struct MemoryRegion
 {
     ULONG64 StartAddress;
     ULONG64 EndAddress;
+
+    //
+    // The bytes of the region.  This is only filled in when the bytes are decoded at parse time (UTF-16 files).
+    // Otherwise, the bytes are decoded on demand or read directly from a binary memory section.  Use
+    // TextDumpParser::ReadMemory to get at them.
+    //
     std::vector<unsigned char> Data;
 };
 
@@ -69,6 +75,13 @@ public:
     // Construct a new parser on a given file.
     //
     TextDumpParser(ISvcDebugSourceFile *pFile) :
+        m_memorySource(MemorySource::Decoded),
+        m_memoryIndexResult(S_OK),
+        m_pageCacheSize(0),
+        m_hSidecarFile(INVALID_HANDLE_VALUE),
+        m_hSidecarMapping(nullptr),
+        m_pSidecarView(nullptr),
+        m_pSidecarMemory(nullptr),
         m_spFile(pFile),
         m_pFileMapping(nullptr),
         m_mappingSize(0),
@@ -76,6 +89,12 @@ public:
     {
     }
 
+    // ~TextDumpParser():
+    //
+    // Releases any sidecar cache file or external binary memory files which memory is being read from.
+    //
+    ~TextDumpParser();
+
     // Initialize():
     //
     // Initializes the parser and performs a basic format check.  If this fails, the file is not
@@ -85,7 +104,9 @@ public:
 
     // Parse():
     //
-    // Parses the file and gathers all the information from each section of the text file.
+    // Parses the file and gathers all the information from each section of the text file.  If sidecar caching
+    // is enabled (see IsSidecarCacheEnabled), the result is taken from a valid sidecar cache file next to the
+    // text file instead, or a sidecar cache file is written after parsing.
     //
     HRESULT Parse();
 
@@ -93,22 +114,74 @@ public:
     //
     // Returns whether certain sections or section data exists in our "text dump"
     //
+    // HasMemoryRegions does not need the memory index.  It is true for a UTF-8 file with memory sections even before
+    // their rows are parsed (see EnsureMemoryIndex).
+    //
     bool HasStackFrames() const { return m_stackFrames.size() > 0; }
-    bool HasMemoryRegions() const { return m_memoryRegions.size() > 0; }
+    bool HasMemoryRegions() const { return m_memorySource == MemorySource::OnDemand || m_memoryRegions.size() > 0; }
     bool HasModuleInformations() const { return m_moduleInfos.size() > 0; }
     bool HasRegisters() const { return m_registerValues.size() > 0; }
 
     // Get*():
     //
-    // Gets our view of certain section data from our "text dump"
+    // Gets our view of certain section data from our "text dump".  GetMemoryRegions builds the memory index on
+    // first use.
     //
     std::vector<StackFrame> const &GetStackFrames() const { return m_stackFrames; }
-    std::vector<MemoryRegion> const &GetMemoryRegions() const { return m_memoryRegions; }
+    std::vector<MemoryRegion> const &GetMemoryRegions() { EnsureMemoryIndex(); return m_memoryRegions; }
     std::vector<ModuleInformation> const &GetModuleInformations() const { return m_moduleInfos; }
     std::vector<RegisterValue> const &GetRegisters() const { return m_registerValues; }
 
+    // FindMemoryRegion():
+    //
+    // Finds the memory region containing the given address in O(log n).  If no region contains the address,
+    // nullptr is returned and the next higher region (if any) is returned in *ppNextRegion.  The memory index is
+    // built on first use.
+    //
+    MemoryRegion const *FindMemoryRegion(_In_ ULONG64 address, _Out_opt_ MemoryRegion const **ppNextRegion = nullptr);
+
+    // ReadMemory():
+    //
+    // Reads bytes from a memory region returned by FindMemoryRegion.  The entire range [address, address + size)
+    // must be within the region.  For UTF-8 files, the bytes are decoded from the file on first touch in pages
+    // which are held in a size bounded LRU cache.
+    //
+    HRESULT ReadMemory(_In_ MemoryRegion const *pRegion,
+                       _In_ ULONG64 address,
+                       _Out_writes_(size) unsigned char *pBuffer,
+                       _In_ size_t size);
+
+    // FindModuleAtAddress():
+    //
+    // Finds the module whose address range contains the given address in O(log n).  On success, the index
+    // of the module within GetModuleInformations() is returned in *pModuleIndex.
+    //
+    bool FindModuleAtAddress(_In_ ULONG64 address, _Out_ size_t *pModuleIndex) const;
+
+    // FindModuleByBaseAddress():
+    //
+    // Finds the module which starts at the given base address in O(log n).  On success, the index of the
+    // module within GetModuleInformations() is returned in *pModuleIndex.
+    //
+    bool FindModuleByBaseAddress(_In_ ULONG64 baseAddress, _Out_ size_t *pModuleIndex) const;
+
 private:
 
+    // BuildMemoryRegionIndex():
+    //
+    // Replaces the memory regions (in file order) with sorted, disjoint regions in which adjacent regions are
+    // merged so that lookups can be done with a binary search.  Where regions overlap, the first one in the
+    // file "wins."
+    //
+    void BuildMemoryRegionIndex();
+
+    // BuildModuleIndex():
+    //
+    // Builds an index of the modules sorted by start address.  The module information itself stays in
+    // file order (which is the order the debugger enumerates the modules in).
+    //
+    void BuildModuleIndex();
+
     // ReadLine():
     //
     // Reads the next line from the text file and converts (if needed) to a standard Windows
@@ -116,11 +189,28 @@ private:
     //
     bool ReadLine(_Out_ std::wstring *pLine);
 
+    // ReadLineBytes():
+    //
+    // Reads the next line from a UTF-8 text file without any conversion.  The returned line points directly
+    // into the file mapping, is not null terminated, and does not include the line terminator.
+    //
+    bool ReadLineBytes(_Out_ char const **ppLine, _Out_ size_t *pLength)
+    {
+        return ReadLineBytes(&m_pos, m_mappingSize, ppLine, pLength);
+    }
+
+    // ReadLineBytes():
+    //
+    // As above, reading from an explicit position (which is advanced past the line) and stopping at endPos.
+    //
+    bool ReadLineBytes(_Inout_ size_t *pPos, _In_ size_t endPos, _Out_ char const **ppLine, _Out_ size_t *pLength) const;
+
     // IsEmptyLine():
     //
     // Checks whether the given string is an emtpy line (either "" or all whitespace of some form or another)
     //
     bool IsEmptyLine(_In_ std::wstring const& str);
+    bool IsEmptyLine(_In_reads_(length) char const *pLine, _In_ size_t length);
 
     // ParseHex():
     //
@@ -130,6 +220,29 @@ private:
     //
     bool ParseHex(_In_ wchar_t const *ps, _Out_ ULONG64 *pValue, _Out_ wchar_t const **ppc);
 
+    // ParseHex():
+    //
+    // As above, for a UTF-8 line which is not null terminated.  The value ends at pe at the latest.
+    //
+    bool ParseHex(_In_ char const *ps, _In_ char const *pe, _Out_ ULONG64 *pValue, _Out_ char const **ppc) const;
+
+    // DecodeMemoryRow():
+    //
+    // Decodes a full row of 16 bytes as printed by the 'db' command ("xx xx xx xx xx xx xx xx-xx xx ... xx")
+    // from a UTF-8 line into pBytes.  If the text at pc is not a full row in exactly this layout, false
+    // is returned and the caller must fall back to parsing the row byte by byte.
+    //
+    static bool DecodeMemoryRow(_In_ char const *pc, _In_ char const *pe, _Out_writes_(16) unsigned char *pBytes);
+
+    // DecodeMemoryLine():
+    //
+    // Decodes a line of a memory section in a UTF-8 file: the address of the line and all of its bytes.
+    //
+    bool DecodeMemoryLine(_In_reads_(length) char const *pLine,
+                          _In_ size_t length,
+                          _Out_ ULONG64 *pAddress,
+                          _Inout_ std::vector<unsigned char> *pBytes) const;
+
     // ParseStackFrames():
     //
     // Parses the stack frames section
@@ -142,10 +255,215 @@ private:
     //
     HRESULT ParseMemoryRegions();
 
+    // MemoryRowCheckpoint:
+    //
+    // The location of a row of a memory run.  A run has checkpoints (sorted by offset) no more than a page apart.
+    //
+    struct MemoryRowCheckpoint
+    {
+        ULONG64 RowOffset;
+        size_t FilePos;
+    };
+
+    // MemoryRun:
+    //
+    // A sequence of contiguous memory rows in a UTF-8 file.  Only where the rows are is recorded (through
+    // the checkpoints).  The bytes are decoded on demand.
+    //
+    // A binary memory section is also a run.  It has no rows; BinaryData points at its raw bytes in the
+    // mapping of this file or of an external file.
+    //
+    // If any row of a memory section is not in our format, the runs of that section which were found keep their
+    // place in the address space but Result holds the failure and every read of them returns it.
+    //
+    struct MemoryRun
+    {
+        ULONG64 StartAddress;
+        ULONG64 EndAddress;
+        size_t EndPos;
+        std::vector<MemoryRowCheckpoint> Checkpoints;
+        unsigned char const *BinaryData;
+        HRESULT Result;
+    };
+
+    // MemorySegment:
+    //
+    // A piece of the address space which is backed by a single memory run.  Segments are sorted and disjoint.
+    //
+    struct MemorySegment
+    {
+        ULONG64 StartAddress;
+        ULONG64 EndAddress;
+        size_t RunIndex;
+    };
+
+    // ResolveMemoryOverlaps():
+    //
+    // Given the address ranges of memory regions (or runs) in file order, returns the sorted, disjoint segments
+    // of the address space which each one provides.  Ranges are applied in file order and a later range only
+    // fills the gaps which are left by earlier ones, so the first one in the file "wins" wherever they overlap
+    // regardless of where each one starts.  The RunIndex of each segment is the index of its range.
+    //
+    static std::vector<MemorySegment> ResolveMemoryOverlaps(_In_ std::vector<std::pair<ULONG64, ULONG64>> const& ranges);
+
+    // CachedMemoryPage:
+    //
+    // A decoded page of a memory segment.
+    //
+    struct CachedMemoryPage
+    {
+        size_t SegmentIndex;
+        ULONG64 PageNumber;
+        std::vector<unsigned char> Data;
+    };
+
+    // MemoryParseTask:
+    //
+    // A row aligned piece of a memory section in a UTF-8 file and the memory runs found in it.  A binary memory
+    // section is an empty piece with its run already filled in.  Section is the index of the memory section (in
+    // file order) which the piece belongs to.
+    //
+    struct MemoryParseTask
+    {
+        size_t StartPos;
+        size_t EndPos;
+        size_t Section;
+        HRESULT Result;
+        std::vector<MemoryRun> Runs;
+    };
+
+    // QueueMemorySection():
+    //
+    // Quickly finds the end of the memory section at the current position of a UTF-8 file and splits the
+    // section into row aligned pieces which can be decoded independently.  The current position is left after
+    // the end of the section.
+    //
+    HRESULT QueueMemorySection(_Inout_ std::vector<MemoryParseTask> *pTasks);
+
+    // ParseMemoryRows():
+    //
+    // Validates the memory rows of a piece of a memory section directly over the bytes of the UTF-8 file
+    // mapping and records where the rows of each memory run are.  Nothing is kept of the decoded bytes.
+    // This does not touch any parser state and may be called concurrently for different pieces.
+    //
+    HRESULT ParseMemoryRows(_Inout_ MemoryParseTask *pTask) const;
+
+    // ParseMemoryTasks():
+    //
+    // Parses all of the queued memory section pieces on a set of worker threads and gathers the
+    // resulting memory runs (in file order).  A section with a row which is not in our format does not
+    // stop the others from being gathered.  Its runs are marked as failed and the first failure is returned.
+    //
+    HRESULT ParseMemoryTasks(_Inout_ std::vector<MemoryParseTask> &tasks);
+
+    // ParseBinaryMemorySection():
+    //
+    // Parses the header of a binary memory section ("*** MEMORY BINARY <address> <length> <file offset|file name>")
+    // given the text after "*** MEMORY BINARY".  The raw bytes are either in this file at the given offset or at
+    // the start of the named file (relative to the directory of this file).  For UTF-8 files, the section is
+    // queued in file order along with the hex memory sections.
+    //
+    HRESULT ParseBinaryMemorySection(_In_ wchar_t const *pc, _Inout_ std::vector<MemoryParseTask> *pTasks);
+
+    // MapExternalMemoryFile():
+    //
+    // Maps (read only) a file which holds the raw bytes of a binary memory section.  Files are only mapped once
+    // and stay mapped for the lifetime of the parser.
+    //
+    HRESULT MapExternalMemoryFile(_In_ std::wstring const& fileName,
+                                  _Out_ unsigned char const **ppData,
+                                  _Out_ ULONG64 *pSize);
+
+    // ReleaseExternalMemoryFiles():
+    //
+    // Unmaps and closes all external binary memory files.
+    //
+    void ReleaseExternalMemoryFiles();
+
+    // GetSourceFilePath():
+    //
+    // Gets the path of the text file on disk (if the file is a mapped view of a file on disk).
+    //
+    HRESULT GetSourceFilePath(_Out_ std::wstring *pPath);
+
+    // BuildLazyMemoryIndex():
+    //
+    // Builds the sorted, disjoint memory segments and the (coalesced) memory regions from the memory runs.  Overlaps
+    // are resolved in file order by ResolveMemoryOverlaps, the same as for BuildMemoryRegionIndex.
+    //
+    void BuildLazyMemoryIndex();
+
+    // EnsureMemoryIndex():
+    //
+    // Parse only locates the memory sections of a UTF-8 file.  The first call to this parses their rows (in
+    // parallel) and builds the memory index.  Later calls return the result of the first.  If the rows of a
+    // section are not in our format, the failure is returned but the index is still built: the other sections
+    // read normally and reads within that section return the failure.  This is safe to call concurrently.
+    //
+    HRESULT EnsureMemoryIndex();
+
+    // DecodeRunBytes():
+    //
+    // Decodes size bytes at the given offset within a memory run from the file.
+    //
+    HRESULT DecodeRunBytes(_In_ MemoryRun const& run,
+                           _In_ ULONG64 runOffset,
+                           _Out_writes_(size) unsigned char *pBuffer,
+                           _In_ size_t size) const;
+
+    // GetMemoryPage():
+    //
+    // Gets a page of a memory segment from the page cache, decoding it if necessary.  The page cache lock must
+    // be held and the returned data is only valid while it is held.
+    //
+    HRESULT GetMemoryPage(_In_ size_t segmentIndex,
+                          _In_ ULONG64 pageNumber,
+                          _Out_ unsigned char const **ppData,
+                          _Out_ size_t *pSize);
+
+    //*************************************************
+    // Sidecar Cache (SidecarCache.cpp):
+    //
+
+    // IsSidecarCacheEnabled():
+    //
+    // Returns whether sidecar cache files should be used.  This is opted into by setting the TEXTDUMP_SIDECAR_CACHE
+    // environment variable to 1.
+    //
+    static bool IsSidecarCacheEnabled();
+
+    // GetSourceFileInformation():
+    //
+    // Gets the path, size, last write time, and content hash of the text file which is used to name and
+    // validate its sidecar cache file.
+    //
+    HRESULT GetSourceFileInformation(_Out_ std::wstring *pPath, _Out_ ULONG64 *pLastWriteTime, _Out_ ULONG64 *pHash);
+
+    // LoadSidecar():
+    //
+    // Maps and validates the sidecar cache file for the text file and, if valid, fills in all of the parsed
+    // information from it.  Memory reads are served straight from the mapped sidecar.  Any failure means the text
+    // file must be parsed.
+    //
+    HRESULT LoadSidecar(_In_ std::wstring const& sidecarPath, _In_ ULONG64 lastWriteTime, _In_ ULONG64 hash);
+    HRESULT LoadSidecarInternal(_In_ std::wstring const& sidecarPath, _In_ ULONG64 lastWriteTime, _In_ ULONG64 hash);
+    HRESULT LoadSidecarTables(_In_ ULONG64 lastWriteTime, _In_ ULONG64 hash);
+
+    // ReleaseSidecar():
+    //
+    // Unmaps and closes any sidecar cache file.
+    //
+    void ReleaseSidecar();
+
+    // WriteSidecar():
+    //
+    // Writes the sidecar cache file for the text file from the parsed information.
+    //
+    HRESULT WriteSidecar(_In_ std::wstring const& sidecarPath, _In_ ULONG64 lastWriteTime, _In_ ULONG64 hash);
+
     // ParseModuleInformation():
     //
     // Parses the module information.
-    //
     HRESULT ParseModuleInformation();
 
     // ParseRegisters():
@@ -157,8 +475,70 @@ private:
     std::vector<StackFrame> m_stackFrames;
     std::vector<MemoryRegion> m_memoryRegions;
     std::vector<ModuleInformation> m_moduleInfos;
+    std::vector<size_t> m_moduleIndex;
     std::vector<RegisterValue> m_registerValues;
 
+    //
+    // Where the bytes of the memory regions come from:
+    //
+    //     Decoded:  decoded at parse time into the regions themselves (UTF-16 files)
+    //     OnDemand: decoded from the text file on first touch into the page cache (UTF-8 files)
+    //     Sidecar:  read directly from a mapped sidecar cache file
+    //
+    enum class MemorySource
+    {
+        Decoded,
+        OnDemand,
+        Sidecar
+    };
+
+    MemorySource m_memorySource;
+
+    //*************************************************
+    // On Demand Memory (UTF-8 files):
+    //
+
+    std::vector<MemoryParseTask> m_pendingMemoryTasks;
+    std::once_flag m_memoryIndexOnce;
+    HRESULT m_memoryIndexResult;
+
+    std::vector<MemoryRun> m_memoryRuns;
+    std::vector<MemorySegment> m_memorySegments;
+
+    std::mutex m_pageCacheLock;
+    std::list<CachedMemoryPage> m_pageCache;        // Most recently used first
+    std::map<std::pair<size_t, ULONG64>, std::list<CachedMemoryPage>::iterator> m_pageCacheIndex;
+    size_t m_pageCacheSize;
+
+    //*************************************************
+    // Sidecar Memory:
+    //
+
+    HANDLE m_hSidecarFile;
+    HANDLE m_hSidecarMapping;
+    void const *m_pSidecarView;
+    unsigned char const *m_pSidecarMemory;
+    std::vector<ULONG64> m_sidecarRegionOffsets;
+
+    //*************************************************
+    // External Binary Memory Files:
+    //
+
+    // ExternalMemoryFile:
+    //
+    // A file holding the raw bytes of one or more binary memory sections.
+    //
+    struct ExternalMemoryFile
+    {
+        std::wstring FileName;
+        HANDLE File;
+        HANDLE Mapping;
+        void const *View;
+        ULONG64 Size;
+    };
+
+    std::vector<ExternalMemoryFile> m_externalMemoryFiles;
+
     Microsoft::WRL::ComPtr<ISvcDebugSourceFile> m_spFile;
 
     //*************************************************
@@ -64,11 +64,13 @@ HRESULT VirtualMemoryService::ReadMemory(_In_ ISvcAddressContext * /*pAddressCon
             break;
         }
 
-        ULONG64 chunkOffset = curOffset - pCurRegion->StartAddress;
-        ULONG64 chunkRemaining = pCurRegion->EndAddress - chunkOffset;
+        ULONG64 chunkRemaining = pCurRegion->EndAddress - curOffset;
         ULONG64 chunkToRead = (chunkRemaining > remaining) ? remaining : chunkRemaining;
 
-        memcpy(pCurBuffer, &(pCurRegion->Data[static_cast<size_t>(chunkOffset)]), static_cast<size_t>(chunkToRead));
+        if (FAILED(m_spParsedFile->ReadMemory(pCurRegion, curOffset, pCurBuffer, static_cast<size_t>(chunkToRead))))
+        {
+            break;
+        }
 
         remaining -= chunkToRead;
         bytesRead += chunkToRead;
@@ -106,32 +108,18 @@ HRESULT VirtualMemoryService::FindMemoryRegion(_In_opt_ ISvcAddressContext * /*p
     ComPtr<VirtualMemoryRegion> spRegion;
     MemoryRegion const* pNextHigherOffsetRegion = nullptr;
 
-    auto&& memoryRegions = m_spParsedFile->GetMemoryRegions();
-
-    for (auto&& region : memoryRegions)
+    MemoryRegion const* pRegion = m_spParsedFile->FindMemoryRegion(offset, &pNextHigherOffsetRegion);
+    if (pRegion != nullptr)
     {
-        if (offset >= region.StartAddress && offset < region.EndAddress)
-        {
-            IfFailedReturn(MakeAndInitialize<VirtualMemoryRegion>(&spRegion, 
-                                                                  region.StartAddress,
-                                                                  region.EndAddress - region.StartAddress));
+        IfFailedReturn(MakeAndInitialize<VirtualMemoryRegion>(&spRegion, 
+                                                              pRegion->StartAddress,
+                                                              pRegion->EndAddress - pRegion->StartAddress));
 
-            //
-            // S_OK: It is within the described region.
-            //
-            *ppRegion = spRegion.Detach();
-            return S_OK;
-        }
-        else if (region.StartAddress > offset)
-        {
-            //
-            // It's a higher memory region.  Is it the closest one we have yet found...?
-            //
-            if (pNextHigherOffsetRegion == nullptr || region.StartAddress < pNextHigherOffsetRegion->StartAddress)
-            {
-                pNextHigherOffsetRegion = &region;
-            }
-        }
+        //
+        // S_OK: It is within the described region.
+        //
+        *ppRegion = spRegion.Detach();
+        return S_OK;
     }
 
     //
@@ -243,15 +231,7 @@ HRESULT VirtualMemoryService::NotifyEvent(_In_ IDebugServiceManager *pServiceMan
 
 MemoryRegion const* VirtualMemoryService::FindTextDumpMemoryRegion(_In_ ULONG64 address)
 {
-    for (auto&& region : m_spParsedFile->GetMemoryRegions())
-    {
-        if (address >= region.StartAddress && address < region.EndAddress)
-        {
-            return &region;
-        }
-    }
-
-    return nullptr;
+    return m_spParsedFile->FindMemoryRegion(address);
 }
 
 } // TextDump
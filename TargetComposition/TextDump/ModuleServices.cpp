@@ -64,72 +64,77 @@ HRESULT ModuleEnumerator::GetNext(_COM_Outptr_ ISvcModule **ppTargetModule)
         return E_BOUNDS;
     }
 
-    ModuleInformation const* pModuleInfo = &(moduleInfos[m_pos]);
+    ComPtr<Module> spModule = m_spModuleService->GetModule(m_pos);
     ++m_pos;
 
-    ComPtr<Module> spModule;
-    IfFailedReturn(MakeAndInitialize<Module>(&spModule, m_spModuleService.Get(), m_spParsedFile, pModuleInfo));
-
     *ppTargetModule = spModule.Detach();
     return hr;
 }
 
+HRESULT ModuleEnumerationService::RuntimeClassInitialize(_In_ std::shared_ptr<TextDumpParser> const& parsedFile)
+{
+    HRESULT hr = S_OK;
+
+    m_pServiceManager = nullptr;
+    m_spParsedFile = parsedFile;
+    m_firstEnumerationComplete = false;
+
+    auto&& moduleInfos = m_spParsedFile->GetModuleInformations();
+    m_modules.reserve(moduleInfos.size());
+    for (auto&& moduleInfo : moduleInfos)
+    {
+        ComPtr<Module> spModule;
+        IfFailedReturn(MakeAndInitialize<Module>(&spModule, this, m_spParsedFile, &moduleInfo));
+        m_modules.push_back(std::move(spModule));
+    }
+
+    return hr;
+}
+
 HRESULT ModuleEnumerationService::FindModule(_In_opt_ ISvcProcess * /*pProcess*/,
                                              _In_ ULONG64 moduleKey,
                                              _COM_Outptr_ ISvcModule **ppTargetModule)
 {
-    HRESULT hr = S_OK;
     *ppTargetModule = nullptr;
 
-    ComPtr<Module> spModule;
-
     //
     // Note that because we represent only a single process in our "text dump" format, we do not need
     // to go look at what process the debugger is asking about.  If this were a kernel target, pProcess would
     // be nullptr to indicate the set of modules loaded in the kernel (or in the "shared address mapping")
     //
 
-    auto&& moduleInfos = m_spParsedFile->GetModuleInformations();
-    for (auto&& moduleInfo : moduleInfos)
+    size_t moduleIndex;
+    if (!m_spParsedFile->FindModuleByBaseAddress(moduleKey, &moduleIndex))
     {
-        if (moduleInfo.StartAddress == moduleKey)
-        {
-            IfFailedReturn(MakeAndInitialize<Module>(&spModule, this, m_spParsedFile, &moduleInfo));
-            *ppTargetModule = spModule.Detach();
-            return S_OK;
-        }
+        return E_BOUNDS;
     }
 
-    return E_BOUNDS;
+    ComPtr<Module> spModule = GetModule(moduleIndex);
+    *ppTargetModule = spModule.Detach();
+    return S_OK;
 }
 
 HRESULT ModuleEnumerationService::FindModuleAtAddress(_In_opt_ ISvcProcess * /*pProcess*/,
                                                       _In_ ULONG64 moduleAddress,
                                                       _COM_Outptr_ ISvcModule **ppTargetModule)
 {
-    HRESULT hr = S_OK;
     *ppTargetModule = nullptr;
 
-    ComPtr<Module> spModule;
-
     //
     // Note that because we represent only a single process in our "text dump" format, we do not need
     // to go look at what process the debugger is asking about.  If this were a kernel target, pProcess would
     // be nullptr to indicate the set of modules loaded in the kernel (or in the "shared address mapping")
     //
 
-    auto&& moduleInfos = m_spParsedFile->GetModuleInformations();
-    for (auto&& moduleInfo : moduleInfos)
+    size_t moduleIndex;
+    if (!m_spParsedFile->FindModuleAtAddress(moduleAddress, &moduleIndex))
     {
-        if (moduleAddress >= moduleInfo.StartAddress && moduleAddress < moduleInfo.EndAddress)
-        {
-            IfFailedReturn(MakeAndInitialize<Module>(&spModule, this, m_spParsedFile, &moduleInfo));
-            *ppTargetModule = spModule.Detach();
-            return S_OK;
-        }
+        return E_BOUNDS;
     }
 
-    return E_BOUNDS;
+    ComPtr<Module> spModule = GetModule(moduleIndex);
+    *ppTargetModule = spModule.Detach();
+    return S_OK;
 }
 
 HRESULT ModuleEnumerationService::EnumerateModules(_In_opt_ ISvcProcess * /*pProcess*/,
@@ -190,25 +195,24 @@ HRESULT ModuleIndexService::GetModuleIndexKey(_In_ ISvcModule *pModule,
     ULONG64 baseAddress;
     IfFailedReturn(pModule->GetBaseAddress(&baseAddress));
 
-    auto&& moduleInfos = m_spParsedFile->GetModuleInformations();
-    for(auto&& moduleInfo : moduleInfos)
+    size_t moduleInfoIndex;
+    if (!m_spParsedFile->FindModuleByBaseAddress(baseAddress, &moduleInfoIndex))
     {
-        if (moduleInfo.StartAddress == baseAddress)
-        {
-            //
-            // The symbol server key for a PE is <time date stamp> padded (zero prefix) to 8 bytes
-            // follwed by the <size of image> (from PE headers) not padded at all.
-            //
-            wchar_t buf[32];
-            swprintf_s(buf, ARRAYSIZE(buf), L"%08X%x", (ULONG)moduleInfo.TimeStamp, (ULONG)moduleInfo.ImageSize);
-
-            *pModuleIndex = SysAllocString(buf);
-            *pModuleIndexKind = DEBUG_MODULEINDEXKEY_TIMESTAMP_IMAGESIZE;
-            return (*pModuleIndex == nullptr ? E_OUTOFMEMORY : S_OK);
-        }
+        return E_FAIL;
     }
 
-    return E_FAIL;
+    ModuleInformation const& moduleInfo = m_spParsedFile->GetModuleInformations()[moduleInfoIndex];
+
+    //
+    // The symbol server key for a PE is <time date stamp> padded (zero prefix) to 8 bytes
+    // follwed by the <size of image> (from PE headers) not padded at all.
+    //
+    wchar_t buf[32];
+    swprintf_s(buf, ARRAYSIZE(buf), L"%08X%x", (ULONG)moduleInfo.TimeStamp, (ULONG)moduleInfo.ImageSize);
+
+    *pModuleIndex = SysAllocString(buf);
+    *pModuleIndexKind = DEBUG_MODULEINDEXKEY_TIMESTAMP_IMAGESIZE;
+    return (*pModuleIndex == nullptr ? E_OUTOFMEMORY : S_OK);
 }
 
 } // TextDump
@@ -125,7 +125,7 @@ public:
                                    _In_ std::shared_ptr<TextDumpParser> &parsedFile,
                                    _In_ ModuleInformation const *pModuleInfo)
     {
-        m_spModuleService = pModuleService;
+        m_pModuleService = pModuleService;
         m_spParsedFile = parsedFile;
         m_pModuleInfo = pModuleInfo;
         return S_OK;
@@ -133,7 +133,11 @@ public:
 
 private:
     
-    Microsoft::WRL::ComPtr<ModuleEnumerationService> m_spModuleService;
+    //
+    // The module enumeration service caches the module objects it hands out.  Keep only a *WEAK* back
+    // pointer to it so that there is no reference cycle between the service and its modules.
+    //
+    ModuleEnumerationService *m_pModuleService;
     std::shared_ptr<TextDumpParser> m_spParsedFile;
     ModuleInformation const *m_pModuleInfo;
 
@@ -332,13 +336,7 @@ public:
     //
     // Initializes the virtual memory service.
     //
-    HRESULT RuntimeClassInitialize(_In_ std::shared_ptr<TextDumpParser> const& parsedFile)
-    {
-        m_pServiceManager = nullptr;
-        m_spParsedFile = parsedFile;
-        m_firstEnumerationComplete = false;
-        return S_OK;
-    }
+    HRESULT RuntimeClassInitialize(_In_ std::shared_ptr<TextDumpParser> const& parsedFile);
 
     // CompleteModuleEnumeration():
     //
@@ -346,11 +344,26 @@ public:
     //
     void CompleteModuleEnumeration();
 
+    // GetModule():
+    //
+    // Gets the (cached) module object for the module at the given index within the parsed module information.
+    //
+    Module *GetModule(_In_ size_t moduleIndex) const
+    {
+        return m_modules[moduleIndex].Get();
+    }
+
 private:
 
     std::shared_ptr<TextDumpParser> m_spParsedFile;
     bool m_firstEnumerationComplete;
 
+    //
+    // The module objects for each module in the parsed module information (in the same order).  The text dump
+    // is immutable, so these are created once rather than on every lookup.
+    //
+    std::vector<Microsoft::WRL::ComPtr<Module>> m_modules;
+
     //
     // Keep a *WEAK* back pointer to the service manager that owns us!
     //
@@ -0,0 +1,584 @@
+//**************************************************************************
+//
+// SidecarCache.cpp
+//
+// An optional binary "sidecar" cache of a parsed "text dump" file.  The
+// sidecar sits next to the text file and allows later opens of the same
+// file to skip parsing entirely.
+//
+//**************************************************************************
+//
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+//
+//**************************************************************************
+
+#include "TextDump.h"
+
+namespace Debugger
+{
+namespace TargetComposition
+{
+namespace Services
+{
+namespace TextDump
+{
+
+namespace
+{
+
+//
+// The layout of a sidecar cache file:
+//
+//     SidecarHeader
+//     SidecarRegion[Regions.Count]
+//     SidecarModule[Modules.Count]
+//     SidecarStackFrame[StackFrames.Count]
+//     SidecarRegister[Registers.Count]
+//     wchar_t[Strings.Count]                  (padded to 8 bytes)
+//     unsigned char[MemoryData.Count]
+//
+// Every structure is made of ULONG64s so that there is no padding and every table is naturally aligned.  The
+// version must change whenever the layout does.
+//
+const ULONG64 SidecarSignature = 0x3143454449534454ull;     // 'TDSIDEC1'
+const ULONG64 SidecarVersion = 1;
+
+struct SidecarTable
+{
+    ULONG64 Offset;
+    ULONG64 Count;
+};
+
+struct SidecarHeader
+{
+    ULONG64 Signature;
+    ULONG64 Version;
+    ULONG64 SourceSize;
+    ULONG64 SourceLastWriteTime;
+    ULONG64 SourceHash;
+    SidecarTable Regions;
+    SidecarTable Modules;
+    SidecarTable StackFrames;
+    SidecarTable Registers;
+    SidecarTable Strings;
+    SidecarTable MemoryData;
+};
+
+struct SidecarString
+{
+    ULONG64 Offset;
+    ULONG64 Length;
+};
+
+struct SidecarRegion
+{
+    ULONG64 StartAddress;
+    ULONG64 EndAddress;
+    ULONG64 DataOffset;
+};
+
+struct SidecarModule
+{
+    ULONG64 StartAddress;
+    ULONG64 EndAddress;
+    ULONG64 TimeStamp;
+    ULONG64 ImageSize;
+    SidecarString ModuleName;
+    SidecarString ModulePath;
+};
+
+struct SidecarStackFrame
+{
+    ULONG64 FrameNumber;
+    ULONG64 ChildSp;
+    ULONG64 RetAddr;
+    ULONG64 Displacement;
+    SidecarString Module;
+    SidecarString Symbol;
+};
+
+struct SidecarRegister
+{
+    ULONG64 Value;
+    SidecarString Name;
+};
+
+// SidecarWriter:
+//
+// Buffered writes to the sidecar cache file.
+//
+class SidecarWriter
+{
+public:
+
+    SidecarWriter(_In_ HANDLE hFile) :
+        m_hFile(hFile),
+        m_failed(false)
+    {
+        m_buffer.reserve(BufferSize);
+    }
+
+    void Write(_In_reads_bytes_(size) void const *pData, _In_ size_t size)
+    {
+        unsigned char const *pBytes = reinterpret_cast<unsigned char const *>(pData);
+        while (size > 0 && !m_failed)
+        {
+            size_t copySize = (std::min)(size, BufferSize - m_buffer.size());
+            m_buffer.insert(m_buffer.end(), pBytes, pBytes + copySize);
+            pBytes += copySize;
+            size -= copySize;
+            if (m_buffer.size() == BufferSize)
+            {
+                Flush();
+            }
+        }
+    }
+
+    template<typename T>
+    void Write(_In_ std::vector<T> const& items)
+    {
+        Write(items.data(), items.size() * sizeof(T));
+    }
+
+    bool Flush()
+    {
+        DWORD bytesWritten;
+        if (!m_failed && !m_buffer.empty())
+        {
+            m_failed = !WriteFile(m_hFile, m_buffer.data(), static_cast<DWORD>(m_buffer.size()), &bytesWritten, nullptr) ||
+                       bytesWritten != m_buffer.size();
+        }
+        m_buffer.clear();
+        return !m_failed;
+    }
+
+private:
+
+    static const size_t BufferSize = 1024 * 1024;
+
+    HANDLE m_hFile;
+    bool m_failed;
+    std::vector<unsigned char> m_buffer;
+};
+
+// IsTableValid():
+//
+// Checks that a table of the sidecar is entirely within the file.
+//
+bool IsTableValid(_In_ SidecarTable const& table, _In_ size_t elementSize, _In_ ULONG64 fileSize)
+{
+    return table.Offset <= fileSize &&
+           table.Count <= (fileSize - table.Offset) / elementSize;
+}
+
+} // anonymous namespace
+
+void TextDumpParser::ReleaseSidecar()
+{
+    if (m_pSidecarView != nullptr)
+    {
+        UnmapViewOfFile(m_pSidecarView);
+        m_pSidecarView = nullptr;
+    }
+
+    if (m_hSidecarMapping != nullptr)
+    {
+        CloseHandle(m_hSidecarMapping);
+        m_hSidecarMapping = nullptr;
+    }
+
+    if (m_hSidecarFile != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(m_hSidecarFile);
+        m_hSidecarFile = INVALID_HANDLE_VALUE;
+    }
+
+    m_pSidecarMemory = nullptr;
+}
+
+bool TextDumpParser::IsSidecarCacheEnabled()
+{
+    wchar_t value[8];
+    DWORD length = GetEnvironmentVariableW(L"TEXTDUMP_SIDECAR_CACHE", value, ARRAYSIZE(value));
+    return (length > 0 && length < ARRAYSIZE(value) && wcscmp(value, L"1") == 0);
+}
+
+HRESULT TextDumpParser::GetSourceFileInformation(_Out_ std::wstring *pPath,
+                                                 _Out_ ULONG64 *pLastWriteTime,
+                                                 _Out_ ULONG64 *pHash)
+{
+    //
+    // If the text file isn't a mapped view of a file on disk, there is no sidecar.
+    //
+    HRESULT hr = S_OK;
+    std::wstring path;
+    IfFailedReturn(GetSourceFilePath(&path));
+
+    WIN32_FILE_ATTRIBUTE_DATA fileData;
+    if (!GetFileAttributesExW(path.c_str(), GetFileExInfoStandard, &fileData))
+    {
+        return HRESULT_FROM_WIN32(GetLastError());
+    }
+
+    ULONG64 fileSize = (static_cast<ULONG64>(fileData.nFileSizeHigh) << 32) | fileData.nFileSizeLow;
+    if (fileSize != m_mappingSize)
+    {
+        return E_FAIL;
+    }
+
+    //
+    // The size and time stamp catch most changes to the text file.  The hash (FNV-1a over 64-bit words) catches
+    // the rest and is still far cheaper than a parse.
+    //
+    ULONG64 hash = 0xcbf29ce484222325ull;
+    size_t wordCount = m_mappingSize / sizeof(ULONG64);
+    for (size_t i = 0; i < wordCount; ++i)
+    {
+        ULONG64 word;
+        memcpy(&word, m_pFileMapping + i * sizeof(ULONG64), sizeof(word));
+        hash = (hash ^ word) * 0x100000001b3ull;
+    }
+    for (size_t i = wordCount * sizeof(ULONG64); i < m_mappingSize; ++i)
+    {
+        hash = (hash ^ static_cast<unsigned char>(m_pFileMapping[i])) * 0x100000001b3ull;
+    }
+
+    *pPath = std::move(path);
+    *pLastWriteTime = (static_cast<ULONG64>(fileData.ftLastWriteTime.dwHighDateTime) << 32) |
+                      fileData.ftLastWriteTime.dwLowDateTime;
+    *pHash = hash;
+    return S_OK;
+}
+
+HRESULT TextDumpParser::LoadSidecar(_In_ std::wstring const& sidecarPath,
+                                    _In_ ULONG64 lastWriteTime,
+                                    _In_ ULONG64 hash)
+{
+    HRESULT hr = LoadSidecarInternal(sidecarPath, lastWriteTime, hash);
+    if (FAILED(hr))
+    {
+        ReleaseSidecar();
+    }
+
+    return hr;
+}
+
+HRESULT TextDumpParser::LoadSidecarInternal(_In_ std::wstring const& sidecarPath,
+                                            _In_ ULONG64 lastWriteTime,
+                                            _In_ ULONG64 hash)
+{
+    HANDLE hFile = CreateFileW(sidecarPath.c_str(),
+                               GENERIC_READ,
+                               FILE_SHARE_READ | FILE_SHARE_DELETE,
+                               nullptr,
+                               OPEN_EXISTING,
+                               FILE_ATTRIBUTE_NORMAL,
+                               nullptr);
+    if (hFile == INVALID_HANDLE_VALUE)
+    {
+        return HRESULT_FROM_WIN32(GetLastError());
+    }
+
+    //
+    // From here on, the handles are owned by the parser.  LoadSidecar releases them if the sidecar turns
+    // out not to be valid.
+    //
+    m_hSidecarFile = hFile;
+
+    auto fn = [&]()
+    {
+        return LoadSidecarTables(lastWriteTime, hash);
+    };
+    return ConvertException(fn);
+}
+
+HRESULT TextDumpParser::LoadSidecarTables(_In_ ULONG64 lastWriteTime, _In_ ULONG64 hash)
+{
+    HANDLE hFile = m_hSidecarFile;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(hFile, &fileSize) || fileSize.QuadPart < static_cast<LONGLONG>(sizeof(SidecarHeader)) ||
+        static_cast<ULONG64>(fileSize.QuadPart) > static_cast<ULONG64>(SIZE_MAX))
+    {
+        return E_FAIL;
+    }
+
+    m_hSidecarMapping = CreateFileMappingW(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (m_hSidecarMapping == nullptr)
+    {
+        return HRESULT_FROM_WIN32(GetLastError());
+    }
+
+    m_pSidecarView = MapViewOfFile(m_hSidecarMapping, FILE_MAP_READ, 0, 0, 0);
+    if (m_pSidecarView == nullptr)
+    {
+        return HRESULT_FROM_WIN32(GetLastError());
+    }
+
+    unsigned char const *pBase = reinterpret_cast<unsigned char const *>(m_pSidecarView);
+    ULONG64 size = static_cast<ULONG64>(fileSize.QuadPart);
+
+    //
+    // Validate *EVERYTHING* before using any of it.  The sidecar might be stale, truncated, or simply garbage.
+    //
+    SidecarHeader const *pHeader = reinterpret_cast<SidecarHeader const *>(pBase);
+    if (pHeader->Signature != SidecarSignature ||
+        pHeader->Version != SidecarVersion ||
+        pHeader->SourceSize != m_mappingSize ||
+        pHeader->SourceLastWriteTime != lastWriteTime ||
+        pHeader->SourceHash != hash)
+    {
+        return E_FAIL;
+    }
+
+    if (!IsTableValid(pHeader->Regions, sizeof(SidecarRegion), size) ||
+        !IsTableValid(pHeader->Modules, sizeof(SidecarModule), size) ||
+        !IsTableValid(pHeader->StackFrames, sizeof(SidecarStackFrame), size) ||
+        !IsTableValid(pHeader->Registers, sizeof(SidecarRegister), size) ||
+        !IsTableValid(pHeader->Strings, sizeof(wchar_t), size) ||
+        !IsTableValid(pHeader->MemoryData, sizeof(unsigned char), size))
+    {
+        return E_FAIL;
+    }
+
+    wchar_t const *pStrings = reinterpret_cast<wchar_t const *>(pBase + pHeader->Strings.Offset);
+    auto getString = [&](SidecarString const& str, std::wstring *pString)
+    {
+        if (str.Offset > pHeader->Strings.Count || str.Length > pHeader->Strings.Count - str.Offset)
+        {
+            return false;
+        }
+        pString->assign(pStrings + str.Offset, static_cast<size_t>(str.Length));
+        return true;
+    };
+
+    //
+    // The regions were written sorted and coalesced.  Make sure that they still are since lookups depend on it.
+    //
+    SidecarRegion const *pRegions = reinterpret_cast<SidecarRegion const *>(pBase + pHeader->Regions.Offset);
+    std::vector<MemoryRegion> memoryRegions;
+    std::vector<ULONG64> regionOffsets;
+    memoryRegions.reserve(static_cast<size_t>(pHeader->Regions.Count));
+    regionOffsets.reserve(static_cast<size_t>(pHeader->Regions.Count));
+    for (ULONG64 i = 0; i < pHeader->Regions.Count; ++i)
+    {
+        SidecarRegion const& region = pRegions[i];
+        if (region.EndAddress <= region.StartAddress ||
+            (i > 0 && region.StartAddress <= pRegions[i - 1].EndAddress) ||
+            region.DataOffset > pHeader->MemoryData.Count ||
+            region.EndAddress - region.StartAddress > pHeader->MemoryData.Count - region.DataOffset)
+        {
+            return E_FAIL;
+        }
+
+        memoryRegions.push_back({ region.StartAddress, region.EndAddress, {} });
+        regionOffsets.push_back(region.DataOffset);
+    }
+
+    std::vector<ModuleInformation> moduleInfos;
+    SidecarModule const *pModules = reinterpret_cast<SidecarModule const *>(pBase + pHeader->Modules.Offset);
+    for (ULONG64 i = 0; i < pHeader->Modules.Count; ++i)
+    {
+        SidecarModule const& module = pModules[i];
+        ModuleInformation moduleInfo = { module.StartAddress, module.EndAddress, {}, {}, module.TimeStamp, module.ImageSize };
+        if (!getString(module.ModuleName, &moduleInfo.ModuleName) || !getString(module.ModulePath, &moduleInfo.ModulePath))
+        {
+            return E_FAIL;
+        }
+        moduleInfos.push_back(std::move(moduleInfo));
+    }
+
+    std::vector<StackFrame> stackFrames;
+    SidecarStackFrame const *pFrames = reinterpret_cast<SidecarStackFrame const *>(pBase + pHeader->StackFrames.Offset);
+    for (ULONG64 i = 0; i < pHeader->StackFrames.Count; ++i)
+    {
+        SidecarStackFrame const& frame = pFrames[i];
+        StackFrame stackFrame = { frame.FrameNumber, frame.ChildSp, frame.RetAddr, {}, {}, frame.Displacement };
+        if (!getString(frame.Module, &stackFrame.Module) || !getString(frame.Symbol, &stackFrame.Symbol))
+        {
+            return E_FAIL;
+        }
+        stackFrames.push_back(std::move(stackFrame));
+    }
+
+    std::vector<RegisterValue> registerValues;
+    SidecarRegister const *pRegisters = reinterpret_cast<SidecarRegister const *>(pBase + pHeader->Registers.Offset);
+    for (ULONG64 i = 0; i < pHeader->Registers.Count; ++i)
+    {
+        RegisterValue registerValue = { {}, pRegisters[i].Value };
+        if (!getString(pRegisters[i].Name, &registerValue.Name))
+        {
+            return E_FAIL;
+        }
+        registerValues.push_back(std::move(registerValue));
+    }
+
+    m_memoryRegions = std::move(memoryRegions);
+    m_sidecarRegionOffsets = std::move(regionOffsets);
+    m_moduleInfos = std::move(moduleInfos);
+    m_stackFrames = std::move(stackFrames);
+    m_registerValues = std::move(registerValues);
+
+    m_pSidecarMemory = pBase + pHeader->MemoryData.Offset;
+    m_memorySource = MemorySource::Sidecar;
+    return S_OK;
+}
+
+HRESULT TextDumpParser::WriteSidecar(_In_ std::wstring const& sidecarPath,
+                                     _In_ ULONG64 lastWriteTime,
+                                     _In_ ULONG64 hash)
+{
+    HRESULT hr = S_OK;
+
+    //
+    // The memory of a UTF-8 file is only indexed on first use.  If its rows cannot be parsed, there is
+    // nothing valid to cache.
+    //
+    IfFailedReturn(EnsureMemoryIndex());
+
+    //
+    // Gather all of the tables (other than the memory bytes themselves) up front so that the header
+    // can be written first.
+    //
+    std::vector<wchar_t> strings;
+    auto addString = [&](std::wstring const& str)
+    {
+        SidecarString sidecarString = { strings.size(), str.length() };
+        strings.insert(strings.end(), str.begin(), str.end());
+        return sidecarString;
+    };
+
+    std::vector<SidecarRegion> regions;
+    regions.reserve(m_memoryRegions.size());
+    ULONG64 memoryDataSize = 0;
+    for (auto&& region : m_memoryRegions)
+    {
+        regions.push_back({ region.StartAddress, region.EndAddress, memoryDataSize });
+        memoryDataSize += region.EndAddress - region.StartAddress;
+    }
+
+    std::vector<SidecarModule> modules;
+    modules.reserve(m_moduleInfos.size());
+    for (auto&& moduleInfo : m_moduleInfos)
+    {
+        modules.push_back({ moduleInfo.StartAddress, moduleInfo.EndAddress, moduleInfo.TimeStamp, moduleInfo.ImageSize,
+                            addString(moduleInfo.ModuleName), addString(moduleInfo.ModulePath) });
+    }
+
+    std::vector<SidecarStackFrame> frames;
+    frames.reserve(m_stackFrames.size());
+    for (auto&& frame : m_stackFrames)
+    {
+        frames.push_back({ frame.FrameNumber, frame.ChildSp, frame.RetAddr, frame.Displacement,
+                           addString(frame.Module), addString(frame.Symbol) });
+    }
+
+    std::vector<SidecarRegister> registers;
+    registers.reserve(m_registerValues.size());
+    for (auto&& registerValue : m_registerValues)
+    {
+        registers.push_back({ registerValue.Value, addString(registerValue.Name) });
+    }
+
+    //
+    // Keep the memory bytes 8 byte aligned.
+    //
+    while ((strings.size() * sizeof(wchar_t)) % sizeof(ULONG64) != 0)
+    {
+        strings.push_back(L'\0');
+    }
+
+    SidecarHeader header = {};
+    header.Signature = SidecarSignature;
+    header.Version = SidecarVersion;
+    header.SourceSize = m_mappingSize;
+    header.SourceLastWriteTime = lastWriteTime;
+    header.SourceHash = hash;
+
+    ULONG64 offset = sizeof(SidecarHeader);
+    auto placeTable = [&](SidecarTable *pTable, size_t count, size_t elementSize)
+    {
+        pTable->Offset = offset;
+        pTable->Count = count;
+        offset += static_cast<ULONG64>(count) * elementSize;
+    };
+
+    placeTable(&header.Regions, regions.size(), sizeof(SidecarRegion));
+    placeTable(&header.Modules, modules.size(), sizeof(SidecarModule));
+    placeTable(&header.StackFrames, frames.size(), sizeof(SidecarStackFrame));
+    placeTable(&header.Registers, registers.size(), sizeof(SidecarRegister));
+    placeTable(&header.Strings, strings.size(), sizeof(wchar_t));
+    header.MemoryData.Offset = offset;
+    header.MemoryData.Count = memoryDataSize;
+
+    //
+    // Write to a temporary file and move it into place so that another debugger opening the same text file
+    // never sees a partially written sidecar.
+    //
+    wchar_t uniquifier[32];
+    swprintf_s(uniquifier, ARRAYSIZE(uniquifier), L".%08x.tmp", GetCurrentProcessId());
+    std::wstring tempPath = sidecarPath + uniquifier;
+
+    HANDLE hFile = CreateFileW(tempPath.c_str(),
+                               GENERIC_WRITE,
+                               0,
+                               nullptr,
+                               CREATE_ALWAYS,
+                               FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+                               nullptr);
+    if (hFile == INVALID_HANDLE_VALUE)
+    {
+        return HRESULT_FROM_WIN32(GetLastError());
+    }
+
+    auto fn = [&]()
+    {
+        HRESULT hr = S_OK;
+
+        SidecarWriter writer(hFile);
+        writer.Write(&header, sizeof(header));
+        writer.Write(regions);
+        writer.Write(modules);
+        writer.Write(frames);
+        writer.Write(registers);
+        writer.Write(strings);
+
+        //
+        // The memory bytes are pulled through ReadMemory a chunk at a time so that this works the same regardless
+        // of whether the bytes were decoded eagerly or are decoded on demand.
+        //
+        std::vector<unsigned char> chunk(1024 * 1024);
+        for (auto&& region : m_memoryRegions)
+        {
+            for (ULONG64 address = region.StartAddress; address < region.EndAddress; )
+            {
+                size_t chunkSize = static_cast<size_t>((std::min)(static_cast<ULONG64>(chunk.size()), region.EndAddress - address));
+                IfFailedReturn(ReadMemory(&region, address, chunk.data(), chunkSize));
+                writer.Write(chunk.data(), chunkSize);
+                address += chunkSize;
+            }
+        }
+
+        return writer.Flush() ? S_OK : E_FAIL;
+    };
+
+    hr = ConvertException(fn);
+    CloseHandle(hFile);
+
+    if (SUCCEEDED(hr) && !MoveFileExW(tempPath.c_str(), sidecarPath.c_str(), MOVEFILE_REPLACE_EXISTING))
+    {
+        hr = HRESULT_FROM_WIN32(GetLastError());
+    }
+
+    if (FAILED(hr))
+    {
+        DeleteFileW(tempPath.c_str());
+    }
+
+    return hr;
+}
+
+} // TextDump
+} // Services
+} // TargetComposition
+} // Debugger
@@ -35,6 +35,11 @@
 #include <unordered_map>
 #include <algorithm>
 #include <functional>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <list>
+#include <numeric>
 
 //
 // @TODO: This should be fixed.  Including the headers in a public release should *NOT* require a define!
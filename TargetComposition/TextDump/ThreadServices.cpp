@@ -27,16 +27,55 @@ namespace TextDump
 HRESULT Thread::GetContext(_In_ SvcContextFlags /*contextFlags*/,
                            _Out_ ISvcRegisterContext **ppRegisterContext)
 {
-    HRESULT hr = S_OK;
     *ppRegisterContext = nullptr;
 
-    ISvcMachineArchitecture *pMachineArch = m_spThreadService->GetMachineArch();
-
     //
     // If there was no register context saved in the "text dump" just return E_NOTIMPL indicating that
     // we do not have any register context available.
     //
-    if (!m_spParsedFile->HasRegisters() || pMachineArch == nullptr)
+    if (!m_spParsedFile->HasRegisters() || m_spThreadService->GetMachineArch() == nullptr)
+    {
+        return E_NOTIMPL;
+    }
+
+    //
+    // NOTE: The caller is only asking for what's in contextFlags (e.g.: maybe only integer registers)
+    //       We do not have to fill in anything beyond that.  For sample purposes here, we fill in everything
+    //       that we know.
+    //
+    return m_spThreadService->GetRegisterContext(ppRegisterContext);
+}
+
+HRESULT ThreadEnumerationService::GetRegisterContext(_COM_Outptr_ ISvcRegisterContext **ppRegisterContext)
+{
+    auto fn = [&]()
+    {
+        HRESULT hr = S_OK;
+        *ppRegisterContext = nullptr;
+
+        std::lock_guard<std::mutex> lock(m_registerContextLock);
+
+        if (m_spRegisterContext == nullptr)
+        {
+            IfFailedReturn(BuildRegisterContext(&m_spRegisterContext));
+        }
+
+        //
+        // The caller is free to modify the context which it gets back.  Hand out a duplicate so that
+        // the cached copy always reflects what is in the "text dump".
+        //
+        IfFailedReturn(m_spRegisterContext->Duplicate(ppRegisterContext));
+        return hr;
+    };
+    return ConvertException(fn);
+}
+
+HRESULT ThreadEnumerationService::BuildRegisterContext(_COM_Outptr_ ISvcRegisterContext **ppRegisterContext)
+{
+    HRESULT hr = S_OK;
+    *ppRegisterContext = nullptr;
+
+    if (m_spMachineArch == nullptr)
     {
         return E_NOTIMPL;
     }
@@ -46,15 +85,10 @@ HRESULT Thread::GetContext(_In_ SvcContextFlags /*contextFlags*/,
     // however, it is far easier (and more typical) to go ask the architecture service to just give us one.
     //
     ComPtr<ISvcRegisterContext> spRegisterContext;
-    IfFailedReturn(pMachineArch->CreateRegisterContext(&spRegisterContext));
+    IfFailedReturn(m_spMachineArch->CreateRegisterContext(&spRegisterContext));
 
-    //
-    // NOTE: The caller is only asking for what's in contextFlags (e.g.: maybe only integer registers)
-    //       We do not have to fill in anything beyond that.  For sample purposes here, we fill in everything
-    //       that we know.
-    //    
     std::unordered_map<std::wstring, ULONG> const* pRegisterMappings;
-    IfFailedReturn(m_spThreadService->GetRegisterMappings(&pRegisterMappings));
+    IfFailedReturn(GetRegisterMappings(&pRegisterMappings));
 
     for (auto&& registerValue : m_spParsedFile->GetRegisters())
     {
@@ -334,6 +334,14 @@ public:
             {
                 IfFailedReturn(pNewService->QueryInterface(IID_PPV_ARGS(&m_spMachineArch)));
             }
+
+            //
+            // Any register context built against the prior architecture service is no longer valid.
+            //
+            {
+                std::lock_guard<std::mutex> lock(m_registerContextLock);
+                m_spRegisterContext = nullptr;
+            }
             IfFailedReturn(InitializeRegisterMappings());
         }
 
@@ -405,6 +413,13 @@ public:
     //
     ISvcMachineArchitecture *GetMachineArch() const { return m_spMachineArch.Get(); }
 
+    // GetRegisterContext():
+    //
+    // Gets a copy of the register context described by the "text dump".  The context is only built
+    // the first time it is requested.  Every caller gets its own duplicate of that context.
+    //
+    HRESULT GetRegisterContext(_COM_Outptr_ ISvcRegisterContext **ppRegisterContext);
+
 private:
 
     // InitializeRegisterMappings():
@@ -413,9 +428,20 @@ private:
     //
     HRESULT InitializeRegisterMappings();
 
+    // BuildRegisterContext():
+    //
+    // Builds the register context described by the "text dump" from the register mappings.
+    //
+    HRESULT BuildRegisterContext(_COM_Outptr_ ISvcRegisterContext **ppRegisterContext);
+
     std::unordered_map<std::wstring, ULONG> m_registerMappings;
     Microsoft::WRL::ComPtr<ISvcMachineArchitecture> m_spMachineArch;
     std::shared_ptr<TextDumpParser> m_spParsedFile;
+
+    // The dump is immutable, so the register context only needs to be built once.  Stack unwinds ask for
+    // the context frequently.
+    std::mutex m_registerContextLock;
+    Microsoft::WRL::ComPtr<ISvcRegisterContext> m_spRegisterContext;
 };
 
 } // TextDump